@@ -44,6 +44,7 @@
 #define ROAD_ACCESS_FILE_TAG "roadaccess"
 #define RESTRICTIONS_FILE_TAG "restrictions"
 #define ROUTING_FILE_TAG "routing"
+#define ROUTING_GEOMETRY_FILE_TAG "routing_geometry"
 #define CROSS_MWM_FILE_TAG "cross_mwm"
 #define FEATURE_OFFSETS_FILE_TAG "offs"
 #define SEARCH_RANKS_FILE_TAG "ranks"
@@ -59,6 +60,7 @@
 #define DESCRIPTIONS_FILE_TAG "descriptions"
 #define MAXSPEEDS_FILE_TAG "maxspeeds"
 #define ROUTING_WORLD_FILE_TAG "routing_world"
+#define CROSS_MWM_OVERLAY_FILE_TAG "cross_mwm_overlay"
 
 #define READY_FILE_EXTENSION ".ready"
 #define RESUME_FILE_EXTENSION ".resume"
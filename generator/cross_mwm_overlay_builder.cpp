@@ -0,0 +1,123 @@
+#include "generator/cross_mwm_overlay_builder.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <queue>
+
+namespace routing_builder
+{
+using namespace routing;
+
+CrossMwmOverlayCellBuilder::CrossMwmOverlayCellBuilder(std::vector<NumMwmId> const & mwms,
+                                                       std::vector<uint32_t> const & mwmVersions)
+{
+  CHECK_EQUAL(mwms.size(), mwmVersions.size(), ());
+  m_cell.m_mwms = mwms;
+  m_cell.m_mwmVersions = mwmVersions;
+}
+
+void CrossMwmOverlayCellBuilder::AddLeap(Segment const & enter, Segment const & exit, Weight weight)
+{
+  CHECK_NOT_EQUAL(weight, connector::kNoRouteStored, (enter, exit));
+  AddEdge(enter, exit, weight);
+}
+
+void CrossMwmOverlayCellBuilder::AddTwins(Segment const & exit, Segment const & enter)
+{
+  AddEdge(exit, enter, 0 /* weight */);
+}
+
+CrossMwmOverlayCell CrossMwmOverlayCellBuilder::Build(base::ComputationalThreadPool & threadPool) &&
+{
+  CHECK(!IsTooLarge(), (GetWeightsCount()));
+
+  std::vector<std::future<std::vector<Weight>>> rows;
+  rows.reserve(m_cell.m_enters.size());
+  for (auto const & enter : m_cell.m_enters)
+  {
+    rows.push_back(threadPool.Submit([this, enter]()
+    {
+      auto const distances = FindDistances(enter);
+
+      std::vector<Weight> row(m_cell.m_exits.size(), connector::kNoRouteStored);
+      for (size_t i = 0; i < m_cell.m_exits.size(); ++i)
+      {
+        auto const id = GetVertexId(m_cell.m_exits[i]);
+        if (!id || distances[*id] == kInf)
+          continue;
+
+        // Stored weight can't be equal to kNoRouteStored.
+        row[i] = static_cast<Weight>(std::clamp(distances[*id], GraphWeight{1},
+                                                GraphWeight{std::numeric_limits<Weight>::max()}));
+      }
+      return row;
+    }));
+  }
+
+  m_cell.m_weights.reserve(GetWeightsCount());
+  for (auto & row : rows)
+  {
+    auto const weights = row.get();
+    m_cell.m_weights.insert(m_cell.m_weights.end(), weights.begin(), weights.end());
+  }
+
+  return std::move(m_cell);
+}
+
+uint32_t CrossMwmOverlayCellBuilder::AddVertex(Segment const & s)
+{
+  auto const [it, inserted] = m_ids.emplace(s, base::checked_cast<uint32_t>(m_edges.size()));
+  if (inserted)
+    m_edges.emplace_back();
+  return it->second;
+}
+
+void CrossMwmOverlayCellBuilder::AddEdge(Segment const & from, Segment const & to, GraphWeight weight)
+{
+  uint32_t const toId = AddVertex(to);
+  m_edges[AddVertex(from)].emplace_back(toId, weight);
+}
+
+std::optional<uint32_t> CrossMwmOverlayCellBuilder::GetVertexId(Segment const & s) const
+{
+  auto const it = m_ids.find(s);
+  if (it == m_ids.end())
+    return {};
+  return it->second;
+}
+
+std::vector<CrossMwmOverlayCellBuilder::GraphWeight> CrossMwmOverlayCellBuilder::FindDistances(
+    Segment const & from) const
+{
+  std::vector<GraphWeight> distances(m_edges.size(), kInf);
+  auto const fromId = GetVertexId(from);
+  if (!fromId)
+    return distances;
+
+  using State = std::pair<GraphWeight, uint32_t>;
+  std::priority_queue<State, std::vector<State>, std::greater<State>> queue;
+  distances[*fromId] = 0;
+  queue.emplace(0, *fromId);
+  while (!queue.empty())
+  {
+    auto const [distance, v] = queue.top();
+    queue.pop();
+    if (distance > distances[v])
+      continue;
+
+    for (auto const & [u, w] : m_edges[v])
+    {
+      if (distance + w < distances[u])
+      {
+        distances[u] = distance + w;
+        queue.emplace(distances[u], u);
+      }
+    }
+  }
+  return distances;
+}
+}  // namespace routing_builder
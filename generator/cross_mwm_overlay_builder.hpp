@@ -0,0 +1,64 @@
+#pragma once
+
+#include "routing/cross_mwm_overlay.hpp"
+#include "routing/segment.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include "base/thread_pool_computational.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace routing_builder
+{
+/// \brief Builds a cell of the cross-mwm overlay from the cross-mwm transitions of its mwms.
+class CrossMwmOverlayCellBuilder
+{
+public:
+  using Weight = routing::CrossMwmOverlayCell::Weight;
+
+  /// The weights matrix grows as enters x exits, bigger cells are not put into the overlay and
+  /// the router goes through the cross_mwm sections of their mwms. With varint weights
+  /// (up to 3 bytes) a cell takes at most ~3MB of the section.
+  static size_t constexpr kMaxWeightsCount = 1 << 20;
+
+  CrossMwmOverlayCellBuilder(std::vector<routing::NumMwmId> const & mwms,
+                             std::vector<uint32_t> const & mwmVersions);
+
+  /// \brief Adds the |enter| -> |exit| route inside an mwm of the cell.
+  void AddLeap(routing::Segment const & enter, routing::Segment const & exit, Weight weight);
+  /// \brief Adds the transition from |exit| to its twin |enter| of another mwm of the cell.
+  void AddTwins(routing::Segment const & exit, routing::Segment const & enter);
+
+  void AddCellEnter(routing::Segment const & enter) { m_cell.m_enters.push_back(enter); }
+  void AddCellExit(routing::Segment const & exit) { m_cell.m_exits.push_back(exit); }
+
+  size_t GetWeightsCount() const { return m_cell.m_enters.size() * m_cell.m_exits.size(); }
+  bool IsTooLarge() const { return GetWeightsCount() > kMaxWeightsCount; }
+
+  /// \brief Calculates the shortest enter -> exit weights on |threadPool|.
+  routing::CrossMwmOverlayCell Build(base::ComputationalThreadPool & threadPool) &&;
+
+private:
+  using GraphWeight = uint64_t;
+  static GraphWeight constexpr kInf = std::numeric_limits<GraphWeight>::max();
+
+  uint32_t AddVertex(routing::Segment const & s);
+  void AddEdge(routing::Segment const & from, routing::Segment const & to, GraphWeight weight);
+  std::optional<uint32_t> GetVertexId(routing::Segment const & s) const;
+  /// \returns shortest weights from |from| to every vertex.
+  std::vector<GraphWeight> FindDistances(routing::Segment const & from) const;
+
+  routing::CrossMwmOverlayCell m_cell;
+
+  // Graph of the leaps inside mwms and the twins between them.
+  std::unordered_map<routing::Segment, uint32_t> m_ids;
+  std::vector<std::vector<std::pair<uint32_t, GraphWeight>>> m_edges;
+};
+}  // namespace routing_builder
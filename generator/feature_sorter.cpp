@@ -22,14 +22,19 @@
 #include "coding/files_container.hpp"
 #include "coding/point_coding.hpp"
 #include "coding/succinct_mapper.hpp"
+#include "coding/writer.hpp"
 
 #include "base/assert.hpp"
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include "defines.hpp"
 
+#include <algorithm>
+#include <array>
+#include <future>
 #include <limits>
 #include <list>
 #include <memory>
@@ -146,9 +151,111 @@ public:
 
   void operator()(FeatureBuilder & fb)
   {
-    GeometryHolder holder([this](int i) -> FileWriter & { return m_geoFile[i]->GetWriter(); },
-                          [this](int i) -> FileWriter & { return m_trgFile[i]->GetWriter(); }, fb, m_header);
+    GeometryHolder holder([this](int i) -> Writer & { return m_geoFile[i]->GetWriter(); },
+                          [this](int i) -> Writer & { return m_trgFile[i]->GetWriter(); }, fb, m_header);
+    Prepare(fb, holder);
+    WriteFeature(fb, holder.GetBuffer());
+  }
+
+  /// Simplifies, tesselates and serializes outer geometry of |batch| features on |pool| threads.
+  /// Features are written in the order of |batch| with the same result as one by one processing.
+  void operator()(std::vector<FeatureBuilder> & batch, base::ComputationalThreadPool & pool, size_t tasksCount)
+  {
+    std::vector<FeatureGeometry> geometries(batch.size());
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(tasksCount);
+    for (size_t task = 0; task < tasksCount; ++task)
+    {
+      size_t const beg = batch.size() * task / tasksCount;
+      size_t const end = batch.size() * (task + 1) / tasksCount;
+      futures.push_back(pool.Submit([this, &batch, &geometries, beg, end]()
+      {
+        for (size_t i = beg; i < end; ++i)
+          Prepare(batch[i], geometries[i]);
+      }));
+    }
+
+    // Rethrows exceptions from the workers.
+    for (auto & f : futures)
+      f.get();
+
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+      AppendGeometry(geometries[i]);
+      WriteFeature(batch[i], geometries[i].m_buffer);
+    }
+  }
+
+private:
+  using Points = std::vector<m2::PointD>;
+  using Polygons = std::list<Points>;
+  using Buffer = std::vector<uint8_t>;
+
+  // Feature geometry which is prepared out of order: outer points and triangles are serialized
+  // into memory, their offsets are relative to the beginning of the buffers.
+  struct FeatureGeometry
+  {
+    FeatureBuilder::SupportingData m_buffer;
+    std::array<Buffer, DataHeader::kMaxScalesCount> m_geo;
+    std::array<Buffer, DataHeader::kMaxScalesCount> m_trg;
+  };
+
+  void Prepare(FeatureBuilder & fb, FeatureGeometry & geometry) const
+  {
+    size_t const scalesCount = m_header.GetScalesCount();
+    std::vector<MemWriter<Buffer>> geoWriters, trgWriters;
+    geoWriters.reserve(scalesCount);
+    trgWriters.reserve(scalesCount);
+    for (size_t i = 0; i < scalesCount; ++i)
+    {
+      geoWriters.emplace_back(geometry.m_geo[i]);
+      trgWriters.emplace_back(geometry.m_trg[i]);
+    }
+
+    GeometryHolder holder([&geoWriters](int i) -> Writer & { return geoWriters[i]; },
+                          [&trgWriters](int i) -> Writer & { return trgWriters[i]; }, fb, m_header);
+    Prepare(fb, holder);
+    geometry.m_buffer = std::move(holder.GetBuffer());
+  }
 
+  // Appends prepared out of order geometry to the geometry files and makes its offsets absolute.
+  void AppendGeometry(FeatureGeometry & geometry)
+  {
+    auto const append = [this](FeatureBuilder::Offsets & offsets, uint8_t mask,
+                               std::array<Buffer, DataHeader::kMaxScalesCount> const & buffers, TmpFiles & files)
+    {
+      // Offsets are added from the upper scale to the lower one, see GeometryHolder::AddPoints.
+      size_t offsetIdx = 0;
+      for (int i = static_cast<int>(m_header.GetScalesCount()) - 1; i >= 0; --i)
+      {
+        if ((mask & (1 << i)) == 0)
+          continue;
+
+        CHECK_LESS(offsetIdx, offsets.size(), ());
+        auto & w = files[i]->GetWriter();
+        auto & offset = offsets[offsetIdx++];
+        if (offset != feature::kGeomOffsetFallback)
+        {
+          uint64_t const pos = CheckedFilePosCast(w) + static_cast<uint64_t>(offset);
+          CHECK_LESS(pos, feature::kGeomOffsetFallback, ("Feature offset is out of 32bit boundary!"));
+          offset = static_cast<uint32_t>(pos);
+        }
+      }
+      CHECK_EQUAL(offsetIdx, offsets.size(), ());
+
+      for (size_t i = 0; i < m_header.GetScalesCount(); ++i)
+        files[i]->GetWriter().Write(buffers[i].data(), buffers[i].size());
+    };
+
+    append(geometry.m_buffer.m_ptsOffset, geometry.m_buffer.m_ptsMask, geometry.m_geo, m_geoFile);
+    append(geometry.m_buffer.m_trgOffset, geometry.m_buffer.m_trgMask, geometry.m_trg, m_trgFile);
+  }
+
+  // Simplifies and serializes feature's geometry with |holder| and updates feature's names.
+  // It doesn't change the collector, so it's called from different threads in batch processing.
+  void Prepare(FeatureBuilder & fb, GeometryHolder & holder) const
+  {
     if (!fb.IsPoint())
     {
       bool const isLine = fb.IsLine();
@@ -282,8 +389,11 @@ public:
           break;
       }
     }
+  }
 
-    auto & buffer = holder.GetBuffer();
+  // Serializes the feature with prepared geometry and writes it with its additional data.
+  void WriteFeature(FeatureBuilder & fb, FeatureBuilder::SupportingData & buffer)
+  {
     if (fb.PreSerializeAndRemoveUselessNamesForMwm(buffer))
     {
       fb.SerializeForMwm(buffer, m_header.GetDefGeometryCodingParams());
@@ -307,10 +417,6 @@ public:
     }
   }
 
-private:
-  using Points = std::vector<m2::PointD>;
-  using Polygons = std::list<Points>;
-
   class TmpFile
   {
     std::unique_ptr<FileWriter> m_writer;
@@ -363,7 +469,7 @@ private:
 };
 
 bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const & name,
-                           feature::DataHeader::MapType mapType)
+                           feature::DataHeader::MapType mapType, size_t threadsCount)
 {
   std::string const srcFilePath = info.GetTmpFileName(name);
   std::string const dataFilePath = info.GetTargetFileName(name);
@@ -410,14 +516,42 @@ bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const
       LOG(LINFO, ("Simplifying and filtering geometry for all geom levels"));
 
       FeaturesCollector2 collector(name, info, header, regionData, info.m_versionDate);
-      for (auto const & point : midPoints.GetVector())
+      auto const readFeature = [&reader](uint64_t pos, FeatureBuilder & fb)
       {
         ReaderSource<FileReader> src(reader);
-        src.Skip(point.second);
-
-        FeatureBuilder fb;
+        src.Skip(pos);
         ReadFromSourceRawFormat(src, fb);
-        collector(fb);
+      };
+
+      if (threadsCount <= 1)
+      {
+        for (auto const & point : midPoints.GetVector())
+        {
+          FeatureBuilder fb;
+          readFeature(point.second, fb);
+          collector(fb);
+        }
+      }
+      else
+      {
+        // Geometry of features batch is processed in parallel, features are written in the
+        // sorted order, so the result is the same as for one thread.
+        size_t constexpr kBatchSize = 4096;
+        size_t const tasksCount = threadsCount * 4;
+        base::ComputationalThreadPool pool(threadsCount);
+
+        auto const & points = midPoints.GetVector();
+        std::vector<FeatureBuilder> batch;
+        for (size_t beg = 0; beg < points.size(); beg += kBatchSize)
+        {
+          size_t const end = std::min(points.size(), beg + kBatchSize);
+          batch.clear();
+          batch.resize(end - beg);
+          for (size_t i = beg; i < end; ++i)
+            readFeature(points[i].second, batch[i - beg]);
+
+          collector(batch, pool, std::min(tasksCount, batch.size()));
+        }
       }
 
       LOG(LINFO, ("Writing features' data to", dataFilePath));
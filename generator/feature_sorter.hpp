@@ -4,6 +4,7 @@
 
 #include "indexer/data_header.hpp"
 
+#include <cstddef>
 #include <string>
 
 namespace feature
@@ -11,6 +12,7 @@ namespace feature
 /// Final generation of data from input feature-file.
 /// @param path - path to folder with countries;
 /// @param name - name of generated country;
+/// @param threadsCount - number of threads for features' geometry simplification and triangulation.
 bool GenerateFinalFeatures(feature::GenerateInfo const & info, std::string const & name,
-                           feature::DataHeader::MapType mapType);
+                           feature::DataHeader::MapType mapType, size_t threadsCount = 1);
 }  // namespace feature
@@ -53,18 +53,14 @@ std::vector<std::vector<std::string>> GetAffiliations(std::vector<FeatureBuilder
                                                       AffiliationInterface const & affiliation,
                                                       size_t threadsCount)
 {
-  base::ComputationalThreadPool pool(threadsCount);
-  std::vector<std::future<std::vector<std::string>>> futuresAffiliations;
-  for (auto const & fb : fbs)
+  // A task per feature is too fine-grained for a future per task, so features are processed
+  // in chunks which are stolen by idle threads.
+  std::vector<std::vector<std::string>> resultAffiliations(fbs.size());
+  base::WorkStealingThreadPool pool(threadsCount);
+  base::ParallelFor(pool, 0, fbs.size(), [&](size_t i)
   {
-    auto result = pool.Submit([&]() { return affiliation.GetAffiliations(fb); });
-    futuresAffiliations.emplace_back(std::move(result));
-  }
-
-  std::vector<std::vector<std::string>> resultAffiliations;
-  resultAffiliations.reserve(futuresAffiliations.size());
-  for (auto & f : futuresAffiliations)
-    resultAffiliations.emplace_back(f.get());
+    resultAffiliations[i] = affiliation.GetAffiliations(fbs[i]);
+  });
 
   return resultAffiliations;
 }
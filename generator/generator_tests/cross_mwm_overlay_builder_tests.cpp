@@ -0,0 +1,73 @@
+#include "testing/testing.hpp"
+
+#include "generator/cross_mwm_overlay_builder.hpp"
+
+#include "routing/cross_mwm_connector.hpp"
+#include "routing/cross_mwm_overlay.hpp"
+#include "routing/segment.hpp"
+
+#include "base/thread_pool_computational.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace cross_mwm_overlay_builder_tests
+{
+using namespace routing;
+using namespace routing_builder;
+using namespace std;
+
+UNIT_TEST(CrossMwmOverlayCellBuilder_Weights)
+{
+  NumMwmId constexpr kMwm1 = 1;
+  NumMwmId constexpr kMwm2 = 2;
+
+  // Cell enters and exits.
+  Segment const enter1(kMwm1, 1, 0, true);
+  Segment const enter2(kMwm2, 2, 0, true);
+  Segment const exit1(kMwm2, 3, 0, true);
+  Segment const exit2(kMwm2, 4, 1, false);
+  // Transition between the cell mwms: |innerExit| of mwm 1 is |innerEnter| of mwm 2.
+  Segment const innerExit(kMwm1, 5, 0, true);
+  Segment const innerEnter(kMwm2, 5, 0, true);
+
+  CrossMwmOverlayCellBuilder builder({kMwm1, kMwm2}, {210101, 210102});
+  builder.AddCellEnter(enter1);
+  builder.AddCellEnter(enter2);
+  builder.AddCellExit(exit1);
+  builder.AddCellExit(exit2);
+
+  builder.AddLeap(enter1, innerExit, 10);
+  builder.AddTwins(innerExit, innerEnter);
+  builder.AddLeap(innerEnter, exit1, 5);
+  builder.AddLeap(enter2, exit1, 30);
+  builder.AddLeap(enter2, exit2, 7);
+
+  TEST_EQUAL(builder.GetWeightsCount(), 4, ());
+  TEST(!builder.IsTooLarge(), ());
+
+  base::ComputationalThreadPool threadPool(2);
+  auto const cell = std::move(builder).Build(threadPool);
+
+  TEST_EQUAL(cell.m_mwms, vector<NumMwmId>({kMwm1, kMwm2}), ());
+  TEST_EQUAL(cell.m_mwmVersions, vector<uint32_t>({210101, 210102}), ());
+  TEST_EQUAL(cell.m_enters, vector<Segment>({enter1, enter2}), ());
+  TEST_EQUAL(cell.m_exits, vector<Segment>({exit1, exit2}), ());
+  // Rows are enters, columns are exits.
+  TEST_EQUAL(cell.m_weights, vector<connector::Weight>({15, connector::kNoRouteStored, 30, 7}), ());
+}
+
+UNIT_TEST(CrossMwmOverlayCellBuilder_TooLarge)
+{
+  CrossMwmOverlayCellBuilder builder({1}, {210101});
+  uint32_t constexpr kTransitionsCount = 1025;
+  for (uint32_t i = 0; i < kTransitionsCount; ++i)
+  {
+    builder.AddCellEnter(Segment(1, i, 0, true));
+    builder.AddCellExit(Segment(1, i, 0, false));
+  }
+
+  TEST_GREATER(builder.GetWeightsCount(), CrossMwmOverlayCellBuilder::kMaxWeightsCount, ());
+  TEST(builder.IsTooLarge(), ());
+}
+}  // namespace cross_mwm_overlay_builder_tests
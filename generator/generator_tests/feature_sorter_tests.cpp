@@ -0,0 +1,87 @@
+#include "testing/testing.hpp"
+
+#include "generator/generator_tests_support/test_feature.hpp"
+#include "generator/generator_tests_support/test_with_custom_mwms.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "coding/files_container.hpp"
+
+#include "geometry/point2d.hpp"
+#include "geometry/rect2d.hpp"
+
+#include "base/string_utils.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace feature_sorter_tests
+{
+using namespace generator::tests_support;
+using namespace std;
+
+// More features than a batch of the parallel processing has.
+uint32_t constexpr kFeaturesCount = 5000;
+
+void AddFeatures(TestMwmBuilder & builder)
+{
+  for (uint32_t i = 0; i < kFeaturesCount; ++i)
+  {
+    auto const n = strings::to_string(i);
+    double const x = (i % 100) * 0.01;
+    double const y = (i / 100) * 0.01;
+
+    // Wavy lines with many points to be simplified.
+    vector<m2::PointD> points;
+    for (uint32_t j = 0; j < 50; ++j)
+      points.emplace_back(x + j * 0.0002, y + 0.001 * sin(i + j * 0.3));
+    builder.Add(TestStreet(points, "Street " + n, "en"));
+
+    // Areas to be triangulated.
+    builder.Add(TestBuilding(m2::RectD(x, y + 0.002, x + 0.001, y + 0.003), "Building " + n, n,
+                             "Street " + n, "en"));
+  }
+}
+
+UNIT_CLASS_TEST(TestWithCustomMwms, FeatureSorter_ParallelGeometry)
+{
+  string const kName = "FeatureSorterTest";
+
+  // Builds the mwm and reads all its sections.
+  auto const buildMwm = [&](size_t threadsCount)
+  {
+    auto const id = BuildCountry(kName, [threadsCount](TestMwmBuilder & builder)
+    {
+      builder.SetThreadsCount(threadsCount);
+      AddFeatures(builder);
+    });
+
+    map<FilesContainerR::Tag, string> sections;
+    FilesContainerR const cont(id.GetInfo()->GetLocalFile().GetPath(MapFileType::Map));
+    cont.ForEachTag([&](FilesContainerR::Tag const & tag)
+    {
+      cont.GetReader(tag).ReadAsString(sections[tag]);
+    });
+
+    DeregisterMap(kName);
+    return sections;
+  };
+
+  auto const expected = buildMwm(1 /* threadsCount */);
+  auto const actual = buildMwm(4 /* threadsCount */);
+
+  TEST(!expected.empty(), ());
+  TEST_EQUAL(expected.size(), actual.size(), ());
+  for (auto const & [tag, section] : expected)
+  {
+    auto const it = actual.find(tag);
+    TEST(it != actual.end(), (tag));
+    // Don't print the sections on failure.
+    TEST(it->second == section, (tag));
+  }
+}
+}  // namespace feature_sorter_tests
@@ -0,0 +1,56 @@
+#include "testing/testing.hpp"
+
+#include "generator/generator_tests_support/test_feature.hpp"
+#include "generator/generator_tests_support/test_with_custom_mwms.hpp"
+#include "generator/search_index_builder.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "coding/files_container.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/string_utils.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace search_index_builder_tests
+{
+using namespace generator::tests_support;
+using namespace std;
+
+UNIT_CLASS_TEST(TestWithCustomMwms, SearchIndexBuilder_SpilledRuns)
+{
+  auto const id = BuildCountry("SearchIndexSpill", [](TestMwmBuilder & builder)
+  {
+    for (uint32_t i = 0; i < 300; ++i)
+    {
+      auto const n = strings::to_string(i);
+      builder.Add(TestPOI(m2::PointD(i * 0.001, 0), "Cafe " + n, "en"));
+      builder.Add(TestStreet({m2::PointD(i * 0.001, 1), m2::PointD(i * 0.001, 1.001)},
+                             "Street " + n, "en"));
+    }
+  });
+
+  FilesContainerR container(id.GetInfo()->GetLocalFile().GetPath(MapFileType::Map));
+
+  auto const buildIndex = [&container](uint32_t threadsCount, size_t maxPairsInMemory)
+  {
+    vector<uint8_t> buffer;
+    MemWriter<vector<uint8_t>> writer(buffer);
+    indexer::BuildSearchIndex(container, writer, threadsCount, maxPairsInMemory);
+    return buffer;
+  };
+
+  auto const inMemory = buildIndex(1 /* threadsCount */, indexer::kMaxSearchIndexPairsInMemory);
+  TEST(!inMemory.empty(), ());
+
+  // No budget: all the sorted runs are spilled to temporary files and merged from them.
+  TEST_EQUAL(buildIndex(4 /* threadsCount */, 0 /* maxPairsInMemory */), inMemory, ());
+  // Some of the runs are spilled.
+  TEST_EQUAL(buildIndex(4 /* threadsCount */, 500 /* maxPairsInMemory */), inMemory, ());
+}
+}  // namespace search_index_builder_tests
@@ -138,3 +138,26 @@ unsigned char const relation_o5m_data[] = /* 224 */
   0x61, 0x63, 0x65, 0x00, 0x74, 0x6F, 0x77, 0x6E, 0x00, 0x00, 0x74, 0x79, 0x70, 0x65, 0x00,
   0x6D, 0x75, 0x6C, 0x74, 0x69, 0x70, 0x6F, 0x6C, 0x79, 0x67, 0x6F, 0x6E, 0x00, 0xFE};
 static_assert(sizeof(relation_o5m_data) == 224, "Size check failed");
+
+// binary data: relation.osm.pbf, the same entities as in relation_xml_data
+unsigned char const relation_pbf_data[] = /* 285 */
+{0x00, 0x00, 0x00, 0x0D, 0x0A, 0x09, 0x4F, 0x53, 0x4D, 0x48, 0x65, 0x61, 0x64, 0x65, 0x72,
+  0x18, 0x25, 0x0A, 0x23, 0x22, 0x0E, 0x4F, 0x73, 0x6D, 0x53, 0x63, 0x68, 0x65, 0x6D, 0x61,
+  0x2D, 0x56, 0x30, 0x2E, 0x36, 0x22, 0x0A, 0x44, 0x65, 0x6E, 0x73, 0x65, 0x4E, 0x6F, 0x64,
+  0x65, 0x73, 0x82, 0x01, 0x04, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 0x00, 0x0C, 0x0A, 0x07,
+  0x4F, 0x53, 0x4D, 0x44, 0x61, 0x74, 0x61, 0x18, 0xD7, 0x01, 0x10, 0xDD, 0x01, 0x1A, 0xD1,
+  0x01, 0x78, 0x9C, 0xE3, 0xB2, 0xE1, 0x62, 0xE0, 0x62, 0xC9, 0x4B, 0xCC, 0x4D, 0xE5, 0xE2,
+  0x0A, 0xCF, 0xC8, 0x2C, 0x49, 0xCD, 0xC8, 0x2F, 0x2A, 0x4E, 0xE5, 0x62, 0x2D, 0xC8, 0x49,
+  0x4C, 0x4E, 0xE5, 0x62, 0x29, 0xC9, 0x2F, 0xCF, 0xE3, 0x62, 0xCD, 0x2F, 0x2D, 0x49, 0x2D,
+  0x02, 0x72, 0x2A, 0x0B, 0x52, 0xB9, 0x78, 0x72, 0x4B, 0x73, 0x4A, 0x32, 0x0B, 0xF2, 0x73,
+  0x2A, 0xD3, 0xF3, 0xF3, 0x84, 0xA2, 0x84, 0x22, 0xB8, 0xB8, 0xAF, 0xAF, 0x51, 0xD4, 0x61,
+  0x01, 0x03, 0x26, 0x27, 0xE9, 0x65, 0xE7, 0x3A, 0x0E, 0xB3, 0xDC, 0xCC, 0xF8, 0xFE, 0x4D,
+  0xF4, 0xF7, 0x19, 0xC1, 0x7F, 0xB3, 0x98, 0x0E, 0x2D, 0xE7, 0xBF, 0x70, 0x58, 0xF2, 0xC1,
+  0x5D, 0xB1, 0xB9, 0x9E, 0x5E, 0xB2, 0xEB, 0xCF, 0xFF, 0x69, 0xE7, 0x9A, 0x33, 0x41, 0xE5,
+  0xCE, 0x59, 0xB9, 0xFE, 0xCB, 0x5A, 0xCF, 0xA7, 0x26, 0x4C, 0xBF, 0x27, 0xBC, 0x65, 0x9E,
+  0xC8, 0x8A, 0x7E, 0xA5, 0x65, 0xDF, 0x24, 0x83, 0x78, 0x19, 0x99, 0x98, 0x59, 0x18, 0x60,
+  0x40, 0x48, 0x4A, 0x4A, 0x82, 0xE3, 0xEB, 0xCA, 0xF7, 0xFF, 0xC1, 0x80, 0xD1, 0x89, 0x7B,
+  0xE2, 0x1A, 0x45, 0x46, 0x66, 0x30, 0x90, 0x12, 0x52, 0x55, 0x52, 0xE6, 0x78, 0x0E, 0x97,
+  0x13, 0x62, 0x66, 0x64, 0x66, 0x93, 0x62, 0x66, 0x62, 0x61, 0x77, 0x62, 0x62, 0x65, 0xF0,
+  0x62, 0x99, 0xBA, 0x46, 0xD1, 0x31, 0x88, 0x89, 0x91, 0x01, 0x00, 0x92, 0x65, 0x4C, 0xF0};
+static_assert(sizeof(relation_pbf_data) == 285, "Size check failed");
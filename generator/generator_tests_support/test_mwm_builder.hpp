@@ -7,6 +7,7 @@
 
 #include "base/timer.hpp"
 
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
@@ -47,6 +48,8 @@ public:
                         std::shared_ptr<storage::CountryInfoGetter> const & countryInfoGetter);
 
   void SetMwmLanguages(std::vector<std::string> const & languages);
+  /// Threads count for features' geometry processing, see feature::GenerateFinalFeatures().
+  void SetThreadsCount(size_t threadsCount) { m_threadsCount = threadsCount; }
 
   void Finish();
 
@@ -62,6 +65,7 @@ private:
   indexer::PostcodePointsDatasetType m_postcodesType;
 
   uint32_t m_version = 0;
+  size_t m_threadsCount = 1;
 };
 }  // namespace tests_support
 }  // namespace generator
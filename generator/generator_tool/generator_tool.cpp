@@ -21,6 +21,7 @@
 #include "generator/raw_generator.hpp"
 #include "generator/restriction_generator.hpp"
 #include "generator/road_access_generator.hpp"
+#include "generator/routing_geometry_generator.hpp"
 #include "generator/routing_index_generator.hpp"
 #include "generator/routing_world_roads_generator.hpp"
 #include "generator/search_index_builder.hpp"
@@ -74,7 +75,7 @@ DEFINE_bool(emit_coasts, false,
 
 // Generator settings and paths.
 DEFINE_string(osm_file_name, "", "Input osm area file.");
-DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m].");
+DEFINE_string(osm_file_type, "xml", "Input osm area file type [xml, o5m, pbf].");
 DEFINE_string(data_path, "", GetDataPathHelp());
 DEFINE_string(user_resource_path, "", "User defined resource path for classificator.txt and etc.");
 DEFINE_string(intermediate_data_path, "", "Path to stored intermediate data.");
@@ -117,6 +118,10 @@ DEFINE_string(addresses_path, "", "Path to addresses directory. If set, adds add
 DEFINE_bool(make_routing_index, false, "Make sections with the routing information.");
 DEFINE_bool(make_cross_mwm, false,
             "Make section for cross mwm routing (for dynamic indexed routing).");
+DEFINE_string(cross_mwm_overlay_path, "",
+              "Path to directory with country mwms. If set, generates a section in World.mwm for "
+              "cross mwm routing over the whole countries. Cross mwm sections should be built for "
+              "all the mwms in the directory before.");
 DEFINE_bool(make_transit_cross_mwm, false, "Make section for cross mwm transit routing.");
 DEFINE_bool(make_transit_cross_mwm_experimental, false,
             "Experimental parameter. If set the new version of transit cross-mwm section will be "
@@ -137,6 +142,9 @@ DEFINE_bool(
     make_city_roads, false,
     "Calculates which roads lie inside cities and makes a section with ids of these roads.");
 DEFINE_bool(generate_maxspeed, false, "Generate section with maxspeed of road features.");
+DEFINE_bool(make_routing_geometry, false,
+            "Make section with points and vehicle attributes of roads, so routing doesn't decode "
+            "features. Needs make_routing_index.");
 
 // Sponsored-related.
 DEFINE_string(complex_hierarchy_data, "", "Path to complex hierarchy in csv format.");
@@ -264,7 +272,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
   if (FLAGS_preprocess)
   {
     LOG(LINFO, ("Generating intermediate data ...."));
-    if (!GenerateIntermediateData(genInfo))
+    if (!GenerateIntermediateData(genInfo, threadsCount))
       return EXIT_FAILURE;
   }
 
@@ -296,7 +304,8 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
 
   // Load mwm tree only if we need it
   std::unique_ptr<storage::CountryParentGetter> countryParentGetter;
-  if (FLAGS_make_routing_index || FLAGS_make_cross_mwm || FLAGS_make_transit_cross_mwm ||
+  if (FLAGS_make_routing_index || FLAGS_make_cross_mwm || !FLAGS_cross_mwm_overlay_path.empty() ||
+      FLAGS_make_transit_cross_mwm ||
       FLAGS_make_transit_cross_mwm_experimental || !FLAGS_uk_postcodes_dataset.empty() ||
       !FLAGS_us_postcodes_dataset.empty())
   {
@@ -339,7 +348,7 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       // On error move to the next bucket without index generation.
 
       LOG(LINFO, ("Generating result features for", country));
-      if (!feature::GenerateFinalFeatures(genInfo, country, mapType))
+      if (!feature::GenerateFinalFeatures(genInfo, country, mapType, threadsCount))
         continue;
 
       LOG(LINFO, ("Generating offsets table for", dataFile));
@@ -504,6 +513,10 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
         LOG(LINFO, ("Generating maxspeeds section for", dataFile, "using", maxspeedsFilename));
         BuildMaxspeedsSection(routingGraph.get(), dataFile, osmToFeatureFilename, maxspeedsFilename);
       }
+
+      // Should be built after city roads and maxspeeds, they are used for roads' speeds.
+      if (FLAGS_make_routing_geometry && !BuildRoutingGeometry(dataFile, country, *countryParentGetter))
+        LOG(LERROR, ("Generating", ROUTING_GEOMETRY_FILE_TAG, "section has failed for", dataFile));
     }
 
     if (FLAGS_make_cross_mwm || FLAGS_make_transit_cross_mwm || FLAGS_make_transit_cross_mwm_experimental)
@@ -540,6 +553,20 @@ MAIN_WITH_ERROR_HANDLING([](int argc, char ** argv)
       }
     }
 
+    if (country == WORLD_FILE_NAME && !FLAGS_cross_mwm_overlay_path.empty())
+    {
+      if (!countryParentGetter)
+      {
+        LOG(LCRITICAL,
+            ("Countries file is needed. Please set countries file name (countries.txt). "
+             "File must be located in data directory."));
+        return EXIT_FAILURE;
+      }
+
+      BuildCrossMwmOverlaySection(FLAGS_cross_mwm_overlay_path, dataFile, *countryParentGetter,
+                                  threadsCount);
+    }
+
     // Check !generate_popular_places to avoid mixing, generate_popular_places stage uses the same wiki flags.
     if (!FLAGS_generate_popular_places && !FLAGS_wikipedia_pages.empty())
     {
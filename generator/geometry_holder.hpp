@@ -33,7 +33,7 @@ double constexpr kGeomMinFactor = 1.5f;
 class GeometryHolder
 {
 public:
-  using FileGetter = std::function<FileWriter &(int i)>;
+  using FileGetter = std::function<Writer &(int i)>;
   using Points = std::vector<m2::PointD>;
   using Polygons = std::list<Points>;
 
@@ -0,0 +1,398 @@
+#include "generator/osm_pbf_source.hpp"
+
+#include "coding/zlib.hpp"
+
+#include "base/assert.hpp"
+#include "base/stl_helpers.hpp"
+
+#include <iterator>
+
+namespace osm
+{
+namespace
+{
+// Limits from the format specification.
+uint32_t constexpr kMaxBlobHeaderSize = 64 * 1024;
+uint32_t constexpr kMaxBlobSize = 32 * 1024 * 1024;
+
+double constexpr kCoordUnit = 1e-9;
+
+bool ReadExactly(PbfReadFunc const & reader, uint8_t * buffer, size_t size)
+{
+  size_t done = 0;
+  while (done < size)
+  {
+    size_t const read = reader(buffer + done, size - done);
+    if (read == 0)
+      break;
+    done += read;
+  }
+  CHECK(done == 0 || done == size, ("Unexpected end of PBF input."));
+  return done == size;
+}
+
+struct BlockContext
+{
+  std::vector<std::string_view> m_strings;
+  int64_t m_granularity = 100;
+  int64_t m_latOffset = 0;
+  int64_t m_lonOffset = 0;
+
+  std::string_view String(uint64_t index) const
+  {
+    CHECK_LESS(index, m_strings.size(), ("Malformed PBF string index."));
+    return m_strings[index];
+  }
+
+  double Lat(int64_t lat) const { return kCoordUnit * (m_latOffset + m_granularity * lat); }
+  double Lon(int64_t lon) const { return kCoordUnit * (m_lonOffset + m_granularity * lon); }
+};
+
+OsmElement::EntityType MemberType(uint64_t type)
+{
+  switch (type)
+  {
+  case 0: return OsmElement::EntityType::Node;
+  case 1: return OsmElement::EntityType::Way;
+  case 2: return OsmElement::EntityType::Relation;
+  default: return OsmElement::EntityType::Unknown;
+  }
+}
+
+// Reads id (1), keys (2), vals (3) and the fields that are specific for each entity. Common part of
+// Node, Way and Relation messages. Note that Node.id is sint64 while Way.id and Relation.id are int64.
+template <typename Fn>
+void ReadEntity(ProtobufReader msg, BlockContext const & ctx, OsmElement & element, Fn && readField)
+{
+  bool const isNode = element.m_type == OsmElement::EntityType::Node;
+  std::vector<uint64_t> keys;
+  std::vector<uint64_t> vals;
+  while (msg.Next())
+  {
+    switch (msg.Field())
+    {
+    case 1: element.m_id = isNode ? static_cast<uint64_t>(msg.ReadSVarint()) : msg.ReadVarint(); break;
+    case 2: msg.ForEachPackedVarint([&](uint64_t k) { keys.push_back(k); }); break;
+    case 3: msg.ForEachPackedVarint([&](uint64_t v) { vals.push_back(v); }); break;
+    default:
+      if (!readField(msg))
+        msg.Skip();
+    }
+  }
+
+  CHECK_EQUAL(keys.size(), vals.size(), ("Malformed PBF tags of", element.m_id));
+  for (size_t i = 0; i < keys.size(); ++i)
+    element.AddTag(ctx.String(keys[i]), ctx.String(vals[i]));
+}
+
+void ReadNode(ProtobufReader msg, BlockContext const & ctx, std::vector<OsmElement> & elements)
+{
+  auto & element = elements.emplace_back();
+  element.m_type = OsmElement::EntityType::Node;
+  ReadEntity(msg, ctx, element, [&](ProtobufReader & r)
+  {
+    if (r.Field() == 8)
+      element.m_lat = ctx.Lat(r.ReadSVarint());
+    else if (r.Field() == 9)
+      element.m_lon = ctx.Lon(r.ReadSVarint());
+    else
+      return false;
+    return true;
+  });
+  element.Validate();
+}
+
+void ReadDenseNodes(ProtobufReader msg, BlockContext const & ctx, std::vector<OsmElement> & elements)
+{
+  std::vector<int64_t> ids, lats, lons;
+  std::vector<uint64_t> keysVals;
+  while (msg.Next())
+  {
+    switch (msg.Field())
+    {
+    case 1: msg.ForEachPackedSVarint([&](int64_t v) { ids.push_back(v); }); break;
+    case 8: msg.ForEachPackedSVarint([&](int64_t v) { lats.push_back(v); }); break;
+    case 9: msg.ForEachPackedSVarint([&](int64_t v) { lons.push_back(v); }); break;
+    case 10: msg.ForEachPackedVarint([&](uint64_t v) { keysVals.push_back(v); }); break;
+    default: msg.Skip();
+    }
+  }
+
+  CHECK(ids.size() == lats.size() && ids.size() == lons.size(), ("Malformed PBF dense nodes."));
+
+  int64_t id = 0, lat = 0, lon = 0;
+  size_t kv = 0;
+  for (size_t i = 0; i < ids.size(); ++i)
+  {
+    id += ids[i];
+    lat += lats[i];
+    lon += lons[i];
+
+    auto & element = elements.emplace_back();
+    element.m_type = OsmElement::EntityType::Node;
+    element.m_id = static_cast<uint64_t>(id);
+    element.m_lat = ctx.Lat(lat);
+    element.m_lon = ctx.Lon(lon);
+
+    // keys_vals is either empty or contains ((<key> <val>)* 0) for each node.
+    while (kv < keysVals.size() && keysVals[kv] != 0)
+    {
+      CHECK_LESS(kv + 1, keysVals.size(), ("Malformed PBF dense tags of", id));
+      element.AddTag(ctx.String(keysVals[kv]), ctx.String(keysVals[kv + 1]));
+      kv += 2;
+    }
+    ++kv;
+
+    element.Validate();
+  }
+}
+
+void ReadWay(ProtobufReader msg, BlockContext const & ctx, std::vector<OsmElement> & elements)
+{
+  auto & element = elements.emplace_back();
+  element.m_type = OsmElement::EntityType::Way;
+  ReadEntity(msg, ctx, element, [&](ProtobufReader & r)
+  {
+    if (r.Field() != 8)
+      return false;
+
+    int64_t ref = 0;
+    r.ForEachPackedSVarint([&](int64_t delta)
+    {
+      ref += delta;
+      element.AddNd(static_cast<uint64_t>(ref));
+    });
+    return true;
+  });
+  element.Validate();
+}
+
+void ReadRelation(ProtobufReader msg, BlockContext const & ctx, std::vector<OsmElement> & elements)
+{
+  auto & element = elements.emplace_back();
+  element.m_type = OsmElement::EntityType::Relation;
+
+  std::vector<uint64_t> roles, types;
+  std::vector<int64_t> ids;
+  ReadEntity(msg, ctx, element, [&](ProtobufReader & r)
+  {
+    switch (r.Field())
+    {
+    case 8: r.ForEachPackedVarint([&](uint64_t v) { roles.push_back(v); }); return true;
+    case 9: r.ForEachPackedSVarint([&](int64_t v) { ids.push_back(v); }); return true;
+    case 10: r.ForEachPackedVarint([&](uint64_t v) { types.push_back(v); }); return true;
+    default: return false;
+    }
+  });
+
+  CHECK(ids.size() == roles.size() && ids.size() == types.size(),
+        ("Malformed PBF members of", element.m_id));
+
+  int64_t ref = 0;
+  for (size_t i = 0; i < ids.size(); ++i)
+  {
+    ref += ids[i];
+    element.AddMember(static_cast<uint64_t>(ref), MemberType(types[i]), std::string(ctx.String(roles[i])));
+  }
+  element.Validate();
+}
+}  // namespace
+
+// ProtobufReader ----------------------------------------------------------------------------------
+bool ProtobufReader::Next()
+{
+  if (Empty())
+    return false;
+
+  uint64_t const key = ReadVarint();
+  m_field = static_cast<uint32_t>(key >> 3);
+  m_type = static_cast<WireType>(key & 0x7);
+  return true;
+}
+
+uint64_t ProtobufReader::ReadVarint()
+{
+  uint64_t res = 0;
+  for (uint32_t shift = 0; shift < 64; shift += 7)
+  {
+    CHECK(m_pos != m_end, ("Malformed PBF varint."));
+    uint8_t const byte = *m_pos++;
+    res |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return res;
+  }
+  CHECK(false, ("Too long PBF varint."));
+  return res;
+}
+
+int64_t ProtobufReader::ReadSVarint()
+{
+  uint64_t const v = ReadVarint();
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+std::string_view ProtobufReader::ReadBytes()
+{
+  CHECK(m_type == WireType::LengthDelimited, ("Unexpected PBF wire type", base::Underlying(m_type)));
+  uint64_t const size = ReadVarint();
+  CHECK_LESS_OR_EQUAL(size, static_cast<uint64_t>(m_end - m_pos), ("Malformed PBF message."));
+  std::string_view const res(reinterpret_cast<char const *>(m_pos), size);
+  m_pos += size;
+  return res;
+}
+
+void ProtobufReader::Skip()
+{
+  switch (m_type)
+  {
+  case WireType::Varint: ReadVarint(); return;
+  case WireType::LengthDelimited: ReadBytes(); return;
+  case WireType::Fixed64:
+  case WireType::Fixed32:
+  {
+    size_t const size = m_type == WireType::Fixed64 ? 8 : 4;
+    CHECK_LESS_OR_EQUAL(size, static_cast<size_t>(m_end - m_pos), ("Malformed PBF message."));
+    m_pos += size;
+    return;
+  }
+  }
+  CHECK(false, ("Unsupported PBF wire type", base::Underlying(m_type)));
+}
+
+// Functions ---------------------------------------------------------------------------------------
+bool ReadPbfBlob(PbfReadFunc const & reader, PbfBlob & blob)
+{
+  uint8_t sizeBuffer[4];
+  if (!ReadExactly(reader, sizeBuffer, sizeof(sizeBuffer)))
+    return false;
+
+  // Header size is stored in network byte order.
+  uint32_t const headerSize = (uint32_t(sizeBuffer[0]) << 24) | (uint32_t(sizeBuffer[1]) << 16) |
+                              (uint32_t(sizeBuffer[2]) << 8) | uint32_t(sizeBuffer[3]);
+  CHECK_LESS_OR_EQUAL(headerSize, kMaxBlobHeaderSize, ("Too big PBF blob header."));
+
+  std::vector<uint8_t> buffer(headerSize);
+  CHECK(ReadExactly(reader, buffer.data(), buffer.size()), ("Unexpected end of PBF input."));
+
+  blob.m_type.clear();
+  uint64_t dataSize = 0;
+  ProtobufReader header(buffer.data(), buffer.data() + buffer.size());
+  while (header.Next())
+  {
+    if (header.Field() == 1)
+      blob.m_type = header.ReadBytes();
+    else if (header.Field() == 3)
+      dataSize = header.ReadVarint();
+    else
+      header.Skip();
+  }
+  CHECK_LESS_OR_EQUAL(dataSize, kMaxBlobSize, ("Too big PBF blob."));
+
+  buffer.resize(dataSize);
+  CHECK(ReadExactly(reader, buffer.data(), buffer.size()), ("Unexpected end of PBF input."));
+
+  blob.m_data.clear();
+  blob.m_rawSize = 0;
+  blob.m_isCompressed = false;
+  ProtobufReader msg(buffer.data(), buffer.data() + buffer.size());
+  while (msg.Next())
+  {
+    switch (msg.Field())
+    {
+    case 1:
+    case 3:
+    {
+      auto const data = msg.ReadBytes();
+      blob.m_data.assign(data.begin(), data.end());
+      blob.m_isCompressed = msg.Field() == 3;
+      break;
+    }
+    case 2: blob.m_rawSize = static_cast<uint32_t>(msg.ReadVarint()); break;
+    case 4:
+    case 5:
+    case 6:
+    case 7: CHECK(false, ("Unsupported PBF blob compression, field", msg.Field())); break;
+    default: msg.Skip();
+    }
+  }
+  return true;
+}
+
+std::vector<uint8_t> UnpackPbfBlob(PbfBlob const & blob)
+{
+  if (!blob.m_isCompressed)
+    return blob.m_data;
+
+  std::vector<uint8_t> res;
+  res.reserve(blob.m_rawSize);
+  coding::ZLib::Inflate const inflate(coding::ZLib::Inflate::Format::ZLib);
+  CHECK(inflate(blob.m_data.data(), blob.m_data.size(), std::back_inserter(res)),
+        ("Can't inflate PBF blob."));
+  CHECK(blob.m_rawSize == 0 || res.size() == blob.m_rawSize, ("Wrong PBF blob size."));
+  return res;
+}
+
+void CheckPbfHeaderBlock(std::vector<uint8_t> const & data)
+{
+  ProtobufReader msg(data.data(), data.data() + data.size());
+  while (msg.Next())
+  {
+    // required_features
+    if (msg.Field() != 4)
+    {
+      msg.Skip();
+      continue;
+    }
+
+    auto const feature = msg.ReadBytes();
+    CHECK(feature == "OsmSchema-V0.6" || feature == "DenseNodes",
+          ("Unsupported PBF required feature:", feature));
+  }
+}
+
+void DecodePbfPrimitiveBlock(std::vector<uint8_t> const & data, std::vector<OsmElement> & elements)
+{
+  BlockContext ctx;
+  std::vector<ProtobufReader> groups;
+
+  ProtobufReader block(data.data(), data.data() + data.size());
+  while (block.Next())
+  {
+    switch (block.Field())
+    {
+    case 1:
+    {
+      auto table = block.ReadMessage();
+      while (table.Next())
+      {
+        if (table.Field() == 1)
+          ctx.m_strings.push_back(table.ReadBytes());
+        else
+          table.Skip();
+      }
+      break;
+    }
+    case 2: groups.push_back(block.ReadMessage()); break;
+    case 17: ctx.m_granularity = static_cast<int64_t>(block.ReadVarint()); break;
+    case 19: ctx.m_latOffset = static_cast<int64_t>(block.ReadVarint()); break;
+    case 20: ctx.m_lonOffset = static_cast<int64_t>(block.ReadVarint()); break;
+    default: block.Skip();
+    }
+  }
+
+  for (auto & group : groups)
+  {
+    while (group.Next())
+    {
+      switch (group.Field())
+      {
+      case 1: ReadNode(group.ReadMessage(), ctx, elements); break;
+      case 2: ReadDenseNodes(group.ReadMessage(), ctx, elements); break;
+      case 3: ReadWay(group.ReadMessage(), ctx, elements); break;
+      case 4: ReadRelation(group.ReadMessage(), ctx, elements); break;
+      default: group.Skip();
+      }
+    }
+  }
+}
+}  // namespace osm
@@ -0,0 +1,99 @@
+// See PBF Format definition at https://wiki.openstreetmap.org/wiki/PBF_Format
+#pragma once
+
+#include "generator/osm_element.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace osm
+{
+using PbfReadFunc = std::function<size_t(uint8_t *, size_t)>;
+
+// Minimal protobuf wire format decoder. It is enough to walk fileformat.proto and osmformat.proto
+// messages without the generated protobuf code. Malformed input is reported with CHECKs.
+class ProtobufReader
+{
+public:
+  enum class WireType : uint8_t
+  {
+    Varint = 0,
+    Fixed64 = 1,
+    LengthDelimited = 2,
+    Fixed32 = 5
+  };
+
+  ProtobufReader() = default;
+  ProtobufReader(uint8_t const * begin, uint8_t const * end) : m_pos(begin), m_end(end) {}
+  explicit ProtobufReader(std::string_view data)
+    : ProtobufReader(reinterpret_cast<uint8_t const *>(data.data()),
+                     reinterpret_cast<uint8_t const *>(data.data()) + data.size())
+  {
+  }
+
+  // Reads the key of the next field. Returns false when the message is over.
+  bool Next();
+
+  uint32_t Field() const { return m_field; }
+  WireType Type() const { return m_type; }
+
+  uint64_t ReadVarint();
+  int64_t ReadSVarint();
+  std::string_view ReadBytes();
+  ProtobufReader ReadMessage() { return ProtobufReader(ReadBytes()); }
+  void Skip();
+
+  // Calls |fn| for every value of a packed repeated varint field.
+  template <typename Fn>
+  void ForEachPackedVarint(Fn && fn)
+  {
+    auto packed = ReadMessage();
+    while (!packed.Empty())
+      fn(packed.ReadVarint());
+  }
+
+  template <typename Fn>
+  void ForEachPackedSVarint(Fn && fn)
+  {
+    auto packed = ReadMessage();
+    while (!packed.Empty())
+      fn(packed.ReadSVarint());
+  }
+
+  bool Empty() const { return m_pos == m_end; }
+
+private:
+  uint8_t const * m_pos = nullptr;
+  uint8_t const * m_end = nullptr;
+  uint32_t m_field = 0;
+  WireType m_type = WireType::Varint;
+};
+
+// One BlobHeader + Blob pair of a .osm.pbf file as it is stored in the file.
+struct PbfBlob
+{
+  std::string m_type;
+  std::vector<uint8_t> m_data;
+  uint32_t m_rawSize = 0;
+  bool m_isCompressed = false;
+};
+
+// Reads the next blob from |reader|. Returns false at the end of input.
+// Reading is cheap, so it is done on the caller's thread, while unpacking and decoding
+// (UnpackPbfBlob, DecodePbfPrimitiveBlock) have no shared state and may run on any thread.
+bool ReadPbfBlob(PbfReadFunc const & reader, PbfBlob & blob);
+
+// Returns the uncompressed blob content (inflates zlib_data if needed).
+std::vector<uint8_t> UnpackPbfBlob(PbfBlob const & blob);
+
+// Checks that all the required features of the OSMHeader block are supported.
+void CheckPbfHeaderBlock(std::vector<uint8_t> const & data);
+
+// Decodes an OSMData PrimitiveBlock and appends its nodes, ways and relations to |elements|
+// in the file order.
+void DecodePbfPrimitiveBlock(std::vector<uint8_t> const & data, std::vector<OsmElement> & elements);
+}  // namespace osm
@@ -124,6 +124,19 @@ void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void(OsmElem
   }
 }
 
+void ProcessOsmElementsFromPbf(SourceReader & stream, std::function<void(OsmElement &&)> const & processor,
+                               size_t threadsCount)
+{
+  ProcessorOsmElementsFromPbf processorOsmElementsFromPbf(stream, threadsCount);
+  OsmElement element;
+  while (processorOsmElementsFromPbf.TryRead(element))
+  {
+    processor(std::move(element));
+    // It is safe to use `element` here as `Clear` will restore the state after the move.
+    element.Clear();
+  }
+}
+
 ProcessorOsmElementsFromO5M::ProcessorOsmElementsFromO5M(SourceReader & stream)
   : m_stream(stream)
   , m_dataset([&](uint8_t * buffer, size_t size) {
@@ -222,11 +235,69 @@ bool ProcessorOsmElementsFromXml::TryRead(OsmElement & element)
   return TryReadFromQueue(element);
 }
 
+ProcessorOsmElementsFromPbf::ProcessorOsmElementsFromPbf(SourceReader & stream, size_t threadsCount)
+  : m_stream(stream)
+  , m_threadPool(threadsCount)
+  // Keep enough decoded blocks ahead to hide the latency of the slowest one.
+  , m_maxBlocksInFlight(2 * threadsCount)
+{
+}
+
+void ProcessorOsmElementsFromPbf::SubmitBlocks()
+{
+  auto const reader = [this](uint8_t * buffer, size_t size)
+  {
+    return m_stream.Read(reinterpret_cast<char *>(buffer), size);
+  };
+
+  osm::PbfBlob blob;
+  while (!m_isEnd && m_blocks.size() < m_maxBlocksInFlight)
+  {
+    if (!osm::ReadPbfBlob(reader, blob))
+    {
+      m_isEnd = true;
+      break;
+    }
+
+    if (blob.m_type == "OSMHeader")
+    {
+      osm::CheckPbfHeaderBlock(osm::UnpackPbfBlob(blob));
+    }
+    else if (blob.m_type == "OSMData")
+    {
+      m_blocks.push(m_threadPool.Submit([blob = std::move(blob)]()
+      {
+        std::vector<OsmElement> elements;
+        osm::DecodePbfPrimitiveBlock(osm::UnpackPbfBlob(blob), elements);
+        return elements;
+      }));
+    }
+    // Unknown blob types should be skipped according to the format specification.
+  }
+}
+
+bool ProcessorOsmElementsFromPbf::TryRead(OsmElement & element)
+{
+  while (m_elementIdx == m_elements.size())
+  {
+    SubmitBlocks();
+    if (m_blocks.empty())
+      return false;
+
+    m_elements = m_blocks.front().get();
+    m_blocks.pop();
+    m_elementIdx = 0;
+  }
+
+  element = std::move(m_elements[m_elementIdx++]);
+  return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Generate functions implementations.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-bool GenerateIntermediateData(feature::GenerateInfo & info)
+bool GenerateIntermediateData(feature::GenerateInfo & info, size_t threadsCount)
 {
   auto nodes =
       cache::CreatePointStorageWriter(info.m_nodeStorageType, info.GetCacheFileName(NODES_FILE));
@@ -250,6 +321,9 @@ bool GenerateIntermediateData(feature::GenerateInfo & info)
   case feature::GenerateInfo::OsmSourceType::O5M:
     ProcessOsmElementsFromO5M(reader, processor);
     break;
+  case feature::GenerateInfo::OsmSourceType::PBF:
+    ProcessOsmElementsFromPbf(reader, processor, threadsCount);
+    break;
   }
 
   cache.SaveIndex();
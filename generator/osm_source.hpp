@@ -3,12 +3,16 @@
 #include "generator/generate_info.hpp"
 #include "generator/intermediate_data.hpp"
 #include "generator/osm_o5m_source.hpp"
+#include "generator/osm_pbf_source.hpp"
 #include "generator/osm_xml_source.hpp"
 #include "generator/translator_interface.hpp"
 
 #include "coding/parse_xml.hpp"
 
+#include "base/thread_pool_computational.hpp"
+
 #include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <queue>
@@ -45,10 +49,12 @@ public:
   uint64_t Pos() const { return m_pos; }
 };
 
-bool GenerateIntermediateData(feature::GenerateInfo & info);
+bool GenerateIntermediateData(feature::GenerateInfo & info, size_t threadsCount = 1);
 
 void ProcessOsmElementsFromO5M(SourceReader & stream, std::function<void (OsmElement &&)> const & processor);
 void ProcessOsmElementsFromXML(SourceReader & stream, std::function<void (OsmElement &&)> const & processor);
+void ProcessOsmElementsFromPbf(SourceReader & stream, std::function<void (OsmElement &&)> const & processor,
+                               size_t threadsCount = 1);
 
 class ProcessorOsmElementsInterface
 {
@@ -87,4 +93,27 @@ private:
   XMLSequenceParser<SourceReader, XMLSource> m_parser;
   std::queue<OsmElement> m_queue;
 };
+
+// Blobs are read sequentially from the stream, then inflated and decoded on |threadsCount| worker
+// threads. Elements are returned in the file order.
+class ProcessorOsmElementsFromPbf : public ProcessorOsmElementsInterface
+{
+public:
+  ProcessorOsmElementsFromPbf(SourceReader & stream, size_t threadsCount);
+
+  // ProcessorOsmElementsInterface overrides:
+  bool TryRead(OsmElement & element) override;
+
+private:
+  // Reads blobs from the stream until |m_maxBlocksInFlight| blocks are being decoded.
+  void SubmitBlocks();
+
+  SourceReader & m_stream;
+  base::ComputationalThreadPool m_threadPool;
+  size_t const m_maxBlocksInFlight;
+  std::queue<std::future<std::vector<OsmElement>>> m_blocks;
+  std::vector<OsmElement> m_elements;
+  size_t m_elementIdx = 0;
+  bool m_isEnd = false;
+};
 }  // namespace generator
@@ -0,0 +1,110 @@
+#include "generator/routing_geometry_generator.hpp"
+
+#include "routing/geometry.hpp"
+#include "routing/routing_geometry_serialization.hpp"
+#include "routing/vehicle_mask.hpp"
+
+#include "routing_common/bicycle_model.hpp"
+#include "routing_common/car_model.hpp"
+#include "routing_common/pedestrian_model.hpp"
+
+#include "indexer/data_header.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/feature_data.hpp"
+#include "indexer/feature_processor.hpp"
+
+#include "coding/files_container.hpp"
+
+#include "base/logging.hpp"
+
+#include <array>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "defines.hpp"
+
+namespace routing_builder
+{
+using namespace routing;
+using std::string, std::vector;
+
+bool BuildRoutingGeometry(string const & mwmPath, string const & country,
+                          CountryParentNameGetterFn const & countryParentNameGetterFn)
+{
+  LOG(LINFO, ("Building", ROUTING_GEOMETRY_FILE_TAG, "section for", mwmPath));
+
+  try
+  {
+    std::array<std::pair<VehicleType, GeometryLoader::VehicleModelPtrT>, 3> const models = {{
+        {VehicleType::Pedestrian,
+         PedestrianModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country)},
+        {VehicleType::Bicycle, BicycleModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country)},
+        {VehicleType::Car, CarModelFactory(countryParentNameGetterFn).GetVehicleModelForCountry(country)},
+    }};
+
+    // The same loaders as routing uses without the section, so attributes (speeds from maxspeeds,
+    // in city flags from city_roads, ferry durations) are calculated in exactly the same way.
+    vector<std::unique_ptr<GeometryLoader>> loaders;
+    for (auto const & [vehicleType, model] : models)
+      loaders.push_back(GeometryLoader::CreateFromFile(mwmPath, model));
+
+    auto const coordBits =
+        static_cast<uint8_t>(feature::DataHeader(mwmPath).GetDefGeometryCodingParams().GetCoordBits());
+    RoutingGeometryBuilder builder(coordBits);
+    for (auto const & [vehicleType, model] : models)
+      builder.SetModelHash(vehicleType, model->GetHash());
+
+    size_t roadsCount = 0;
+    vector<m2::PointD> points;
+    feature::ForEachFeature(mwmPath, [&](FeatureType & ft, uint32_t featureId)
+    {
+      if (ft.GetGeomType() != feature::GeomType::Line)
+        return;
+
+      feature::TypesHolder const types(ft);
+      bool hasPoints = false;
+      for (size_t i = 0; i < models.size(); ++i)
+      {
+        if (!models[i].second->IsRoad(types))
+          continue;
+
+        if (!hasPoints)
+        {
+          ft.ParseGeometry(FeatureType::BEST_GEOMETRY);
+          size_t const count = ft.GetPointsCount();
+          if (count < 2)
+            return;
+
+          points.clear();
+          points.reserve(count);
+          for (size_t j = 0; j < count; ++j)
+            points.push_back(ft.GetPoint(j));
+
+          builder.PutPoints(featureId, points);
+          hasPoints = true;
+          ++roadsCount;
+        }
+
+        RoadGeometry road;
+        loaders[i]->Load(featureId, road);
+        CHECK(road.IsValid(), (featureId));
+        builder.PutAttrs(models[i].first, featureId, road.GetAttrs());
+      }
+    });
+
+    FilesContainerW cont(mwmPath, FileWriter::OP_WRITE_EXISTING);
+    auto writer = cont.GetWriter(ROUTING_GEOMETRY_FILE_TAG);
+    builder.Freeze(*writer);
+
+    LOG(LINFO, (ROUTING_GEOMETRY_FILE_TAG, "section is built for", roadsCount, "roads in", mwmPath));
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LERROR, ("Error while building", ROUTING_GEOMETRY_FILE_TAG, "section in", mwmPath, ". Message:",
+                 e.Msg()));
+    return false;
+  }
+  return true;
+}
+}  // namespace routing_builder
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace routing_builder
+{
+using CountryParentNameGetterFn = std::function<std::string(std::string const &)>;
+
+/// \brief Builds ROUTING_GEOMETRY_FILE_TAG section with points and vehicle dependent attributes
+/// of road features, so routing may load RoadGeometry without FeatureType decoding.
+/// \note Before a call of this method city_roads and maxspeeds sections should be built,
+/// because speeds and in city flags are precalculated in the section.
+bool BuildRoutingGeometry(std::string const & mwmPath, std::string const & country,
+                          CountryParentNameGetterFn const & countryParentNameGetterFn);
+}  // namespace routing_builder
@@ -2,6 +2,7 @@
 
 #include "generator/borders.hpp"
 #include "generator/cross_mwm_osm_ways_collector.hpp"
+#include "generator/cross_mwm_overlay_builder.hpp"
 #include "generator/routing_helpers.hpp"
 
 #include "routing/base/astar_algorithm.hpp"
@@ -9,11 +10,13 @@
 #include "routing/cross_mwm_connector.hpp"
 #include "routing/cross_mwm_connector_serialization.hpp"
 #include "routing/cross_mwm_ids.hpp"
+#include "routing/cross_mwm_overlay.hpp"
 #include "routing/index_graph.hpp"
 #include "routing/index_graph_loader.hpp"
 #include "routing/index_graph_serialization.hpp"
 #include "routing/index_graph_starter_joints.hpp"
 #include "routing/joint_segment.hpp"
+#include "routing/mwm_hierarchy_handler.hpp"
 #include "routing/vehicle_mask.hpp"
 #include "routing/world_graph.hpp"
 
@@ -27,6 +30,9 @@
 #include "indexer/feature.hpp"
 #include "indexer/feature_processor.hpp"
 
+#include "platform/mwm_version.hpp"
+#include "platform/platform.hpp"
+
 #include "coding/files_container.hpp"
 #include "coding/point_coding.hpp"
 #include "coding/reader.hpp"
@@ -38,11 +44,13 @@
 #include "base/file_name_utils.hpp"
 #include "base/geo_object_id.hpp"
 #include "base/logging.hpp"
+#include "base/thread_pool_computational.hpp"
 #include "base/timer.hpp"
 
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -721,4 +729,212 @@ void BuildTransitCrossMwmSection(
 
   SerializeCrossMwm(mwmFile, TRANSIT_CROSS_MWM_FILE_TAG, builder);
 }
+
+namespace
+{
+using CrossMwmConnectorT = CrossMwmConnector<base::GeoObjectId>;
+using CrossMwmIdToMwms = std::unordered_map<base::GeoObjectId, std::vector<NumMwmId>>;
+
+struct OverlayMwm
+{
+  OverlayMwm(std::string const & mwmPath, NumMwmId mwmId)
+    : m_cont(mwmPath), m_connector(mwmId)
+  {
+    m_version = version::MwmVersion::Read(m_cont).GetVersion();
+  }
+
+  void LoadConnector(CrossMwmConnectorT & connector, bool loadWeights) const
+  {
+    CrossMwmConnectorBuilder<base::GeoObjectId> builder(connector);
+    builder.ApplyNumerationOffset();
+
+    auto reader = m_cont.GetReader(CROSS_MWM_FILE_TAG);
+    builder.DeserializeTransitions(VehicleType::Car, reader);
+    if (loadWeights)
+      builder.DeserializeWeights(reader);
+  }
+
+  FilesContainerR m_cont;
+  // Transitions only, weights are loaded for the mwms of the current cell.
+  CrossMwmConnectorT m_connector;
+  uint32_t m_version = 0;
+};
+
+/// \returns nullopt if the cell is too large, see CrossMwmOverlayCellBuilder::kMaxWeightsCount.
+std::optional<CrossMwmOverlayCell> BuildOverlayCell(std::vector<NumMwmId> const & cellMwms,
+                                                    std::vector<std::unique_ptr<OverlayMwm>> const & mwms,
+                                                    std::vector<std::string> const & mwmToCountry,
+                                                    CrossMwmIdToMwms const & crossMwmIdToMwms,
+                                                    base::ComputationalThreadPool & threadPool)
+{
+  std::vector<uint32_t> mwmVersions;
+  for (auto const mwmId : cellMwms)
+    mwmVersions.push_back(mwms[mwmId]->m_version);
+
+  std::string const & country = mwmToCountry[cellMwms.front()];
+  CrossMwmOverlayCellBuilder builder(cellMwms, mwmVersions);
+
+  for (auto const mwmId : cellMwms)
+  {
+    auto const & mwm = *mwms[mwmId];
+    auto const & transitions = mwm.m_connector;
+
+    // |isEnter| is the type of the twins we are looking for.
+    auto const forEachTwin = [&](Segment const & s, bool isEnter, auto && fn)
+    {
+      auto const & crossMwmId = transitions.GetCrossMwmId(s);
+      auto const it = crossMwmIdToMwms.find(crossMwmId);
+      if (it == crossMwmIdToMwms.end())
+        return;
+
+      for (auto const twinMwmId : it->second)
+      {
+        if (twinMwmId == mwmId)
+          continue;
+
+        auto const twin = mwms[twinMwmId]->m_connector.GetTransition(crossMwmId, s.GetSegmentIdx(), isEnter);
+        if (twin && twin->IsForward() == s.IsForward())
+          fn(*twin);
+      }
+    };
+
+    transitions.ForEachExit([&](uint32_t, Segment const & exit)
+    {
+      bool isCellExit = false;
+      forEachTwin(exit, true /* isEnter */, [&](Segment const & twin)
+      {
+        if (mwmToCountry[twin.GetMwmId()] == country)
+          builder.AddTwins(exit, twin);
+        else
+          isCellExit = true;
+      });
+
+      if (isCellExit)
+        builder.AddCellExit(exit);
+    });
+
+    transitions.ForEachEnter([&](uint32_t, Segment const & enter)
+    {
+      bool isCellEnter = false;
+      forEachTwin(enter, false /* isEnter */, [&](Segment const & twin)
+      {
+        isCellEnter = isCellEnter || mwmToCountry[twin.GetMwmId()] != country;
+      });
+
+      if (isCellEnter)
+        builder.AddCellEnter(enter);
+    });
+  }
+
+  // Check the size before loading the weights of the cell mwms.
+  if (builder.IsTooLarge())
+    return {};
+
+  for (auto const mwmId : cellMwms)
+  {
+    CrossMwmConnectorT connector(mwmId);
+    mwms[mwmId]->LoadConnector(connector, true /* loadWeights */);
+
+    // Leaps inside the mwm.
+    connector.ForEachEnter([&](uint32_t enterIdx, Segment const & enter)
+    {
+      connector.ForEachExit([&](uint32_t exitIdx, Segment const & exit)
+      {
+        auto const weight = connector.GetWeight(enterIdx, exitIdx);
+        if (weight != connector::kNoRouteStored)
+          builder.AddLeap(enter, exit, weight);
+      });
+    });
+  }
+
+  return std::move(builder).Build(threadPool);
+}
+}  // namespace
+
+void BuildCrossMwmOverlaySection(string const & path, string const & worldFile,
+                                 CountryParentNameGetterFn const & countryParentNameGetterFn,
+                                 size_t threadsCount)
+{
+  LOG(LINFO, ("Building cross mwm overlay section for", worldFile));
+  base::Timer timer;
+
+  Platform::FilesList files;
+  Platform::GetFilesByExt(path, DATA_FILE_EXTENSION, files);
+  std::sort(files.begin(), files.end());
+
+  NumMwmIds numMwmIds;
+  std::vector<std::unique_ptr<OverlayMwm>> mwms;
+  std::vector<std::string> mwmToCountry;
+  CrossMwmIdToMwms crossMwmIdToMwms;
+  // Top level country -> its mwms.
+  std::map<std::string, std::vector<NumMwmId>> countries;
+
+  for (auto const & file : files)
+  {
+    auto const name = base::FilenameWithoutExt(file);
+    if (name == WORLD_FILE_NAME || name == WORLD_COASTS_FILE_NAME)
+      continue;
+
+    platform::CountryFile const countryFile(name);
+    numMwmIds.RegisterFile(countryFile);
+    NumMwmId const mwmId = numMwmIds.GetId(countryFile);
+    CHECK_EQUAL(mwmId, mwms.size(), ());
+
+    auto mwm = std::make_unique<OverlayMwm>(base::JoinPath(path, file), mwmId);
+    std::string country = GetCountryByMwmName(name, countryParentNameGetterFn);
+    if (mwm->m_cont.IsExist(CROSS_MWM_FILE_TAG))
+    {
+      mwm->LoadConnector(mwm->m_connector, false /* loadWeights */);
+
+      auto const addCrossMwmId = [&](uint32_t, Segment const & s)
+      {
+        auto & ids = crossMwmIdToMwms[mwm->m_connector.GetCrossMwmId(s)];
+        if (ids.empty() || ids.back() != mwmId)
+          ids.push_back(mwmId);
+      };
+      mwm->m_connector.ForEachEnter(addCrossMwmId);
+      mwm->m_connector.ForEachExit(addCrossMwmId);
+
+      // Disputed territories are not grouped.
+      if (!country.empty())
+        countries[country].push_back(mwmId);
+    }
+    else
+    {
+      LOG(LWARNING, ("Mwm", name, "has no", CROSS_MWM_FILE_TAG, "section."));
+    }
+
+    mwms.push_back(std::move(mwm));
+    mwmToCountry.push_back(std::move(country));
+  }
+
+  base::ComputationalThreadPool threadPool(threadsCount);
+  CrossMwmOverlay overlay;
+  for (auto const & [country, countryMwms] : countries)
+  {
+    // Nothing to jump over in one mwm, its cross_mwm section has the same leaps.
+    if (countryMwms.size() < 2)
+      continue;
+
+    auto cell = BuildOverlayCell(countryMwms, mwms, mwmToCountry, crossMwmIdToMwms, threadPool);
+    if (!cell)
+    {
+      LOG(LWARNING, ("Overlay cell", country, "is too large, skipped."));
+      continue;
+    }
+
+    LOG(LINFO, ("Overlay cell", country, "mwms:", countryMwms.size(), "enters:", cell->m_enters.size(),
+                "exits:", cell->m_exits.size()));
+    overlay.AddCell(std::move(*cell));
+  }
+
+  FilesContainerW cont(worldFile, FileWriter::OP_WRITE_EXISTING);
+  auto writer = cont.GetWriter(CROSS_MWM_OVERLAY_FILE_TAG);
+  auto const startPos = writer->Pos();
+  CrossMwmOverlaySerializer::Serialize(overlay, *writer, numMwmIds);
+  auto const sectionSize = writer->Pos() - startPos;
+
+  LOG(LINFO, ("Cross mwm overlay section generated, size:", sectionSize, "bytes, cells:",
+              overlay.GetCellsCount(), "elapsed:", timer.ElapsedSeconds(), "seconds"));
+}
 }  // namespace routing_builder
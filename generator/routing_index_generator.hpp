@@ -2,6 +2,7 @@
 
 #include "transit/experimental/transit_data.hpp"
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <string>
@@ -29,4 +30,10 @@ void BuildTransitCrossMwmSection(
     CountryParentNameGetterFn const & countryParentNameGetterFn,
     ::transit::experimental::EdgeIdToFeatureId const & edgeIdToFeatureId,
     bool experimentalTransit = false);
+
+/// \brief Builds CROSS_MWM_OVERLAY_FILE_TAG section of |worldFile|.
+/// \note Before a call of this method CROSS_MWM_FILE_TAG should be built for all the mwms in |path|.
+void BuildCrossMwmOverlaySection(std::string const & path, std::string const & worldFile,
+                                 CountryParentNameGetterFn const & countryParentNameGetterFn,
+                                 size_t threadsCount);
 }  // namespace routing
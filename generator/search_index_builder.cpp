@@ -24,8 +24,11 @@
 
 #include "platform/platform.hpp"
 
+#include "coding/file_reader.hpp"
+#include "coding/file_writer.hpp"
 #include "coding/reader_writer_ops.hpp"
 #include "coding/succinct_mapper.hpp"
+#include "coding/varint.hpp"
 #include "coding/writer.hpp"
 
 #include "base/assert.hpp"
@@ -35,15 +38,21 @@
 #include "base/scope_guard.hpp"
 #include "base/stats.hpp"
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
 #include "base/timer.hpp"
 
 #include "defines.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <optional>
+#include <queue>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 
@@ -122,24 +131,22 @@ void GetCategoryTypes(CategoriesHolder const & categories, std::pair<int, int> s
   }
 }
 
+using StreetTokensStats = base::TopStatsCounter<std::string>;
+
 template <class ContT>
 class FeatureNameInserter
 {
   String2StringMap const & m_suffixes;
 
-  base::TopStatsCounter<std::string> m_stats;
+  StreetTokensStats & m_stats;
 
 public:
-  explicit FeatureNameInserter(ContT & keyValuePairs)
+  FeatureNameInserter(ContT & keyValuePairs, StreetTokensStats & stats)
     : m_suffixes(GetDACHStreets())
+    , m_stats(stats)
     , m_keyValuePairs(keyValuePairs)
   {
   }
-  ~FeatureNameInserter()
-  {
-    LOG(LINFO, ("Top street's name tokens:"));
-    m_stats.PrintTop(10);
-  }
 
   void SetFeature(uint32_t index, SynonymsHolder const * synonyms, bool hasStreetType)
   {
@@ -286,12 +293,12 @@ template <class ContT>
 class FeatureInserter
 {
 public:
-  FeatureInserter(SynonymsHolder * synonyms, ContT & keyValuePairs,
+  FeatureInserter(SynonymsHolder const * synonyms, ContT & keyValuePairs, StreetTokensStats & stats,
                   CategoriesHolder const & catHolder, std::pair<int, int> const & scales)
     : m_synonyms(synonyms)
     , m_categories(catHolder)
     , m_scales(scales)
-    , m_inserter(keyValuePairs)
+    , m_inserter(keyValuePairs, stats)
   {
   }
 
@@ -371,7 +378,7 @@ public:
   }
 
 private:
-  SynonymsHolder * m_synonyms;
+  SynonymsHolder const * m_synonyms;
 
   CategoriesHolder const & m_categories;
   std::pair<int, int> m_scales;
@@ -380,20 +387,221 @@ private:
   FeatureNameInserter<ContT> m_inserter;
 };
 
-template <class ContT>
-void AddFeatureNameIndexPairs(FeaturesVectorTest const & features,
-                              CategoriesHolder const & categoriesHolder,
-                              ContT & keyValuePairs)
+using SearchIndexKey = strings::UniString;
+using SearchIndexValue = Uint64IndexValue;
+using SearchIndexPair = std::pair<SearchIndexKey, SearchIndexValue>;
+
+// Sorted run of the search index pairs. A run is kept in memory or spilled to a temporary file
+// when the pairs in memory exceed the budget.
+class SortedRun
+{
+public:
+  explicit SortedRun(std::vector<SearchIndexPair> && pairs) : m_pairs(std::move(pairs)) {}
+
+  SortedRun(std::vector<SearchIndexPair> const & pairs, std::string const & fileName) : m_fileName(fileName)
+  {
+    FileWriter writer(m_fileName);
+    for (auto const & [key, value] : pairs)
+    {
+      WriteVarUint(writer, key.size());
+      for (auto const c : key)
+        WriteVarUint(writer, c);
+      WriteVarUint(writer, value.m_featureId);
+    }
+  }
+
+  SortedRun(SortedRun && rhs)
+    : m_pairs(std::move(rhs.m_pairs))
+    , m_pos(rhs.m_pos)
+    , m_fileName(std::exchange(rhs.m_fileName, {}))
+    , m_reader(std::move(rhs.m_reader))
+    , m_source(std::move(rhs.m_source))
+  {
+  }
+
+  ~SortedRun()
+  {
+    if (!m_fileName.empty())
+      FileWriter::DeleteFileX(m_fileName);
+  }
+
+  void Open()
+  {
+    if (m_fileName.empty())
+      return;
+
+    m_reader = std::make_unique<FileReader>(m_fileName);
+    m_source = std::make_unique<ReaderSource<FileReader>>(*m_reader);
+  }
+
+  bool Next(SearchIndexPair & pair)
+  {
+    if (m_fileName.empty())
+    {
+      if (m_pos == m_pairs.size())
+        return false;
+      pair = std::move(m_pairs[m_pos++]);
+      return true;
+    }
+
+    if (m_source->Size() == 0)
+      return false;
+
+    auto & [key, value] = pair;
+    key.resize(ReadVarUint<uint32_t>(*m_source));
+    for (auto & c : key)
+      c = ReadVarUint<uint32_t>(*m_source);
+    value.m_featureId = ReadVarUint<uint64_t>(*m_source);
+    return true;
+  }
+
+private:
+  std::vector<SearchIndexPair> m_pairs;
+  size_t m_pos = 0;
+
+  std::string m_fileName;
+  std::unique_ptr<FileReader> m_reader;
+  std::unique_ptr<ReaderSource<FileReader>> m_source;
+};
+
+struct FeaturesRangeResult
+{
+  std::optional<SortedRun> m_run;
+  StreetTokensStats m_stats;
+};
+
+/// @return Pairs of all the features from the mwm in the sorted order, duplicates are possible.
+/// Token extraction and sorting are done in parallel over feature ranges, the sorted runs
+/// are merged after that, see SortedRunsMerger.
+std::vector<SortedRun> CollectSortedRuns(std::string const & mwmPath, CategoriesHolder const & categoriesHolder,
+                                         uint32_t threadsCount, size_t maxPairsInMemory)
 {
-  feature::DataHeader const & header = features.GetHeader();
+  uint32_t featuresCount = 0;
+  feature::DataHeader::MapType mapType;
+  std::pair<int, int> scaleRange;
+  {
+    FeaturesVectorTest features(mwmPath);
+    featuresCount = base::checked_cast<uint32_t>(features.GetVector().GetNumFeatures());
+    mapType = features.GetHeader().GetType();
+    scaleRange = features.GetHeader().GetScaleRange();
+  }
 
   std::unique_ptr<SynonymsHolder> synonyms;
-  if (header.GetType() == feature::DataHeader::MapType::World)
+  if (mapType == feature::DataHeader::MapType::World)
     synonyms = std::make_unique<SynonymsHolder>();
 
-  features.GetVector().ForEach(FeatureInserter(synonyms.get(), keyValuePairs, categoriesHolder, header.GetScaleRange()));
+  // Ranges are smaller than featuresCount / threadsCount to balance threads load.
+  uint32_t constexpr kRangesPerThread = 8;
+  uint32_t const rangesCount = std::max(1U, std::min(featuresCount, threadsCount * kRangesPerThread));
+
+  // Bigger runs are spilled to temporary files when the pairs in memory exceed the budget.
+  std::atomic<size_t> pairsInMemory = 0;
+
+  auto const processRange = [&](uint32_t rangeIdx)
+  {
+    auto const fc = static_cast<uint64_t>(featuresCount);
+    auto const beg = static_cast<uint32_t>(fc * rangeIdx / rangesCount);
+    auto const end = static_cast<uint32_t>(fc * (rangeIdx + 1) / rangesCount);
+
+    FeaturesRangeResult result;
+    std::vector<SearchIndexPair> pairs;
+    {
+      FeaturesVectorTest features(mwmPath);
+      FeatureInserter inserter(synonyms.get(), pairs, result.m_stats, categoriesHolder, scaleRange);
+      for (uint32_t i = beg; i < end; ++i)
+      {
+        auto ft = features.GetVector().GetByIndex(i);
+        CHECK(ft, (i));
+        // The same as FeaturesVector::ForEach does for metadata loading.
+        ft->SetID(FeatureID(MwmSet::MwmId(), i));
+        inserter(*ft, i);
+      }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+    if (pairsInMemory.fetch_add(pairs.size()) + pairs.size() <= maxPairsInMemory)
+    {
+      result.m_run.emplace(std::move(pairs));
+    }
+    else
+    {
+      pairsInMemory -= pairs.size();
+      auto const fileName = mwmPath + "." + SEARCH_INDEX_FILE_TAG + "." + strings::to_string(rangeIdx) + EXTENSION_TMP;
+      result.m_run.emplace(pairs, fileName);
+    }
+    return result;
+  };
+
+  std::vector<std::future<FeaturesRangeResult>> futures;
+  futures.reserve(rangesCount);
+  {
+    base::ComputationalThreadPool pool(threadsCount);
+    for (uint32_t i = 0; i < rangesCount; ++i)
+      futures.push_back(pool.Submit(processRange, i));
+  }
+
+  std::vector<SortedRun> runs;
+  runs.reserve(rangesCount);
+  StreetTokensStats stats;
+  for (auto & f : futures)
+  {
+    auto result = f.get();
+    runs.push_back(std::move(*result.m_run));
+    stats.Merge(result.m_stats);
+  }
+
+  LOG(LINFO, ("Top street's name tokens:"));
+  stats.PrintTop(10);
+
+  return runs;
 }
 
+// Merges sorted runs into one sorted sequence of pairs.
+class SortedRunsMerger
+{
+public:
+  explicit SortedRunsMerger(std::vector<SortedRun> & runs) : m_runs(runs)
+  {
+    for (size_t i = 0; i < m_runs.size(); ++i)
+    {
+      m_runs[i].Open();
+      Entry entry;
+      entry.m_run = i;
+      if (m_runs[i].Next(entry.m_pair))
+        m_queue.push(std::move(entry));
+    }
+  }
+
+  template <typename Fn>
+  void ForEach(Fn && fn)
+  {
+    while (!m_queue.empty())
+    {
+      // Extract the top entry, std::priority_queue::top() is const.
+      Entry entry = std::move(const_cast<Entry &>(m_queue.top()));
+      m_queue.pop();
+
+      fn(entry.m_pair.first, entry.m_pair.second);
+
+      if (m_runs[entry.m_run].Next(entry.m_pair))
+        m_queue.push(std::move(entry));
+    }
+  }
+
+private:
+  struct Entry
+  {
+    // The greater pair is, the lower priority it has.
+    bool operator<(Entry const & rhs) const { return rhs.m_pair < m_pair; }
+
+    SearchIndexPair m_pair;
+    size_t m_run = 0;
+  };
+
+  std::vector<SortedRun> & m_runs;
+  std::priority_queue<Entry> m_queue;
+};
+
 void ReadAddressData(std::string const & filename, std::vector<feature::AddressData> & addrs)
 {
   FileReader reader(filename);
@@ -590,8 +798,6 @@ void BuildAddressTable(FilesContainerR & container, std::string const & addressD
 }  // namespace
 
 
-void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter);
-
 bool BuildSearchIndexFromDataFile(std::string const & country, feature::GenerateInfo const & info,
                                   bool forceRebuild, uint32_t threadsCount)
 {
@@ -613,7 +819,7 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
   {
     {
       FileWriter writer(indexFilePath);
-      BuildSearchIndex(readContainer, writer);
+      BuildSearchIndex(readContainer, writer, threadsCount);
       LOG(LINFO, ("Search index size =", writer.Size()));
     }
 
@@ -674,27 +880,27 @@ bool BuildSearchIndexFromDataFile(std::string const & country, feature::Generate
   return true;
 }
 
-void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter)
+void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter, uint32_t threadsCount,
+                      size_t maxPairsInMemory)
 {
-  using Key = strings::UniString;
-  using Value = Uint64IndexValue;
+  using Value = SearchIndexValue;
 
   LOG(LINFO, ("Start building search index for", container.GetFileName()));
   base::Timer timer;
 
-  auto const & categoriesHolder = GetDefaultCategories();
-
-  FeaturesVectorTest features(container);
-  SingleValueSerializer<Value> serializer;
-
-  std::vector<std::pair<Key, Value>> searchIndexKeyValuePairs;
-  AddFeatureNameIndexPairs(features, categoriesHolder, searchIndexKeyValuePairs);
-
-  std::sort(searchIndexKeyValuePairs.begin(), searchIndexKeyValuePairs.end());
+  auto runs = CollectSortedRuns(container.GetFileName(), GetDefaultCategories(), threadsCount, maxPairsInMemory);
   LOG(LINFO, ("End sorting strings:", timer.ElapsedSeconds()));
 
-  trie::Build<Writer, Key, ValueList<Value>, SingleValueSerializer<Value>>(
-      indexWriter, serializer, searchIndexKeyValuePairs);
+  // Pairs are merged from sorted runs straight into the trie in the same order as sorting of
+  // all the pairs gives, so the index is the same as a single threaded build gives.
+  SingleValueSerializer<Value> serializer;
+  trie::Builder<Writer, SearchIndexKey, ValueList<Value>, SingleValueSerializer<Value>> builder(indexWriter,
+                                                                                                 serializer);
+  SortedRunsMerger(runs).ForEach([&builder](SearchIndexKey const & key, Value const & value)
+  {
+    builder.Add(key, value);
+  });
+  builder.Finish();
 
   LOG(LINFO, ("End building search index, elapsed seconds:", timer.ElapsedSeconds()));
 }
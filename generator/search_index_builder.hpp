@@ -4,12 +4,19 @@
 
 #include "indexer/ftypes_matcher.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
 
+class FilesContainerR;
+class Writer;
+
 namespace indexer
 {
+size_t constexpr kMaxSearchIndexPairsInMemory = 16 * 1000 * 1000;
+
 class SynonymsHolder
 {
 public:
@@ -38,6 +45,11 @@ private:
   std::unordered_map<std::string, std::vector<std::string>> m_map;
 };
 
+// Builds the search index trie of |container| into |indexWriter|, the nodes are written from
+// the leaves to the root. Index pairs over |maxPairsInMemory| are spilled to temporary files.
+void BuildSearchIndex(FilesContainerR & container, Writer & indexWriter, uint32_t threadsCount,
+                      size_t maxPairsInMemory = kMaxSearchIndexPairsInMemory);
+
 // Builds the latest version of the search index section and writes it to the mwm file.
 // An attempt to rewrite the search index of an old mwm may result in a future crash
 // when using search because this function does not update mwm's version. This results
@@ -0,0 +1,120 @@
+#include "testing/testing.hpp"
+
+#include "base/bounded_mpsc_queue.hpp"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+UNIT_TEST(BoundedMpscQueue_Smoke)
+{
+  threads::BoundedMpscQueue<size_t> queue(3);
+  TEST_EQUAL(queue.GetCapacity(), 4, ());
+  TEST(queue.IsEmpty(), ());
+
+  size_t value = 0;
+  TEST(!queue.TryPop(value), ());
+
+  for (size_t i = 0; i < 4; ++i)
+    TEST(queue.TryPush(size_t(i)), ());
+  TEST_EQUAL(queue.GetSize(), 4, ());
+
+  // The queue is full.
+  TEST(!queue.TryPush(size_t(4)), ());
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    TEST(queue.TryPop(value), ());
+    TEST_EQUAL(value, i, ());
+  }
+  TEST(queue.IsEmpty(), ());
+
+  // Cells are reused on the next lap.
+  TEST(queue.TryPush(size_t(5)), ());
+  TEST(queue.TryPop(value), ());
+  TEST_EQUAL(value, 5, ());
+}
+
+UNIT_TEST(BoundedMpscQueue_MoveOnly)
+{
+  threads::BoundedMpscQueue<std::unique_ptr<int>> queue(1);
+  TEST_EQUAL(queue.GetCapacity(), 2, ());
+  TEST(queue.TryPush(std::make_unique<int>(1)), ());
+  TEST(queue.TryPush(std::make_unique<int>(2)), ());
+
+  // A failed push doesn't take the value.
+  auto p = std::make_unique<int>(3);
+  TEST(!queue.TryPush(std::move(p)), ());
+  TEST(p != nullptr, ());
+
+  std::unique_ptr<int> res;
+  TEST(queue.TryPop(res), ());
+  TEST_EQUAL(*res, 1, ());
+}
+
+UNIT_TEST(BoundedMpscQueue_ReservedCell)
+{
+  threads::BoundedMpscQueue<size_t> queue(4);
+  TEST(queue.IsDrained(), ());
+
+  // A producer has reserved the cell, but hasn't published its value yet.
+  auto const pos = queue.ReserveForTesting();
+  TEST(pos, ());
+  TEST(queue.TryPush(size_t(1)), ());
+
+  size_t value = 0;
+  TEST(queue.IsEmpty(), ());
+  TEST(!queue.IsDrained(), ());
+  TEST(!queue.TryPop(value), ());
+
+  queue.PublishForTesting(*pos, size_t(0));
+  for (size_t i = 0; i < 2; ++i)
+  {
+    TEST(queue.TryPop(value), ());
+    TEST_EQUAL(value, i, ());
+  }
+  TEST(queue.IsEmpty(), ());
+  TEST(queue.IsDrained(), ());
+}
+
+UNIT_TEST(BoundedMpscQueue_MultipleProducers)
+{
+  size_t constexpr kProducersCount = 4;
+  size_t constexpr kValuesCount = 10000;
+
+  threads::BoundedMpscQueue<std::pair<size_t, size_t>> queue(64);
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < kProducersCount; ++p)
+  {
+    producers.emplace_back([&queue, p]()
+    {
+      for (size_t i = 0; i < kValuesCount; ++i)
+      {
+        while (!queue.TryPush({p, i}))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  // Values of every producer are popped in the order of pushing.
+  std::vector<size_t> next(kProducersCount, 0);
+  std::pair<size_t, size_t> value;
+  for (size_t popped = 0; popped < kProducersCount * kValuesCount;)
+  {
+    if (!queue.TryPop(value))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    TEST_EQUAL(value.second, next[value.first], ());
+    ++next[value.first];
+    ++popped;
+  }
+
+  for (auto & t : producers)
+    t.join();
+
+  TEST(queue.IsEmpty(), ());
+  for (auto const n : next)
+    TEST_EQUAL(n, kValuesCount, ());
+}
@@ -120,3 +120,19 @@ UNIT_TEST(ThreadPoolComputational_ManyTasks)
     TEST_EQUAL(taskCount, counter, ());
   }
 }
+
+UNIT_TEST(ThreadPoolComputational_OneThreadOrder)
+{
+  size_t const taskCount = 100;
+  std::vector<size_t> order;
+  {
+    base::ComputationalThreadPool threadPool(1);
+    for (size_t i = 0; i < taskCount; ++i)
+      threadPool.SubmitWork([&order, i]() { order.push_back(i); });
+  }
+
+  // Tasks which are submitted not from the pool's threads are started in FIFO order.
+  TEST_EQUAL(order.size(), taskCount, ());
+  for (size_t i = 0; i < taskCount; ++i)
+    TEST_EQUAL(order[i], i, ());
+}
@@ -0,0 +1,205 @@
+#include "testing/testing.hpp"
+
+#include "base/thread_pool_work_stealing.hpp"
+
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+UNIT_TEST(WorkStealingThreadPool_Submit)
+{
+  size_t constexpr kTasksCount = 1000;
+  std::atomic<size_t> counter{0};
+  std::vector<std::future<size_t>> futures;
+  {
+    base::WorkStealingThreadPool pool(4);
+    for (size_t i = 0; i < kTasksCount; ++i)
+    {
+      futures.push_back(pool.Submit([&counter, i]()
+      {
+        ++counter;
+        return i;
+      }));
+    }
+
+    for (size_t i = 0; i < kTasksCount; ++i)
+      TEST_EQUAL(futures[i].get(), i, ());
+  }
+  TEST_EQUAL(counter, kTasksCount, ());
+}
+
+UNIT_TEST(WorkStealingThreadPool_DestructorRunsPending)
+{
+  size_t constexpr kTasksCount = 100;
+  std::atomic<size_t> counter{0};
+  {
+    base::WorkStealingThreadPool pool(2);
+    for (size_t i = 0; i < kTasksCount; ++i)
+      pool.Push([&counter]() { ++counter; });
+  }
+  TEST_EQUAL(counter, kTasksCount, ());
+}
+
+UNIT_TEST(WorkStealingThreadPool_Stop)
+{
+  base::WorkStealingThreadPool pool(2);
+  pool.Stop();
+  TEST(!pool.Push([]() {}), ());
+  TEST(!pool.Submit([]() { return 1; }).valid(), ());
+}
+
+UNIT_TEST(WorkStealingThreadPool_ParallelFor)
+{
+  size_t constexpr kSize = 10000;
+  std::vector<size_t> values(kSize, 0);
+
+  base::WorkStealingThreadPool pool(4);
+  base::ParallelFor(pool, 0, kSize, [&values](size_t i) { values[i] = i * 2; });
+  for (size_t i = 0; i < kSize; ++i)
+    TEST_EQUAL(values[i], i * 2, ());
+
+  // Empty range and a grain larger than the range.
+  base::ParallelFor(pool, 5, 5, [](size_t) { TEST(false, ()); });
+  base::ParallelFor(pool, 0, 3, [&values](size_t i) { values[i] = 0; }, 100 /* grainSize */);
+  TEST_EQUAL(values[2], 0, ());
+}
+
+UNIT_TEST(WorkStealingThreadPool_NestedParallelFor)
+{
+  size_t constexpr kOuter = 16;
+  size_t constexpr kInner = 100;
+  std::atomic<size_t> counter{0};
+
+  // Inner loops wait on the workers, they must run pending tasks instead of blocking.
+  base::WorkStealingThreadPool pool(2);
+  base::ParallelFor(pool, 0, kOuter, [&](size_t)
+  {
+    base::ParallelFor(pool, 0, kInner, [&counter](size_t) { ++counter; });
+  });
+  TEST_EQUAL(counter, kOuter * kInner, ());
+}
+
+UNIT_TEST(WorkStealingThreadPool_ParallelReduce)
+{
+  size_t constexpr kSize = 12345;
+  base::WorkStealingThreadPool pool(3);
+
+  auto const sum = base::ParallelReduce(pool, 0, kSize, size_t{0}, [](size_t b, size_t e)
+  {
+    size_t s = 0;
+    for (size_t i = b; i < e; ++i)
+      s += i;
+    return s;
+  }, [](size_t l, size_t r) { return l + r; });
+  TEST_EQUAL(sum, kSize * (kSize - 1) / 2, ());
+
+  // Non-commutative reduce keeps the order of subranges.
+  auto const str = base::ParallelReduce(pool, 0, 20, std::string(), [](size_t b, size_t e)
+  {
+    std::string s;
+    for (size_t i = b; i < e; ++i)
+      s += static_cast<char>('a' + i);
+    return s;
+  }, [](std::string l, std::string const & r) { return l + r; });
+  TEST_EQUAL(str, "abcdefghijklmnopqrst", ());
+}
+
+UNIT_TEST(WorkStealingThreadPool_TaskGroupCancel)
+{
+  base::WorkStealingThreadPool pool(1);
+  std::atomic<size_t> counter{0};
+  std::promise<void> started;
+  std::promise<void> cancelled;
+  auto cancelledFuture = cancelled.get_future().share();
+
+  base::TaskGroup group(pool);
+  // The only worker is blocked, so the rest of the tasks are not started before cancellation.
+  group.Run([&]()
+  {
+    started.set_value();
+    cancelledFuture.wait();
+    ++counter;
+  });
+  started.get_future().wait();
+
+  for (size_t i = 0; i < 10; ++i)
+    group.Run([&counter]() { ++counter; });
+
+  group.Cancel();
+  cancelled.set_value();
+  group.Wait();
+
+  TEST(group.IsCancelled(), ());
+  TEST_EQUAL(counter, 1, ());
+}
+
+UNIT_TEST(WorkStealingThreadPool_StopWithTaskGroup)
+{
+  base::WorkStealingThreadPool pool(1);
+  std::atomic<size_t> counter{0};
+  std::promise<void> started;
+  std::promise<void> stopped;
+  auto stoppedFuture = stopped.get_future().share();
+
+  base::TaskGroup group(pool);
+  group.Run([&]()
+  {
+    started.set_value();
+    stoppedFuture.wait();
+    ++counter;
+  });
+  started.get_future().wait();
+
+  for (size_t i = 0; i < 10; ++i)
+    group.Run([&counter]() { ++counter; });
+
+  // Dropped tasks are not run, but they don't block the group.
+  pool.Stop();
+  stopped.set_value();
+  group.Wait();
+  TEST_EQUAL(counter, 1, ());
+
+  // Tasks of a stopped pool are run on the calling thread.
+  group.Run([&counter]() { ++counter; });
+  group.Wait();
+  TEST_EQUAL(counter, 2, ());
+}
+
+UNIT_TEST(WorkStealingThreadPool_StopDuringParallelFor)
+{
+  size_t constexpr kSize = 100;
+  std::vector<std::atomic<size_t>> values(kSize);
+
+  base::WorkStealingThreadPool pool(1);
+
+  // The only worker is blocked, so the chunks are run by the ParallelFor thread.
+  std::promise<void> release;
+  auto releaseFuture = release.get_future().share();
+  pool.Push([releaseFuture]() { releaseFuture.wait(); });
+
+  std::promise<void> started;
+  std::thread loop([&]()
+  {
+    base::ParallelFor(pool, 0, kSize, [&](size_t i)
+    {
+      if (i == 0)
+      {
+        started.set_value();
+        releaseFuture.wait();
+      }
+      ++values[i];
+    });
+  });
+
+  started.get_future().wait();
+  pool.Stop();
+  release.set_value();
+  loop.join();
+
+  // Chunks which are dropped by Stop() are run on the calling thread.
+  for (size_t i = 0; i < kSize; ++i)
+    TEST_EQUAL(values[i], 1, (i));
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace threads
+{
+// Bounded lock-free queue for multiple producers and a single consumer.
+// Every cell keeps a sequence number, which tells whether the cell is free for the
+// producer of the current lap or keeps a value for the consumer (D. Vyukov's bounded queue).
+// Producers only contend on the enqueue position, the consumer doesn't use atomic RMW at all.
+// TryPop(), IsEmpty() and IsDrained() must be called by one thread at a time, e.g. under the consumer's mutex.
+template <typename T>
+class BoundedMpscQueue
+{
+public:
+  // |capacity| is rounded up to a power of two, at least two cells are needed to tell
+  // a free cell from an occupied one.
+  explicit BoundedMpscQueue(size_t capacity)
+    : m_mask(std::bit_ceil(std::max(capacity, size_t{2})) - 1)
+    , m_cells(std::make_unique<Cell[]>(m_mask + 1))
+  {
+    CHECK_GREATER(capacity, 0, ());
+    for (size_t i = 0; i <= m_mask; ++i)
+      m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+  }
+
+  // Thread-safe. Returns false and leaves |value| untouched if the queue is full.
+  bool TryPush(T && value)
+  {
+    size_t pos = 0;
+    Cell * cell = Reserve(pos);
+    if (cell == nullptr)
+      return false;
+
+    Publish(*cell, pos, std::move(value));
+    return true;
+  }
+
+  // Reserves a cell like TryPush() does, but doesn't publish a value, as a producer which is
+  // preempted in the middle of TryPush(). Returns the position for PublishForTesting() or
+  // std::nullopt if the queue is full.
+  std::optional<size_t> ReserveForTesting()
+  {
+    size_t pos = 0;
+    if (Reserve(pos) == nullptr)
+      return {};
+    return pos;
+  }
+
+  void PublishForTesting(size_t pos, T && value) { Publish(m_cells[pos & m_mask], pos, std::move(value)); }
+
+  // Returns false if the queue is empty or the oldest value is still being pushed.
+  bool TryPop(T & value)
+  {
+    size_t const pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Cell & cell = m_cells[pos & m_mask];
+    if (cell.m_sequence.load(std::memory_order_acquire) != pos + 1)
+      return false;
+
+    value = std::move(cell.m_value);
+    cell.m_value = T();
+    cell.m_sequence.store(pos + m_mask + 1, std::memory_order_release);
+    m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Returns true if there is no value to pop, the oldest value may be still being pushed.
+  bool IsEmpty() const
+  {
+    size_t const pos = m_dequeuePos.load(std::memory_order_relaxed);
+    return m_cells[pos & m_mask].m_sequence.load(std::memory_order_acquire) != pos + 1;
+  }
+
+  // Unlike IsEmpty(), returns false while a value is being pushed. So all the values whose
+  // pushes happen before the call are popped if it returns true.
+  bool IsDrained() const
+  {
+    return m_enqueuePos.load(std::memory_order_relaxed) == m_dequeuePos.load(std::memory_order_relaxed);
+  }
+
+  // Approximate number of values in the queue, it's exact if there are no concurrent pushes.
+  size_t GetSize() const
+  {
+    return m_enqueuePos.load(std::memory_order_relaxed) - m_dequeuePos.load(std::memory_order_relaxed);
+  }
+
+  size_t GetCapacity() const { return m_mask + 1; }
+
+private:
+  // Producers and the consumer change different positions, so they are kept
+  // in different cache lines.
+  static size_t constexpr kCacheLineSize = 64;
+
+  struct Cell
+  {
+    std::atomic<size_t> m_sequence;
+    T m_value;
+  };
+
+  // Returns the cell for the value at |pos| or nullptr if the queue is full.
+  Cell * Reserve(size_t & pos)
+  {
+    pos = m_enqueuePos.load(std::memory_order_relaxed);
+    while (true)
+    {
+      Cell * cell = &m_cells[pos & m_mask];
+      size_t const seq = cell->m_sequence.load(std::memory_order_acquire);
+      auto const diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          return cell;
+      }
+      else if (diff < 0)
+      {
+        // The cell keeps a value of the previous lap.
+        return nullptr;
+      }
+      else
+      {
+        pos = m_enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void Publish(Cell & cell, size_t pos, T && value)
+  {
+    cell.m_value = std::move(value);
+    cell.m_sequence.store(pos + 1, std::memory_order_release);
+  }
+
+  size_t const m_mask;
+  std::unique_ptr<Cell[]> m_cells;
+  alignas(kCacheLineSize) std::atomic<size_t> m_enqueuePos{0};
+  alignas(kCacheLineSize) std::atomic<size_t> m_dequeuePos{0};
+
+  DISALLOW_COPY_AND_MOVE(BoundedMpscQueue);
+};
+}  // namespace threads
@@ -0,0 +1,269 @@
+#include "base/thread_pool_work_stealing.hpp"
+
+#include "base/logging.hpp"
+
+#include "std/target_os.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+#if defined(OMIM_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace base
+{
+namespace
+{
+// Pool and index of the worker which runs on the current thread, tasks pushed by a worker
+// go to its own deque, other tasks go to the pool's injection queue.
+thread_local WorkStealingThreadPool const * t_pool = nullptr;
+thread_local size_t t_workerIndex = 0;
+
+void PinThread(std::thread & thread, size_t cpu)
+{
+#if defined(OMIM_OS_LINUX)
+  auto const cpusCount = std::thread::hardware_concurrency();
+  if (cpusCount == 0)
+    return;
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu % cpusCount, &cpus);
+  if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) != 0)
+    LOG(LWARNING, ("Can't pin a worker thread to cpu", cpu % cpusCount));
+#else
+  UNUSED_VALUE(thread);
+  UNUSED_VALUE(cpu);
+#endif
+}
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t threadsCount, bool pinThreads)
+{
+  CHECK_GREATER(threadsCount, 0, ());
+
+  m_workers.reserve(threadsCount);
+  for (size_t i = 0; i < threadsCount; ++i)
+    m_workers.push_back(std::make_unique<Worker>());
+
+  m_threads.reserve(threadsCount);
+  try
+  {
+    for (size_t i = 0; i < threadsCount; ++i)
+    {
+      m_threads.emplace_back(&WorkStealingThreadPool::WorkerLoop, this, i);
+      if (pinThreads)
+        PinThread(m_threads.back(), i);
+    }
+  }
+  catch (...)  // std::system_error etc.
+  {
+    Stop();
+    Shutdown();
+    throw;
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+  Shutdown();
+}
+
+bool WorkStealingThreadPool::Push(Task && task)
+{
+  if (m_done.load())
+    return false;
+
+  // The counter is increased first, so it never goes below the real number of tasks.
+  // It pairs with the sleepers increment in WorkerLoop: either the worker sees the pending task
+  // or we see the sleeping worker.
+  m_pendingCount.fetch_add(1);
+
+  if (t_pool == this)
+  {
+    auto & worker = *m_workers[t_workerIndex];
+    std::lock_guard lock(worker.m_mutex);
+    worker.m_tasks.push_back(std::move(task));
+  }
+  else
+  {
+    std::lock_guard lock(m_injectedMutex);
+    m_injectedTasks.push_back(std::move(task));
+  }
+
+  if (m_sleepersCount.load() > 0)
+  {
+    std::lock_guard lock(m_sleepMutex);
+    m_condition.notify_one();
+  }
+  return true;
+}
+
+bool WorkStealingThreadPool::TryRunPendingTask()
+{
+  Task task;
+  bool const found = t_pool == this ? PopTask(t_workerIndex, task)
+                                    : PopInjectedTask(task) || StealTask(m_workers.size(), task);
+  if (!found)
+    return false;
+
+  task();
+  return true;
+}
+
+bool WorkStealingThreadPool::PopTask(size_t index, Task & task)
+{
+  {
+    auto & worker = *m_workers[index];
+    std::lock_guard lock(worker.m_mutex);
+    if (!worker.m_tasks.empty())
+    {
+      task = std::move(worker.m_tasks.back());
+      worker.m_tasks.pop_back();
+      m_pendingCount.fetch_sub(1);
+      return true;
+    }
+  }
+  return PopInjectedTask(task) || StealTask(index, task);
+}
+
+bool WorkStealingThreadPool::PopInjectedTask(Task & task)
+{
+  if (m_pendingCount.load() == 0)
+    return false;
+
+  std::lock_guard lock(m_injectedMutex);
+  if (m_injectedTasks.empty())
+    return false;
+
+  task = std::move(m_injectedTasks.front());
+  m_injectedTasks.pop_front();
+  m_pendingCount.fetch_sub(1);
+  return true;
+}
+
+bool WorkStealingThreadPool::StealTask(size_t thiefIndex, Task & task)
+{
+  if (m_pendingCount.load() == 0)
+    return false;
+
+  // Start with the next worker, so thieves don't rush to the same victim.
+  size_t const count = m_workers.size();
+  for (size_t i = 1; i <= count; ++i)
+  {
+    size_t const victim = (thiefIndex + i) % count;
+    if (victim == thiefIndex)
+      continue;
+
+    auto & worker = *m_workers[victim];
+    std::lock_guard lock(worker.m_mutex);
+    if (!worker.m_tasks.empty())
+    {
+      task = std::move(worker.m_tasks.front());
+      worker.m_tasks.pop_front();
+      m_pendingCount.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::WorkerLoop(size_t index)
+{
+  t_pool = this;
+  t_workerIndex = index;
+
+  while (true)
+  {
+    Task task;
+    if (PopTask(index, task))
+    {
+      task();
+      continue;
+    }
+
+    std::unique_lock lock(m_sleepMutex);
+    m_sleepersCount.fetch_add(1);
+    m_condition.wait(lock, [this] { return m_done.load() || m_pendingCount.load() > 0; });
+    m_sleepersCount.fetch_sub(1);
+
+    if (m_done.load() && m_pendingCount.load() == 0)
+      return;
+  }
+}
+
+void WorkStealingThreadPool::Stop()
+{
+  m_done.store(true);
+
+  // Destruction of a task may report to its TaskGroup, so the tasks are destroyed
+  // without the workers' locks.
+  std::deque<Task> dropped;
+  for (auto & worker : m_workers)
+  {
+    std::lock_guard lock(worker->m_mutex);
+    m_pendingCount.fetch_sub(worker->m_tasks.size());
+    std::move(worker->m_tasks.begin(), worker->m_tasks.end(), std::back_inserter(dropped));
+    worker->m_tasks.clear();
+  }
+  {
+    std::lock_guard lock(m_injectedMutex);
+    m_pendingCount.fetch_sub(m_injectedTasks.size());
+    std::move(m_injectedTasks.begin(), m_injectedTasks.end(), std::back_inserter(dropped));
+    m_injectedTasks.clear();
+  }
+  dropped.clear();
+
+  std::lock_guard lock(m_sleepMutex);
+  m_condition.notify_all();
+}
+
+void WorkStealingThreadPool::WaitingStop()
+{
+  Shutdown();
+}
+
+void WorkStealingThreadPool::Shutdown()
+{
+  {
+    std::lock_guard lock(m_sleepMutex);
+    m_done.store(true);
+    m_condition.notify_all();
+  }
+
+  for (auto & thread : m_threads)
+  {
+    if (thread.joinable())
+      thread.join();
+  }
+}
+
+void TaskGroup::Wait()
+{
+  using namespace std::chrono_literals;
+
+  while (m_pendingCount.load() > 0)
+  {
+    if (m_pool.TryRunPendingTask())
+      continue;
+
+    // The rest of the tasks are running. They may push new tasks, so the wait is limited
+    // to help with them.
+    std::unique_lock lock(m_mutex);
+    m_condition.wait_for(lock, 1ms, [this] { return m_pendingCount.load() == 0; });
+  }
+
+  // The last task may still hold the mutex, the group can't be destroyed until it's released.
+  std::lock_guard lock(m_mutex);
+}
+
+void TaskGroup::OnTaskFinished()
+{
+  std::lock_guard lock(m_mutex);
+  if (m_pendingCount.fetch_sub(1) == 1)
+    m_condition.notify_all();
+}
+}  // namespace base
@@ -0,0 +1,257 @@
+#pragma once
+
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+#include "base/thread_utils.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace base
+{
+// Thread pool where every worker has its own deque of tasks.
+// A worker pushes and pops tasks at the back of its deque, so nested tasks are run in LIFO
+// order by the same thread. Tasks pushed from other threads go to a shared injection queue
+// and are started in FIFO order, like in a usual thread pool, when workers have no nested
+// tasks. An idle worker steals the oldest task from the front of the other workers' deques.
+// Warning: WorkStealingThreadPool works with std::thread instead of SimpleThread and therefore
+// should not be used when the JVM is needed.
+class WorkStealingThreadPool
+{
+public:
+  using Task = threads::FunctionWrapper;
+
+  // |pinThreads| binds worker i to cpu i, so neighbour workers (which steal tasks from each other
+  // first) share caches and the NUMA node. It's supported on Linux only.
+  // Warning: The constructor may throw exceptions.
+  explicit WorkStealingThreadPool(size_t threadsCount, bool pinThreads = false);
+
+  // Runs all pending tasks and joins threads.
+  ~WorkStealingThreadPool();
+
+  // Returns false and leaves |task| untouched if the pool is stopped.
+  bool Push(Task && task);
+
+  template <typename F, typename... Args>
+  auto Submit(F && func, Args &&... args) -> std::future<decltype(func(args...))>
+  {
+    using ResultType = decltype(func(args...));
+    std::packaged_task<ResultType()> task(std::bind(std::forward<F>(func),
+                                                    std::forward<Args>(args)...));
+    std::future<ResultType> result(task.get_future());
+    if (!Push(Task(std::move(task))))
+      return {};
+    return result;
+  }
+
+  // Runs one pending task on the calling thread. It lets a thread which waits for some tasks
+  // help to run them instead of blocking a worker.
+  // Returns false if there are no pending tasks.
+  bool TryRunPendingTask();
+
+  // Removes the tasks that are not yet started. Running tasks are not waited for,
+  // threads are joined by the destructor. Removed tasks are destroyed without running,
+  // the tasks of a TaskGroup are reported as finished then.
+  void Stop();
+  // Runs all pending tasks and joins threads.
+  void WaitingStop();
+
+  size_t GetThreadsCount() const { return m_threads.size(); }
+
+private:
+  struct Worker
+  {
+    std::mutex m_mutex;
+    std::deque<Task> m_tasks;
+  };
+
+  bool PopTask(size_t index, Task & task);
+  bool PopInjectedTask(Task & task);
+  bool StealTask(size_t thiefIndex, Task & task);
+  void WorkerLoop(size_t index);
+  void Shutdown();
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::vector<std::thread> m_threads;
+
+  // Tasks which are pushed not from the workers.
+  std::mutex m_injectedMutex;
+  std::deque<Task> m_injectedTasks;
+
+  std::atomic<size_t> m_pendingCount{0};
+  std::atomic<size_t> m_sleepersCount{0};
+  std::atomic<bool> m_done{false};
+
+  std::mutex m_sleepMutex;
+  std::condition_variable m_condition;
+
+  DISALLOW_COPY_AND_MOVE(WorkStealingThreadPool);
+};
+
+// A group of tasks which may be waited for and cancelled together.
+class TaskGroup
+{
+public:
+  explicit TaskGroup(WorkStealingThreadPool & pool) : m_pool(pool) {}
+  ~TaskGroup() { Wait(); }
+
+  // |func| is run on the calling thread if the pool is stopped. Tasks which are removed by
+  // WorkStealingThreadPool::Stop() before they are started are not run, but they don't
+  // block Wait().
+  template <typename F>
+  void Run(F && func)
+  {
+    m_pendingCount.fetch_add(1);
+    WorkStealingThreadPool::Task task([this, guard = FinishGuard(*this), func = std::forward<F>(func)]() mutable
+    {
+      if (!IsCancelled())
+        func();
+    });
+
+    // The task is left untouched if the pool is stopped.
+    if (!m_pool.Push(std::move(task)))
+      task();
+  }
+
+  // Waits for all the tasks of the group. The calling thread runs pending tasks of the pool
+  // while waiting, so it's safe to wait from a task of the same pool.
+  void Wait();
+
+  // Tasks which are not started yet are skipped. Running tasks may check IsCancelled()
+  // to finish earlier.
+  void Cancel() { m_isCancelled.store(true); }
+  bool IsCancelled() const { return m_isCancelled.load(); }
+
+private:
+  // Reports that a task is finished when the task is destroyed, i.e. after it's run
+  // or when it's dropped by the pool without running.
+  class FinishGuard
+  {
+  public:
+    explicit FinishGuard(TaskGroup & group) : m_group(&group) {}
+    FinishGuard(FinishGuard && other) : m_group(other.m_group) { other.m_group = nullptr; }
+    ~FinishGuard()
+    {
+      if (m_group)
+        m_group->OnTaskFinished();
+    }
+
+  private:
+    TaskGroup * m_group;
+
+    DISALLOW_COPY(FinishGuard);
+  };
+
+  void OnTaskFinished();
+
+  WorkStealingThreadPool & m_pool;
+  std::atomic<size_t> m_pendingCount{0};
+  std::atomic<bool> m_isCancelled{false};
+
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+
+  DISALLOW_COPY_AND_MOVE(TaskGroup);
+};
+
+namespace impl
+{
+// Splits [begin, end) into chunks of at least |grainSize| elements, there are a few chunks
+// per thread so the chunks of a slow thread may be stolen.
+inline std::vector<std::pair<size_t, size_t>> SplitIntoChunks(WorkStealingThreadPool const & pool, size_t begin,
+                                                             size_t end, size_t grainSize)
+{
+  size_t constexpr kChunksPerThread = 4;
+  size_t const count = end - begin;
+  size_t const maxChunks = std::max<size_t>(pool.GetThreadsCount() * kChunksPerThread, 1);
+  size_t const chunkSize = std::max({grainSize, (count + maxChunks - 1) / maxChunks, size_t{1}});
+
+  std::vector<std::pair<size_t, size_t>> chunks;
+  for (size_t b = begin; b < end; b += chunkSize)
+    chunks.emplace_back(b, std::min(b + chunkSize, end));
+  return chunks;
+}
+}  // namespace impl
+
+// Calls fn(i) for every i of [begin, end) on the pool's threads and the calling thread.
+// If the pool is stopped meanwhile, the chunks it drops are run on the calling thread.
+template <typename Fn>
+void ParallelFor(WorkStealingThreadPool & pool, size_t begin, size_t end, Fn && fn, size_t grainSize = 1)
+{
+  if (begin >= end)
+    return;
+
+  auto const chunks = impl::SplitIntoChunks(pool, begin, end, grainSize);
+  // Every chunk sets its own flag, so there are no races on the flags.
+  std::vector<uint8_t> done(chunks.size(), 0);
+  {
+    TaskGroup group(pool);
+    for (size_t chunk = 0; chunk < chunks.size(); ++chunk)
+    {
+      group.Run([&fn, &done, chunk, b = chunks[chunk].first, e = chunks[chunk].second]()
+      {
+        for (size_t i = b; i < e; ++i)
+          fn(i);
+        done[chunk] = 1;
+      });
+    }
+    group.Wait();
+  }
+
+  for (size_t chunk = 0; chunk < chunks.size(); ++chunk)
+  {
+    if (!done[chunk])
+    {
+      for (size_t i = chunks[chunk].first; i < chunks[chunk].second; ++i)
+        fn(i);
+    }
+  }
+}
+
+// Calls map(b, e) for subranges of [begin, end) in parallel and folds the results with
+// |init| in the order of subranges: reduce(reduce(init, map(b0, e0)), map(b1, e1))...
+// So |reduce| doesn't have to be commutative.
+// If the pool is stopped meanwhile, the subranges it drops are mapped on the calling thread.
+template <typename T, typename Map, typename Reduce>
+T ParallelReduce(WorkStealingThreadPool & pool, size_t begin, size_t end, T init, Map && map,
+                 Reduce && reduce, size_t grainSize = 1)
+{
+  if (begin >= end)
+    return init;
+
+  auto const chunks = impl::SplitIntoChunks(pool, begin, end, grainSize);
+  std::vector<std::optional<T>> partial(chunks.size());
+  {
+    TaskGroup group(pool);
+    for (size_t chunk = 0; chunk < chunks.size(); ++chunk)
+    {
+      group.Run([&map, &partial, chunk, b = chunks[chunk].first, e = chunks[chunk].second]()
+      {
+        partial[chunk] = map(b, e);
+      });
+    }
+    group.Wait();
+  }
+
+  for (size_t chunk = 0; chunk < chunks.size(); ++chunk)
+  {
+    auto & p = partial[chunk];
+    if (!p)
+      p = map(chunks[chunk].first, chunks[chunk].second);
+    init = reduce(std::move(init), std::move(*p));
+  }
+  return init;
+}
+}  // namespace base
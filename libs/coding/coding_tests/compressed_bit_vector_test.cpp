@@ -3,11 +3,16 @@
 #include "coding/compressed_bit_vector.hpp"
 #include "coding/writer.hpp"
 
+#include "base/logging.hpp"
+#include "base/timer.hpp"
+
 #include <algorithm>
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <random>
 #include <set>
+#include <string>
 #include <vector>
 
 using namespace std;
@@ -472,3 +477,197 @@ UNIT_TEST(CompressedBitVector_SparseLeaveFirstNBits)
   for (uint64_t bit = 0; bit < (1 << 10); ++bit)
     TEST(!cbv->GetBit(bit), (bit));
 }
+
+UNIT_TEST(CompressedBitVector_SerializationChunked)
+{
+  // Runs, an array and a bitmap in chunks which are far from each other.
+  uint64_t constexpr kArrayStart = 100 * coding::ChunkedCBV::kChunkSize;
+  uint64_t constexpr kBitmapStart = 1000 * coding::ChunkedCBV::kChunkSize;
+  vector<uint64_t> setBits;
+  for (uint64_t i = 0; i < 5000; ++i)
+    setBits.push_back(i);
+  for (uint64_t i = 0; i < 1000; ++i)
+    setBits.push_back(kArrayStart + i * 7);
+  for (uint64_t i = 0; i < 30000; ++i)
+    setBits.push_back(kBitmapStart + i * 2);
+
+  vector<uint8_t> buf;
+  {
+    auto cbv = coding::CompressedBitVectorBuilder::FromBitPositions(setBits);
+    TEST_EQUAL(coding::CompressedBitVector::StorageStrategy::Chunked, cbv->GetStorageStrategy(), ());
+
+    auto const & chunked = static_cast<coding::ChunkedCBV const &>(*cbv);
+    using ContainerType = coding::ChunkedCBV::ContainerType;
+    TEST_EQUAL(chunked.NumChunks(), 3, ());
+    TEST_EQUAL(chunked.GetContainer(0).GetType(), ContainerType::Runs, ());
+    TEST_EQUAL(chunked.GetContainer(1).GetType(), ContainerType::Array, ());
+    TEST_EQUAL(chunked.GetContainer(2).GetType(), ContainerType::Bitmap, ());
+
+    // The persistent format is the same as the sparse bit vector gives.
+    vector<uint8_t> sparseBuf;
+    {
+      MemWriter<vector<uint8_t>> writer(buf);
+      cbv->Serialize(writer);
+    }
+    {
+      MemWriter<vector<uint8_t>> writer(sparseBuf);
+      coding::SparseCBV(setBits).Serialize(writer);
+    }
+    TEST_EQUAL(buf, sparseBuf, ());
+
+    buf.clear();
+    MemWriter<vector<uint8_t>> writer(buf);
+    cbv->SerializeWithStrategy(writer);
+  }
+  MemReader reader(buf.data(), buf.size());
+  auto cbv = coding::CompressedBitVectorBuilder::DeserializeFromReader(reader);
+  TEST(cbv.get(), ());
+  TEST_EQUAL(coding::CompressedBitVector::StorageStrategy::Chunked, cbv->GetStorageStrategy(), ());
+  TEST_EQUAL(setBits.size(), cbv->PopCount(), ());
+
+  vector<uint64_t> actual;
+  coding::CompressedBitVectorEnumerator::ForEach(*cbv, [&actual](uint64_t bit) { actual.push_back(bit); });
+  TEST_EQUAL(actual, setBits, ());
+  TEST(!cbv->GetBit(5000), ());
+  TEST(!cbv->GetBit(kArrayStart + 1), ());
+  TEST(!cbv->GetBit(kBitmapStart + 1), ());
+
+  auto const first = cbv->LeaveFirstSetNBits(5500);
+  TEST_EQUAL(first->PopCount(), 5500, ());
+  TEST(first->GetBit(kArrayStart + 499 * 7), ());
+  TEST(!first->GetBit(kArrayStart + 500 * 7), ());
+}
+
+UNIT_TEST(CompressedBitVector_ChunkedOps)
+{
+  using coding::CompressedBitVector;
+  using Strategy = CompressedBitVector::StorageStrategy;
+
+  // Clustered sets: groups of consecutive bits spread over a large range.
+  mt19937 rng(0);
+  auto const makeClusters = [&rng](uint64_t numClusters, uint64_t range)
+  {
+    uniform_int_distribution<uint64_t> start(0, range);
+    uniform_int_distribution<uint64_t> length(1, 3000);
+    set<uint64_t> bits;
+    for (uint64_t i = 0; i < numClusters; ++i)
+    {
+      uint64_t const s = start(rng);
+      for (uint64_t j = 0, n = length(rng); j < n; ++j)
+        bits.insert(s + j);
+    }
+    return vector<uint64_t>(bits.begin(), bits.end());
+  };
+
+  vector<uint64_t> dense;
+  for (uint64_t i = 0; i < 2000000; i += 2)
+    dense.push_back(i);
+  vector<uint64_t> sparse;
+  for (uint64_t i = 0; i < 100; ++i)
+    sparse.push_back(i * 19997);
+
+  vector<vector<uint64_t>> const sets = {makeClusters(100, 2000000), makeClusters(300, 100000000),
+                                         dense, sparse};
+  auto const cbv = coding::CompressedBitVectorBuilder::FromBitPositions(sets[0]);
+  TEST_EQUAL(cbv->GetStorageStrategy(), Strategy::Chunked, ());
+  TEST_EQUAL(coding::CompressedBitVectorBuilder::FromBitPositions(sets[1])->GetStorageStrategy(),
+             Strategy::Chunked, ());
+
+  auto const toVector = [](CompressedBitVector const & cbv)
+  {
+    vector<uint64_t> setBits;
+    coding::CompressedBitVectorEnumerator::ForEach(cbv, [&setBits](uint64_t bit) { setBits.push_back(bit); });
+    return setBits;
+  };
+
+  for (auto setBits1 : sets)
+  {
+    for (auto setBits2 : sets)
+    {
+      auto const cbv1 = coding::CompressedBitVectorBuilder::FromBitPositions(setBits1);
+      auto const cbv2 = coding::CompressedBitVectorBuilder::FromBitPositions(setBits2);
+      auto const strategies = make_pair(cbv1->GetStorageStrategy(), cbv2->GetStorageStrategy());
+
+      vector<uint64_t> expected;
+      Intersect(setBits1, setBits2, expected);
+      TEST_EQUAL(toVector(*CompressedBitVector::Intersect(*cbv1, *cbv2)), expected, (strategies));
+
+      expected.clear();
+      Subtract(setBits1, setBits2, expected);
+      TEST_EQUAL(toVector(*CompressedBitVector::Subtract(*cbv1, *cbv2)), expected, (strategies));
+
+      expected.clear();
+      Union(setBits1, setBits2, expected);
+      TEST_EQUAL(toVector(*CompressedBitVector::Union(*cbv1, *cbv2)), expected, (strategies));
+    }
+  }
+}
+
+// Checks operations on bit vectors with densities which are typical for search retrieval
+// (features matching a token in an mwm of a few million features) and logs their timings.
+UNIT_TEST(CompressedBitVector_OpsBenchmark)
+{
+  uint64_t constexpr kNumBits = 2000000;
+  size_t constexpr kIterations = 10;
+
+  mt19937 rng(0);
+  auto const makeBits = [&rng](double density)
+  {
+    bernoulli_distribution dist(density);
+    vector<uint64_t> setBits;
+    for (uint64_t i = 0; i < kNumBits; ++i)
+    {
+      if (dist(rng))
+        setBits.push_back(i);
+    }
+    return setBits;
+  };
+
+  auto const toVector = [](coding::CompressedBitVector const & cbv)
+  {
+    vector<uint64_t> setBits;
+    coding::CompressedBitVectorEnumerator::ForEach(cbv, [&setBits](uint64_t bit) { setBits.push_back(bit); });
+    return setBits;
+  };
+
+  using Op = unique_ptr<coding::CompressedBitVector> (*)(coding::CompressedBitVector const &,
+                                                         coding::CompressedBitVector const &);
+  using RefOp = void (*)(vector<uint64_t> &, vector<uint64_t> &, vector<uint64_t> &);
+  struct NamedOp
+  {
+    string m_name;
+    Op m_op;
+    RefOp m_refOp;
+  };
+  vector<NamedOp> const ops = {
+      {"Intersect", &coding::CompressedBitVector::Intersect, &Intersect},
+      {"Subtract", &coding::CompressedBitVector::Subtract, &Subtract},
+      {"Union", &coding::CompressedBitVector::Union, &Union}};
+
+  vector<pair<double, double>> const densities = {
+      {0.5, 0.35}, {0.4, 0.005}, {0.005, 0.4}, {0.01, 0.02}, {0.0001, 0.05}};
+
+  for (auto const & [density1, density2] : densities)
+  {
+    auto setBits1 = makeBits(density1);
+    auto setBits2 = makeBits(density2);
+    auto const cbv1 = coding::CompressedBitVectorBuilder::FromBitPositions(setBits1);
+    auto const cbv2 = coding::CompressedBitVectorBuilder::FromBitPositions(setBits2);
+
+    for (auto const & op : ops)
+    {
+      vector<uint64_t> expected;
+      op.m_refOp(setBits1, setBits2, expected);
+
+      base::Timer timer;
+      unique_ptr<coding::CompressedBitVector> res;
+      for (size_t i = 0; i < kIterations; ++i)
+        res = op.m_op(*cbv1, *cbv2);
+      auto const elapsed = timer.ElapsedSeconds() / kIterations;
+
+      TEST_EQUAL(toVector(*res), expected, (op.m_name, density1, density2));
+      LOG(LINFO, (op.m_name, cbv1->GetStorageStrategy(), density1, cbv2->GetStorageStrategy(),
+                  density2, "ms:", elapsed * 1000));
+    }
+  }
+}
@@ -58,6 +58,28 @@ UNIT_TEST(FileData_ApiSmoke)
   TEST(!base::GetFileSize(name2, sz), ());
 }
 
+UNIT_TEST(FileData_WriteAt)
+{
+  {
+    base::FileData f(name1, base::FileData::Op::WRITE_TRUNCATE);
+    f.Truncate(10);
+    // Parts are written out of order.
+    f.WriteAt(6, "6789", 4);
+    f.WriteAt(0, "012", 3);
+    f.WriteAt(3, "345", 3);
+  }
+
+  {
+    base::FileData f(name1, base::FileData::Op::READ);
+    TEST_EQUAL(f.Size(), 10, ());
+    char buffer[10];
+    f.Read(0, buffer, sizeof(buffer));
+    TEST_EQUAL(std::string(buffer, sizeof(buffer)), "0123456789", ());
+  }
+
+  TEST(base::DeleteFileX(name1), ());
+}
+
 /*
 UNIT_TEST(FileData_NoDiskSpace)
 {
@@ -2,6 +2,9 @@
 
 #include "coding/sha1.hpp"
 
+#include <algorithm>
+#include <string>
+
 
 namespace sha1_test
 {
@@ -40,4 +43,20 @@ UNIT_TEST(SHA1_Smoke)
   for (size_t i = 0; i < std::size(bytes); ++i)
     TEST_EQUAL(SHA1::CalculateForString(bytes[i]), encoded[i], ());
 }
+
+UNIT_TEST(SHA1_Calculator)
+{
+  std::string const str = "Organic Maps is the ultimate companion app for travellers, tourists, hikers, and cyclists!";
+  auto const expected = SHA1::CalculateForString(str);
+
+  for (size_t partSize : {1, 7, 64, 100})
+  {
+    SHA1::Calculator calculator;
+    for (size_t i = 0; i < str.size(); i += partSize)
+      calculator.Update(str.data() + i, std::min(partSize, str.size() - i));
+    TEST_EQUAL(calculator.GetHash(), expected, (partSize));
+  }
+
+  TEST_EQUAL(SHA1::ToBase64(expected).size(), 28, ());
+}
 }
@@ -5,7 +5,14 @@
 #include "base/assert.hpp"
 
 #include <algorithm>
+#include <array>
 #include <bit>
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CBV_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
 
 namespace coding
 {
@@ -13,8 +20,382 @@ using std::make_unique, std::max, std::min, std::unique_ptr, std::vector;
 
 namespace
 {
+// Bitwise operations on bit groups of dense CBVs. AVX2 version is chosen at runtime when
+// the cpu supports it, otherwise the scalar loop is used which is vectorized by the compiler
+// with the baseline instruction set (SSE2 or NEON).
+enum class GroupsOp
+{
+  And,
+  AndNot,
+  Or
+};
+
+template <GroupsOp op>
+uint64_t ApplyToGroup(uint64_t a, uint64_t b)
+{
+  if constexpr (op == GroupsOp::And)
+    return a & b;
+  else if constexpr (op == GroupsOp::AndNot)
+    return a & ~b;
+  else
+    return a | b;
+}
+
+template <GroupsOp op>
+void ApplyToGroupsScalar(uint64_t const * a, uint64_t const * b, uint64_t * res, size_t size)
+{
+  for (size_t i = 0; i < size; ++i)
+    res[i] = ApplyToGroup<op>(a[i], b[i]);
+}
+
+#ifdef CBV_AVX2_DISPATCH
+template <GroupsOp op>
+__attribute__((target("avx2"))) void ApplyToGroupsAvx2(uint64_t const * a, uint64_t const * b,
+                                                       uint64_t * res, size_t size)
+{
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+  {
+    __m256i const x = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(a + i));
+    __m256i const y = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(b + i));
+    __m256i r;
+    if constexpr (op == GroupsOp::And)
+      r = _mm256_and_si256(x, y);
+    else if constexpr (op == GroupsOp::AndNot)
+      r = _mm256_andnot_si256(y, x);
+    else
+      r = _mm256_or_si256(x, y);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(res + i), r);
+  }
+
+  for (; i < size; ++i)
+    res[i] = ApplyToGroup<op>(a[i], b[i]);
+}
+#endif  // CBV_AVX2_DISPATCH
+
+template <GroupsOp op>
+void ApplyToGroups(uint64_t const * a, uint64_t const * b, uint64_t * res, size_t size)
+{
+#ifdef CBV_AVX2_DISPATCH
+  static bool const kHasAvx2 = __builtin_cpu_supports("avx2");
+  if (kHasAvx2)
+  {
+    ApplyToGroupsAvx2<op>(a, b, res, size);
+    return;
+  }
+#endif
+  ApplyToGroupsScalar<op>(a, b, res, size);
+}
+
+// The ratio of sizes of sparse CBVs when galloping intersection is faster than the linear one.
+size_t constexpr kGallopingRatio = 32;
+
+// Intersects sorted |small| and |large| by exponential search of each |small| element in |large|.
+void GallopingIntersection(vector<uint64_t> const & small, vector<uint64_t> const & large,
+                           vector<uint64_t> & res)
+{
+  auto lo = large.begin();
+  for (auto const v : small)
+  {
+    // Find a range where the first element which is not less than |v| is.
+    auto hi = lo;
+    size_t step = 1;
+    while (hi != large.end() && *hi < v)
+    {
+      lo = hi + 1;
+      hi = static_cast<size_t>(large.end() - hi) > step ? hi + step : large.end();
+      step *= 2;
+    }
+
+    lo = std::lower_bound(lo, hi, v);
+    if (lo == large.end())
+      return;
+    if (*lo == v)
+    {
+      res.push_back(v);
+      ++lo;
+    }
+  }
+}
+
+bool IsBitSet(vector<uint64_t> const & groups, uint64_t pos)
+{
+  auto const i = static_cast<size_t>(pos / DenseCBV::kBlockSize);
+  return i < groups.size() && ((groups[i] >> (pos % DenseCBV::kBlockSize)) & 1) != 0;
+}
+
+using Container = ChunkedCBV::Container;
+using ContainerType = ChunkedCBV::ContainerType;
+
+// Returns true if a bit vector with popCount bits set out of totalBits
+// is fit to be represented as a DenseCBV. Note that we do not
+// account for possible irregularities in the distribution of bits.
+// In particular, we do not break the bit vector into blocks that are
+// stored separately although this might turn out to be a good idea.
+bool DenseEnough(uint64_t popCount, uint64_t totalBits)
+{
+  // Settle at 30% for now.
+  return popCount * 10 >= totalBits * 3;
+}
+
+// Memory which is needed for a chunk besides its container data.
+uint64_t constexpr kChunkOverhead = sizeof(uint64_t) + sizeof(Container);
+
+// ChunkedCBV is considered for large bit vectors only, the small ones are cheap anyway.
+uint64_t constexpr kMinChunkedPopCount = 1024;
+
+// Returns true if ChunkedCBV of |chunkedSize| bytes is worth using instead of the dense
+// or sparse bit vector which is chosen by DenseEnough().
+bool ChunkedEnough(uint64_t chunkedSize, uint64_t popCount, uint64_t maxBit)
+{
+  if (popCount < kMinChunkedPopCount)
+    return false;
+
+  uint64_t const size = DenseEnough(popCount, maxBit)
+                            ? (maxBit / DenseCBV::kBlockSize + 1) * sizeof(uint64_t)
+                            : popCount * sizeof(uint64_t);
+  return chunkedSize * 2 < size;
+}
+
+uint64_t ChunkSize(uint32_t popCount, uint32_t runsCount)
+{
+  return kChunkOverhead +
+         Container::GetSize(Container::GetBestType(popCount, runsCount), popCount, runsCount);
+}
+
+// Returns the size of ChunkedCBV for sorted |setBits|.
+uint64_t EstimateChunkedSizeByPositions(vector<uint64_t> const & setBits)
+{
+  uint64_t size = 0;
+  uint32_t popCount = 0;
+  uint32_t runsCount = 0;
+  for (size_t i = 0; i < setBits.size(); ++i)
+  {
+    if (i != 0 && setBits[i] / ChunkedCBV::kChunkSize != setBits[i - 1] / ChunkedCBV::kChunkSize)
+    {
+      size += ChunkSize(popCount, runsCount);
+      popCount = 0;
+      runsCount = 0;
+    }
+
+    if (popCount == 0 || setBits[i] != setBits[i - 1] + 1)
+      ++runsCount;
+    ++popCount;
+  }
+  return popCount == 0 ? size : size + ChunkSize(popCount, runsCount);
+}
+
+// Returns the number of runs of set bits in |group|. |prevGroup| is the previous bit group,
+// a run which continues from it is not counted.
+uint32_t RunsCount(uint64_t group, uint64_t prevGroup)
+{
+  return std::popcount(group & ~((group << 1) | (prevGroup >> (DenseCBV::kBlockSize - 1))));
+}
+
+// Returns the size of ChunkedCBV for |bitGroups|.
+uint64_t EstimateChunkedSizeByGroups(vector<uint64_t> const & bitGroups)
+{
+  uint64_t size = 0;
+  for (size_t begin = 0; begin < bitGroups.size(); begin += ChunkedCBV::kBitmapSize)
+  {
+    size_t const end = min(bitGroups.size(), begin + ChunkedCBV::kBitmapSize);
+    uint32_t popCount = 0;
+    uint32_t runsCount = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+      popCount += std::popcount(bitGroups[i]);
+      runsCount += RunsCount(bitGroups[i], i == begin ? 0 : bitGroups[i - 1]);
+    }
+    if (popCount != 0)
+      size += ChunkSize(popCount, runsCount);
+  }
+  return size;
+}
+
+// Sets bits [first, last] in |bitmap|.
+void SetRange(uint64_t * bitmap, uint32_t first, uint32_t last)
+{
+  uint64_t constexpr kFull = std::numeric_limits<uint64_t>::max();
+  size_t const firstGroup = first / DenseCBV::kBlockSize;
+  size_t const lastGroup = last / DenseCBV::kBlockSize;
+  uint64_t const firstMask = kFull << (first % DenseCBV::kBlockSize);
+  uint64_t const lastMask = kFull >> (DenseCBV::kBlockSize - 1 - last % DenseCBV::kBlockSize);
+  if (firstGroup == lastGroup)
+  {
+    bitmap[firstGroup] |= firstMask & lastMask;
+    return;
+  }
+
+  bitmap[firstGroup] |= firstMask;
+  for (size_t i = firstGroup + 1; i < lastGroup; ++i)
+    bitmap[i] = kFull;
+  bitmap[lastGroup] |= lastMask;
+}
+
+template <typename Fn>
+Container FilterArray(Container const & array, Fn && fn)
+{
+  vector<uint16_t> res;
+  copy_if(array.GetValues().begin(), array.GetValues().end(), back_inserter(res), fn);
+  return Container::FromPositions(res);
+}
+
+Container ApplyToContainers(GroupsOp op, Container const & a, Container const & b)
+{
+  bool const isArrayA = a.GetType() == ContainerType::Array;
+  bool const isArrayB = b.GetType() == ContainerType::Array;
+  if (isArrayA && isArrayB)
+  {
+    auto const & va = a.GetValues();
+    auto const & vb = b.GetValues();
+    vector<uint16_t> res;
+    switch (op)
+    {
+    case GroupsOp::And: set_intersection(va.begin(), va.end(), vb.begin(), vb.end(), back_inserter(res)); break;
+    case GroupsOp::AndNot: set_difference(va.begin(), va.end(), vb.begin(), vb.end(), back_inserter(res)); break;
+    case GroupsOp::Or: set_union(va.begin(), va.end(), vb.begin(), vb.end(), back_inserter(res)); break;
+    }
+    return Container::FromPositions(res);
+  }
+
+  if (op == GroupsOp::And && isArrayA)
+    return FilterArray(a, [&b](uint16_t v) { return b.GetBit(v); });
+  if (op == GroupsOp::And && isArrayB)
+    return FilterArray(b, [&a](uint16_t v) { return a.GetBit(v); });
+  if (op == GroupsOp::AndNot && isArrayA)
+    return FilterArray(a, [&b](uint16_t v) { return !b.GetBit(v); });
+
+  std::array<uint64_t, ChunkedCBV::kBitmapSize> bitmapA, bitmapB, res;
+  a.ToBitmap(bitmapA.data());
+  b.ToBitmap(bitmapB.data());
+  switch (op)
+  {
+  case GroupsOp::And: ApplyToGroups<GroupsOp::And>(bitmapA.data(), bitmapB.data(), res.data(), res.size()); break;
+  case GroupsOp::AndNot: ApplyToGroups<GroupsOp::AndNot>(bitmapA.data(), bitmapB.data(), res.data(), res.size()); break;
+  case GroupsOp::Or: ApplyToGroups<GroupsOp::Or>(bitmapA.data(), bitmapB.data(), res.data(), res.size()); break;
+  }
+  return Container::FromBitmap(res.data());
+}
+
+uint64_t GetMaxBit(ChunkedCBV const & cbv)
+{
+  ASSERT_GREATER(cbv.NumChunks(), 0, ());
+  size_t const last = cbv.NumChunks() - 1;
+  return cbv.GetKey(last) * ChunkedCBV::kChunkSize + cbv.GetContainer(last).GetLastBit();
+}
+
+// Converts |cbv| to the dense or sparse bit vector which is chosen by DenseEnough(),
+// i.e. to the same bit vector the builders make when ChunkedCBV is not worth it.
+unique_ptr<CompressedBitVector> ToDenseOrSparse(ChunkedCBV const & cbv)
+{
+  if (cbv.NumChunks() == 0)
+    return make_unique<SparseCBV>();
+
+  uint64_t const maxBit = GetMaxBit(cbv);
+  if (DenseEnough(cbv.PopCount(), maxBit))
+  {
+    vector<uint64_t> groups(static_cast<size_t>(maxBit / DenseCBV::kBlockSize + 1));
+    for (size_t i = 0; i < cbv.NumChunks(); ++i)
+    {
+      std::array<uint64_t, ChunkedCBV::kBitmapSize> bitmap;
+      cbv.GetContainer(i).ToBitmap(bitmap.data());
+      size_t const begin = static_cast<size_t>(cbv.GetKey(i)) * ChunkedCBV::kBitmapSize;
+      std::copy(bitmap.begin(), bitmap.begin() + min(bitmap.size(), groups.size() - begin),
+                groups.begin() + begin);
+    }
+    return DenseCBV::BuildFromBitGroups(std::move(groups));
+  }
+
+  vector<uint64_t> setBits;
+  setBits.reserve(static_cast<size_t>(cbv.PopCount()));
+  cbv.ForEach([&setBits](uint64_t bit) { setBits.push_back(bit); });
+  return make_unique<SparseCBV>(std::move(setBits));
+}
+
+// Converts |cbv| to the dense or sparse bit vector if ChunkedCBV is not worth it.
+unique_ptr<CompressedBitVector> ChooseStrategy(unique_ptr<ChunkedCBV> cbv)
+{
+  if (cbv->NumChunks() == 0)
+    return make_unique<SparseCBV>();
+
+  if (ChunkedEnough(cbv->GetMemorySize(), cbv->PopCount(), GetMaxBit(*cbv)))
+    return cbv;
+
+  return ToDenseOrSparse(*cbv);
+}
+
+unique_ptr<ChunkedCBV> ToChunked(CompressedBitVector const & cbv)
+{
+  switch (cbv.GetStorageStrategy())
+  {
+  case CompressedBitVector::StorageStrategy::Dense:
+    return ChunkedCBV::BuildFromBitGroups(static_cast<DenseCBV const &>(cbv).GetBitGroups());
+  case CompressedBitVector::StorageStrategy::Sparse:
+    return ChunkedCBV::BuildFromBitPositions(static_cast<SparseCBV const &>(cbv).GetPositions());
+  case CompressedBitVector::StorageStrategy::Chunked: break;
+  }
+  UNREACHABLE();
+}
+
+// Applies |op| chunk by chunk. Chunks which are present in one vector only are copied
+// or skipped without looking into their containers.
+unique_ptr<CompressedBitVector> ApplyChunked(GroupsOp op, ChunkedCBV const & a, ChunkedCBV const & b)
+{
+  vector<uint64_t> keys;
+  vector<Container> containers;
+  auto const add = [&keys, &containers](uint64_t key, Container && container)
+  {
+    if (container.PopCount() == 0)
+      return;
+    keys.push_back(key);
+    containers.push_back(std::move(container));
+  };
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < a.NumChunks() || j < b.NumChunks())
+  {
+    if (j == b.NumChunks() || (i < a.NumChunks() && a.GetKey(i) < b.GetKey(j)))
+    {
+      if (op != GroupsOp::And)
+        add(a.GetKey(i), Container(a.GetContainer(i)));
+      ++i;
+    }
+    else if (i == a.NumChunks() || b.GetKey(j) < a.GetKey(i))
+    {
+      if (op == GroupsOp::Or)
+        add(b.GetKey(j), Container(b.GetContainer(j)));
+      ++j;
+    }
+    else
+    {
+      add(a.GetKey(i), ApplyToContainers(op, a.GetContainer(i), b.GetContainer(j)));
+      ++i;
+      ++j;
+    }
+  }
+
+  return ChooseStrategy(make_unique<ChunkedCBV>(std::move(keys), std::move(containers)));
+}
+
+unique_ptr<CompressedBitVector> ApplyChunked(GroupsOp op, CompressedBitVector const & lhs,
+                                             CompressedBitVector const & rhs)
+{
+  using strat = CompressedBitVector::StorageStrategy;
+  unique_ptr<ChunkedCBV> lhsChunked, rhsChunked;
+  if (lhs.GetStorageStrategy() != strat::Chunked)
+    lhsChunked = ToChunked(lhs);
+  if (rhs.GetStorageStrategy() != strat::Chunked)
+    rhsChunked = ToChunked(rhs);
+
+  return ApplyChunked(op, lhsChunked ? *lhsChunked : static_cast<ChunkedCBV const &>(lhs),
+                      rhsChunked ? *rhsChunked : static_cast<ChunkedCBV const &>(rhs));
+}
+
 struct IntersectOp
 {
+  static GroupsOp constexpr kGroupsOp = GroupsOp::And;
+
   IntersectOp() {}
 
   unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
@@ -23,8 +404,8 @@ struct IntersectOp
     size_t const sizeA = a.NumBitGroups();
     size_t const sizeB = b.NumBitGroups();
     vector<uint64_t> resGroups(min(sizeA, sizeB));
-    for (size_t i = 0; i < resGroups.size(); ++i)
-      resGroups[i] = a.GetBitGroup(i) & b.GetBitGroup(i);
+    ApplyToGroups<GroupsOp::And>(a.GetBitGroups().data(), b.GetBitGroups().data(), resGroups.data(),
+                                 resGroups.size());
     return coding::CompressedBitVectorBuilder::FromBitGroups(std::move(resGroups));
   }
 
@@ -32,12 +413,14 @@ struct IntersectOp
   unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
                                                      coding::SparseCBV const & b) const
   {
+    auto const & groups = a.GetBitGroups();
+    uint64_t const bitsEnd = groups.size() * DenseCBV::kBlockSize;
+
     vector<uint64_t> resPos;
-    for (size_t i = 0; i < b.PopCount(); ++i)
+    for (auto it = b.Begin(); it != b.End() && *it < bitsEnd; ++it)
     {
-      auto pos = b.Select(i);
-      if (a.GetBit(pos))
-        resPos.push_back(pos);
+      if (IsBitSet(groups, *it))
+        resPos.push_back(*it);
     }
     return make_unique<coding::SparseCBV>(std::move(resPos));
   }
@@ -51,14 +434,22 @@ struct IntersectOp
   unique_ptr<coding::CompressedBitVector> operator()(coding::SparseCBV const & a,
                                                      coding::SparseCBV const & b) const
   {
+    auto const & small = a.PopCount() <= b.PopCount() ? a : b;
+    auto const & large = a.PopCount() <= b.PopCount() ? b : a;
+
     vector<uint64_t> resPos;
-    set_intersection(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
+    if (small.PopCount() * kGallopingRatio < large.PopCount())
+      GallopingIntersection(small.GetPositions(), large.GetPositions(), resPos);
+    else
+      set_intersection(a.Begin(), a.End(), b.Begin(), b.End(), back_inserter(resPos));
     return make_unique<coding::SparseCBV>(std::move(resPos));
   }
 };
 
 struct SubtractOp
 {
+  static GroupsOp constexpr kGroupsOp = GroupsOp::AndNot;
+
   SubtractOp() {}
 
   unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
@@ -66,9 +457,12 @@ struct SubtractOp
   {
     size_t const sizeA = a.NumBitGroups();
     size_t const sizeB = b.NumBitGroups();
-    vector<uint64_t> resGroups(min(sizeA, sizeB));
-    for (size_t i = 0; i < resGroups.size(); ++i)
-      resGroups[i] = a.GetBitGroup(i) & ~b.GetBitGroup(i);
+    vector<uint64_t> resGroups(sizeA);
+    size_t const commonSize = min(sizeA, sizeB);
+    ApplyToGroups<GroupsOp::AndNot>(a.GetBitGroups().data(), b.GetBitGroups().data(),
+                                    resGroups.data(), commonSize);
+    std::copy(a.GetBitGroups().begin() + commonSize, a.GetBitGroups().end(),
+              resGroups.begin() + commonSize);
     return CompressedBitVectorBuilder::FromBitGroups(std::move(resGroups));
   }
 
@@ -103,10 +497,11 @@ struct SubtractOp
   unique_ptr<coding::CompressedBitVector> operator()(coding::SparseCBV const & a,
                                                      coding::DenseCBV const & b) const
   {
+    auto const & groups = b.GetBitGroups();
     vector<uint64_t> resPos;
-    copy_if(a.Begin(), a.End(), back_inserter(resPos), [&](uint64_t bit)
+    copy_if(a.Begin(), a.End(), back_inserter(resPos), [&groups](uint64_t bit)
             {
-              return !b.GetBit(bit);
+              return !IsBitSet(groups, bit);
             });
     return CompressedBitVectorBuilder::FromBitPositions(std::move(resPos));
   }
@@ -122,6 +517,8 @@ struct SubtractOp
 
 struct UnionOp
 {
+  static GroupsOp constexpr kGroupsOp = GroupsOp::Or;
+
   UnionOp() {}
 
   unique_ptr<coding::CompressedBitVector> operator()(coding::DenseCBV const & a,
@@ -133,18 +530,10 @@ struct UnionOp
     size_t commonSize = min(sizeA, sizeB);
     size_t resultSize = max(sizeA, sizeB);
     vector<uint64_t> resGroups(resultSize);
-    for (size_t i = 0; i < commonSize; ++i)
-      resGroups[i] = a.GetBitGroup(i) | b.GetBitGroup(i);
-    if (a.NumBitGroups() == resultSize)
-    {
-      for (size_t i = commonSize; i < resultSize; ++i)
-        resGroups[i] = a.GetBitGroup(i);
-    }
-    else
-    {
-      for (size_t i = commonSize; i < resultSize; ++i)
-        resGroups[i] = b.GetBitGroup(i);
-    }
+    ApplyToGroups<GroupsOp::Or>(a.GetBitGroups().data(), b.GetBitGroups().data(), resGroups.data(),
+                                commonSize);
+    auto const & longer = sizeA == resultSize ? a.GetBitGroups() : b.GetBitGroups();
+    std::copy(longer.begin() + commonSize, longer.end(), resGroups.begin() + commonSize);
     return CompressedBitVectorBuilder::FromBitGroups(std::move(resGroups));
   }
 
@@ -220,6 +609,8 @@ unique_ptr<coding::CompressedBitVector> Apply(TBinaryOp const & op, CompressedBi
   using strat = CompressedBitVector::StorageStrategy;
   auto const stratA = lhs.GetStorageStrategy();
   auto const stratB = rhs.GetStorageStrategy();
+  if (stratA == strat::Chunked || stratB == strat::Chunked)
+    return ApplyChunked(TBinaryOp::kGroupsOp, lhs, rhs);
   if (stratA == strat::Dense && stratB == strat::Dense)
   {
     DenseCBV const & a = static_cast<DenseCBV const &>(lhs);
@@ -248,17 +639,6 @@ unique_ptr<coding::CompressedBitVector> Apply(TBinaryOp const & op, CompressedBi
   return nullptr;
 }
 
-// Returns true if a bit vector with popCount bits set out of totalBits
-// is fit to be represented as a DenseCBV. Note that we do not
-// account for possible irregularities in the distribution of bits.
-// In particular, we do not break the bit vector into blocks that are
-// stored separately although this might turn out to be a good idea.
-bool DenseEnough(uint64_t popCount, uint64_t totalBits)
-{
-  // Settle at 30% for now.
-  return popCount * 10 >= totalBits * 3;
-}
-
 template <typename TBitPositions>
 unique_ptr<CompressedBitVector> BuildFromBitPositions(TBitPositions && setBits)
 {
@@ -266,6 +646,12 @@ unique_ptr<CompressedBitVector> BuildFromBitPositions(TBitPositions && setBits)
     return make_unique<SparseCBV>(std::forward<TBitPositions>(setBits));
   uint64_t const maxBit = *max_element(setBits.begin(), setBits.end());
 
+  if (setBits.size() >= kMinChunkedPopCount && is_sorted(setBits.begin(), setBits.end()) &&
+      ChunkedEnough(EstimateChunkedSizeByPositions(setBits), setBits.size(), maxBit))
+  {
+    return ChunkedCBV::BuildFromBitPositions(setBits);
+  }
+
   if (DenseEnough(setBits.size(), maxBit))
     return make_unique<DenseCBV>(std::forward<TBitPositions>(setBits));
 
@@ -417,6 +803,310 @@ unique_ptr<CompressedBitVector> SparseCBV::Clone() const
   return unique_ptr<CompressedBitVector>(cbv);
 }
 
+// ChunkedCBV::Container ---------------------------------------------------------------------------
+// static
+ChunkedCBV::Container ChunkedCBV::Container::FromBitmap(uint64_t const * bitmap)
+{
+  uint32_t popCount = 0;
+  uint32_t runsCount = 0;
+  for (size_t i = 0; i < kBitmapSize; ++i)
+  {
+    popCount += std::popcount(bitmap[i]);
+    runsCount += RunsCount(bitmap[i], i == 0 ? 0 : bitmap[i - 1]);
+  }
+
+  Container c;
+  c.m_type = GetBestType(popCount, runsCount);
+  c.m_popCount = popCount;
+  switch (c.m_type)
+  {
+  case ContainerType::Bitmap: c.m_bitmap.assign(bitmap, bitmap + kBitmapSize); break;
+  case ContainerType::Array:
+    c.m_values.reserve(popCount);
+    for (size_t i = 0; i < kBitmapSize; ++i)
+    {
+      for (uint64_t group = bitmap[i]; group != 0; group &= group - 1)
+        c.m_values.push_back(static_cast<uint16_t>(DenseCBV::kBlockSize * i + std::countr_zero(group)));
+    }
+    break;
+  case ContainerType::Runs:
+    c.m_values.reserve(2 * runsCount);
+    for (size_t i = 0; i < kBitmapSize; ++i)
+    {
+      uint64_t const group = bitmap[i];
+      uint64_t const prevTop = i == 0 ? 0 : bitmap[i - 1] >> (DenseCBV::kBlockSize - 1);
+      uint64_t const nextBottom = i + 1 == kBitmapSize ? 0 : bitmap[i + 1] & 1;
+      // Bits which start and finish runs.
+      for (uint64_t starts = group & ~((group << 1) | prevTop); starts != 0; starts &= starts - 1)
+        c.m_values.push_back(static_cast<uint16_t>(DenseCBV::kBlockSize * i + std::countr_zero(starts)));
+      for (uint64_t ends = group & ~((group >> 1) | (nextBottom << (DenseCBV::kBlockSize - 1))); ends != 0;
+           ends &= ends - 1)
+      {
+        c.m_values.push_back(static_cast<uint16_t>(DenseCBV::kBlockSize * i + std::countr_zero(ends)));
+      }
+    }
+    // Starts and ends are pushed by groups, so they are sorted together.
+    sort(c.m_values.begin(), c.m_values.end());
+    break;
+  }
+  return c;
+}
+
+// static
+ChunkedCBV::Container ChunkedCBV::Container::FromPositions(vector<uint16_t> const & positions)
+{
+  ASSERT(is_sorted(positions.begin(), positions.end()), ());
+  auto const popCount = static_cast<uint32_t>(positions.size());
+  uint32_t runsCount = 0;
+  for (size_t i = 0; i < positions.size(); ++i)
+  {
+    if (i == 0 || positions[i] != positions[i - 1] + 1)
+      ++runsCount;
+  }
+
+  Container c;
+  c.m_type = GetBestType(popCount, runsCount);
+  c.m_popCount = popCount;
+  switch (c.m_type)
+  {
+  case ContainerType::Array: c.m_values = positions; break;
+  case ContainerType::Bitmap:
+    c.m_bitmap.resize(kBitmapSize);
+    for (auto const v : positions)
+      c.m_bitmap[v / DenseCBV::kBlockSize] |= static_cast<uint64_t>(1) << (v % DenseCBV::kBlockSize);
+    break;
+  case ContainerType::Runs:
+    c.m_values.reserve(2 * runsCount);
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+      if (i == 0 || positions[i] != positions[i - 1] + 1)
+        c.m_values.push_back(positions[i]);
+      if (i + 1 == positions.size() || positions[i + 1] != positions[i] + 1)
+        c.m_values.push_back(positions[i]);
+    }
+    break;
+  }
+  return c;
+}
+
+// static
+ChunkedCBV::ContainerType ChunkedCBV::Container::GetBestType(uint32_t popCount, uint32_t runsCount)
+{
+  auto const arraySize = GetSize(ContainerType::Array, popCount, runsCount);
+  auto const bitmapSize = GetSize(ContainerType::Bitmap, popCount, runsCount);
+  auto const runsSize = GetSize(ContainerType::Runs, popCount, runsCount);
+  if (runsSize < min(arraySize, bitmapSize))
+    return ContainerType::Runs;
+  return arraySize <= bitmapSize ? ContainerType::Array : ContainerType::Bitmap;
+}
+
+// static
+size_t ChunkedCBV::Container::GetSize(ContainerType type, uint32_t popCount, uint32_t runsCount)
+{
+  switch (type)
+  {
+  case ContainerType::Array: return popCount * sizeof(uint16_t);
+  case ContainerType::Bitmap: return kBitmapSize * sizeof(uint64_t);
+  case ContainerType::Runs: return 2 * runsCount * sizeof(uint16_t);
+  }
+  UNREACHABLE();
+}
+
+bool ChunkedCBV::Container::GetBit(uint16_t pos) const
+{
+  switch (m_type)
+  {
+  case ContainerType::Array: return binary_search(m_values.begin(), m_values.end(), pos);
+  case ContainerType::Bitmap:
+    return ((m_bitmap[pos / DenseCBV::kBlockSize] >> (pos % DenseCBV::kBlockSize)) & 1) != 0;
+  case ContainerType::Runs:
+  {
+    // The first value which is greater than |pos|. Odd index means |pos| is inside a run,
+    // even index means |pos| is between runs, equal to a run's end is handled separately.
+    auto const it = upper_bound(m_values.begin(), m_values.end(), pos);
+    auto const i = static_cast<size_t>(it - m_values.begin());
+    return i % 2 == 1 || (i != 0 && m_values[i - 1] == pos);
+  }
+  }
+  UNREACHABLE();
+}
+
+uint16_t ChunkedCBV::Container::GetLastBit() const
+{
+  ASSERT_NOT_EQUAL(m_popCount, 0, ());
+  if (m_type != ContainerType::Bitmap)
+    return m_values.back();
+
+  for (size_t i = kBitmapSize; i > 0; --i)
+  {
+    if (m_bitmap[i - 1] != 0)
+      return static_cast<uint16_t>(DenseCBV::kBlockSize * (i - 1) + bits::FloorLog(m_bitmap[i - 1]));
+  }
+  UNREACHABLE();
+}
+
+size_t ChunkedCBV::Container::GetSize() const
+{
+  return m_type == ContainerType::Bitmap ? m_bitmap.size() * sizeof(uint64_t)
+                                         : m_values.size() * sizeof(uint16_t);
+}
+
+void ChunkedCBV::Container::ToBitmap(uint64_t * bitmap) const
+{
+  switch (m_type)
+  {
+  case ContainerType::Bitmap: std::copy(m_bitmap.begin(), m_bitmap.end(), bitmap); return;
+  case ContainerType::Array:
+    std::fill(bitmap, bitmap + kBitmapSize, 0);
+    for (auto const v : m_values)
+      bitmap[v / DenseCBV::kBlockSize] |= static_cast<uint64_t>(1) << (v % DenseCBV::kBlockSize);
+    return;
+  case ContainerType::Runs:
+    std::fill(bitmap, bitmap + kBitmapSize, 0);
+    for (size_t i = 0; i < m_values.size(); i += 2)
+      SetRange(bitmap, m_values[i], m_values[i + 1]);
+    return;
+  }
+}
+
+void ChunkedCBV::Container::UpdatePopCount()
+{
+  m_popCount = 0;
+  switch (m_type)
+  {
+  case ContainerType::Array: m_popCount = static_cast<uint32_t>(m_values.size()); break;
+  case ContainerType::Bitmap:
+    for (auto const group : m_bitmap)
+      m_popCount += std::popcount(group);
+    break;
+  case ContainerType::Runs:
+    CHECK_EQUAL(m_values.size() % 2, 0, ());
+    for (size_t i = 0; i < m_values.size(); i += 2)
+      m_popCount += m_values[i + 1] - m_values[i] + 1;
+    break;
+  }
+}
+
+// ChunkedCBV --------------------------------------------------------------------------------------
+// static
+uint64_t const ChunkedCBV::kChunkSize;
+// static
+size_t const ChunkedCBV::kBitmapSize;
+
+ChunkedCBV::ChunkedCBV(vector<uint64_t> && keys, vector<Container> && containers)
+  : m_keys(std::move(keys)), m_containers(std::move(containers))
+{
+  ASSERT_EQUAL(m_keys.size(), m_containers.size(), ());
+  ASSERT(is_sorted(m_keys.begin(), m_keys.end()), ());
+  for (auto const & c : m_containers)
+    m_popCount += c.PopCount();
+}
+
+// static
+unique_ptr<ChunkedCBV> ChunkedCBV::BuildFromBitPositions(vector<uint64_t> const & setBits)
+{
+  ASSERT(is_sorted(setBits.begin(), setBits.end()), ());
+  vector<uint64_t> keys;
+  vector<Container> containers;
+  vector<uint16_t> positions;
+  for (size_t i = 0; i < setBits.size(); ++i)
+  {
+    positions.push_back(static_cast<uint16_t>(setBits[i] % kChunkSize));
+    if (i + 1 == setBits.size() || setBits[i + 1] / kChunkSize != setBits[i] / kChunkSize)
+    {
+      keys.push_back(setBits[i] / kChunkSize);
+      containers.push_back(Container::FromPositions(positions));
+      positions.clear();
+    }
+  }
+  return make_unique<ChunkedCBV>(std::move(keys), std::move(containers));
+}
+
+// static
+unique_ptr<ChunkedCBV> ChunkedCBV::BuildFromBitGroups(vector<uint64_t> const & bitGroups)
+{
+  vector<uint64_t> keys;
+  vector<Container> containers;
+  std::array<uint64_t, kBitmapSize> bitmap;
+  for (size_t begin = 0; begin < bitGroups.size(); begin += kBitmapSize)
+  {
+    size_t const end = min(bitGroups.size(), begin + kBitmapSize);
+    if (all_of(bitGroups.begin() + begin, bitGroups.begin() + end, [](uint64_t g) { return g == 0; }))
+      continue;
+
+    std::fill(std::copy(bitGroups.begin() + begin, bitGroups.begin() + end, bitmap.begin()), bitmap.end(), 0);
+    keys.push_back(begin / kBitmapSize);
+    containers.push_back(Container::FromBitmap(bitmap.data()));
+  }
+  return make_unique<ChunkedCBV>(std::move(keys), std::move(containers));
+}
+
+uint64_t ChunkedCBV::GetMemorySize() const
+{
+  uint64_t size = 0;
+  for (auto const & c : m_containers)
+    size += kChunkOverhead + c.GetSize();
+  return size;
+}
+
+uint64_t ChunkedCBV::PopCount() const { return m_popCount; }
+
+bool ChunkedCBV::GetBit(uint64_t pos) const
+{
+  auto const it = lower_bound(m_keys.begin(), m_keys.end(), pos / kChunkSize);
+  if (it == m_keys.end() || *it != pos / kChunkSize)
+    return false;
+  return m_containers[it - m_keys.begin()].GetBit(static_cast<uint16_t>(pos % kChunkSize));
+}
+
+unique_ptr<CompressedBitVector> ChunkedCBV::LeaveFirstSetNBits(uint64_t n) const
+{
+  if (PopCount() <= n)
+    return Clone();
+
+  vector<uint64_t> setBits;
+  setBits.reserve(static_cast<size_t>(n));
+  ForEach([&setBits, n](uint64_t bit)
+  {
+    if (setBits.size() == n)
+      return base::ControlFlow::Break;
+    setBits.push_back(bit);
+    return base::ControlFlow::Continue;
+  });
+  return CompressedBitVectorBuilder::FromBitPositions(std::move(setBits));
+}
+
+CompressedBitVector::StorageStrategy ChunkedCBV::GetStorageStrategy() const
+{
+  return CompressedBitVector::StorageStrategy::Chunked;
+}
+
+void ChunkedCBV::Serialize(Writer & writer) const
+{
+  // Chunked storage is not a part of the persistent format, the same bits are written
+  // exactly as the dense or sparse bit vector built from them.
+  ToDenseOrSparse(*this)->Serialize(writer);
+}
+
+void ChunkedCBV::SerializeWithStrategy(Writer & writer) const
+{
+  uint8_t header = static_cast<uint8_t>(GetStorageStrategy());
+  WriteToSink(writer, header);
+  WriteVarUint(writer, static_cast<uint64_t>(m_keys.size()));
+  uint64_t prevKey = 0;
+  for (size_t i = 0; i < m_keys.size(); ++i)
+  {
+    WriteVarUint(writer, m_keys[i] - prevKey);
+    prevKey = m_keys[i];
+    m_containers[i].Serialize(writer);
+  }
+}
+
+unique_ptr<CompressedBitVector> ChunkedCBV::Clone() const
+{
+  return make_unique<ChunkedCBV>(vector<uint64_t>(m_keys), vector<Container>(m_containers));
+}
+
 // static
 unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitPositions(
     vector<uint64_t> const & setBits)
@@ -447,19 +1137,20 @@ unique_ptr<CompressedBitVector> CompressedBitVectorBuilder::FromBitGroups(
   for (size_t i = 0; i < bitGroups.size(); ++i)
     popCount += std::popcount(bitGroups[i]);
 
+  if (popCount >= kMinChunkedPopCount && ChunkedEnough(EstimateChunkedSizeByGroups(bitGroups), popCount, maxBit))
+    return ChunkedCBV::BuildFromBitGroups(bitGroups);
+
   if (DenseEnough(popCount, maxBit))
     return DenseCBV::BuildFromBitGroups(std::move(bitGroups));
 
   vector<uint64_t> setBits;
+  setBits.reserve(static_cast<size_t>(popCount));
   for (size_t i = 0; i < bitGroups.size(); ++i)
   {
-    for (size_t j = 0; j < kBlockSize; ++j)
-    {
-      if (((bitGroups[i] >> j) & 1) > 0)
-        setBits.push_back(kBlockSize * i + j);
-    }
+    for (uint64_t group = bitGroups[i]; group != 0; group &= group - 1)
+      setBits.push_back(kBlockSize * i + std::countr_zero(group));
   }
-  return make_unique<SparseCBV>(setBits);
+  return make_unique<SparseCBV>(std::move(setBits));
 }
 
 std::string DebugPrint(CompressedBitVector::StorageStrategy strat)
@@ -468,6 +1159,18 @@ std::string DebugPrint(CompressedBitVector::StorageStrategy strat)
   {
   case CompressedBitVector::StorageStrategy::Dense: return "Dense";
   case CompressedBitVector::StorageStrategy::Sparse: return "Sparse";
+  case CompressedBitVector::StorageStrategy::Chunked: return "Chunked";
+  }
+  UNREACHABLE();
+}
+
+std::string DebugPrint(ChunkedCBV::ContainerType type)
+{
+  switch (type)
+  {
+  case ChunkedCBV::ContainerType::Array: return "Array";
+  case ChunkedCBV::ContainerType::Bitmap: return "Bitmap";
+  case ChunkedCBV::ContainerType::Runs: return "Runs";
   }
   UNREACHABLE();
 }
@@ -2,12 +2,15 @@
 
 #include "coding/read_write_utils.hpp"
 #include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
 #include "coding/writer.hpp"
 
 #include "base/assert.hpp"
 #include "base/control_flow.hpp"
 #include "base/ref_counted.hpp"
 
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -23,7 +26,8 @@ public:
   enum class StorageStrategy
   {
     Dense,
-    Sparse
+    Sparse,
+    Chunked
   };
 
   virtual ~CompressedBitVector() = default;
@@ -71,7 +75,8 @@ public:
 
   // Writes the contents of a bit vector to writer.
   // The first byte is always the header that defines the format.
-  // Currently the header is 0 or 1 for Dense and Sparse strategies respectively.
+  // Currently the header is 0 or 1 for Dense and Sparse strategies respectively,
+  // ChunkedCBV is written as the dense or sparse bit vector with the same bits.
   // It is easier to dispatch via virtual method calls and not bother
   // with template TWriters here as we do in similar places in our code.
   // This should not pose too much a problem because commonly
@@ -80,6 +85,11 @@ public:
   // code in old_compressed_bit_vector.{c,h}pp.
   virtual void Serialize(Writer & writer) const = 0;
 
+  // Same as Serialize() but keeps the storage strategy, ChunkedCBV is written with the header 2.
+  // Only the builds with ChunkedCBV can read it, so it must not be used for mwm sections
+  // or other shipped data, only for the files of in-process caches.
+  virtual void SerializeWithStrategy(Writer & writer) const { Serialize(writer); }
+
   // Copies a bit vector and returns a pointer to the copy.
   virtual std::unique_ptr<CompressedBitVector> Clone() const = 0;
 };
@@ -102,6 +112,7 @@ public:
   static std::unique_ptr<DenseCBV> BuildFromBitGroups(std::vector<uint64_t> && bitGroups);
 
   size_t NumBitGroups() const { return m_bitGroups.size(); }
+  std::vector<uint64_t> const & GetBitGroups() const { return m_bitGroups; }
 
   template <typename Fn>
   void ForEach(Fn && f) const
@@ -109,13 +120,10 @@ public:
     base::ControlFlowWrapper<Fn> wrapper(std::forward<Fn>(f));
     for (size_t i = 0; i < m_bitGroups.size(); ++i)
     {
-      for (size_t j = 0; j < kBlockSize; ++j)
+      for (uint64_t group = m_bitGroups[i]; group != 0; group &= group - 1)
       {
-        if (((m_bitGroups[i] >> j) & 1) > 0)
-        {
-          if (wrapper(kBlockSize * i + j) == base::ControlFlow::Break)
-            return;
-        }
+        if (wrapper(kBlockSize * i + std::countr_zero(group)) == base::ControlFlow::Break)
+          return;
       }
     }
   }
@@ -172,12 +180,203 @@ public:
 
   inline TIterator Begin() const { return m_positions.cbegin(); }
   inline TIterator End() const { return m_positions.cend(); }
+  std::vector<uint64_t> const & GetPositions() const { return m_positions; }
 
 private:
   // 0-based positions of the set bits.
   std::vector<uint64_t> m_positions;
 };
 
+// Bit vector which is split into chunks of kChunkSize bits like Roaring bitmaps.
+// Every non-empty chunk is kept in the smallest container: a sorted array of set bits,
+// a bitmap or a sorted list of runs of set bits. It fits sets which are clustered
+// but span large ranges, when both dense and sparse vectors are too big.
+// It's an in-memory representation, Serialize() writes the dense or sparse format.
+class ChunkedCBV : public CompressedBitVector
+{
+public:
+  friend class CompressedBitVectorBuilder;
+  static uint64_t const kChunkSize = 1 << 16;
+  static size_t const kBitmapSize = kChunkSize / DenseCBV::kBlockSize;
+
+  enum class ContainerType : uint8_t
+  {
+    Array,
+    Bitmap,
+    Runs
+  };
+
+  class Container
+  {
+  public:
+    // Builds the smallest container by chunk's bitmap of kBitmapSize bit groups.
+    static Container FromBitmap(uint64_t const * bitmap);
+    // Builds the smallest container by sorted positions of chunk's set bits.
+    static Container FromPositions(std::vector<uint16_t> const & positions);
+
+    // Returns the type of the smallest container for a chunk with |popCount| set bits
+    // which form |runsCount| runs.
+    static ContainerType GetBestType(uint32_t popCount, uint32_t runsCount);
+    // Returns size of the container of |type| in bytes.
+    static size_t GetSize(ContainerType type, uint32_t popCount, uint32_t runsCount);
+
+    ContainerType GetType() const { return m_type; }
+    uint32_t PopCount() const { return m_popCount; }
+    bool GetBit(uint16_t pos) const;
+    uint16_t GetLastBit() const;
+    size_t GetSize() const;
+
+    // Set bits for arrays.
+    std::vector<uint16_t> const & GetValues() const { return m_values; }
+
+    // Fills |bitmap| of kBitmapSize bit groups.
+    void ToBitmap(uint64_t * bitmap) const;
+
+    template <typename Fn>
+    base::ControlFlow ForEach(Fn && fn) const
+    {
+      switch (m_type)
+      {
+      case ContainerType::Array:
+        for (auto const v : m_values)
+        {
+          if (fn(v) == base::ControlFlow::Break)
+            return base::ControlFlow::Break;
+        }
+        break;
+      case ContainerType::Bitmap:
+        for (size_t i = 0; i < m_bitmap.size(); ++i)
+        {
+          for (uint64_t group = m_bitmap[i]; group != 0; group &= group - 1)
+          {
+            auto const v = static_cast<uint16_t>(DenseCBV::kBlockSize * i + std::countr_zero(group));
+            if (fn(v) == base::ControlFlow::Break)
+              return base::ControlFlow::Break;
+          }
+        }
+        break;
+      case ContainerType::Runs:
+        for (size_t i = 0; i < m_values.size(); i += 2)
+        {
+          for (uint32_t v = m_values[i]; v <= m_values[i + 1]; ++v)
+          {
+            if (fn(static_cast<uint16_t>(v)) == base::ControlFlow::Break)
+              return base::ControlFlow::Break;
+          }
+        }
+        break;
+      }
+      return base::ControlFlow::Continue;
+    }
+
+    template <typename Sink>
+    void Serialize(Sink & sink) const
+    {
+      WriteToSink(sink, static_cast<uint8_t>(m_type));
+      if (m_type == ContainerType::Bitmap)
+      {
+        sink.Write(m_bitmap.data(), m_bitmap.size() * sizeof(uint64_t));
+      }
+      else
+      {
+        WriteVarUint(sink, static_cast<uint32_t>(m_values.size()));
+        sink.Write(m_values.data(), m_values.size() * sizeof(uint16_t));
+      }
+    }
+
+    template <typename Source>
+    static Container Deserialize(Source & src)
+    {
+      Container c;
+      c.m_type = static_cast<ContainerType>(ReadPrimitiveFromSource<uint8_t>(src));
+      switch (c.m_type)
+      {
+      case ContainerType::Bitmap:
+        c.m_bitmap.resize(kBitmapSize);
+        src.Read(c.m_bitmap.data(), c.m_bitmap.size() * sizeof(uint64_t));
+        break;
+      case ContainerType::Array:
+      case ContainerType::Runs:
+        c.m_values.resize(ReadVarUint<uint32_t>(src));
+        src.Read(c.m_values.data(), c.m_values.size() * sizeof(uint16_t));
+        break;
+      default: CHECK(false, ("Unknown container type", static_cast<int>(c.m_type)));
+      }
+      c.UpdatePopCount();
+      return c;
+    }
+
+  private:
+    void UpdatePopCount();
+
+    ContainerType m_type = ContainerType::Array;
+    uint32_t m_popCount = 0;
+    // Set bits for arrays, pairs of the first and the last set bits of runs for runs.
+    std::vector<uint16_t> m_values;
+    std::vector<uint64_t> m_bitmap;
+  };
+
+  ChunkedCBV() = default;
+  // |keys| are sorted indices of non-empty chunks.
+  ChunkedCBV(std::vector<uint64_t> && keys, std::vector<Container> && containers);
+
+  // |setBits| should be sorted.
+  static std::unique_ptr<ChunkedCBV> BuildFromBitPositions(std::vector<uint64_t> const & setBits);
+  static std::unique_ptr<ChunkedCBV> BuildFromBitGroups(std::vector<uint64_t> const & bitGroups);
+
+  size_t NumChunks() const { return m_keys.size(); }
+  uint64_t GetKey(size_t i) const { return m_keys[i]; }
+  Container const & GetContainer(size_t i) const { return m_containers[i]; }
+
+  // Returns approximate size of the bit vector in memory in bytes.
+  uint64_t GetMemorySize() const;
+
+  template <typename Fn>
+  void ForEach(Fn && f) const
+  {
+    base::ControlFlowWrapper<Fn> wrapper(std::forward<Fn>(f));
+    for (size_t i = 0; i < m_keys.size(); ++i)
+    {
+      uint64_t const base = m_keys[i] * kChunkSize;
+      auto const res = m_containers[i].ForEach([&wrapper, base](uint16_t v) { return wrapper(base + v); });
+      if (res == base::ControlFlow::Break)
+        return;
+    }
+  }
+
+  template <typename Source>
+  static std::unique_ptr<ChunkedCBV> Deserialize(Source & src)
+  {
+    auto const count = ReadVarUint<uint64_t>(src);
+    std::vector<uint64_t> keys;
+    std::vector<Container> containers;
+    uint64_t key = 0;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+      key += ReadVarUint<uint64_t>(src);
+      keys.push_back(key);
+      containers.push_back(Container::Deserialize(src));
+    }
+    return std::make_unique<ChunkedCBV>(std::move(keys), std::move(containers));
+  }
+
+  // CompressedBitVector overrides:
+  uint64_t PopCount() const override;
+  bool GetBit(uint64_t pos) const override;
+  std::unique_ptr<CompressedBitVector> LeaveFirstSetNBits(uint64_t n) const override;
+  StorageStrategy GetStorageStrategy() const override;
+  void Serialize(Writer & writer) const override;
+  void SerializeWithStrategy(Writer & writer) const override;
+  std::unique_ptr<CompressedBitVector> Clone() const override;
+
+private:
+  std::vector<uint64_t> m_keys;
+  std::vector<Container> m_containers;
+  uint64_t m_popCount = 0;
+};
+
+std::string DebugPrint(ChunkedCBV::ContainerType type);
+
 class CompressedBitVectorBuilder
 {
 public:
@@ -223,6 +422,7 @@ public:
       rw::ReadVectorOfPOD(src, setBits);
       return std::make_unique<SparseCBV>(std::move(setBits));
     }
+    case CompressedBitVector::StorageStrategy::Chunked: return ChunkedCBV::Deserialize(src);
     }
     return std::unique_ptr<CompressedBitVector>();
   }
@@ -252,6 +452,12 @@ public:
       sparseCBV.ForEach(f);
       return;
     }
+    case CompressedBitVector::StorageStrategy::Chunked:
+    {
+      ChunkedCBV const & chunkedCBV = static_cast<ChunkedCBV const &>(cbv);
+      chunkedCBV.ForEach(f);
+      return;
+    }
     }
   }
 };
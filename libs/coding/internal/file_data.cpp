@@ -21,7 +21,7 @@
 #ifdef OMIM_OS_WINDOWS
 #include <io.h>
 #else
-#include <unistd.h>  // ftruncate
+#include <unistd.h>  // ftruncate, pwrite
 #endif
 
 namespace base
@@ -143,6 +143,32 @@ void FileData::Write(void const * p, size_t size)
     MYTHROW(Writer::WriteException, (GetErrorProlog(), bytesWritten, size));
 }
 
+void FileData::WriteAt(uint64_t pos, void const * p, size_t size)
+{
+  ASSERT_NOT_EQUAL(m_Op, Op::APPEND, (m_FileName, m_Op, pos));
+#ifdef OMIM_OS_WINDOWS
+  Seek(pos);
+  Write(p, size);
+#else
+  auto const * data = static_cast<char const *>(p);
+  int const fd = fileno(m_File);
+  while (size > 0)
+  {
+    ssize_t const written = pwrite(fd, data, size, static_cast<off_t>(pos));
+    if (written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      MYTHROW(Writer::WriteException, (GetErrorProlog(), pos, size));
+    }
+
+    data += written;
+    pos += static_cast<uint64_t>(written);
+    size -= static_cast<size_t>(written);
+  }
+#endif
+}
+
 void FileData::Flush()
 {
   if (fflush(m_File))
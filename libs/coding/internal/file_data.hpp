@@ -25,6 +25,10 @@ public:
 
   void Read(uint64_t pos, void * p, size_t size);
   void Write(void const * p, size_t size);
+  /// Writes at |pos| without moving the file position and bypassing the stdio buffer, so writes
+  /// to different places of a file don't flush and refill the buffer.
+  /// Don't mix with Write() without Flush().
+  void WriteAt(uint64_t pos, void const * p, size_t size);
 
   void Flush();
   void Truncate(uint64_t sz);
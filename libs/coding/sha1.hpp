@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 namespace coding
@@ -16,5 +17,23 @@ public:
   static std::string CalculateBase64(std::string const & filePath);
 
   static Hash CalculateForString(std::string_view str);
+
+  static std::string ToBase64(Hash const & hash);
+
+  // Calculates a hash of the data which comes by parts, e.g. while a file is being downloaded.
+  class Calculator
+  {
+  public:
+    Calculator();
+    ~Calculator();
+
+    void Update(void const * data, size_t size);
+    // Calculator can't be updated after the hash is taken.
+    Hash GetHash();
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+  };
 };
 }  // coding
@@ -20,6 +20,7 @@
 //#define RENDER_STATISTIC
 //#define TILES_STATISTIC
 //#define GENERATING_STATISTIC
+//#define MESSAGE_QUEUE_STATISTIC
 
 //#define TRACK_GPU_MEM
 //#define TRACK_GLYPH_USAGE
@@ -299,7 +299,8 @@ void TextureManager::Init(ref_ptr<dp::GraphicsContext> context, Params const & p
   CHECK(!m_isInitialized, ());
 
   m_resPostfix = params.m_resPostfix;
-  m_textureAllocator = CreateAllocator(context);
+  m_textureAllocator = params.m_textureAllocatorFactory ? params.m_textureAllocatorFactory()
+                                                        : CreateAllocator(context);
 
   m_maxTextureSize = std::min(kMaxTextureSize, dp::SupportManager::Instance().GetMaxTextureSize());
   auto const apiVersion = context->GetApiVersion();
@@ -11,6 +11,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <list>
 #include <mutex>
 #include <string>
@@ -74,6 +75,9 @@ public:
     GlyphManager::Params m_glyphMngParams;
     std::string m_arrowTexturePath; // maybe empty if no custom texture
     bool m_arrowTextureUseDefaultResourceFolder = false;
+    // Creates the allocator of hardware textures. If it's empty, the allocator for the context's
+    // graphics API is used. Headless tools set it to work without a GPU.
+    std::function<drape_ptr<HWTextureAllocator>()> m_textureAllocatorFactory;
   };
 
   TextureManager();
@@ -774,14 +774,9 @@ void DrapeEngine::EnableTraffic(bool trafficEnabled)
 
 void DrapeEngine::UpdateTraffic(traffic::TrafficInfo const & info)
 {
-  if (info.GetColoring().empty())
+  if (info.GetColoring().IsEmpty())
     return;
 
-#ifdef DEBUG
-  for (auto const & segmentPair : info.GetColoring())
-    ASSERT_NOT_EQUAL(segmentPair.second, traffic::SpeedGroup::Unknown, ());
-#endif
-
   df::TrafficSegmentsColoring segmentsColoring;
   segmentsColoring.emplace(info.GetMwmId(), info.GetColoring());
 
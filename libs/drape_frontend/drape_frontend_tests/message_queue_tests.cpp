@@ -0,0 +1,200 @@
+#include "testing/testing.hpp"
+
+#include "drape_frontend/message.hpp"
+#include "drape_frontend/message_queue.hpp"
+
+#include "drape/pointers.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace message_queue_tests
+{
+using namespace df;
+using namespace std;
+
+class TestMessage : public Message
+{
+public:
+  TestMessage(Type type, size_t producer, size_t index)
+    : m_type(type), m_producer(producer), m_index(index)
+  {}
+
+  Type GetType() const override { return m_type; }
+
+  Type const m_type;
+  size_t const m_producer;
+  size_t const m_index;
+};
+
+void Push(MessageQueue & queue, MessagePriority priority, size_t index,
+          Message::Type type = Message::Type::Unknown, size_t producer = 0)
+{
+  queue.PushMessage(make_unique_dp<TestMessage>(type, producer, index), priority);
+}
+
+// Pops messages without waiting and returns their indices.
+vector<size_t> PopAll(MessageQueue & queue)
+{
+  vector<size_t> indices;
+  while (auto message = queue.PopMessage(false /* waitForMessage */))
+    indices.push_back(static_cast<TestMessage const &>(*message).m_index);
+  return indices;
+}
+
+UNIT_TEST(MessageQueue_Priorities)
+{
+  MessageQueue queue;
+  Push(queue, MessagePriority::Low, 0);
+  Push(queue, MessagePriority::Normal, 1);
+  Push(queue, MessagePriority::High, 2);
+  Push(queue, MessagePriority::Normal, 3);
+  Push(queue, MessagePriority::UberHighSingleton, 4, Message::Type::UpdateReadManager);
+  Push(queue, MessagePriority::High, 5);
+  Push(queue, MessagePriority::Low, 6);
+
+  TEST_EQUAL(PopAll(queue), vector<size_t>({4, 2, 5, 1, 3, 0, 6}), ());
+}
+
+UNIT_TEST(MessageQueue_UberHighSingleton)
+{
+  MessageQueue queue;
+  Push(queue, MessagePriority::UberHighSingleton, 0, Message::Type::UpdateReadManager);
+  Push(queue, MessagePriority::UberHighSingleton, 1, Message::Type::InvalidateReadManagerRect);
+  // The queued message of the same type wins.
+  Push(queue, MessagePriority::UberHighSingleton, 2, Message::Type::UpdateReadManager);
+  Push(queue, MessagePriority::Normal, 3, Message::Type::UpdateReadManager);
+
+  // Newer messages go first.
+  TEST_EQUAL(PopAll(queue), vector<size_t>({1, 0, 3}), ());
+
+  // A popped message doesn't block the next one of its type.
+  Push(queue, MessagePriority::UberHighSingleton, 4, Message::Type::UpdateReadManager);
+  TEST_EQUAL(PopAll(queue), vector<size_t>({4}), ());
+}
+
+UNIT_TEST(MessageQueue_Filtering)
+{
+  auto const isFiltered = [](ref_ptr<Message> message)
+  {
+    return message->GetType() == Message::Type::FlushTile;
+  };
+
+  MessageQueue queue;
+  Push(queue, MessagePriority::Normal, 0, Message::Type::FlushTile);
+  Push(queue, MessagePriority::Normal, 1);
+  queue.EnableMessageFiltering(isFiltered);
+
+  // Messages pushed while the filtering is enabled are filtered too, even if they are popped
+  // after the filtering is disabled.
+  Push(queue, MessagePriority::Normal, 2, Message::Type::FlushTile);
+  Push(queue, MessagePriority::Low, 3, Message::Type::FlushTile);
+  Push(queue, MessagePriority::Normal, 4);
+  queue.DisableMessageFiltering();
+
+  Push(queue, MessagePriority::Normal, 5, Message::Type::FlushTile);
+  TEST_EQUAL(PopAll(queue), vector<size_t>({1, 4, 5}), ());
+
+  Push(queue, MessagePriority::High, 6, Message::Type::FlushTile);
+  Push(queue, MessagePriority::High, 7);
+  queue.InstantFilter(isFiltered);
+  Push(queue, MessagePriority::High, 8, Message::Type::FlushTile);
+  TEST_EQUAL(PopAll(queue), vector<size_t>({7, 8}), ());
+}
+
+UNIT_TEST(MessageQueue_OverflowKeepsOrder)
+{
+  // Much more than a lane ring takes, so the rest spills into the overflow.
+  size_t constexpr kProducersCount = 4;
+  size_t constexpr kMessagesCount = 10000;
+
+  MessageQueue queue;
+  vector<thread> producers;
+  for (size_t producer = 0; producer < kProducersCount; ++producer)
+  {
+    producers.emplace_back([&queue, producer]()
+    {
+      for (size_t i = 0; i < kMessagesCount; ++i)
+        Push(queue, MessagePriority::Normal, i, Message::Type::Unknown, producer);
+    });
+  }
+
+  // Pop concurrently with the producers.
+  vector<size_t> nextIndex(kProducersCount, 0);
+  size_t popped = 0;
+  while (popped < kProducersCount * kMessagesCount)
+  {
+    auto const message = queue.PopMessage(true /* waitForMessage */);
+    if (message == nullptr)
+      continue;
+
+    auto const & m = static_cast<TestMessage const &>(*message);
+    TEST_EQUAL(m.m_index, nextIndex[m.m_producer], (m.m_producer));
+    ++nextIndex[m.m_producer];
+    ++popped;
+  }
+
+  for (auto & producer : producers)
+    producer.join();
+  TEST(queue.PopMessage(false /* waitForMessage */) == nullptr, ());
+}
+
+UNIT_TEST(MessageQueue_OverflowWaitsForReservedSlot)
+{
+  MessageQueue queue;
+  // Another producer has reserved a slot, but hasn't written its message yet.
+  auto const slot = queue.ReserveForTesting(MessagePriority::Normal);
+  TEST(slot, ());
+
+  // The ring gets full after the reserved slot, the rest goes to the overflow.
+  size_t constexpr kMessagesCount = 2000;
+  for (size_t i = 0; i < kMessagesCount; ++i)
+    Push(queue, MessagePriority::Normal, i);
+
+  // Nothing can be popped before the reserved slot, overflow messages wait for it too.
+  TEST(PopAll(queue).empty(), ());
+
+  queue.PushReservedForTesting(*slot, make_unique_dp<TestMessage>(Message::Type::Unknown, 1, 0),
+                               MessagePriority::Normal);
+  auto const message = queue.PopMessage(false /* waitForMessage */);
+  TEST(message, ());
+  TEST_EQUAL(static_cast<TestMessage const &>(*message).m_producer, 1, ());
+
+  vector<size_t> expected(kMessagesCount);
+  for (size_t i = 0; i < kMessagesCount; ++i)
+    expected[i] = i;
+  TEST_EQUAL(PopAll(queue), expected, ());
+}
+
+UNIT_TEST(MessageQueue_WaitForMessage)
+{
+  MessageQueue queue;
+  auto popped = async(launch::async, [&queue]()
+  {
+    auto const message = queue.PopMessage(true /* waitForMessage */);
+    return message == nullptr ? size_t{0} : static_cast<TestMessage const &>(*message).m_index;
+  });
+
+  this_thread::sleep_for(chrono::milliseconds(50));
+  TEST(popped.wait_for(chrono::seconds(0)) == future_status::timeout, ());
+  Push(queue, MessagePriority::Low, 42);
+  TEST_EQUAL(popped.get(), 42, ());
+}
+
+UNIT_TEST(MessageQueue_CancelWait)
+{
+  MessageQueue queue;
+  auto popped = async(launch::async, [&queue]()
+  {
+    return queue.PopMessage(true /* waitForMessage */) == nullptr;
+  });
+
+  // CancelWait() wakes up the waiting consumer only, so repeat it until the consumer waits.
+  while (popped.wait_for(chrono::milliseconds(10)) == future_status::timeout)
+    queue.CancelWait();
+  TEST(popped.get(), ());
+}
+}  // namespace message_queue_tests
@@ -45,6 +45,17 @@ void DrapeMeasurer::Start()
   }
 #endif
 
+#ifdef MESSAGE_QUEUE_STATISTIC
+  {
+    std::lock_guard<std::mutex> lock(m_messagesMutex);
+    m_poppedMessagesCount = 0;
+    m_totalMessagesDepth = 0;
+    m_maxMessagesDepth = 0;
+    m_totalMessagesLatency = steady_clock::duration::zero();
+    m_maxMessagesLatency = steady_clock::duration::zero();
+  }
+#endif
+
 #if defined(RENDER_STATISTIC) || defined(TRACK_GPU_MEM)
   m_totalTPF = steady_clock::duration::zero();
   m_totalTPFCount = 0;
@@ -414,6 +425,54 @@ DrapeMeasurer::TileStatistic DrapeMeasurer::GetTileStatistic()
 }
 #endif
 
+#ifdef MESSAGE_QUEUE_STATISTIC
+std::string DrapeMeasurer::MessageQueueStatistic::ToString() const
+{
+  std::ostringstream ss;
+  ss << " ----- Message queue statistic report ----- \n";
+  ss << " Messages count = " << m_messagesCount << "\n";
+  ss << " Avg queue depth = " << m_avgDepth << "\n";
+  ss << " Max queue depth = " << m_maxDepth << "\n";
+  ss << " Avg message latency, mcs = " << m_avgLatencyInMcs << "\n";
+  ss << " Max message latency, mcs = " << m_maxLatencyInMcs << "\n";
+  ss << " ----- Message queue statistic report ----- \n";
+
+  return ss.str();
+}
+
+void DrapeMeasurer::RecordMessagePopping(size_t depth, std::chrono::nanoseconds latency)
+{
+  if (!m_isEnabled)
+    return;
+
+  std::lock_guard<std::mutex> lock(m_messagesMutex);
+  ++m_poppedMessagesCount;
+  m_totalMessagesDepth += depth;
+  m_maxMessagesDepth = std::max(m_maxMessagesDepth, depth);
+  m_totalMessagesLatency += latency;
+  m_maxMessagesLatency = std::max(m_maxMessagesLatency, latency);
+}
+
+DrapeMeasurer::MessageQueueStatistic DrapeMeasurer::GetMessageQueueStatistic()
+{
+  using namespace std::chrono;
+
+  std::lock_guard<std::mutex> lock(m_messagesMutex);
+  MessageQueueStatistic statistic;
+  statistic.m_messagesCount = m_poppedMessagesCount;
+  statistic.m_maxDepth = static_cast<uint32_t>(m_maxMessagesDepth);
+  statistic.m_maxLatencyInMcs =
+      static_cast<uint32_t>(duration_cast<microseconds>(m_maxMessagesLatency).count());
+  if (m_poppedMessagesCount > 0)
+  {
+    statistic.m_avgDepth = static_cast<uint32_t>(m_totalMessagesDepth / m_poppedMessagesCount);
+    statistic.m_avgLatencyInMcs = static_cast<uint32_t>(
+        duration_cast<microseconds>(m_totalMessagesLatency).count() / m_poppedMessagesCount);
+  }
+  return statistic;
+}
+#endif
+
 #ifdef TRACK_GPU_MEM
 std::string DrapeMeasurer::GPUMemoryStatistic::ToString() const
 {
@@ -506,6 +565,9 @@ std::string DrapeMeasurer::DrapeStatistic::ToString() const
 #ifdef GENERATING_STATISTIC
   ss << "\n" << m_generatingStatistic.ToString() << "\n";
 #endif
+#ifdef MESSAGE_QUEUE_STATISTIC
+  ss << "\n" << m_messageQueueStatistic.ToString() << "\n";
+#endif
 #ifdef TRACK_GPU_MEM
   ss << "\n" << m_gpuMemStatistic.ToString() << "\n";
 #endif
@@ -529,6 +591,9 @@ DrapeMeasurer::DrapeStatistic DrapeMeasurer::GetDrapeStatistic()
 #ifdef GENERATING_STATISTIC
   statistic.m_generatingStatistic = GetGeneratingStatistic();
 #endif
+#ifdef MESSAGE_QUEUE_STATISTIC
+  statistic.m_messageQueueStatistic = GetMessageQueueStatistic();
+#endif
 #ifdef TRACK_GPU_MEM
   statistic.m_gpuMemStatistic = GetGPUMemoryStatistic();
 #endif
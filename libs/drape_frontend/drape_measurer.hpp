@@ -89,6 +89,25 @@ public:
   GeneratingStatistic GetGeneratingStatistic();
 #endif
 
+#ifdef MESSAGE_QUEUE_STATISTIC
+  struct MessageQueueStatistic
+  {
+    std::string ToString() const;
+
+    uint64_t m_messagesCount = 0;
+    uint32_t m_avgDepth = 0;
+    uint32_t m_maxDepth = 0;
+    uint32_t m_avgLatencyInMcs = 0;
+    uint32_t m_maxLatencyInMcs = 0;
+  };
+
+  // |depth| is the number of messages which were in the queue when a message was popped,
+  // |latency| is the time the message spent in the queue.
+  void RecordMessagePopping(size_t depth, std::chrono::nanoseconds latency);
+
+  MessageQueueStatistic GetMessageQueueStatistic();
+#endif
+
 #ifdef TRACK_GPU_MEM
   struct GPUMemoryStatistic
   {
@@ -122,6 +141,9 @@ public:
 #ifdef GENERATING_STATISTIC
     GeneratingStatistic m_generatingStatistic;
 #endif
+#ifdef MESSAGE_QUEUE_STATISTIC
+    MessageQueueStatistic m_messageQueueStatistic;
+#endif
 #ifdef TRACK_GPU_MEM
     GPUMemoryStatistic m_gpuMemStatistic;
 #endif
@@ -164,6 +186,16 @@ private:
   std::mutex m_tilesMutex;
 #endif
 
+#ifdef MESSAGE_QUEUE_STATISTIC
+  // Messages are popped by the frontend and the backend renderer threads.
+  std::mutex m_messagesMutex;
+  uint64_t m_poppedMessagesCount = 0;
+  uint64_t m_totalMessagesDepth = 0;
+  size_t m_maxMessagesDepth = 0;
+  std::chrono::nanoseconds m_totalMessagesLatency;
+  std::chrono::nanoseconds m_maxMessagesLatency;
+#endif
+
   std::chrono::time_point<std::chrono::steady_clock> m_startFrameRenderTime;
 
   std::chrono::nanoseconds m_realtimeMinFrameRenderTime;
@@ -39,34 +39,32 @@ ref_ptr<MetalineManager> EngineContext::GetMetalineManager() const
 
 void EngineContext::BeginReadTile()
 {
-  PostMessage(make_unique_dp<TileReadStartMessage>(m_tileKey));
+  PostMessage(make_unique_dp<TileReadStartMessage>(m_tileKey), MessagePriority::Normal);
 }
 
 void EngineContext::Flush(TMapShapes && shapes)
 {
-  PostMessage(make_unique_dp<MapShapeReadedMessage>(m_tileKey, std::move(shapes)));
+  PostMessage(make_unique_dp<MapShapeReadedMessage>(m_tileKey, std::move(shapes)), MessagePriority::Normal);
 }
 
 void EngineContext::FlushOverlays(TMapShapes && shapes)
 {
-  PostMessage(make_unique_dp<OverlayMapShapeReadedMessage>(m_tileKey, std::move(shapes)));
+  PostMessage(make_unique_dp<OverlayMapShapeReadedMessage>(m_tileKey, std::move(shapes)), MessagePriority::Normal);
 }
 
 void EngineContext::FlushTrafficGeometry(TrafficSegmentsGeometry && geometry)
 {
-  m_commutator->PostMessage(ThreadsCommutator::ResourceUploadThread,
-                            make_unique_dp<FlushTrafficGeometryMessage>(m_tileKey, std::move(geometry)),
-                            MessagePriority::Low);
+  PostMessage(make_unique_dp<FlushTrafficGeometryMessage>(m_tileKey, std::move(geometry)),
+              MessagePriority::Low);
 }
 
 void EngineContext::EndReadTile()
 {
-  PostMessage(make_unique_dp<TileReadEndMessage>(m_tileKey));
+  PostMessage(make_unique_dp<TileReadEndMessage>(m_tileKey), MessagePriority::Normal);
 }
 
-void EngineContext::PostMessage(drape_ptr<Message> && message)
+void EngineContext::PostMessage(drape_ptr<Message> && message, MessagePriority priority)
 {
-  m_commutator->PostMessage(ThreadsCommutator::ResourceUploadThread, std::move(message),
-                            MessagePriority::Normal);
+  m_commutator->PostMessage(ThreadsCommutator::ResourceUploadThread, std::move(message), priority);
 }
 }  // namespace df
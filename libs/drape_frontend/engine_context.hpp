@@ -33,6 +33,7 @@ public:
                 bool isTrafficEnabled,
                 bool isolinesEnabled,
                 int8_t mapLangIndex);
+  virtual ~EngineContext() = default;
 
   TileKey const & GetTileKey() const { return m_tileKey; }
   bool Is3dBuildingsEnabled() const { return m_3dBuildingsEnabled; }
@@ -49,9 +50,12 @@ public:
   void FlushTrafficGeometry(TrafficSegmentsGeometry && geometry);
   void EndReadTile();
 
-private:
-  void PostMessage(drape_ptr<Message> && message);
+protected:
+  // Posts |message| to the resource upload thread. Overridden to consume read results
+  // without a frontend, e.g. in benchmarks.
+  virtual void PostMessage(drape_ptr<Message> && message, MessagePriority priority);
 
+private:
   TileKey m_tileKey;
   ref_ptr<ThreadsCommutator> m_commutator;
   ref_ptr<dp::TextureManager> m_texMng;
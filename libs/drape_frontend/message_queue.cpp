@@ -1,113 +1,236 @@
 #include "drape_frontend/message_queue.hpp"
 
+#ifdef MESSAGE_QUEUE_STATISTIC
+#include "drape_frontend/drape_measurer.hpp"
+#endif
+
 #include "base/assert.hpp"
 #include "base/stl_helpers.hpp"
 
+#include <algorithm>
+
 namespace df
 {
+namespace
+{
+// Messages come in bursts (e.g. render buckets of a tile), the rest of a burst goes to the overflow.
+size_t constexpr kLaneCapacity = 1024;
+}  // namespace
+
+MessageQueue::Lane::Lane() : m_ring(kLaneCapacity) {}
+
 MessageQueue::MessageQueue()
   : m_isWaiting(false)
 {}
 
 MessageQueue::~MessageQueue()
 {
-  CancelWaitImpl();
+  CancelWait();
   ClearQuery();
 }
 
+// static
+MessageQueue::LaneIndex MessageQueue::GetLaneIndex(MessagePriority priority)
+{
+  switch (priority)
+  {
+  case MessagePriority::UberHighSingleton: return UberHighSingletonLane;
+  case MessagePriority::High: return HighLane;
+  case MessagePriority::Normal: return NormalLane;
+  case MessagePriority::Low: return LowLane;
+  }
+  ASSERT(false, ("Unknown message priority type"));
+  return NormalLane;
+}
+
 drape_ptr<Message> MessageQueue::PopMessage(bool waitForMessage)
 {
   std::unique_lock<std::mutex> lock(m_mutex);
-  if (waitForMessage && m_messages.empty() && m_lowPriorityMessages.empty())
+  auto msg = PopMessageImpl();
+  if (msg != nullptr || !waitForMessage)
+    return msg;
+
   {
-    m_isWaiting = true;
-    m_condition.wait(lock, [this]() { return !m_isWaiting; });
-    m_isWaiting = false;
+    std::unique_lock<std::mutex> waitLock(m_waitMutex);
+    m_isWaiting.store(true, std::memory_order_relaxed);
+    // Pairs with the fence in PushMessage: either the producer sees |m_isWaiting| and wakes us up,
+    // or we see the pushed message here.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (HasPushedMessages())
+    {
+      m_isWaiting.store(false, std::memory_order_relaxed);
+    }
+    else
+    {
+      lock.unlock();
+      m_condition.wait(waitLock, [this]() { return !m_isWaiting.load(std::memory_order_relaxed); });
+    }
   }
 
-  drape_ptr<Message> msg;
-  if (!m_messages.empty())
+  if (!lock.owns_lock())
+    lock.lock();
+  return PopMessageImpl();
+}
+
+void MessageQueue::PushMessage(drape_ptr<Message> && message, MessagePriority priority)
+{
+  Node node;
+  node.m_message = std::move(message);
+#ifdef MESSAGE_QUEUE_STATISTIC
+  node.m_pushTime = std::chrono::steady_clock::now();
+#endif
+
+  // While the overflow is not empty all messages of the lane go there to keep the order.
+  auto & lane = m_lanes[GetLaneIndex(priority)];
+  if (lane.m_hasOverflow.load(std::memory_order_acquire) || !lane.m_ring.TryPush(std::move(node)))
   {
-    msg = std::move(m_messages.front().first);
-    m_messages.pop_front();
+    std::lock_guard<std::mutex> lock(lane.m_overflowMutex);
+    lane.m_overflow.push_back(std::move(node));
+    lane.m_hasOverflow.store(true, std::memory_order_release);
   }
-  else if (!m_lowPriorityMessages.empty())
+
+  WakeUpConsumer();
+}
+
+std::optional<size_t> MessageQueue::ReserveForTesting(MessagePriority priority)
+{
+  return m_lanes[GetLaneIndex(priority)].m_ring.ReserveForTesting();
+}
+
+void MessageQueue::PushReservedForTesting(size_t slot, drape_ptr<Message> && message,
+                                          MessagePriority priority)
+{
+  Node node;
+  node.m_message = std::move(message);
+  m_lanes[GetLaneIndex(priority)].m_ring.PublishForTesting(slot, std::move(node));
+  WakeUpConsumer();
+}
+
+void MessageQueue::WakeUpConsumer()
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_isWaiting.load(std::memory_order_relaxed))
   {
-    msg = std::move(m_lowPriorityMessages.front());
-    m_lowPriorityMessages.pop_front();
+    std::lock_guard<std::mutex> lock(m_waitMutex);
+    CancelWaitImpl();
   }
-  return msg;
 }
 
-void MessageQueue::PushMessage(drape_ptr<Message> && message, MessagePriority priority)
+bool MessageQueue::AddToBatch(LaneIndex index, Node && node)
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_filter != nullptr && m_filter(make_ref(node.m_message)))
+    return false;
+
+  auto & batch = m_lanes[index].m_batch;
+  if (index == UberHighSingletonLane)
+  {
+    // A message of the same type which is already queued wins, newer messages go first.
+    auto const type = node.m_message->GetType();
+    auto const it = std::find_if(batch.cbegin(), batch.cend(), [type](Node const & n)
+    {
+      return n.m_message->GetType() == type;
+    });
+    if (it != batch.cend())
+      return false;
+
+    batch.push_front(std::move(node));
+    return true;
+  }
+
+  batch.push_back(std::move(node));
+  return true;
+}
+
+void MessageQueue::CollectMessages(LaneIndex index)
+{
+  auto & lane = m_lanes[index];
 
-  if (m_filter != nullptr && m_filter(make_ref(message)))
+  Node node;
+  while (lane.m_ring.TryPop(node))
+    AddToBatch(index, std::move(node));
+
+  if (!lane.m_hasOverflow.load(std::memory_order_acquire))
     return;
 
-  switch (priority)
+  std::deque<Node> overflow;
   {
-  case MessagePriority::Normal:
-    {
-      m_messages.emplace_back(std::move(message), priority);
-      break;
-    }
-  case MessagePriority::High:
-    {
-      auto iter = m_messages.begin();
-      while (iter != m_messages.end() && iter->second > MessagePriority::High) { iter++; }
-      m_messages.emplace(iter, std::move(message), priority);
-      break;
-    }
-  case MessagePriority::UberHighSingleton:
-    {
-      bool found = false;
-      auto iter = m_messages.begin();
-      while (iter != m_messages.end() && iter->second == MessagePriority::UberHighSingleton)
-      {
-        if (iter->first->GetType() == message->GetType())
-        {
-          found = true;
-          break;
-        }
-        iter++;
-      }
-
-      if (!found)
-        m_messages.emplace_front(std::move(message), priority);
-      break;
-    }
-  case MessagePriority::Low:
-    {
-      m_lowPriorityMessages.emplace_back(std::move(message));
-      break;
-    }
-  default:
-    ASSERT(false, ("Unknown message priority type"));
+    std::lock_guard<std::mutex> lock(lane.m_overflowMutex);
+    // A producer pushes to the overflow after its ring messages got their slots, but a slot may be
+    // still being written when the drain above stops at it. So the overflow is taken only when
+    // all the reserved slots are popped, otherwise it waits for the next call and the order of
+    // each producer's pushes is kept. A producer which sees the flag pushes to the overflow until
+    // the flag is reset here, so its next ring messages are collected after the overflow.
+    if (!lane.m_ring.IsDrained())
+      return;
+    overflow.swap(lane.m_overflow);
+    lane.m_hasOverflow.store(false, std::memory_order_release);
   }
+  for (auto & n : overflow)
+    AddToBatch(index, std::move(n));
+}
 
-  CancelWaitImpl();
+void MessageQueue::CollectAllMessages()
+{
+  for (size_t i = 0; i < LanesCount; ++i)
+    CollectMessages(static_cast<LaneIndex>(i));
 }
 
-void MessageQueue::FilterMessagesImpl()
+bool MessageQueue::HasPushedMessages() const
 {
-  CHECK(m_filter != nullptr, ());
+  return std::any_of(m_lanes.cbegin(), m_lanes.cend(), [](Lane const & lane)
+  {
+    // The overflow waits for the slots which are still being written, their producers wake
+    // the consumer up after the push.
+    return !lane.m_ring.IsEmpty() ||
+           (lane.m_hasOverflow.load(std::memory_order_acquire) && lane.m_ring.IsDrained());
+  });
+}
 
-  for (auto it = m_messages.begin(); it != m_messages.end(); )
+drape_ptr<Message> MessageQueue::PopMessageImpl()
+{
+  for (size_t i = 0; i < LanesCount; ++i)
   {
-    if (m_filter(make_ref(it->first)))
-      it = m_messages.erase(it);
-    else
-      ++it;
+    auto const index = static_cast<LaneIndex>(i);
+    auto & batch = m_lanes[index].m_batch;
+    if (batch.empty())
+      CollectMessages(index);
+    if (batch.empty())
+      continue;
+
+    Node node = std::move(batch.front());
+    batch.pop_front();
+#ifdef MESSAGE_QUEUE_STATISTIC
+    DrapeMeasurer::Instance().RecordMessagePopping(GetSizeImpl() + 1,
+                                                   std::chrono::steady_clock::now() - node.m_pushTime);
+#endif
+    return std::move(node.m_message);
   }
+  return nullptr;
+}
 
-  for (auto it = m_lowPriorityMessages.begin(); it != m_lowPriorityMessages.end(); )
+size_t MessageQueue::GetSizeImpl() const
+{
+  size_t size = 0;
+  for (auto const & lane : m_lanes)
   {
-    if (m_filter(make_ref(*it)))
-      it = m_lowPriorityMessages.erase(it);
-    else
-      ++it;
+    size += lane.m_batch.size() + lane.m_ring.GetSize();
+    std::lock_guard<std::mutex> lock(lane.m_overflowMutex);
+    size += lane.m_overflow.size();
+  }
+  return size;
+}
+
+void MessageQueue::FilterMessagesImpl()
+{
+  CHECK(m_filter != nullptr, ());
+
+  CollectAllMessages();
+  for (auto & lane : m_lanes)
+  {
+    base::EraseIf(lane.m_batch, [this](Node const & node)
+    {
+      return m_filter(make_ref(node.m_message));
+    });
   }
 }
 
@@ -121,6 +244,8 @@ void MessageQueue::EnableMessageFiltering(FilterMessageFn && filter)
 void MessageQueue::DisableMessageFiltering()
 {
   std::lock_guard<std::mutex> lock(m_mutex);
+  // Messages which were pushed while the filter was enabled must not pass.
+  CollectAllMessages();
   m_filter = nullptr;
 }
 
@@ -136,35 +261,45 @@ void MessageQueue::InstantFilter(FilterMessageFn && filter)
 #ifdef DEBUG_MESSAGE_QUEUE
 bool MessageQueue::IsEmpty() const
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
-  return m_messages.empty() && m_lowPriorityMessages.empty();
+  return GetSize() == 0;
 }
 
 size_t MessageQueue::GetSize() const
 {
   std::lock_guard<std::mutex> lock(m_mutex);
-  return m_messages.size() + m_lowPriorityMessages.size();
+  return GetSizeImpl();
 }
 #endif
 
 void MessageQueue::CancelWait()
 {
-  std::lock_guard<std::mutex> lock(m_mutex);
+  std::lock_guard<std::mutex> lock(m_waitMutex);
   CancelWaitImpl();
 }
 
 void MessageQueue::CancelWaitImpl()
 {
-  if (m_isWaiting)
+  if (m_isWaiting.load(std::memory_order_relaxed))
   {
-    m_isWaiting = false;
+    m_isWaiting.store(false, std::memory_order_relaxed);
     m_condition.notify_all();
   }
 }
 
 void MessageQueue::ClearQuery()
 {
-  m_messages.clear();
-  m_lowPriorityMessages.clear();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto & lane : m_lanes)
+  {
+    Node node;
+    while (lane.m_ring.TryPop(node))
+      ;
+    {
+      std::lock_guard<std::mutex> overflowLock(lane.m_overflowMutex);
+      lane.m_overflow.clear();
+      lane.m_hasOverflow.store(false, std::memory_order_release);
+    }
+    lane.m_batch.clear();
+  }
 }
 }  // namespace df
@@ -5,13 +5,23 @@
 #include "drape/drape_diagnostics.hpp"
 #include "drape/pointers.hpp"
 
+#include "base/bounded_mpsc_queue.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <functional>
 #include <mutex>
+#include <optional>
 
 namespace df
 {
+// Messages are pushed by many threads and popped by the owner renderer thread only.
+// Every priority has its own lock-free lane, so pushing doesn't contend with popping. The consumer
+// moves all the messages of a lane into a local batch at once and pops the batch without touching
+// shared state. A lane which is full spills into an overflow list protected by a mutex.
 class MessageQueue
 {
 public:
@@ -24,26 +34,77 @@ public:
   void CancelWait();
   void ClearQuery();
 
+  // Filters are applied on the thread which pops messages or changes filtering.
   using FilterMessageFn = std::function<bool(ref_ptr<Message>)>;
   void EnableMessageFiltering(FilterMessageFn && filter);
   void DisableMessageFiltering();
   void InstantFilter(FilterMessageFn && filter);
 
+  // Reserves a slot in the ring of the |priority| lane as a producer which is preempted
+  // in PushMessage() before it writes the message. The message is written by
+  // PushReservedForTesting(). Returns std::nullopt if the ring is full.
+  std::optional<size_t> ReserveForTesting(MessagePriority priority);
+  void PushReservedForTesting(size_t slot, drape_ptr<Message> && message, MessagePriority priority);
+
 #ifdef DEBUG_MESSAGE_QUEUE
   bool IsEmpty() const;
   size_t GetSize() const;
 #endif
 
 private:
+  struct Node
+  {
+    drape_ptr<Message> m_message;
+#ifdef MESSAGE_QUEUE_STATISTIC
+    std::chrono::steady_clock::time_point m_pushTime;
+#endif
+  };
+
+  struct Lane
+  {
+    Lane();
+
+    threads::BoundedMpscQueue<Node> m_ring;
+
+    mutable std::mutex m_overflowMutex;
+    std::deque<Node> m_overflow;
+    std::atomic<bool> m_hasOverflow = false;
+
+    // Accessed under MessageQueue::m_mutex only.
+    std::deque<Node> m_batch;
+  };
+
+  // Lanes in order of popping.
+  enum LaneIndex
+  {
+    UberHighSingletonLane = 0,
+    HighLane,
+    NormalLane,
+    LowLane,
+    LanesCount
+  };
+
+  static LaneIndex GetLaneIndex(MessagePriority priority);
+
+  // The following methods must be called under |m_mutex|.
+  void CollectMessages(LaneIndex index);
+  void CollectAllMessages();
+  bool AddToBatch(LaneIndex index, Node && node);
+  bool HasPushedMessages() const;
+  drape_ptr<Message> PopMessageImpl();
+  size_t GetSizeImpl() const;
   void FilterMessagesImpl();
+
+  void WakeUpConsumer();
   void CancelWaitImpl();
 
+  // Protects batches and filter, it's never taken by PushMessage.
   mutable std::mutex m_mutex;
-  std::condition_variable m_condition;
-  bool m_isWaiting;
-  using TMessageNode = std::pair<drape_ptr<Message>, MessagePriority>;
-  std::deque<TMessageNode> m_messages;
-  std::deque<drape_ptr<Message>> m_lowPriorityMessages;
+  std::array<Lane, LanesCount> m_lanes;
   FilterMessageFn m_filter;
+
+  std::mutex m_waitMutex;
+  std::condition_variable m_condition;
+  std::atomic<bool> m_isWaiting;
 };
 }  // namespace df
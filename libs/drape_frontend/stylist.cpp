@@ -176,12 +176,13 @@ Stylist::Stylist(FeatureType & f, uint8_t zoomLevel, int8_t deviceLang)
 
   auto const & hatchingChecker = IsHatchingTerritoryChecker::Instance();
   auto const geomType = types.GetGeomType();
+  auto const & rulesHolder = drule::rules();
 
   drule::KeysT keys;
   for (uint32_t t : types)
   {
     drule::KeysT typeKeys;
-    cl.GetObject(t)->GetSuitable(zoomLevel, geomType, typeKeys);
+    rulesHolder.GetSuitable(t, zoomLevel, geomType, typeKeys);
     bool const hasHatching = hatchingChecker(t);
 
     for (auto & k : typeKeys)
@@ -243,14 +244,14 @@ Stylist::Stylist(FeatureType & f, uint8_t zoomLevel, int8_t deviceLang)
         else
         {
           drule::KeysT addressKeys;
-          cl.GetObject(addressType)->GetSuitable(zoomLevel, geomType, addressKeys);
+          rulesHolder.GetSuitable(addressType, zoomLevel, geomType, addressKeys);
           if (!addressKeys.empty())
           {
             // A caption drule exists for this zoom level.
             ASSERT(addressKeys.size() == 1 && addressKeys[0].m_type == drule::caption,
                    ("building-address should contain a caption drule only"));
             ASSERT(m_houseNumberRule == nullptr, ());
-            m_houseNumberRule = drule::rules().Find(addressKeys[0])->GetCaption();
+            m_houseNumberRule = rulesHolder.Find(addressKeys[0])->GetCaption();
           }
         }
       }
@@ -142,7 +142,7 @@ void TrafficGenerator::GenerateSegmentsGeometry(ref_ptr<dp::GraphicsContext> con
                                                 MwmSet::MwmId const & mwmId,
                                                 TileKey const & tileKey,
                                                 TrafficSegmentsGeometryValue const & geometry,
-                                                traffic::TrafficInfo::Coloring const & coloring,
+                                                traffic::TrafficInfo::PackedColoring const & coloring,
                                                 ref_ptr<dp::TextureManager> texturesMgr)
 {
   static std::array<int, 3> const kGenerateCirclesZoomLevel = {14, 14, 16};
@@ -172,13 +172,13 @@ void TrafficGenerator::GenerateSegmentsGeometry(ref_ptr<dp::GraphicsContext> con
 
   for (auto const & geomPair : geometry)
   {
-    auto const coloringIt = coloring.find(geomPair.first);
-    if (coloringIt == coloring.cend() || coloringIt->second == traffic::SpeedGroup::Unknown)
+    auto const speedGroup = coloring.Get(geomPair.first);
+    if (speedGroup == traffic::SpeedGroup::Unknown)
       continue;
 
-    auto const & colorRegion = m_colorsCache[static_cast<size_t>(coloringIt->second)];
-    auto const vOffset = kCoordVOffsets[static_cast<size_t>(coloringIt->second)];
-    auto const minU = kMinCoordU[static_cast<size_t>(coloringIt->second)];
+    auto const & colorRegion = m_colorsCache[static_cast<size_t>(speedGroup)];
+    auto const vOffset = kCoordVOffsets[static_cast<size_t>(speedGroup)];
+    auto const minU = kMinCoordU[static_cast<size_t>(speedGroup)];
 
     TrafficSegmentGeometry const & g = geomPair.second;
     ref_ptr<dp::Batcher> batcher =
@@ -186,7 +186,7 @@ void TrafficGenerator::GenerateSegmentsGeometry(ref_ptr<dp::GraphicsContext> con
     batcher->SetBatcherHash(tileKey.GetHashValue(BatcherBucket::Traffic));
 
     auto const finalDepth = kRoadClassDepths[static_cast<size_t>(g.m_roadClass)] +
-                            static_cast<float>(coloringIt->second);
+                            static_cast<float>(speedGroup);
 
     int width = 0;
     if (TrafficRenderer::CanBeRenderedAsLine(g.m_roadClass, tileKey.m_zoomLevel, width))
@@ -80,7 +80,7 @@ struct TrafficSegmentGeometry
 using TrafficSegmentsGeometryValue = std::vector<std::pair<traffic::TrafficInfo::RoadSegmentId,
                                                            TrafficSegmentGeometry>>;
 using TrafficSegmentsGeometry = std::map<MwmSet::MwmId, TrafficSegmentsGeometryValue>;
-using TrafficSegmentsColoring = std::map<MwmSet::MwmId, traffic::TrafficInfo::Coloring>;
+using TrafficSegmentsColoring = std::map<MwmSet::MwmId, traffic::TrafficInfo::PackedColoring>;
 
 struct TrafficRenderData
 {
@@ -226,7 +226,7 @@ private:
   void GenerateSegmentsGeometry(ref_ptr<dp::GraphicsContext> context, MwmSet::MwmId const & mwmId,
                                 TileKey const & tileKey,
                                 TrafficSegmentsGeometryValue const & geometry,
-                                traffic::TrafficInfo::Coloring const & coloring,
+                                traffic::TrafficInfo::PackedColoring const & coloring,
                                 ref_ptr<dp::TextureManager> texturesMgr);
 
   TrafficSegmentsColoring m_coloring;
@@ -169,9 +169,13 @@ std::unique_ptr<MwmInfo> DataSource::CreateInfo(platform::LocalCountryFile const
 std::unique_ptr<MwmValue> DataSource::CreateValue(MwmInfo & info) const
 {
   platform::LocalCountryFile const & localFile = info.GetLocalFile();
-  auto p = std::make_unique<MwmValue>(localFile);
+  feature::FeaturesBackend const backend = m_featuresBackend;
+  auto p = std::make_unique<MwmValue>(localFile, backend == feature::FeaturesBackend::Concurrent);
 
-  p->SetTable(dynamic_cast<MwmInfoEx &>(info));
+  auto & infoEx = dynamic_cast<MwmInfoEx &>(info);
+  p->SetTable(infoEx);
+  if (backend == feature::FeaturesBackend::Mapped || backend == feature::FeaturesBackend::Concurrent)
+    p->SetMappedFeatures(infoEx);
 
   p->m_metaDeserializer = indexer::MetadataDeserializer::Load(p->m_cont);
   CHECK(p->m_metaDeserializer, ());
@@ -2,8 +2,10 @@
 
 #include "indexer/feature_covering.hpp"
 #include "indexer/feature_source.hpp"
+#include "indexer/mapped_features.hpp"
 #include "indexer/mwm_set.hpp"
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <utility>
@@ -51,6 +53,12 @@ public:
     return (*m_factory)(handle);
   }
 
+  /// Sets how features are read for mwm values created after the call. Already
+  /// created values (including the cached ones) keep their backend, so it's better
+  /// to call this before any mwm is locked.
+  void SetFeaturesBackend(feature::FeaturesBackend backend) { m_featuresBackend = backend; }
+  feature::FeaturesBackend GetFeaturesBackend() const { return m_featuresBackend; }
+
 protected:
   using ReaderCallback = std::function<void(MwmSet::MwmHandle const & handle,
                                             covering::CoveringGetter & cov, int scale)>;
@@ -68,6 +76,7 @@ protected:
 
 private:
   std::unique_ptr<FeatureSourceFactory> m_factory;
+  std::atomic<feature::FeaturesBackend> m_featuresBackend = feature::FeaturesBackend::Reader;
 };
 
 // DataSource which operates with features from mwm file and does not support features creation
@@ -80,7 +89,8 @@ public:
 
 /// Guard for loading features from particular MWM by demand.
 /// @note If you need to work with FeatureType from different threads you need to use
-/// a unique FeaturesLoaderGuard instance for every thread.
+/// a unique FeaturesLoaderGuard instance for every thread, unless features are read
+/// with feature::FeaturesBackend::Concurrent (see FeatureSource::IsThreadSafe()).
 /// For an example of concurrent extracting feature details please see ConcurrentFeatureParsingTest.
 class FeaturesLoaderGuard
 {
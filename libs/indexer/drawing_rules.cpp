@@ -8,6 +8,7 @@
 
 #include "platform/platform.hpp"
 
+#include "base/checked_cast.hpp"
 #include "base/logging.hpp"
 
 #include <functional>
@@ -83,6 +84,10 @@ void RulesHolder::Clean()
 
   m_dRules.clear();
   m_colors.clear();
+
+  m_typeToSuitable.clear();
+  m_suitableBounds.clear();
+  m_suitableKeys.clear();
 }
 
 Key RulesHolder::AddRule(int scale, TypeT type, BaseRule * p)
@@ -104,6 +109,53 @@ BaseRule const * RulesHolder::Find(Key const & k) const
   return m_dRules[k.m_index];
 }
 
+void RulesHolder::GetSuitable(uint32_t type, int scale, feature::GeomType gt, KeysT & keys) const
+{
+  ASSERT(static_cast<int>(gt) >= 0 && static_cast<int>(gt) < static_cast<int>(kGeomTypesCount), ());
+  ASSERT(0 <= scale && scale <= scales::GetUpperStyleScale(), (scale));
+
+  auto const it = m_typeToSuitable.find(type);
+  if (it == m_typeToSuitable.end())
+  {
+    // Not an exact classificator type, e.g. a type with an unknown subtype.
+    classif().GetObject(type)->GetSuitable(scale, gt, keys);
+    return;
+  }
+
+  if (it->second == kNoSuitableKeys)
+    return;
+
+  size_t const i = it->second + scale * kGeomTypesCount + static_cast<size_t>(gt);
+  keys.append(m_suitableKeys.begin() + m_suitableBounds[i], m_suitableKeys.begin() + m_suitableBounds[i + 1]);
+}
+
+void RulesHolder::InitSuitableKeys()
+{
+  ASSERT(m_suitableBounds.empty(), ());
+  m_suitableBounds.push_back(0);
+
+  classif().ForEachTree([this](ClassifObject const * p, uint32_t type)
+  {
+    if (!p->IsDrawableAny())
+    {
+      m_typeToSuitable.emplace(type, kNoSuitableKeys);
+      return;
+    }
+
+    m_typeToSuitable.emplace(type, base::asserted_cast<uint32_t>(m_suitableBounds.size() - 1));
+    for (int scale = 0; scale <= scales::GetUpperStyleScale(); ++scale)
+    {
+      for (size_t gt = 0; gt < kGeomTypesCount; ++gt)
+      {
+        KeysT keys;
+        p->GetSuitable(scale, static_cast<feature::GeomType>(gt), keys);
+        m_suitableKeys.insert(m_suitableKeys.end(), keys.begin(), keys.end());
+        m_suitableBounds.push_back(base::asserted_cast<uint32_t>(m_suitableKeys.size()));
+      }
+    }
+  });
+}
+
 uint32_t RulesHolder::GetBgColor(int scale) const
 {
   ASSERT_LESS(scale, static_cast<int>(m_bgColors.size()), ());
@@ -421,6 +473,7 @@ void RulesHolder::LoadFromBinaryProto(string const & s)
 
   InitBackgroundColors(doSet.m_cont);
   InitColors(doSet.m_cont);
+  InitSuitableKeys();
 }
 
 void LoadRules()
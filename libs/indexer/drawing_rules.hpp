@@ -9,8 +9,11 @@
 
 #include "std/target_os.hpp"
 
+#include "3party/skarupke/flat_hash_map.hpp"
+
 #include <array>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -62,6 +65,11 @@ namespace drule
 
     BaseRule const * Find(Key const & k) const;
 
+    /// The same as classif().GetObject(type)->GetSuitable(), but the keys are taken from a table
+    /// which is built on rules loading for all classificator types, scales and geometry types.
+    /// So styling of a feature doesn't walk the classificator tree and the drawing rules of every type.
+    void GetSuitable(uint32_t type, int scale, feature::GeomType gt, KeysT & keys) const;
+
     uint32_t GetBgColor(int scale) const;
     uint32_t GetColor(std::string const & name) const;
 
@@ -81,12 +89,23 @@ namespace drule
   private:
     void InitBackgroundColors(ContainerProto const & cp);
     void InitColors(ContainerProto const & cp);
+    void InitSuitableKeys();
     void Clean();
 
     /// background color for scales in range [0...scales::UPPER_STYLE_SCALE]
     std::vector<uint32_t> m_bgColors;
     std::unordered_map<std::string, uint32_t> m_colors;
     std::vector<BaseRule *> m_dRules;
+
+    static size_t constexpr kGeomTypesCount = 3;
+    static uint32_t constexpr kNoSuitableKeys = std::numeric_limits<uint32_t>::max();
+
+    /// Type -> index of its first (scale, geometry type) range in |m_suitableBounds|
+    /// or kNoSuitableKeys for types without drawing rules.
+    ska::flat_hash_map<uint32_t, uint32_t> m_typeToSuitable;
+    /// Range i of suitable keys is [m_suitableBounds[i], m_suitableBounds[i + 1]) of |m_suitableKeys|.
+    std::vector<uint32_t> m_suitableBounds;
+    std::vector<Key> m_suitableKeys;
   };
 
   RulesHolder & rules();
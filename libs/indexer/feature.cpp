@@ -117,9 +117,9 @@ uint32_t CalcOffset(ArrayByteSource const & source, uint8_t const * start)
   return static_cast<uint32_t>(distance(start, source.PtrUint8()));
 }
 
-uint8_t Header(vector<uint8_t> const & data)
+uint8_t Header(uint8_t const * data, size_t size)
 {
- CHECK(!data.empty(), ());
+ CHECK(data && size != 0, ());
  return data[0];
 }
 
@@ -190,12 +190,26 @@ uint8_t ReadByte(TSource & src)
 FeatureType::FeatureType(SharedLoadInfo const * loadInfo, vector<uint8_t> && buffer,
                          indexer::MetadataDeserializer * metadataDeserializer)
   : m_loadInfo(loadInfo)
-  , m_data(std::move(buffer))
+  , m_buffer(std::move(buffer))
+  , m_data(m_buffer.data())
+  , m_dataSize(m_buffer.size())
   , m_metadataDeserializer(metadataDeserializer)
 {
   CHECK(m_loadInfo, ());
 
-  m_header = Header(m_data); // Parse the header and optional name/layer/addinfo.
+  m_header = Header(m_data, m_dataSize); // Parse the header and optional name/layer/addinfo.
+}
+
+FeatureType::FeatureType(SharedLoadInfo const * loadInfo, uint8_t const * data, size_t size,
+                         indexer::MetadataDeserializer * metadataDeserializer)
+  : m_loadInfo(loadInfo)
+  , m_data(data)
+  , m_dataSize(size)
+  , m_metadataDeserializer(metadataDeserializer)
+{
+  CHECK(m_loadInfo, ());
+
+  m_header = Header(m_data, m_dataSize); // Parse the header and optional name/layer/addinfo.
 }
 
 std::unique_ptr<FeatureType> FeatureType::CreateFromMapObject(osm::MapObject const & emo)
@@ -274,7 +288,7 @@ void FeatureType::ParseTypes()
 
   auto const typesOffset = sizeof(m_header);
   Classificator & c = classif();
-  ArrayByteSource source(m_data.data() + typesOffset);
+  ArrayByteSource source(m_data + typesOffset);
 
   size_t const count = GetTypesCount();
   for (size_t i = 0; i < count; ++i)
@@ -293,7 +307,7 @@ void FeatureType::ParseTypes()
     }
   }
 
-  m_offsets.m_common = CalcOffset(source, m_data.data());
+  m_offsets.m_common = CalcOffset(source, m_data);
   m_parsed.m_types = true;
 }
 
@@ -305,8 +319,8 @@ void FeatureType::ParseCommon()
   CHECK(m_loadInfo, ());
   ParseTypes();
 
-  ArrayByteSource source(m_data.data() + m_offsets.m_common);
-  uint8_t const h = Header(m_data);
+  ArrayByteSource source(m_data + m_offsets.m_common);
+  uint8_t const h = Header(m_data, m_dataSize);
   m_params.Read(source, h);
 
   if (GetGeomType() == GeomType::Point)
@@ -315,7 +329,7 @@ void FeatureType::ParseCommon()
     m_limitRect.Add(m_center);
   }
 
-  m_offsets.m_header2 = CalcOffset(source, m_data.data());
+  m_offsets.m_header2 = CalcOffset(source, m_data);
   m_parsed.m_common = true;
 }
 
@@ -351,8 +365,8 @@ void FeatureType::ParseHeader2()
   ParseCommon();
 
   uint8_t elemsCount = 0, geomScalesMask = 0;
-  BitSource bitSource(m_data.data() + m_offsets.m_header2);
-  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
+  BitSource bitSource(m_data + m_offsets.m_header2);
+  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data, m_dataSize) & HEADER_MASK_GEOMTYPE);
 
   if (headerGeomType == HeaderGeomType::Line || headerGeomType == HeaderGeomType::Area)
   {
@@ -420,7 +434,7 @@ void FeatureType::ParseHeader2()
     }
   }
   // Size of the whole header incl. inner geometry / triangles.
-  m_innerStats.m_size = CalcOffset(src, m_data.data());
+  m_innerStats.m_size = CalcOffset(src, m_data);
   m_parsed.m_header2 = true;
 }
 
@@ -449,7 +463,7 @@ void FeatureType::ParseGeometry(int scale)
     CHECK(m_loadInfo, ());
     ParseHeader2();
 
-    auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
+    auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data, m_dataSize) & HEADER_MASK_GEOMTYPE);
     if (headerGeomType == HeaderGeomType::Line)
     {
       size_t const pointsCount = m_points.size();
@@ -501,7 +515,7 @@ FeatureType::GeomStat FeatureType::GetOuterGeometryStats()
   ASSERT_LESS_OR_EQUAL(scalesCount, DataHeader::kMaxScalesCount, ("MWM has too many geometry scales!"));
   FeatureType::GeomStat res;
 
-  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
+  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data, m_dataSize) & HEADER_MASK_GEOMTYPE);
   if (headerGeomType == HeaderGeomType::Line)
   {
     size_t const pointsCount = m_points.size();
@@ -550,7 +564,7 @@ void FeatureType::ParseTriangles(int scale)
     CHECK(m_loadInfo, ());
     ParseHeader2();
 
-    auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
+    auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data, m_dataSize) & HEADER_MASK_GEOMTYPE);
     if (headerGeomType == HeaderGeomType::Area)
     {
       if (m_triangles.empty())
@@ -577,7 +591,7 @@ FeatureType::GeomStat FeatureType::GetOuterTrianglesStats()
   ASSERT_LESS_OR_EQUAL(scalesCount, static_cast<int>(DataHeader::kMaxScalesCount), ("MWM has too many geometry scales!"));
   FeatureType::GeomStat res;
 
-  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data) & HEADER_MASK_GEOMTYPE);
+  auto const headerGeomType = static_cast<HeaderGeomType>(Header(m_data, m_dataSize) & HEADER_MASK_GEOMTYPE);
   if (headerGeomType == HeaderGeomType::Area)
   {
     if (m_triangles.empty())
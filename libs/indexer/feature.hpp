@@ -36,6 +36,10 @@ public:
 
   FeatureType(feature::SharedLoadInfo const * loadInfo, std::vector<uint8_t> && buffer,
               indexer::MetadataDeserializer * metadataDeserializer);
+  /// Decodes the feature directly from |data| without copying, so |data| must outlive the feature
+  /// the same way as |loadInfo|.
+  FeatureType(feature::SharedLoadInfo const * loadInfo, uint8_t const * data, size_t size,
+              indexer::MetadataDeserializer * metadataDeserializer);
 
   static std::unique_ptr<FeatureType> CreateFromMapObject(osm::MapObject const & emo);
 
@@ -245,7 +249,11 @@ private:
 
   // Non-owning pointer to shared load info. SharedLoadInfo created once per FeaturesVector.
   feature::SharedLoadInfo const * m_loadInfo = nullptr;
-  std::vector<uint8_t> m_data;
+  // Owns |m_data| if the feature was copied from a reader.
+  std::vector<uint8_t> m_buffer;
+  // Serialized feature, non-owning.
+  uint8_t const * m_data = nullptr;
+  size_t m_dataSize = 0;
 
   // Pointer to shared metedata deserializer. Must be set for mwm format >= Format::v11
   indexer::MetadataDeserializer * m_metadataDeserializer = nullptr;
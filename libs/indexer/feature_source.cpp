@@ -20,7 +20,8 @@ FeatureSource::FeatureSource(MwmSet::MwmHandle const & handle) : m_handle(handle
 
   auto const & value = *m_handle.GetValue();
   m_vector = std::make_unique<FeaturesVector>(value.m_cont, value.GetHeader(), value.m_table.get(),
-                                              value.m_metaDeserializer.get());
+                                              value.m_metaDeserializer.get(),
+                                              value.m_mappedFeatures.get());
 }
 
 size_t FeatureSource::GetNumFeatures() const
@@ -32,6 +33,11 @@ size_t FeatureSource::GetNumFeatures() const
   return m_vector->GetNumFeatures();
 }
 
+bool FeatureSource::IsThreadSafe() const
+{
+  return m_handle.IsAlive() && m_handle.GetValue()->HasConcurrentReader();
+}
+
 std::unique_ptr<FeatureType> FeatureSource::GetOriginalFeature(uint32_t index) const
 {
   ASSERT(m_handle.IsAlive(), ());
@@ -33,6 +33,10 @@ public:
 
   size_t GetNumFeatures() const;
 
+  /// Returns true if features may be read from several threads at once via this source,
+  /// see feature::FeaturesBackend::Concurrent.
+  bool IsThreadSafe() const;
+
   std::unique_ptr<FeatureType> GetOriginalFeature(uint32_t index) const;
 
   MwmSet::MwmId const & GetMwmId() const { return m_handle.GetId(); }
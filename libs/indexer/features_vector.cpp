@@ -8,8 +8,9 @@
 
 FeaturesVector::FeaturesVector(FilesContainerR const & cont, feature::DataHeader const & header,
                                feature::FeaturesOffsetsTable const * table,
-                               indexer::MetadataDeserializer * metaDeserializer)
-: m_loadInfo(cont, header), m_table(table), m_metaDeserializer(metaDeserializer)
+                               indexer::MetadataDeserializer * metaDeserializer,
+                               feature::MappedFeatures const * mapped)
+: m_loadInfo(cont, header), m_table(table), m_metaDeserializer(metaDeserializer), m_mapped(mapped)
 {
   InitRecordsReader();
 }
@@ -29,6 +30,13 @@ void FeaturesVector::InitRecordsReader()
 std::unique_ptr<FeatureType> FeaturesVector::GetByIndex(uint32_t index) const
 {
   auto const ftOffset = m_table ? m_table->GetFeatureOffset(index) : index;
+  if (m_mapped)
+  {
+    size_t size = 0;
+    uint8_t const * data = m_mapped->GetRecord(ftOffset, size);
+    return std::make_unique<FeatureType>(&m_loadInfo, data, size, m_metaDeserializer);
+  }
+
   return std::make_unique<FeatureType>(&m_loadInfo, m_recordReader->ReadRecord(ftOffset), m_metaDeserializer);
 }
 
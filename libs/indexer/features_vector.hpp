@@ -1,6 +1,7 @@
 #pragma once
 
 #include "indexer/feature.hpp"
+#include "indexer/mapped_features.hpp"
 #include "indexer/metadata_serdes.hpp"
 #include "indexer/shared_load_info.hpp"
 
@@ -12,16 +13,20 @@
 
 namespace feature { class FeaturesOffsetsTable; }
 
-/// Note! This class is NOT Thread-Safe.
-/// You should have separate instance of Vector for every thread.
+/// Note! This class is NOT Thread-Safe unless |cont| is read without mutable state
+/// (see MwmValue::HasConcurrentReader() and feature::FeaturesBackend::Concurrent).
+/// Otherwise you should have separate instance of Vector for every thread.
 class FeaturesVector
 {
   DISALLOW_COPY(FeaturesVector);
 
 public:
+  /// Features are decoded directly from |mapped| memory if it's not null,
+  /// otherwise they are copied via the container's reader.
   FeaturesVector(FilesContainerR const & cont, feature::DataHeader const & header,
                  feature::FeaturesOffsetsTable const * table,
-                 indexer::MetadataDeserializer * metaDeserializer);
+                 indexer::MetadataDeserializer * metaDeserializer,
+                 feature::MappedFeatures const * mapped = nullptr);
 
   std::unique_ptr<FeatureType> GetByIndex(uint32_t index) const;
 
@@ -30,19 +35,35 @@ public:
   template <class ToDo> void ForEach(ToDo && toDo) const
   {
     uint32_t index = 0;
-    m_recordReader->ForEachRecord([&](uint32_t pos, std::vector<uint8_t> && data)
+    auto const processFeature = [&](FeatureType & ft, uint32_t pos)
     {
-      FeatureType ft(&m_loadInfo, std::move(data), m_metaDeserializer);
-
       // We can't properly set MwmId here, because FeaturesVector
       // works with FileContainerR, not with MwmId/MwmHandle/MwmValue.
       // But it's OK to set at least feature's index, because it can
       // be used later for Metadata loading.
       ft.SetID(FeatureID(MwmSet::MwmId(), index));
       toDo(ft, m_table ? index++ : pos);
+    };
+
+    if (m_mapped)
+    {
+      m_mapped->ForEachRecord([&](uint32_t pos, uint8_t const * data, size_t size)
+      {
+        FeatureType ft(&m_loadInfo, data, size, m_metaDeserializer);
+        processFeature(ft, pos);
+      });
+      return;
+    }
+
+    m_recordReader->ForEachRecord([&](uint32_t pos, std::vector<uint8_t> && data)
+    {
+      FeatureType ft(&m_loadInfo, std::move(data), m_metaDeserializer);
+      processFeature(ft, pos);
     });
   }
 
+  bool IsMapped() const { return m_mapped != nullptr; }
+
   template <class ToDo> static void ForEachOffset(FilesContainerR const & cont, ToDo && toDo)
   {
     feature::DataHeader header(cont);
@@ -69,6 +90,7 @@ private:
   std::unique_ptr<RecordReader> m_recordReader;
   feature::FeaturesOffsetsTable const * m_table;
   indexer::MetadataDeserializer * m_metaDeserializer;
+  feature::MappedFeatures const * m_mapped = nullptr;
 };
 
 /// Test features vector (reader) that combines all the needed data for stand-alone work.
@@ -1,6 +1,8 @@
 #include "testing/testing.hpp"
 
 #include "indexer/classificator.hpp"
+#include "indexer/drawing_rules.hpp"
+#include "indexer/scales.hpp"
 
 #include "generator/generator_tests_support/test_with_classificator.hpp"
 
@@ -102,3 +104,34 @@ UNIT_CLASS_TEST(TestWithClassificator, Classificator_StableIndex)
   TEST_NOT_EQUAL(type, c.GetTypeForIndex(356 - 1), ()); // Restored underground-fee
   TEST_EQUAL(type, c.GetTypeForIndex(357 - 1), ());
 }
+
+UNIT_CLASS_TEST(TestWithClassificator, Classificator_SuitableKeysTable)
+{
+  Classificator const & c = classif();
+  auto const & rules = drule::rules();
+
+  auto const toIndexes = [](drule::KeysT const & keys)
+  {
+    vector<size_t> res;
+    for (auto const & k : keys)
+      res.push_back(k.m_index);
+    return res;
+  };
+
+  size_t keysCount = 0;
+  c.ForEachTree([&](ClassifObject const * p, uint32_t type)
+  {
+    for (int scale = 0; scale <= scales::GetUpperStyleScale(); ++scale)
+    {
+      for (auto const gt : {feature::GeomType::Point, feature::GeomType::Line, feature::GeomType::Area})
+      {
+        drule::KeysT expected, actual;
+        p->GetSuitable(scale, gt, expected);
+        rules.GetSuitable(type, scale, gt, actual);
+        TEST_EQUAL(toIndexes(expected), toIndexes(actual), (c.GetReadableObjectName(type), scale, gt));
+        keysCount += actual.size();
+      }
+    }
+  });
+  TEST_GREATER(keysCount, 0, ());
+}
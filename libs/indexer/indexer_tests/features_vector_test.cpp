@@ -1,13 +1,17 @@
 #include "testing/testing.hpp"
 
 #include "indexer/data_source.hpp"
+#include "indexer/feature_source.hpp"
 #include "indexer/features_vector.hpp"
+#include "indexer/mapped_features.hpp"
 #include "indexer/mwm_set.hpp"
+#include "indexer/scales.hpp"
 
 #include "platform/local_country_file.hpp"
 
 #include <map>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace features_vector_test
@@ -76,4 +80,116 @@ UNIT_TEST(FeaturesVectorTest_ParseMetadata)
   });
   TEST_EQUAL(expected, actual, ());
 }
+
+UNIT_TEST(FeaturesVectorTest_MappedBackend)
+{
+  LocalCountryFile localFile = LocalCountryFile::MakeForTesting("minsk-pass");
+
+  FrozenDataSource readerSource;
+  auto const readerResult = readerSource.RegisterMap(localFile);
+  TEST_EQUAL(readerResult.second, MwmSet::RegResult::Success, ());
+
+  FrozenDataSource mappedSource;
+  mappedSource.SetFeaturesBackend(feature::FeaturesBackend::Mapped);
+  auto const mappedResult = mappedSource.RegisterMap(localFile);
+  TEST_EQUAL(mappedResult.second, MwmSet::RegResult::Success, ());
+
+  auto const readerHandle = readerSource.GetMwmHandleById(readerResult.first);
+  auto const mappedHandle = mappedSource.GetMwmHandleById(mappedResult.first);
+  auto const * readerValue = readerHandle.GetValue();
+  auto const * mappedValue = mappedHandle.GetValue();
+  TEST(!readerValue->m_mappedFeatures, ());
+  TEST(mappedValue->m_mappedFeatures, ());
+
+  FeaturesVector readerVector(readerValue->m_cont, readerValue->GetHeader(), readerValue->m_table.get(),
+                              readerValue->m_metaDeserializer.get());
+  FeaturesVector mappedVector(mappedValue->m_cont, mappedValue->GetHeader(), mappedValue->m_table.get(),
+                              mappedValue->m_metaDeserializer.get(), mappedValue->m_mappedFeatures.get());
+  TEST(!readerVector.IsMapped(), ());
+  TEST(mappedVector.IsMapped(), ());
+
+  auto const toString = [](FeatureType & ft)
+  {
+    return ft.DebugString() + " " + DebugPrint(ft.GetLimitRect(scales::GetUpperScale())) + " " +
+           string(ft.GetMetadata(feature::Metadata::FMD_POSTCODE));
+  };
+
+  vector<string> readerFeatures;
+  readerVector.ForEach([&](FeatureType & ft, uint32_t index)
+  {
+    TEST_EQUAL(index, readerFeatures.size(), ());
+    readerFeatures.push_back(toString(ft));
+  });
+
+  size_t count = 0;
+  mappedVector.ForEach([&](FeatureType & ft, uint32_t index)
+  {
+    TEST_LESS(index, readerFeatures.size(), ());
+    TEST_EQUAL(toString(ft), readerFeatures[index], (index));
+    ++count;
+  });
+  TEST_EQUAL(count, readerFeatures.size(), ());
+  TEST_EQUAL(count, mappedVector.GetNumFeatures(), ());
+
+  for (uint32_t index = 0; index < count; index += 97)
+  {
+    auto const ft = mappedVector.GetByIndex(index);
+    TEST(ft, (index));
+    TEST_EQUAL(toString(*ft), readerFeatures[index], (index));
+  }
+}
+
+UNIT_TEST(FeaturesVectorTest_ConcurrentBackend)
+{
+  LocalCountryFile localFile = LocalCountryFile::MakeForTesting("minsk-pass");
+
+  FrozenDataSource readerSource;
+  auto const readerResult = readerSource.RegisterMap(localFile);
+  TEST_EQUAL(readerResult.second, MwmSet::RegResult::Success, ());
+
+  FrozenDataSource concurrentSource;
+  concurrentSource.SetFeaturesBackend(feature::FeaturesBackend::Concurrent);
+  auto const concurrentResult = concurrentSource.RegisterMap(localFile);
+  TEST_EQUAL(concurrentResult.second, MwmSet::RegResult::Success, ());
+
+  auto const readerHandle = readerSource.GetMwmHandleById(readerResult.first);
+  auto const concurrentHandle = concurrentSource.GetMwmHandleById(concurrentResult.first);
+  TEST(!readerHandle.GetValue()->HasConcurrentReader(), ());
+  TEST(concurrentHandle.GetValue()->HasConcurrentReader(), ());
+
+  auto const readerFeatures = readerSource.CreateFeatureSource(readerHandle);
+  auto const concurrentFeatures = concurrentSource.CreateFeatureSource(concurrentHandle);
+  TEST(!readerFeatures->IsThreadSafe(), ());
+  TEST(concurrentFeatures->IsThreadSafe(), ());
+
+  auto const toString = [](FeatureType & ft)
+  {
+    return ft.DebugString() + " " + DebugPrint(ft.GetLimitRect(scales::GetUpperScale())) + " " +
+           string(ft.GetMetadata(feature::Metadata::FMD_POSTCODE));
+  };
+
+  auto const count = static_cast<uint32_t>(readerFeatures->GetNumFeatures());
+  TEST_EQUAL(count, concurrentFeatures->GetNumFeatures(), ());
+  vector<string> expected;
+  for (uint32_t index = 0; index < count; ++index)
+    expected.push_back(toString(*readerFeatures->GetOriginalFeature(index)));
+
+  // All threads read features via the same FeatureSource.
+  uint32_t constexpr kThreadsCount = 4;
+  vector<vector<string>> actual(kThreadsCount);
+  vector<thread> threads;
+  for (uint32_t t = 0; t < kThreadsCount; ++t)
+  {
+    threads.emplace_back([&, t]()
+    {
+      for (uint32_t index = t; index < count; index += kThreadsCount)
+        actual[t].push_back(toString(*concurrentFeatures->GetOriginalFeature(index)));
+    });
+  }
+  for (auto & t : threads)
+    t.join();
+
+  for (uint32_t index = 0; index < count; ++index)
+    TEST_EQUAL(actual[index % kThreadsCount][index / kThreadsCount], expected[index], (index));
+}
 } // namespace features_vector_test
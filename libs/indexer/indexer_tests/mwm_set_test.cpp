@@ -1,3 +1,4 @@
+#include "testing/benchmark.hpp"
 #include "testing/testing.hpp"
 
 #include "platform/platform_tests_support/scoped_mwm.hpp"
@@ -5,10 +6,16 @@
 #include "indexer/indexer_tests/test_mwm_set.hpp"
 #include "indexer/mwm_set.hpp"
 
+#include "base/logging.hpp"
 #include "base/macros.hpp"
+#include "base/thread.hpp"
+#include "base/timer.hpp"
 
+#include <atomic>
 #include <initializer_list>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace mwm_set_test
 {
@@ -169,4 +176,113 @@ UNIT_TEST(MwmSetLockAndIdTest)
   TEST(!handle.GetId().IsAlive(), ());
   TEST(!handle.GetId().GetInfo().get(), ());
 }
+
+UNIT_TEST(MwmSetConcurrentLockTest)
+{
+  ScopedMwm mwm2("2.mwm");
+  ScopedMwm mwm3("3.mwm");
+  TestMwmSet mwmSet;
+
+  auto const id2 = mwmSet.Register(LocalCountryFile::MakeForTesting("2")).first;
+  auto const id3 = mwmSet.Register(LocalCountryFile::MakeForTesting("3")).first;
+  TEST(id2.IsAlive(), ());
+  TEST(id3.IsAlive(), ());
+
+  size_t constexpr kThreadsCount = 8;
+  size_t constexpr kIterations = 2000;
+  atomic<size_t> lockedThreadsCount(0);
+  atomic<bool> isMarkedToDeregister(false);
+
+  vector<threads::SimpleThread> threads;
+  for (size_t i = 0; i < kThreadsCount; ++i)
+  {
+    threads.emplace_back([&]()
+    {
+      // Every lock succeeds while mwm 2 is registered.
+      for (size_t j = 0; j < kIterations; ++j)
+      {
+        TEST(mwmSet.GetMwmHandleById(id2).IsAlive(), ());
+        TEST(mwmSet.GetMwmHandleById(id3).IsAlive(), ());
+      }
+
+      ++lockedThreadsCount;
+      while (!isMarkedToDeregister)
+        this_thread::yield();
+
+      // Mwm 2 may be locked until the last of its handles is released and it's deregistered.
+      // No lock succeeds after that.
+      bool isDeregistered = false;
+      for (size_t j = 0; j < kIterations; ++j)
+      {
+        auto const handle2 = mwmSet.GetMwmHandleById(id2);
+        if (isDeregistered)
+          TEST(!handle2.IsAlive(), ());
+        isDeregistered = !handle2.IsAlive();
+        TEST(mwmSet.GetMwmHandleById(id3).IsAlive(), ());
+      }
+    });
+  }
+
+  {
+    auto const handle2 = mwmSet.GetMwmHandleById(id2);
+    TEST(handle2.IsAlive(), ());
+    while (lockedThreadsCount != kThreadsCount)
+      this_thread::yield();
+
+    TEST(!mwmSet.Deregister(CountryFile("2")), ());
+    TEST_EQUAL(MwmInfo::STATUS_MARKED_TO_DEREGISTER, id2.GetInfo()->GetStatus(), ());
+    isMarkedToDeregister = true;
+  }
+
+  for (auto & thread : threads)
+    thread.join();
+
+  TEST(!id2.IsAlive(), ());
+  TEST_EQUAL(MwmInfo::STATUS_DEREGISTERED, id2.GetInfo()->GetStatus(), ());
+  TEST_EQUAL(id2.GetInfo()->GetNumRefs(), 0, ());
+  TEST(!mwmSet.GetMwmHandleById(id2).IsAlive(), ());
+
+  TEST(id3.IsAlive(), ());
+  TEST_EQUAL(id3.GetInfo()->GetNumRefs(), 0, ());
+  TEST(mwmSet.Deregister(CountryFile("3")), ());
+}
+
+BENCHMARK_TEST(MwmSetHandleContention)
+{
+  vector<unique_ptr<ScopedMwm>> mwms;
+  TestMwmSet mwmSet;
+  vector<MwmSet::MwmId> ids;
+  for (char c = '0'; c <= '9'; ++c)
+  {
+    string const name(1, c);
+    mwms.push_back(make_unique<ScopedMwm>(name + ".mwm"));
+    ids.push_back(mwmSet.Register(LocalCountryFile::MakeForTesting(name)).first);
+  }
+
+  size_t constexpr kIterations = 100000;
+  for (size_t threadsCount : {1, 2, 4, 8})
+  {
+    base::Timer timer;
+    vector<threads::SimpleThread> threads;
+    for (size_t i = 0; i < threadsCount; ++i)
+    {
+      threads.emplace_back([&, i]()
+      {
+        for (size_t j = 0; j < kIterations; ++j)
+        {
+          // Every thread mostly works with its own mwm and sometimes with a shared one.
+          auto const & id = ids[j % 8 == 0 ? 0 : 1 + i % (ids.size() - 1)];
+          auto const handle = mwmSet.GetMwmHandleById(id);
+          TEST(handle.IsAlive(), ());
+        }
+      });
+    }
+    for (auto & thread : threads)
+      thread.join();
+
+    auto const seconds = timer.ElapsedSeconds();
+    LOG(LINFO, (threadsCount, "threads:", seconds, "s,",
+                static_cast<int>(seconds * 1e9 / (threadsCount * kIterations)), "ns per handle"));
+  }
+}
 }  // namespace mwm_set_test
@@ -0,0 +1,58 @@
+#include "indexer/mapped_features.hpp"
+
+#include "indexer/dat_section_header.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/varint.hpp"
+
+#include "base/assert.hpp"
+#include "base/macros.hpp"
+
+#include "defines.hpp"
+
+namespace feature
+{
+std::string DebugPrint(FeaturesBackend backend)
+{
+  switch (backend)
+  {
+  case FeaturesBackend::Reader: return "Reader";
+  case FeaturesBackend::Mapped: return "Mapped";
+  case FeaturesBackend::Concurrent: return "Concurrent";
+  }
+  UNREACHABLE();
+}
+
+// static
+std::unique_ptr<MappedFeatures> MappedFeatures::Load(FilesContainerR const & cont)
+{
+  DatSectionHeader header;
+  header.Read(*cont.GetReader(FEATURES_FILE_TAG).GetPtr());
+
+  auto const section = cont.GetAbsoluteOffsetAndSize(FEATURES_FILE_TAG);
+  CHECK_LESS_OR_EQUAL(static_cast<uint64_t>(header.m_featuresOffset) + header.m_featuresSize,
+                      section.second, (cont.GetFileName()));
+
+  std::unique_ptr<MappedFeatures> features(new MappedFeatures());
+  features->m_size = header.m_featuresSize;
+  if (features->m_size == 0)
+    return features;
+
+  features->m_file.Open(cont.GetFileName());
+  features->m_handle.Assign(features->m_file.Map(section.first + header.m_featuresOffset,
+                                                 header.m_featuresSize, FEATURES_FILE_TAG));
+  features->m_data = features->m_handle.GetData<uint8_t>();
+  return features;
+}
+
+uint8_t const * MappedFeatures::GetRecord(uint64_t pos, size_t & size) const
+{
+  ASSERT_LESS(pos, m_size, ());
+  ArrayByteSource source(m_data + pos);
+  size = ReadVarUint<uint32_t>(source);
+
+  uint8_t const * data = source.PtrUint8();
+  ASSERT_LESS_OR_EQUAL(static_cast<uint64_t>(data - m_data) + size, m_size, ());
+  return data;
+}
+}  // namespace feature
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "coding/files_container.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace feature
+{
+/// Defines how FeaturesVector gets serialized features from the features section.
+enum class FeaturesBackend
+{
+  /// Every feature is copied via the container's reader (default).
+  Reader,
+  /// The features section is memory-mapped once per mwm and FeatureType is decoded
+  /// directly from the mapped memory.
+  Mapped,
+  /// The same as Mapped, but all other sections (geometry, metadata, etc.) are read
+  /// from the memory-mapped mwm too. No reader keeps mutable state, so one FeatureSource
+  /// (or FeaturesVector) of an mwm may be shared by rendering, search and routing threads
+  /// without per-thread page caches.
+  Concurrent
+};
+
+std::string DebugPrint(FeaturesBackend backend);
+
+/// Memory-mapped records of the features section (see DatSectionHeader).
+/// Records are encoded as [VarUint size] [Data] .. [VarUint size] [Data], the same way
+/// VarRecordReader reads them.
+/// This class is immutable after loading, so one instance may be shared by all
+/// FeaturesVectors (and threads) of an mwm.
+class MappedFeatures
+{
+public:
+  static std::unique_ptr<MappedFeatures> Load(FilesContainerR const & cont);
+
+  MappedFeatures(MappedFeatures const &) = delete;
+  MappedFeatures & operator=(MappedFeatures const &) = delete;
+
+  /// \param pos offset of a record relative to the start of features.
+  /// \return pointer to the record's data which is valid while this instance is alive.
+  uint8_t const * GetRecord(uint64_t pos, size_t & size) const;
+
+  template <class ToDo>
+  void ForEachRecord(ToDo && toDo) const
+  {
+    uint64_t pos = 0;
+    while (pos < m_size)
+    {
+      size_t size = 0;
+      uint8_t const * data = GetRecord(pos, size);
+      toDo(static_cast<uint32_t>(pos), data, size);
+      pos = static_cast<uint64_t>(data - m_data) + size;
+    }
+  }
+
+  uint64_t GetSize() const { return m_size; }
+
+private:
+  MappedFeatures() = default;
+
+  ::detail::MappedFile m_file;
+  ::detail::MappedFile::Handle m_handle;
+  uint8_t const * m_data = nullptr;
+  uint64_t m_size = 0;
+};
+}  // namespace feature
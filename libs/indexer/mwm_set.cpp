@@ -1,8 +1,10 @@
 #include "indexer/mwm_set.hpp"
 
 #include "indexer/features_offsets_table.hpp"
+#include "indexer/mapped_features.hpp"
 #include "indexer/scales.hpp"
 
+#include "coding/mmap_reader.hpp"
 #include "coding/reader.hpp"
 
 #include "platform/local_country_file_utils.hpp"
@@ -13,6 +15,7 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <exception>
 #include <sstream>
 
@@ -23,6 +26,27 @@ using platform::LocalCountryFile;
 
 MwmInfo::MwmInfo() : m_minScale(0), m_maxScale(0), m_status(STATUS_DEREGISTERED), m_numRefs(0) {}
 
+bool MwmInfo::TryAddRef()
+{
+  if ((m_numRefs.fetch_add(1) & kDeregisteredRef) == 0)
+    return true;
+  m_numRefs.fetch_sub(1);
+  return false;
+}
+
+uint32_t MwmInfo::ReleaseRef()
+{
+  auto const numRefs = m_numRefs.fetch_sub(1);
+  ASSERT_GREATER(numRefs & ~kDeregisteredRef, 0, ());
+  return numRefs - 1;
+}
+
+bool MwmInfo::TryMarkDeregistered()
+{
+  uint32_t expected = 0;
+  return m_numRefs.compare_exchange_strong(expected, kDeregisteredRef);
+}
+
 MwmInfo::MwmTypeT MwmInfo::GetType() const
 {
   if (m_minScale > 0)
@@ -154,30 +178,32 @@ pair<MwmSet::MwmId, MwmSet::RegResult> MwmSet::RegisterImpl(LocalCountryFile con
   return make_pair(MwmId(info), RegResult::Success);
 }
 
+MwmSet::MwmSet(size_t cacheSize)
+  : m_shardCacheSize(max<size_t>(1, (cacheSize + kCacheShardsCount - 1) / kCacheShardsCount))
+{
+}
+
 bool MwmSet::DeregisterImpl(MwmId const & id, EventList & events)
 {
   if (!id.IsAlive())
     return false;
 
   shared_ptr<MwmInfo> const & info = id.GetInfo();
-  if (info->m_numRefs == 0)
+  if (!info->TryMarkDeregistered())
   {
-    SetStatus(*info, MwmInfo::STATUS_DEREGISTERED, events);
-    vector<shared_ptr<MwmInfo>> & infos = m_info[info->GetCountryName()];
-    infos.erase(remove(infos.begin(), infos.end(), info), infos.end());
-    for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
-    {
-      if (it->first == id)
-      {
-        m_cache.erase(it);
-        break;
-      }
-    }
-    return true;
+    SetStatus(*info, MwmInfo::STATUS_MARKED_TO_DEREGISTER, events);
+
+    // The last handle may be released between the check above and the status
+    // change, in this case UnlockValue() doesn't see the new status.
+    if (!info->TryMarkDeregistered())
+      return false;
   }
 
-  SetStatus(*info, MwmInfo::STATUS_MARKED_TO_DEREGISTER, events);
-  return false;
+  SetStatus(*info, MwmInfo::STATUS_DEREGISTERED, events);
+  vector<shared_ptr<MwmInfo>> & infos = m_info[info->GetCountryName()];
+  infos.erase(remove(infos.begin(), infos.end(), info), infos.end());
+  ClearCache(id);
+  return true;
 }
 
 bool MwmSet::Deregister(CountryFile const & countryFile)
@@ -256,68 +282,56 @@ void MwmSet::ProcessEventList(EventList & events)
 }
 
 unique_ptr<MwmValue> MwmSet::LockValue(MwmId const & id)
-{
-  unique_ptr<MwmValue> result;
-  WithEventLog([&](EventList & events)
-               {
-                 result = LockValueImpl(id, events);
-               });
-  return result;
-}
-
-unique_ptr<MwmValue> MwmSet::LockValueImpl(MwmId const & id, EventList & events)
 {
   if (!id.IsAlive())
     return nullptr;
-  shared_ptr<MwmInfo> info = id.GetInfo();
+  shared_ptr<MwmInfo> const & info = id.GetInfo();
 
   // It's better to return valid "value pointer" even for "out-of-date" files,
   // because they can be locked for a long time by other algos.
   //if (!info->IsUpToDate())
   //  return TMwmValuePtr();
 
-  ++info->m_numRefs;
+  if (!info->TryAddRef())
+    return nullptr;
 
-  // Search in cache.
-  for (auto it = m_cache.begin(); it != m_cache.end(); ++it)
+  auto & shard = GetCacheShard(id);
   {
-    if (it->first == id)
+    lock_guard<mutex> lock(shard.m_lock);
+    for (auto it = shard.m_cache.begin(); it != shard.m_cache.end(); ++it)
     {
-      unique_ptr<MwmValue> result = std::move(it->second);
-      m_cache.erase(it);
-      return result;
+      if (it->first == id)
+      {
+        unique_ptr<MwmValue> result = std::move(it->second);
+        shard.m_cache.erase(it);
+        return result;
+      }
     }
   }
 
   try
   {
+    // Values of the same mwm share some data via MwmInfoEx, see MwmValue::SetTable().
+    lock_guard<mutex> lock(shard.m_lock);
     return CreateValue(*info);
   }
   catch (Reader::TooManyFilesException const & ex)
   {
     LOG(LERROR, ("Too many open files, can't open:", info->GetCountryName()));
-    --info->m_numRefs;
+    info->ReleaseRef();
     return nullptr;
   }
   catch (exception const & ex)
   {
     LOG(LERROR, ("Can't create MWMValue for", info->GetCountryName(), "Reason", ex.what()));
 
-    --info->m_numRefs;
-    DeregisterImpl(id, events);
+    info->ReleaseRef();
+    WithEventLog([&](EventList & events) { DeregisterImpl(id, events); });
     return nullptr;
   }
 }
 
 void MwmSet::UnlockValue(MwmId const & id, unique_ptr<MwmValue> p)
-{
-  WithEventLog([&](EventList & events)
-               {
-                 UnlockValueImpl(id, std::move(p), events);
-               });
-}
-
-void MwmSet::UnlockValueImpl(MwmId const & id, unique_ptr<MwmValue> p, EventList & events)
 {
   ASSERT(id.IsAlive(), (id));
   ASSERT(p.get() != nullptr, ());
@@ -325,37 +339,54 @@ void MwmSet::UnlockValueImpl(MwmId const & id, unique_ptr<MwmValue> p, EventList
     return;
 
   shared_ptr<MwmInfo> const & info = id.GetInfo();
-  ASSERT_GREATER(info->m_numRefs, 0, ());
-  --info->m_numRefs;
-  if (info->m_numRefs == 0 && info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
-    VERIFY(DeregisterImpl(id, events), ());
 
+  // The value is cached before the ref is released, so the deregistration,
+  // which is possible only after that, removes it from the cache.
   if (info->IsUpToDate())
   {
     /// @todo Probably, it's better to store only "unique by id" free caches here.
     /// But it's no obvious if we have many threads working with the single mwm.
 
-    m_cache.push_back(make_pair(id, std::move(p)));
-    if (m_cache.size() > m_cacheSize)
+    auto & shard = GetCacheShard(id);
+    lock_guard<mutex> lock(shard.m_lock);
+    shard.m_cache.push_back(make_pair(id, std::move(p)));
+    if (shard.m_cache.size() > m_shardCacheSize)
     {
-      LOG(LDEBUG, ("MwmValue max cache size reached! Added", id, "removed", m_cache.front().first));
-      ASSERT_EQUAL(m_cache.size(), m_cacheSize + 1, ());
-      m_cache.pop_front();
+      LOG(LDEBUG, ("MwmValue max cache size reached! Added", id, "removed", shard.m_cache.front().first));
+      ASSERT_EQUAL(shard.m_cache.size(), m_shardCacheSize + 1, ());
+      shard.m_cache.pop_front();
     }
   }
+
+  if (info->ReleaseRef() == 0 && info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
+  {
+    WithEventLog([&](EventList & events)
+                 {
+                   // The mwm may be registered again or deregistered by another thread.
+                   if (info->GetStatus() == MwmInfo::STATUS_MARKED_TO_DEREGISTER)
+                     DeregisterImpl(id, events);
+                 });
+  }
 }
 
 void MwmSet::Clear()
 {
   lock_guard<mutex> lock(m_lock);
-  ClearCacheImpl(m_cache.begin(), m_cache.end());
+  for (auto & shard : m_cacheShards)
+  {
+    lock_guard<mutex> shardLock(shard.m_lock);
+    shard.m_cache.clear();
+  }
   m_info.clear();
 }
 
 void MwmSet::ClearCache()
 {
-  lock_guard<mutex> lock(m_lock);
-  ClearCacheImpl(m_cache.begin(), m_cache.end());
+  for (auto & shard : m_cacheShards)
+  {
+    lock_guard<mutex> lock(shard.m_lock);
+    shard.m_cache.clear();
+  }
 }
 
 MwmSet::MwmId MwmSet::GetMwmIdByCountryFile(CountryFile const & countryFile) const
@@ -366,47 +397,57 @@ MwmSet::MwmId MwmSet::GetMwmIdByCountryFile(CountryFile const & countryFile) con
 
 MwmSet::MwmHandle MwmSet::GetMwmHandleByCountryFile(CountryFile const & countryFile)
 {
-  MwmSet::MwmHandle handle;
-  WithEventLog([&](EventList & events)
-               {
-                 handle = GetMwmHandleByIdImpl(GetMwmIdByCountryFileImpl(countryFile), events);
-               });
-  return handle;
+  return GetMwmHandleById(GetMwmIdByCountryFile(countryFile));
 }
 
 MwmSet::MwmHandle MwmSet::GetMwmHandleById(MwmId const & id)
 {
-  MwmSet::MwmHandle handle;
-  WithEventLog([&](EventList & events)
-               {
-                 handle = GetMwmHandleByIdImpl(id, events);
-               });
-  return handle;
+  return MwmHandle(*this, id, LockValue(id));
 }
 
-MwmSet::MwmHandle MwmSet::GetMwmHandleByIdImpl(MwmId const & id, EventList & events)
+MwmSet::CacheShard & MwmSet::GetCacheShard(MwmId const & id)
 {
-  unique_ptr<MwmValue> value;
-  if (id.IsAlive())
-    value = LockValueImpl(id, events);
-  return MwmHandle(*this, id, std::move(value));
+  // Infos are heap-allocated, so the lowest bits of the address are always zero.
+  auto const ptr = reinterpret_cast<uintptr_t>(id.GetInfo().get());
+  return m_cacheShards[(ptr >> 4) % kCacheShardsCount];
 }
 
-void MwmSet::ClearCacheImpl(Cache::iterator beg, Cache::iterator end) { m_cache.erase(beg, end); }
-
 void MwmSet::ClearCache(MwmId const & id)
 {
   auto sameId = [&id](pair<MwmSet::MwmId, unique_ptr<MwmValue>> const & p)
   {
     return (p.first == id);
   };
-  ClearCacheImpl(base::RemoveIfKeepValid(m_cache.begin(), m_cache.end(), sameId), m_cache.end());
+
+  auto & shard = GetCacheShard(id);
+  lock_guard<mutex> lock(shard.m_lock);
+  shard.m_cache.erase(base::RemoveIfKeepValid(shard.m_cache.begin(), shard.m_cache.end(), sameId),
+                      shard.m_cache.end());
 }
 
 // MwmValue ----------------------------------------------------------------------------------------
 
-MwmValue::MwmValue(LocalCountryFile const & localFile)
-  : m_cont(platform::GetCountryReader(localFile, MapFileType::Map)), m_file(localFile)
+namespace
+{
+// Mwms from the bundle may be packed into the application's archive, so they are
+// always read by the platform's reader.
+bool CanReadConcurrently(LocalCountryFile const & localFile, bool concurrentReads)
+{
+  return concurrentReads && !localFile.IsInBundle();
+}
+
+ModelReaderPtr GetMwmReader(LocalCountryFile const & localFile, bool concurrentReads)
+{
+  if (CanReadConcurrently(localFile, concurrentReads))
+    return make_unique<MmapReader>(localFile.GetPath(MapFileType::Map), MmapReader::Advice::Random);
+  return platform::GetCountryReader(localFile, MapFileType::Map);
+}
+}  // namespace
+
+MwmValue::MwmValue(LocalCountryFile const & localFile, bool concurrentReads)
+  : m_cont(GetMwmReader(localFile, concurrentReads))
+  , m_file(localFile)
+  , m_concurrentReader(CanReadConcurrently(localFile, concurrentReads))
 {
   m_factory.Load(m_cont);
 }
@@ -421,6 +462,16 @@ void MwmValue::SetTable(MwmInfoEx & info)
   info.m_table = m_table;
 }
 
+void MwmValue::SetMappedFeatures(MwmInfoEx & info)
+{
+  m_mappedFeatures = info.m_mappedFeatures.lock();
+  if (m_mappedFeatures)
+    return;
+
+  m_mappedFeatures = feature::MappedFeatures::Load(m_cont);
+  info.m_mappedFeatures = m_mappedFeatures;
+}
+
 string DebugPrint(MwmSet::RegResult result)
 {
   switch (result)
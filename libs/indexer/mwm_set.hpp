@@ -12,6 +12,7 @@
 
 #include "defines.hpp"
 
+#include <array>
 #include <atomic>
 #include <deque>
 #include <map>
@@ -21,7 +22,11 @@
 #include <utility>
 #include <vector>
 
-namespace feature { class FeaturesOffsetsTable; }
+namespace feature
+{
+class FeaturesOffsetsTable;
+class MappedFeatures;
+}  // namespace feature
 
 /// Information about stored mwm.
 class MwmInfo
@@ -74,7 +79,7 @@ public:
   feature::RegionData const & GetRegionData() const { return m_data; }
 
   /// Returns the lock counter value for test needs.
-  uint8_t GetNumRefs() const { return m_numRefs; }
+  uint8_t GetNumRefs() const { return static_cast<uint8_t>(m_numRefs & ~kDeregisteredRef); }
 
 protected:
   Status SetStatus(Status status)
@@ -84,11 +89,23 @@ protected:
     return result;
   }
 
+  /// Returns false if the mwm is already deregistered and can't be locked.
+  bool TryAddRef();
+  /// Returns the number of refs left.
+  uint32_t ReleaseRef();
+  /// Returns true if there are no active handles. New handles can't be locked after that.
+  bool TryMarkDeregistered();
+
   feature::RegionData m_data;
 
   platform::LocalCountryFile m_file;  ///< Path to the mwm file.
   std::atomic<Status> m_status;       ///< Current country status.
-  uint32_t m_numRefs;                 ///< Number of active handles.
+
+  /// Number of active handles. Handles are locked and released without MwmSet::m_lock,
+  /// so the counter is set to |kDeregisteredRef| by the deregistration to prevent
+  /// new locks after the last handle is released.
+  static uint32_t constexpr kDeregisteredRef = 1U << 31;
+  std::atomic<uint32_t> m_numRefs;
 };
 
 class MwmInfoEx : public MwmInfo
@@ -103,9 +120,11 @@ private:
   // must be removed as soon as the last corresponding MwmValue is
   // destroyed. Also, note that this value must be used and modified
   // only in MwmValue::SetTable() method, which, in turn, is called
-  // only in the MwmSet critical section, protected by a lock.  So,
+  // only under the lock of the MwmSet's cache shard of the MWM. So,
   // there's an implicit synchronization on this field.
   std::weak_ptr<feature::FeaturesOffsetsTable> m_table;
+  // Features section mapping, shared the same way as |m_table|.
+  std::weak_ptr<feature::MappedFeatures> m_mappedFeatures;
 };
 
 class MwmValue;
@@ -138,7 +157,8 @@ public:
   };
 
 public:
-  explicit MwmSet(size_t cacheSize = 64) : m_cacheSize(cacheSize) {}
+  /// |cacheSize| is a total number of cached MwmValues, it's split between cache shards.
+  explicit MwmSet(size_t cacheSize = 64);
   virtual ~MwmSet() = default;
 
   // Mwm handle, which is used to refer to mwm and prevent it from
@@ -316,6 +336,17 @@ protected:
 private:
   using Cache = std::deque<std::pair<MwmId, std::unique_ptr<MwmValue>>>;
 
+  // Free MwmValues are cached in shards by MwmId, so handles of
+  // different mwms are locked and released without contention.
+  // All values of an mwm are always in the same shard.
+  struct CacheShard
+  {
+    std::mutex m_lock;
+    Cache m_cache;
+  };
+
+  static size_t constexpr kCacheShardsCount = 8;
+
   // This is the only valid way to take |m_lock| and use *Impl()
   // functions. The reason is that event processing requires
   // triggering of observers, but it's generally unsafe to call
@@ -340,23 +371,20 @@ private:
   // Triggers observers on each event in |events|.
   void ProcessEventList(EventList & events);
 
-  /// @precondition This function is always called under mutex m_lock.
-  MwmHandle GetMwmHandleByIdImpl(MwmId const & id, EventList & events);
-
+  // Handles are locked and released without |m_lock|: the value is taken from
+  // (or returned to) the cache shard of the mwm and MwmInfo::m_numRefs is
+  // changed atomically. |m_lock| is taken only when the mwm must be deregistered.
   std::unique_ptr<MwmValue> LockValue(MwmId const & id);
-  std::unique_ptr<MwmValue> LockValueImpl(MwmId const & id, EventList & events);
   void UnlockValue(MwmId const & id, std::unique_ptr<MwmValue> p);
-  void UnlockValueImpl(MwmId const & id, std::unique_ptr<MwmValue> p, EventList & events);
 
-  /// Do the cleaning for [beg, end) without acquiring the mutex.
-  /// @precondition This function is always called under mutex m_lock.
-  void ClearCacheImpl(Cache::iterator beg, Cache::iterator end);
+  CacheShard & GetCacheShard(MwmId const & id);
 
-  Cache m_cache;
-  size_t const m_cacheSize;
+  std::array<CacheShard, kCacheShardsCount> m_cacheShards;
+  size_t const m_shardCacheSize;
 
 protected:
-  /// @precondition This function is always called under mutex m_lock.
+  /// Removes cached values of |id|. Takes the lock of the cache shard,
+  /// so it may be called both under mutex m_lock and without it.
   void ClearCache(MwmId const & id);
 
   /// Find mwm with a given name.
@@ -379,11 +407,16 @@ public:
   platform::LocalCountryFile const m_file;
 
   std::shared_ptr<feature::FeaturesOffsetsTable> m_table;
+  // Not null only when features are decoded directly from the mapped features section.
+  std::shared_ptr<feature::MappedFeatures> m_mappedFeatures;
   std::unique_ptr<indexer::MetadataDeserializer> m_metaDeserializer;
   std::unique_ptr<HouseToStreetTable> m_house2street, m_house2place;
 
-  explicit MwmValue(platform::LocalCountryFile const & localFile);
+  /// If |concurrentReads| is true, the mwm file is read via a memory mapping instead of
+  /// FileReader with its page cache, see feature::FeaturesBackend::Concurrent.
+  explicit MwmValue(platform::LocalCountryFile const & localFile, bool concurrentReads = false);
   void SetTable(MwmInfoEx & info);
+  void SetMappedFeatures(MwmInfoEx & info);
 
   feature::DataHeader const & GetHeader() const  { return m_factory.GetHeader(); }
   feature::RegionData const & GetRegionData() const { return m_factory.GetRegionData(); }
@@ -392,6 +425,13 @@ public:
 
   bool HasSearchIndex() const { return m_cont.IsExist(SEARCH_INDEX_FILE_TAG); }
   bool HasGeometryIndex() const { return m_cont.IsExist(INDEX_FILE_TAG); }
+
+  /// Returns true if the container's reader has no mutable state, so features of this
+  /// value may be read by several threads at once.
+  bool HasConcurrentReader() const { return m_concurrentReader; }
+
+private:
+  bool m_concurrentReader = false;
 }; // class MwmValue
 
 
@@ -1,5 +1,10 @@
 #pragma once
 
+#include "indexer/mapped_features.hpp"
+
+#include "geometry/rect2d.hpp"
+
+#include <cstddef>
 #include <string>
 #include <utility>
 #include <vector>
@@ -43,6 +48,33 @@ namespace bench
     double m_all = 0.0;
   };
 
+  class TilesResult
+  {
+  public:
+    void Print();
+
+    Result m_index;
+    Result m_stylist;
+    Result m_shapes;
+    double m_all = 0.0;
+    size_t m_threadsCount = 0;
+    size_t m_tilesCount = 0;
+    size_t m_shapesCount = 0;
+  };
+
   /// @param[in] count number of times to run benchmark
   void RunFeaturesLoadingBenchmark(std::string filePath, std::pair<int, int> scaleR, AllResult & res);
+
+  /// Runs FeaturesVector::ForEach over all features of the mwm |count| times
+  /// with features read via |backend|. If |threadsCount| > 1, features are read by index
+  /// from |threadsCount| threads, which share one FeaturesVector for the Concurrent backend.
+  void RunFeaturesVectorBenchmark(std::string filePath, feature::FeaturesBackend backend,
+                                  size_t count, size_t threadsCount, AllResult & res);
+
+  /// Reads tiles covering |viewports| (or all mwms if it's empty) on each of |zooms| and makes
+  /// map shapes for them as the backend renderer does, but with a null graphics backend.
+  /// Shapes aren't batched into GPU buffers. Tiles are processed once for each threads count.
+  void RunTilesRenderingBenchmark(std::vector<std::string> const & filePaths,
+                                  std::vector<m2::RectD> const & viewports, std::vector<int> const & zooms,
+                                  std::vector<size_t> const & threadsCounts, std::vector<TilesResult> & res);
 }  // namespace bench
@@ -0,0 +1,106 @@
+#include "map/benchmark_tool/api.hpp"
+
+#include "indexer/data_source.hpp"
+#include "indexer/feature.hpp"
+#include "indexer/features_vector.hpp"
+
+#include "platform/local_country_file.hpp"
+
+#include "base/file_name_utils.hpp"
+#include "base/macros.hpp"
+#include "base/timer.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace bench
+{
+void RunFeaturesVectorBenchmark(string fileName, feature::FeaturesBackend backend, size_t count,
+                                size_t threadsCount, AllResult & res)
+{
+  base::GetNameFromFullPath(fileName);
+  base::GetNameWithoutExt(fileName);
+
+  FrozenDataSource dataSource;
+  dataSource.SetFeaturesBackend(backend);
+  auto const r = dataSource.RegisterMap(platform::LocalCountryFile::MakeForTesting(std::move(fileName)));
+  if (r.second != MwmSet::RegResult::Success)
+    return;
+
+  auto const makeVector = [](MwmSet::MwmHandle const & handle)
+  {
+    auto const & value = *handle.GetValue();
+    return make_unique<FeaturesVector>(value.m_cont, value.GetHeader(), value.m_table.get(),
+                                       value.m_metaDeserializer.get(), value.m_mappedFeatures.get());
+  };
+
+  auto const handle = dataSource.GetMwmHandleById(r.first);
+  auto const featuresVector = makeVector(handle);
+
+  if (threadsCount <= 1)
+  {
+    base::Timer decodingTimer;
+    for (size_t i = 0; i < count; ++i)
+    {
+      base::Timer timer;
+      featuresVector->ForEach([&](FeatureType & ft, uint32_t /* index */)
+      {
+        decodingTimer.Reset();
+        // Load feature's header, inner data and geometry.
+        ft.ForEachType([](uint32_t /* type */) {});
+        UNUSED_VALUE(ft.IsEmptyGeometry(FeatureType::BEST_GEOMETRY));
+        res.m_reading.Add(decodingTimer.ElapsedSeconds());
+      });
+      res.Add(timer.ElapsedSeconds());
+    }
+    return;
+  }
+
+  // Threads share |featuresVector| when it's thread-safe, otherwise each thread locks its own
+  // mwm value and reads features via its own FeaturesVector.
+  bool const shared = handle.GetValue()->HasConcurrentReader();
+  vector<MwmSet::MwmHandle> handles;
+  vector<unique_ptr<FeaturesVector>> vectors;
+  for (size_t t = 0; !shared && t < threadsCount; ++t)
+  {
+    handles.push_back(dataSource.GetMwmHandleById(r.first));
+    vectors.push_back(makeVector(handles.back()));
+  }
+
+  auto const numFeatures = static_cast<uint32_t>(featuresVector->GetNumFeatures());
+  for (size_t i = 0; i < count; ++i)
+  {
+    vector<Result> results(threadsCount);
+    vector<thread> threads;
+    base::Timer timer;
+    for (size_t t = 0; t < threadsCount; ++t)
+    {
+      threads.emplace_back([&, t]()
+      {
+        FeaturesVector const & v = shared ? *featuresVector : *vectors[t];
+        base::Timer decodingTimer;
+        for (uint32_t index = static_cast<uint32_t>(t); index < numFeatures;
+             index += static_cast<uint32_t>(threadsCount))
+        {
+          decodingTimer.Reset();
+          auto ft = v.GetByIndex(index);
+          ft->ForEachType([](uint32_t /* type */) {});
+          UNUSED_VALUE(ft->IsEmptyGeometry(FeatureType::BEST_GEOMETRY));
+          results[t].Add(decodingTimer.ElapsedSeconds());
+        }
+      });
+    }
+    for (auto & t : threads)
+      t.join();
+    res.Add(timer.ElapsedSeconds());
+
+    for (auto const & result : results)
+      res.m_reading.Add(result);
+  }
+}
+}  // namespace bench
@@ -3,6 +3,12 @@
 #include "indexer/classificator_loader.hpp"
 #include "indexer/data_header.hpp"
 
+#include "geometry/mercator.hpp"
+
+#include "base/logging.hpp"
+#include "base/string_utils.hpp"
+
+#include <algorithm>
 #include <iostream>
 
 #include <gflags/gflags.h>
@@ -13,6 +19,46 @@ DEFINE_string(input, "", "MWM file name in the data directory");
 DEFINE_int32(lowS, 10, "Low processing scale");
 DEFINE_int32(highS, 17, "High processing scale");
 DEFINE_bool(print_scales, false, "Print geometry scales for MWM and exit");
+DEFINE_bool(features_vector, false,
+            "Compare FeaturesVector::ForEach with reader, mapped and concurrent features backends and exit");
+DEFINE_int32(features_vector_count, 3, "Number of FeaturesVector::ForEach passes for each backend");
+DEFINE_int32(features_vector_threads, 1, "Number of threads which read features for each backend");
+DEFINE_bool(tiles, false,
+            "Read tiles and make map shapes for them with a null graphics backend and exit. "
+            "Input may be a comma-separated list of MWMs");
+DEFINE_string(tiles_viewports, "",
+              "Semicolon-separated viewports as minLat,minLon,maxLat,maxLon. All MWMs are covered if empty");
+DEFINE_string(tiles_zooms, "10,13,16", "Comma-separated tile zoom levels");
+DEFINE_string(tiles_threads, "1,2,4", "Comma-separated numbers of reading threads");
+
+namespace
+{
+template <typename T>
+bool ParseNumbers(string const & s, vector<T> & numbers)
+{
+  for (auto const & token : strings::Tokenize(s, ","))
+  {
+    T n;
+    if (!strings::to_any(string(token), n))
+      return false;
+    numbers.push_back(n);
+  }
+  return true;
+}
+
+bool ParseViewports(string const & s, vector<m2::RectD> & viewports)
+{
+  for (auto const & token : strings::Tokenize(s, ";"))
+  {
+    vector<double> coords;
+    if (!ParseNumbers(string(token), coords) || coords.size() != 4)
+      return false;
+    viewports.emplace_back(mercator::FromLatLon(coords[0], coords[1]),
+                           mercator::FromLatLon(coords[2], coords[3]));
+  }
+  return true;
+}
+}  // namespace
 
 int main(int argc, char ** argv)
 {
@@ -37,6 +83,46 @@ int main(int argc, char ** argv)
     return 0;
   }
 
+  if (FLAGS_tiles && !FLAGS_input.empty())
+  {
+    using namespace bench;
+
+    auto const files = strings::Tokenize<string>(FLAGS_input, ",");
+
+    vector<m2::RectD> viewports;
+    vector<int> zooms;
+    vector<size_t> threadsCounts;
+    if (!ParseViewports(FLAGS_tiles_viewports, viewports) || !ParseNumbers(FLAGS_tiles_zooms, zooms) ||
+        !ParseNumbers(FLAGS_tiles_threads, threadsCounts))
+    {
+      LOG(LERROR, ("Invalid tiles benchmark parameters"));
+      return 1;
+    }
+
+    vector<TilesResult> res;
+    RunTilesRenderingBenchmark(files, viewports, zooms, threadsCounts, res);
+    for (auto & r : res)
+      r.Print();
+    return 0;
+  }
+
+  if (FLAGS_features_vector && !FLAGS_input.empty())
+  {
+    using namespace bench;
+
+    for (auto const backend : {feature::FeaturesBackend::Reader, feature::FeaturesBackend::Mapped,
+                               feature::FeaturesBackend::Concurrent})
+    {
+      AllResult res;
+      RunFeaturesVectorBenchmark(FLAGS_input, backend, FLAGS_features_vector_count,
+                                 static_cast<size_t>(max(FLAGS_features_vector_threads, 1)), res);
+
+      cout << DebugPrint(backend) << " backend: ";
+      res.Print();
+    }
+    return 0;
+  }
+
   if (!FLAGS_input.empty())
   {
     using namespace bench;
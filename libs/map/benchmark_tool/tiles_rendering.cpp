@@ -0,0 +1,305 @@
+#include "map/benchmark_tool/api.hpp"
+
+#include "map/features_fetcher.hpp"
+
+#include "drape_frontend/engine_context.hpp"
+#include "drape_frontend/map_data_provider.hpp"
+#include "drape_frontend/map_shape.hpp"
+#include "drape_frontend/metaline_manager.hpp"
+#include "drape_frontend/rule_drawer.hpp"
+#include "drape_frontend/stylist.hpp"
+#include "drape_frontend/tile_utils.hpp"
+#include "drape_frontend/visual_params.hpp"
+
+#include "drape/graphics_context.hpp"
+#include "drape/hw_texture.hpp"
+#include "drape/texture_manager.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/string_utf8_multilang.hpp"
+
+#include "base/file_name_utils.hpp"
+#include "base/logging.hpp"
+#include "base/macros.hpp"
+#include "base/timer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+namespace bench
+{
+namespace
+{
+uint32_t constexpr kTileSize = 256;
+
+// Graphics context without a graphics API. Nothing is rendered with it, it only lets
+// the texture manager and shapes be created without a GPU.
+class NullGraphicsContext : public dp::GraphicsContext
+{
+public:
+  void Present() override {}
+  void MakeCurrent() override {}
+  void SetFramebuffer(ref_ptr<dp::BaseFramebuffer> framebuffer) override {}
+  void ForgetFramebuffer(ref_ptr<dp::BaseFramebuffer> framebuffer) override {}
+  void ApplyFramebuffer(string const & framebufferLabel) override {}
+
+  void Init(dp::ApiVersion apiVersion) override {}
+  dp::ApiVersion GetApiVersion() const override { return dp::ApiVersion::Invalid; }
+  string GetRendererName() const override { return {}; }
+  string GetRendererVersion() const override { return {}; }
+
+  void PushDebugLabel(string const & label) override {}
+  void PopDebugLabel() override {}
+
+  void SetClearColor(dp::Color const & color) override {}
+  void Clear(uint32_t clearBits, uint32_t storeBits) override {}
+  void Flush() override {}
+  void SetViewport(uint32_t x, uint32_t y, uint32_t w, uint32_t h) override {}
+  void SetScissor(uint32_t x, uint32_t y, uint32_t w, uint32_t h) override {}
+  void SetDepthTestEnabled(bool enabled) override {}
+  void SetDepthTestFunction(dp::TestFunction depthFunction) override {}
+  void SetStencilTestEnabled(bool enabled) override {}
+  void SetStencilFunction(dp::StencilFace face, dp::TestFunction stencilFunction) override {}
+  void SetStencilActions(dp::StencilFace face, dp::StencilAction stencilFailAction,
+                         dp::StencilAction depthFailAction, dp::StencilAction passAction) override {}
+  void SetStencilReferenceValue(uint32_t stencilReferenceValue) override {}
+  void SetCullingEnabled(bool enabled) override {}
+};
+
+// Texture which keeps its parameters only, so texture regions have correct sizes.
+class NullHWTexture : public dp::HWTexture
+{
+public:
+  void Create(ref_ptr<dp::GraphicsContext> context, Params const & params, ref_ptr<void> data) override
+  {
+    m_params = params;
+  }
+  void UploadData(ref_ptr<dp::GraphicsContext> context, uint32_t x, uint32_t y, uint32_t width,
+                  uint32_t height, ref_ptr<void> data) override {}
+  void Bind(ref_ptr<dp::GraphicsContext> context) const override {}
+  void SetFilter(dp::TextureFilter filter) override { m_params.m_filter = filter; }
+  bool Validate() const override { return true; }
+};
+
+class NullHWTextureAllocator : public dp::HWTextureAllocator
+{
+public:
+  drape_ptr<dp::HWTexture> CreateTexture(ref_ptr<dp::GraphicsContext> context) override
+  {
+    return make_unique_dp<NullHWTexture>();
+  }
+  void Flush() override {}
+};
+
+// Engine context which counts read shapes instead of sending them to the backend renderer.
+class CountingEngineContext : public df::EngineContext
+{
+public:
+  CountingEngineContext(df::TileKey const & tileKey, ref_ptr<dp::TextureManager> texMng,
+                        ref_ptr<df::MetalineManager> metalineMng)
+    : df::EngineContext(tileKey, nullptr /* commutator */, texMng, metalineMng,
+                        {} /* customFeaturesContext */, false /* is3dBuildingsEnabled */,
+                        false /* isTrafficEnabled */, false /* isolinesEnabled */,
+                        StringUtf8Multilang::kDefaultCode)
+  {}
+
+  size_t GetShapesCount() const { return m_shapesCount; }
+
+protected:
+  void PostMessage(drape_ptr<df::Message> && message, df::MessagePriority priority) override
+  {
+    auto const type = message->GetType();
+    if (type == df::Message::Type::MapShapeReaded || type == df::Message::Type::OverlayMapShapeReaded)
+      m_shapesCount += static_cast<df::MapShapeReadedMessage &>(*message).GetShapes().size();
+  }
+
+private:
+  size_t m_shapesCount = 0;
+};
+
+struct StagesResult
+{
+  Result m_index;
+  Result m_stylist;
+  Result m_shapes;
+  size_t m_shapesCount = 0;
+};
+
+class TilesReader
+{
+public:
+  TilesReader(FeaturesFetcher const & fetcher, ref_ptr<dp::TextureManager> texMng)
+    : m_model([&fetcher](df::MapDataProvider::TReadCallback<FeatureID const> const & fn,
+                         m2::RectD const & r, int scale) { fetcher.ForEachFeatureID(r, fn, scale); },
+              [&fetcher](df::MapDataProvider::TReadCallback<FeatureType> const & fn,
+                         vector<FeatureID> const & ids) { fetcher.ReadFeatures(fn, ids); },
+              [&fetcher](string_view countryId) { return fetcher.IsLoaded(countryId); },
+              [](m2::PointD const &, int) {})
+    // Metalines are read asynchronously by the backend renderer, so lines are not merged here.
+    , m_metalineManager(nullptr /* commutator */, m_model)
+    , m_texMng(texMng)
+  {
+  }
+
+  void ReadTile(df::TileKey const & tileKey, StagesResult & res) const
+  {
+    base::Timer timer;
+
+    // Index stage: the same as TileInfo::ReadFeatureIndex.
+    vector<FeatureID> ids;
+    m_model.ReadFeaturesID([&ids](FeatureID const & id) { ids.push_back(id); },
+                           tileKey.GetGlobalRect(), df::ClipTileZoomByMaxDataZoom(tileKey.m_zoomLevel));
+    sort(ids.begin(), ids.end());
+    res.m_index.Add(timer.ElapsedSeconds());
+
+    if (ids.empty())
+      return;
+
+    // Stylist stage: features decoding and drawing rules selection.
+    timer.Reset();
+    m_model.ReadFeatures([&tileKey](FeatureType & ft)
+    {
+      df::Stylist const s(ft, tileKey.m_zoomLevel, StringUtf8Multilang::kDefaultCode);
+      UNUSED_VALUE(s);
+    }, ids);
+    res.m_stylist.Add(timer.ElapsedSeconds());
+
+    // Shapes stage: the same as TileInfo::ReadFeatures, it includes features reading and styling.
+    timer.Reset();
+    CountingEngineContext context(tileKey, m_texMng, make_ref(&m_metalineManager));
+    {
+      df::RuleDrawer drawer([]() { return false; }, m_model.m_isCountryLoadedByName, make_ref(&context),
+                            StringUtf8Multilang::kDefaultCode);
+      m_model.ReadFeatures([&drawer](FeatureType & ft) { drawer(ft); }, ids);
+    }
+    res.m_shapes.Add(timer.ElapsedSeconds());
+    res.m_shapesCount += context.GetShapesCount();
+  }
+
+private:
+  df::MapDataProvider m_model;
+  mutable df::MetalineManager m_metalineManager;
+  ref_ptr<dp::TextureManager> m_texMng;
+};
+
+void InitTextureManager(ref_ptr<dp::GraphicsContext> context, dp::TextureManager & texMng)
+{
+  dp::TextureManager::Params params;
+  params.m_resPostfix = df::VisualParams::Instance().GetResourcePostfix();
+  params.m_visualScale = df::VisualParams::Instance().GetVisualScale();
+  params.m_colors = "colors.txt";
+  params.m_patterns = "patterns.txt";
+  params.m_glyphMngParams.m_uniBlocks = base::JoinPath("fonts", "unicode_blocks.txt");
+  params.m_glyphMngParams.m_whitelist = base::JoinPath("fonts", "whitelist.txt");
+  params.m_glyphMngParams.m_blacklist = base::JoinPath("fonts", "blacklist.txt");
+  GetPlatform().GetFontNames(params.m_glyphMngParams.m_fonts);
+  params.m_textureAllocatorFactory = []() -> drape_ptr<dp::HWTextureAllocator>
+  {
+    return make_unique_dp<NullHWTextureAllocator>();
+  };
+
+  texMng.Init(context, params);
+}
+
+void PrintStage(string const & name, Result & r)
+{
+  r.CalcMetrics();
+  size_t constexpr count = 1000;
+  cout << name << "*1000[ median:" << r.m_med * count << " avg:" << r.m_avg * count
+       << " max:" << r.m_max * count << " ] ";
+}
+}  // namespace
+
+void TilesResult::Print()
+{
+  cout << fixed << setprecision(4) << "threads:" << m_threadsCount << " ";
+  PrintStage("INDEX", m_index);
+  PrintStage("STYLIST", m_stylist);
+  PrintStage("SHAPES", m_shapes);
+  cout << "TILES[ count:" << m_tilesCount << " shapes:" << m_shapesCount
+       << " per second:" << (m_all > 0.0 ? m_tilesCount / m_all : 0.0) << " ]" << endl;
+}
+
+void RunTilesRenderingBenchmark(vector<string> const & filePaths, vector<m2::RectD> const & viewports,
+                                vector<int> const & zooms, vector<size_t> const & threadsCounts,
+                                vector<TilesResult> & res)
+{
+  FeaturesFetcher fetcher;
+  m2::RectD bordersRect;
+  for (auto fileName : filePaths)
+  {
+    base::GetNameFromFullPath(fileName);
+    base::GetNameWithoutExt(fileName);
+
+    auto const r = fetcher.RegisterMap(platform::LocalCountryFile::MakeForTesting(fileName));
+    if (r.second != MwmSet::RegResult::Success)
+    {
+      LOG(LERROR, ("Can't register", fileName));
+      return;
+    }
+    bordersRect.Add(r.first.GetInfo()->m_bordersRect);
+  }
+
+  vector<df::TileKey> tiles;
+  for (int const zoom : zooms)
+  {
+    for (auto const & viewport : viewports.empty() ? vector<m2::RectD>{bordersRect} : viewports)
+    {
+      df::CalcTilesCoverage(viewport, zoom, [&tiles, zoom](int x, int y)
+      {
+        tiles.emplace_back(x, y, static_cast<uint8_t>(zoom));
+      });
+    }
+  }
+
+  df::VisualParams::Init(1.0 /* visualScale */, kTileSize);
+  NullGraphicsContext context;
+  dp::TextureManager texMng;
+  InitTextureManager(make_ref(&context), texMng);
+
+  TilesReader const reader(fetcher, make_ref(&texMng));
+  for (size_t const threadsCount : threadsCounts)
+  {
+    CHECK_GREATER(threadsCount, 0, ());
+
+    atomic<size_t> nextTile = 0;
+    vector<StagesResult> results(threadsCount);
+    vector<thread> threads;
+    threads.reserve(threadsCount);
+
+    base::Timer timer;
+    for (size_t i = 0; i < threadsCount; ++i)
+    {
+      threads.emplace_back([&reader, &tiles, &nextTile, &result = results[i]]()
+      {
+        for (size_t t = nextTile++; t < tiles.size(); t = nextTile++)
+          reader.ReadTile(tiles[t], result);
+      });
+    }
+    for (auto & t : threads)
+      t.join();
+
+    TilesResult tilesRes;
+    tilesRes.m_all = timer.ElapsedSeconds();
+    tilesRes.m_threadsCount = threadsCount;
+    tilesRes.m_tilesCount = tiles.size();
+    for (auto const & r : results)
+    {
+      tilesRes.m_index.Add(r.m_index);
+      tilesRes.m_stylist.Add(r.m_stylist);
+      tilesRes.m_shapes.Add(r.m_shapes);
+      tilesRes.m_shapesCount += r.m_shapesCount;
+    }
+    res.push_back(std::move(tilesRes));
+  }
+
+  texMng.Release();
+}
+}  // namespace bench
@@ -373,11 +373,10 @@ void TrafficManager::OnTrafficDataResponse(traffic::TrafficInfo && info)
     it->second.m_isWaitingForResponse = false;
     it->second.m_lastAvailability = info.GetAvailability();
 
-    if (!info.GetColoring().empty())
+    if (!info.GetColoring().IsEmpty())
     {
       // Update cache.
-      size_t constexpr kElementSize = sizeof(traffic::TrafficInfo::RoadSegmentId) + sizeof(traffic::SpeedGroup);
-      size_t const dataSize = info.GetColoring().size() * kElementSize;
+      size_t const dataSize = info.GetColoring().GetMemorySize();
       m_currentCacheSizeBytes += (dataSize - it->second.m_dataSize);
       it->second.m_dataSize = dataSize;
       ShrinkCacheToAllowableSize();
@@ -386,7 +385,7 @@ void TrafficManager::OnTrafficDataResponse(traffic::TrafficInfo && info)
     UpdateState();
   }
 
-  if (!info.GetColoring().empty())
+  if (!info.GetColoring().IsEmpty())
   {
     m_drapeEngine.SafeCall(&df::DrapeEngine::UpdateTraffic,
                            static_cast<traffic::TrafficInfo const &>(info));
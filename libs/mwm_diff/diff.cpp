@@ -2,8 +2,10 @@
 
 #include "coding/buffered_file_writer.hpp"
 #include "coding/file_reader.hpp"
+#include "coding/files_container.hpp"
 #include "coding/file_writer.hpp"
 #include "coding/reader.hpp"
+#include "coding/varint.hpp"
 #include "coding/write_to_sink.hpp"
 #include "coding/writer.hpp"
 #include "coding/zlib.hpp"
@@ -12,22 +14,130 @@
 #include "base/cancellable.hpp"
 #include "base/checked_cast.hpp"
 #include "base/logging.hpp"
+#include "base/scope_guard.hpp"
+#include "base/thread_pool_computational.hpp"
 
+#include <algorithm>
+#include <array>
+#include <condition_variable>
 #include <cstdint>
+#include <future>
 #include <iterator>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "3party/bsdiff-courgette/bsdiff/bsdiff.h"
 
+#include "zlib.h"
+
 namespace
 {
-enum Version
+using namespace generator::mwm_diff;
+
+using bsdiff::kNumStreams;
+
+// Sizes of buffers used for the diff application. They bound the memory which is needed
+// to apply a diff of any size.
+size_t constexpr kInflateInBufferSize = 16 * 1024;
+size_t constexpr kInflateOutBufferSize = 64 * 1024;
+size_t constexpr kOldBufferSize = 64 * 1024;
+size_t constexpr kNewBufferSize = 64 * 1024;
+
+// Bound of the memory which is used by parts encoded simultaneously when the diff is made.
+uint64_t constexpr kEncodeMemoryBudget = uint64_t{2} * 1024 * 1024 * 1024;
+
+// Source which incrementally inflates one zlib stream of |rawSize| bytes from |reader|.
+class InflateSource
 {
-  // Format Version 0: bsdiff+gzip.
-  VERSION_V0 = 0,
-  VERSION_LATEST = VERSION_V0
+public:
+  InflateSource(FileReader && reader, uint64_t rawSize)
+    : m_reader(std::move(reader)), m_rawSize(rawSize), m_in(kInflateInBufferSize), m_out(kInflateOutBufferSize)
+  {
+    if (inflateInit(&m_stream) != Z_OK)
+      MYTHROW(Reader::ReadException, ("Can't init zlib stream"));
+  }
+
+  ~InflateSource() { inflateEnd(&m_stream); }
+
+  // Number of bytes which are not read yet.
+  uint64_t Size() const { return m_rawSize - m_read; }
+
+  void Read(void * p, size_t size)
+  {
+    if (size > Size())
+      MYTHROW(Reader::SizeException, ("Read beyond the end of the stream", size, Size()));
+
+    auto * out = static_cast<uint8_t *>(p);
+    while (size != 0)
+    {
+      if (m_outBeg == m_outEnd)
+        Inflate();
+
+      size_t const n = std::min(size, m_outEnd - m_outBeg);
+      std::copy(m_out.data() + m_outBeg, m_out.data() + m_outBeg + n, out);
+      m_outBeg += n;
+      m_read += n;
+      out += n;
+      size -= n;
+    }
+  }
+
+private:
+  void Inflate()
+  {
+    m_stream.next_out = m_out.data();
+    m_stream.avail_out = static_cast<uInt>(m_out.size());
+    while (m_stream.avail_out == m_out.size())
+    {
+      if (m_stream.avail_in == 0 && m_pos < m_reader.Size())
+      {
+        auto const n = static_cast<size_t>(std::min<uint64_t>(m_in.size(), m_reader.Size() - m_pos));
+        m_reader.Read(m_pos, m_in.data(), n);
+        m_pos += n;
+        m_stream.next_in = m_in.data();
+        m_stream.avail_in = static_cast<uInt>(n);
+      }
+
+      int const ret = inflate(&m_stream, Z_NO_FLUSH);
+      if (ret == Z_STREAM_END && m_stream.avail_out == m_out.size())
+        MYTHROW(Reader::ReadException, ("Unexpected end of zlib stream"));
+      if (ret != Z_OK && ret != Z_STREAM_END)
+        MYTHROW(Reader::ReadException, ("Corrupted zlib stream", ret));
+    }
+
+    m_outBeg = 0;
+    m_outEnd = m_out.size() - m_stream.avail_out;
+  }
+
+  FileReader m_reader;
+  uint64_t m_pos = 0;
+  uint64_t const m_rawSize;
+  uint64_t m_read = 0;
+
+  z_stream m_stream = {};
+  std::vector<uint8_t> m_in;
+  std::vector<uint8_t> m_out;
+  size_t m_outBeg = 0;
+  size_t m_outEnd = 0;
+
+  DISALLOW_COPY_AND_MOVE(InflateSource);
 };
 
+uint32_t CalculateCrc(FileReader const & reader)
+{
+  std::vector<uint8_t> buffer(kOldBufferSize);
+  uLong crc = crc32(0, nullptr, 0);
+  for (uint64_t pos = 0; pos < reader.Size(); pos += buffer.size())
+  {
+    auto const n = static_cast<size_t>(std::min<uint64_t>(buffer.size(), reader.Size() - pos));
+    reader.Read(pos, buffer.data(), n);
+    crc = crc32(crc, buffer.data(), static_cast<uInt>(n));
+  }
+  return ~base::checked_cast<uint32_t>(crc);
+}
+
 bool MakeDiffVersion0(FileReader & oldReader, FileReader & newReader, FileWriter & diffFileWriter)
 {
   std::vector<uint8_t> diffBuf;
@@ -54,6 +164,337 @@ bool MakeDiffVersion0(FileReader & oldReader, FileReader & newReader, FileWriter
   return true;
 }
 
+// Format of the streamed patch:
+//   bsdiff patch header;
+//   kNumStreams of uint32_t inflated bsdiff stream sizes;
+//   kNumStreams of uint32_t deflated bsdiff stream sizes;
+//   kNumStreams of deflated bsdiff streams.
+// The streams are deflated separately, so the patch can be applied with the constant memory
+// by inflating all the streams simultaneously.
+bool MakeStreamedPatch(FileReader & oldReader, FileReader & newReader, Writer & writer)
+{
+  std::vector<uint8_t> diffBuf;
+  MemWriter<std::vector<uint8_t>> diffMemWriter(diffBuf);
+
+  auto const status = bsdiff::CreateBinaryPatch(oldReader, newReader, diffMemWriter);
+
+  if (status != bsdiff::BSDiffStatus::OK)
+  {
+    LOG(LERROR, ("Could not create patch with bsdiff:", status));
+    return false;
+  }
+
+  MemReader diffMemReader(diffBuf.data(), diffBuf.size());
+  ReaderSource<MemReader> diffSource(diffMemReader);
+
+  bsdiff::MBSPatchHeader header;
+  CHECK_EQUAL(bsdiff::MBS_ReadHeader(diffSource, &header), bsdiff::BSDiffStatus::OK, ());
+
+  std::array<uint32_t, kNumStreams> rawSizes;
+  for (auto & size : rawSizes)
+    size = ReadPrimitiveFromSource<uint32_t>(diffSource);
+
+  using Deflate = coding::ZLib::Deflate;
+  Deflate deflate(Deflate::Format::ZLib, Deflate::Level::BestCompression);
+
+  std::array<std::vector<uint8_t>, kNumStreams> streams;
+  for (size_t i = 0; i < kNumStreams; ++i)
+  {
+    std::vector<uint8_t> raw(rawSizes[i]);
+    diffSource.Read(raw.data(), raw.size());
+    deflate(raw.data(), raw.size(), back_inserter(streams[i]));
+  }
+  CHECK_EQUAL(diffSource.Size(), 0, ());
+
+  bsdiff::WriteHeader(writer, &header);
+  for (auto const size : rawSizes)
+    WriteToSink(writer, size);
+  for (auto const & stream : streams)
+    WriteToSink(writer, base::checked_cast<uint32_t>(stream.size()));
+  for (auto const & stream : streams)
+    writer.Write(stream.data(), stream.size());
+
+  return true;
+}
+
+// Format Version 1: a streamed patch of the whole file.
+bool MakeDiffVersion1(FileReader & oldReader, FileReader & newReader, FileWriter & diffFileWriter)
+{
+  WriteToSink(diffFileWriter, static_cast<uint32_t>(VERSION_V1));
+  return MakeStreamedPatch(oldReader, newReader, diffFileWriter);
+}
+
+// How a part of the new mwm is kept in the version 2 diff.
+enum class Codec : uint8_t
+{
+  // The part is the same as a part of the old mwm.
+  Copy = 0,
+  // The part is deflated.
+  Deflate = 1,
+  // The part is a streamed patch of a section of the old mwm.
+  Patch = 2,
+};
+
+struct Part
+{
+  Codec m_codec = Codec::Deflate;
+  uint64_t m_newOffset = 0;
+  uint64_t m_newSize = 0;
+  // Range of the old mwm for Copy and Patch codecs.
+  uint64_t m_oldOffset = 0;
+  uint64_t m_oldSize = 0;
+  // Size of the part's data in the diff for Deflate and Patch codecs.
+  uint64_t m_dataSize = 0;
+};
+
+// Splits the new mwm into sections and gaps between them (header, paddings and the sections table).
+// A section is patched against the old mwm section with the same tag.
+// Returns false if sections of the new mwm overlap.
+bool SplitIntoParts(FilesContainerR const & oldCont, FilesContainerR const & newCont,
+                    std::vector<Part> & parts)
+{
+  std::map<FilesContainerBase::Tag, FilesContainerBase::TagInfo> oldSections;
+  oldCont.ForEachTagInfo([&oldSections](FilesContainerBase::TagInfo const & info)
+  {
+    if (info.m_size != 0)
+      oldSections.emplace(info.m_tag, info);
+  });
+
+  std::vector<FilesContainerBase::TagInfo> newSections;
+  newCont.ForEachTagInfo([&newSections](FilesContainerBase::TagInfo const & info)
+  {
+    if (info.m_size != 0)
+      newSections.push_back(info);
+  });
+  std::sort(newSections.begin(), newSections.end(),
+            [](auto const & lhs, auto const & rhs) { return lhs.m_offset < rhs.m_offset; });
+
+  auto const addGap = [&parts](uint64_t offset, uint64_t size)
+  {
+    Part gap;
+    gap.m_newOffset = offset;
+    gap.m_newSize = size;
+    parts.push_back(gap);
+  };
+
+  uint64_t pos = 0;
+  for (auto const & info : newSections)
+  {
+    if (info.m_offset < pos)
+      return false;
+    if (info.m_offset > pos)
+      addGap(pos, info.m_offset - pos);
+
+    Part part;
+    part.m_newOffset = info.m_offset;
+    part.m_newSize = info.m_size;
+    auto const it = oldSections.find(info.m_tag);
+    if (it != oldSections.end())
+    {
+      part.m_codec = Codec::Patch;
+      part.m_oldOffset = it->second.m_offset;
+      part.m_oldSize = it->second.m_size;
+    }
+    parts.push_back(part);
+    pos = info.m_offset + info.m_size;
+  }
+
+  uint64_t const newSize = newCont.GetFileSize();
+  if (pos > newSize)
+    return false;
+  if (pos < newSize)
+    addGap(pos, newSize - pos);
+  return true;
+}
+
+bool IsEqual(FileReader const & lhs, FileReader const & rhs)
+{
+  if (lhs.Size() != rhs.Size())
+    return false;
+
+  std::vector<uint8_t> lhsBuf(kOldBufferSize), rhsBuf(kOldBufferSize);
+  for (uint64_t pos = 0; pos < lhs.Size(); pos += lhsBuf.size())
+  {
+    auto const n = static_cast<size_t>(std::min<uint64_t>(lhsBuf.size(), lhs.Size() - pos));
+    lhs.Read(pos, lhsBuf.data(), n);
+    rhs.Read(pos, rhsBuf.data(), n);
+    if (!std::equal(lhsBuf.begin(), lhsBuf.begin() + n, rhsBuf.begin()))
+      return false;
+  }
+  return true;
+}
+
+// Chooses the codec of |part| and makes its |data|. A patch is kept only if it's smaller than
+// the deflated part. It's called from different threads, so files are opened here.
+void EncodePart(std::string const & oldMwmPath, std::string const & newMwmPath, Part & part,
+                std::vector<uint8_t> & data)
+{
+  FileReader newReader = FileReader(newMwmPath).SubReader(part.m_newOffset, part.m_newSize);
+
+  std::vector<uint8_t> newBuf(static_cast<size_t>(part.m_newSize));
+  newReader.Read(0, newBuf.data(), newBuf.size());
+
+  using Deflate = coding::ZLib::Deflate;
+  Deflate deflate(Deflate::Format::ZLib, Deflate::Level::BestCompression);
+  deflate(newBuf.data(), newBuf.size(), back_inserter(data));
+
+  if (part.m_codec != Codec::Patch)
+    return;
+
+  FileReader oldReader = FileReader(oldMwmPath).SubReader(part.m_oldOffset, part.m_oldSize);
+  if (IsEqual(oldReader, newReader))
+  {
+    part.m_codec = Codec::Copy;
+    data.clear();
+    return;
+  }
+
+  std::vector<uint8_t> patch;
+  MemWriter<std::vector<uint8_t>> patchWriter(patch);
+  if (MakeStreamedPatch(oldReader, newReader, patchWriter) && patch.size() < data.size())
+    data.swap(patch);
+  else
+    part.m_codec = Codec::Deflate;
+}
+
+// Estimates the peak memory of EncodePart(): the new part with its deflated copy and,
+// for a patch, bsdiff buffers of both parts with the suffix array of the old one and the patch.
+uint64_t EstimateEncodeMemory(Part const & part)
+{
+  uint64_t memory = 2 * part.m_newSize;
+  if (part.m_codec == Codec::Patch)
+    memory += 5 * part.m_oldSize + 2 * part.m_newSize;
+  return memory;
+}
+
+// Blocks encoding of parts until the memory they need is released by the parts encoded
+// by other threads. A part which needs more than the whole budget is encoded alone.
+class MemoryBudget
+{
+public:
+  explicit MemoryBudget(uint64_t budget) : m_budget(budget), m_free(budget) {}
+
+  uint64_t Acquire(uint64_t size)
+  {
+    size = std::min(size, m_budget);
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [this, size]() { return m_free >= size; });
+    m_free -= size;
+    return size;
+  }
+
+  void Release(uint64_t size)
+  {
+    {
+      std::lock_guard lock(m_mutex);
+      m_free += size;
+    }
+    m_cv.notify_all();
+  }
+
+private:
+  uint64_t const m_budget;
+  uint64_t m_free;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+};
+
+// Format Version 2, after the version:
+//   uint64_t size and uint32_t crc of the old mwm;
+//   VarUint count of parts of the new mwm and their descriptions in the order of the new mwm;
+//   data of parts.
+// Unchanged sections are copied from the old mwm, changed ones are diffed separately in parallel
+// within kEncodeMemoryBudget.
+// Files which are not files containers are diffed as a whole with the version 1 format.
+bool MakeDiffVersion2(std::string const & oldMwmPath, std::string const & newMwmPath,
+                      FileReader & oldReader, FileReader & newReader, FileWriter & diffFileWriter)
+{
+  // FilesContainerR expects a valid sections table, check at least that it's inside the file.
+  auto const hasSectionsTable = [](FileReader const & reader)
+  {
+    uint64_t constexpr kHeaderSize = sizeof(uint64_t);
+    if (reader.Size() <= kHeaderSize)
+      return false;
+    auto const tableOffset = ReadPrimitiveFromPos<uint64_t>(reader, 0);
+    return tableOffset >= kHeaderSize && tableOffset < reader.Size();
+  };
+  if (!hasSectionsTable(oldReader) || !hasSectionsTable(newReader))
+  {
+    LOG(LWARNING, ("Not a files container, making a whole file diff"));
+    return MakeDiffVersion1(oldReader, newReader, diffFileWriter);
+  }
+
+  std::vector<Part> parts;
+  try
+  {
+    FilesContainerR const oldCont(oldMwmPath);
+    FilesContainerR const newCont(newMwmPath);
+    if (!SplitIntoParts(oldCont, newCont, parts))
+    {
+      LOG(LWARNING, ("Overlapped sections in", newMwmPath, ", making a whole file diff"));
+      return MakeDiffVersion1(oldReader, newReader, diffFileWriter);
+    }
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LWARNING, ("Can't read sections, making a whole file diff:", e.Msg()));
+    return MakeDiffVersion1(oldReader, newReader, diffFileWriter);
+  }
+
+  std::vector<std::vector<uint8_t>> data(parts.size());
+  {
+    MemoryBudget budget(kEncodeMemoryBudget);
+    auto const threadsCount = std::min<size_t>(parts.size(), std::thread::hardware_concurrency());
+    base::ComputationalThreadPool pool(std::max<size_t>(1, threadsCount));
+    std::vector<std::future<void>> futures;
+    futures.reserve(parts.size());
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+      futures.push_back(pool.Submit([&oldMwmPath, &newMwmPath, &budget, &part = parts[i], &partData = data[i]]()
+      {
+        auto const memory = budget.Acquire(EstimateEncodeMemory(part));
+        SCOPE_GUARD(releaseMemory, [&]() { budget.Release(memory); });
+        EncodePart(oldMwmPath, newMwmPath, part, partData);
+      }));
+    }
+
+    // Rethrows exceptions from the workers.
+    for (auto & f : futures)
+      f.get();
+  }
+
+  std::array<size_t, 3> codecsCount = {};
+  WriteToSink(diffFileWriter, static_cast<uint32_t>(VERSION_V2));
+  WriteToSink(diffFileWriter, oldReader.Size());
+  WriteToSink(diffFileWriter, CalculateCrc(oldReader));
+  WriteVarUint(diffFileWriter, parts.size());
+  for (size_t i = 0; i < parts.size(); ++i)
+  {
+    auto const & part = parts[i];
+    ++codecsCount[static_cast<size_t>(part.m_codec)];
+    WriteToSink(diffFileWriter, static_cast<uint8_t>(part.m_codec));
+    WriteVarUint(diffFileWriter, part.m_newSize);
+    switch (part.m_codec)
+    {
+    case Codec::Copy: WriteVarUint(diffFileWriter, part.m_oldOffset); break;
+    case Codec::Deflate: WriteVarUint(diffFileWriter, data[i].size()); break;
+    case Codec::Patch:
+      WriteVarUint(diffFileWriter, part.m_oldOffset);
+      WriteVarUint(diffFileWriter, part.m_oldSize);
+      WriteVarUint(diffFileWriter, data[i].size());
+      break;
+    }
+  }
+
+  for (auto const & partData : data)
+    diffFileWriter.Write(partData.data(), partData.size());
+
+  LOG(LINFO, ("Diff parts copied:", codecsCount[static_cast<size_t>(Codec::Copy)],
+              "deflated:", codecsCount[static_cast<size_t>(Codec::Deflate)],
+              "patched:", codecsCount[static_cast<size_t>(Codec::Patch)]));
+  return true;
+}
+
 generator::mwm_diff::DiffApplicationResult ApplyDiffVersion0(
     FileReader & oldReader, FileWriter & newWriter, ReaderSource<FileReader> & diffFileSource,
     base::Cancellable const & cancellable)
@@ -91,13 +532,258 @@ generator::mwm_diff::DiffApplicationResult ApplyDiffVersion0(
   LOG(LERROR, ("Could not apply patch with bsdiff:", status));
   return DiffApplicationResult::Failed;
 }
+
+// Applies the streamed patch the same way as bsdiff::ApplyBinaryPatch() does, but streams are
+// inflated on the fly and the old file is read by chunks instead of loading everything in memory.
+generator::mwm_diff::DiffApplicationResult ApplyStreamedPatch(
+    FileReader const & oldReader, Writer & newWriter, FileReader const & patchReader,
+    base::Cancellable const & cancellable)
+{
+  using generator::mwm_diff::DiffApplicationResult;
+
+  ReaderSource<FileReader> patchSource(patchReader);
+  bsdiff::MBSPatchHeader header;
+  if (bsdiff::MBS_ReadHeader(patchSource, &header) != bsdiff::BSDiffStatus::OK)
+  {
+    LOG(LERROR, ("Corrupted mwm diff header"));
+    return DiffApplicationResult::Failed;
+  }
+
+  if (oldReader.Size() != header.slen || CalculateCrc(oldReader) != header.scrc32)
+  {
+    LOG(LERROR, ("The mwm diff doesn't match the old mwm"));
+    return DiffApplicationResult::Failed;
+  }
+
+  std::array<uint32_t, kNumStreams> rawSizes, deflatedSizes;
+  for (auto & size : rawSizes)
+    size = ReadPrimitiveFromSource<uint32_t>(patchSource);
+  for (auto & size : deflatedSizes)
+    size = ReadPrimitiveFromSource<uint32_t>(patchSource);
+
+  std::vector<std::unique_ptr<InflateSource>> streams;
+  for (size_t i = 0; i < kNumStreams; ++i)
+  {
+    // SubReader() throws on sizes which are out of the file.
+    streams.push_back(std::make_unique<InflateSource>(
+        patchReader.SubReader(patchSource.Pos(), deflatedSizes[i]), rawSizes[i]));
+    patchSource.Skip(deflatedSizes[i]);
+  }
+
+  auto & controlStreamCopyCounts = *streams[0];
+  auto & controlStreamExtraCounts = *streams[1];
+  auto & controlStreamSeeks = *streams[2];
+  auto & diffSkips = *streams[3];
+  auto & diffBytes = *streams[4];
+  auto & extraBytes = *streams[5];
+
+  std::vector<uint8_t> oldBuf(kOldBufferSize);
+  std::vector<uint8_t> newBuf;
+  newBuf.reserve(kNewBufferSize);
+  uint64_t newSize = 0;
+  auto const flushNew = [&newWriter, &newBuf, &newSize]()
+  {
+    newWriter.Write(newBuf.data(), newBuf.size());
+    newSize += newBuf.size();
+    newBuf.clear();
+  };
+
+  uint64_t const oldSize = oldReader.Size();
+  uint64_t oldPos = 0;
+  auto pendingDiffZeros = ReadVarUint<uint32_t>(diffSkips);
+
+  while (controlStreamCopyCounts.Size() > 0)
+  {
+    if (cancellable.IsCancelled())
+    {
+      LOG(LDEBUG, ("Diff application has been cancelled"));
+      return DiffApplicationResult::Cancelled;
+    }
+
+    auto const copyCount = ReadVarUint<uint32_t>(controlStreamCopyCounts);
+    auto extraCount = ReadVarUint<uint32_t>(controlStreamExtraCounts);
+    auto const seekAdjustment = ReadVarInt<int32_t>(controlStreamSeeks);
+
+    if (copyCount > oldSize - oldPos || extraCount > extraBytes.Size())
+      return DiffApplicationResult::Failed;
+
+    // Add together bytes from the old file and the diff stream.
+    for (uint32_t copied = 0; copied < copyCount;)
+    {
+      auto const n = std::min<size_t>(oldBuf.size(), copyCount - copied);
+      oldReader.Read(oldPos + copied, oldBuf.data(), n);
+      for (size_t i = 0; i < n; ++i)
+      {
+        uint8_t diffByte = 0;
+        if (pendingDiffZeros != 0)
+        {
+          --pendingDiffZeros;
+        }
+        else
+        {
+          pendingDiffZeros = ReadVarUint<uint32_t>(diffSkips);
+          diffByte = ReadPrimitiveFromSource<uint8_t>(diffBytes);
+        }
+        newBuf.push_back(static_cast<uint8_t>(oldBuf[i] + diffByte));
+        if (newBuf.size() == kNewBufferSize)
+          flushNew();
+      }
+      copied += n;
+
+      if (cancellable.IsCancelled())
+        return DiffApplicationResult::Cancelled;
+    }
+    oldPos += copyCount;
+
+    // Copy bytes from the extra stream.
+    while (extraCount != 0)
+    {
+      auto const n = std::min<size_t>(kNewBufferSize - newBuf.size(), extraCount);
+      auto const size = newBuf.size();
+      newBuf.resize(size + n);
+      extraBytes.Read(newBuf.data() + size, n);
+      if (newBuf.size() == kNewBufferSize)
+        flushNew();
+      extraCount -= n;
+    }
+
+    // Seek forwards (or backwards) in the old file.
+    auto const newOldPos = static_cast<int64_t>(oldPos) + seekAdjustment;
+    if (newOldPos < 0 || static_cast<uint64_t>(newOldPos) > oldSize)
+      return DiffApplicationResult::Failed;
+    oldPos = static_cast<uint64_t>(newOldPos);
+  }
+  flushNew();
+
+  for (auto const & stream : streams)
+  {
+    if (stream->Size() != 0)
+      return DiffApplicationResult::Failed;
+  }
+
+  if (newSize != header.dlen)
+    return DiffApplicationResult::Failed;
+
+  return cancellable.IsCancelled() ? DiffApplicationResult::Cancelled : DiffApplicationResult::Ok;
+}
+
+generator::mwm_diff::DiffApplicationResult ApplyDiffVersion1(
+    FileReader & oldReader, FileWriter & newWriter, FileReader const & diffFileReader,
+    ReaderSource<FileReader> & diffFileSource, base::Cancellable const & cancellable)
+{
+  return ApplyStreamedPatch(oldReader, newWriter,
+                            diffFileReader.SubReader(diffFileSource.Pos(), diffFileSource.Size()),
+                            cancellable);
+}
+
+generator::mwm_diff::DiffApplicationResult ApplyDiffVersion2(
+    FileReader & oldReader, FileWriter & newWriter, FileReader const & diffFileReader,
+    ReaderSource<FileReader> & diffFileSource, base::Cancellable const & cancellable)
+{
+  using generator::mwm_diff::DiffApplicationResult;
+
+  auto const oldSize = ReadPrimitiveFromSource<uint64_t>(diffFileSource);
+  auto const oldCrc = ReadPrimitiveFromSource<uint32_t>(diffFileSource);
+  if (oldReader.Size() != oldSize || CalculateCrc(oldReader) != oldCrc)
+  {
+    LOG(LERROR, ("The mwm diff doesn't match the old mwm"));
+    return DiffApplicationResult::Failed;
+  }
+
+  // Reading of a corrupted count fails on the end of the file.
+  auto const partsCount = ReadVarUint<uint64_t>(diffFileSource);
+  std::vector<Part> parts;
+  for (uint64_t i = 0; i < partsCount; ++i)
+  {
+    Part part;
+    auto const codec = ReadPrimitiveFromSource<uint8_t>(diffFileSource);
+    part.m_newSize = ReadVarUint<uint64_t>(diffFileSource);
+    switch (static_cast<Codec>(codec))
+    {
+    case Codec::Copy:
+      part.m_codec = Codec::Copy;
+      part.m_oldOffset = ReadVarUint<uint64_t>(diffFileSource);
+      break;
+    case Codec::Deflate:
+      part.m_codec = Codec::Deflate;
+      part.m_dataSize = ReadVarUint<uint64_t>(diffFileSource);
+      break;
+    case Codec::Patch:
+      part.m_codec = Codec::Patch;
+      part.m_oldOffset = ReadVarUint<uint64_t>(diffFileSource);
+      part.m_oldSize = ReadVarUint<uint64_t>(diffFileSource);
+      part.m_dataSize = ReadVarUint<uint64_t>(diffFileSource);
+      break;
+    default:
+      LOG(LERROR, ("Unknown codec of mwm diff part:", codec));
+      return DiffApplicationResult::Failed;
+    }
+    parts.push_back(part);
+  }
+
+  std::vector<uint8_t> buffer(kNewBufferSize);
+  // SubReader() throws on ranges which are out of the file.
+  uint64_t dataPos = diffFileSource.Pos();
+  for (auto const & part : parts)
+  {
+    if (cancellable.IsCancelled())
+    {
+      LOG(LDEBUG, ("Diff application has been cancelled"));
+      return DiffApplicationResult::Cancelled;
+    }
+
+    switch (part.m_codec)
+    {
+    case Codec::Copy:
+    {
+      FileReader const reader = oldReader.SubReader(part.m_oldOffset, part.m_newSize);
+      for (uint64_t pos = 0; pos < part.m_newSize; pos += buffer.size())
+      {
+        auto const n = static_cast<size_t>(std::min<uint64_t>(buffer.size(), part.m_newSize - pos));
+        reader.Read(pos, buffer.data(), n);
+        newWriter.Write(buffer.data(), n);
+      }
+      break;
+    }
+    case Codec::Deflate:
+    {
+      InflateSource source(diffFileReader.SubReader(dataPos, part.m_dataSize), part.m_newSize);
+      while (source.Size() != 0)
+      {
+        auto const n = static_cast<size_t>(std::min<uint64_t>(buffer.size(), source.Size()));
+        source.Read(buffer.data(), n);
+        newWriter.Write(buffer.data(), n);
+      }
+      break;
+    }
+    case Codec::Patch:
+    {
+      auto const pos = newWriter.Pos();
+      auto const res = ApplyStreamedPatch(oldReader.SubReader(part.m_oldOffset, part.m_oldSize), newWriter,
+                                          diffFileReader.SubReader(dataPos, part.m_dataSize), cancellable);
+      if (res != DiffApplicationResult::Ok)
+        return res;
+      if (newWriter.Pos() - pos != part.m_newSize)
+        return DiffApplicationResult::Failed;
+      break;
+    }
+    }
+    dataPos += part.m_dataSize;
+  }
+
+  if (dataPos != diffFileReader.Size())
+    return DiffApplicationResult::Failed;
+
+  return cancellable.IsCancelled() ? DiffApplicationResult::Cancelled : DiffApplicationResult::Ok;
+}
 }  // namespace
 
 namespace generator
 {
 namespace mwm_diff
 {
-bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, std::string const & diffPath)
+bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, std::string const & diffPath,
+              Version version)
 {
   try
   {
@@ -105,12 +791,15 @@ bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath, st
     FileReader newReader(newMwmPath);
     FileWriter diffFileWriter(diffPath);
 
-    switch (VERSION_LATEST)
+    switch (version)
     {
     case VERSION_V0: return MakeDiffVersion0(oldReader, newReader, diffFileWriter);
+    case VERSION_V1: return MakeDiffVersion1(oldReader, newReader, diffFileWriter);
+    case VERSION_V2:
+      return MakeDiffVersion2(oldMwmPath, newMwmPath, oldReader, newReader, diffFileWriter);
     default:
       LOG(LERROR,
-          ("Making mwm diffs with diff format version", VERSION_LATEST, "is not implemented"));
+          ("Making mwm diffs with diff format version", version, "is not implemented"));
     }
   }
   catch (Reader::Exception const & e)
@@ -143,6 +832,10 @@ DiffApplicationResult ApplyDiff(std::string const & oldMwmPath, std::string cons
     {
     case VERSION_V0:
       return ApplyDiffVersion0(oldReader, newWriter, diffFileSource, cancellable);
+    case VERSION_V1:
+      return ApplyDiffVersion1(oldReader, newWriter, diffFileReader, diffFileSource, cancellable);
+    case VERSION_V2:
+      return ApplyDiffVersion2(oldReader, newWriter, diffFileReader, diffFileSource, cancellable);
     default:
       LOG(LERROR, ("Unknown version format of mwm diff:", version));
       return DiffApplicationResult::Failed;
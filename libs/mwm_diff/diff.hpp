@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace base
@@ -11,6 +12,20 @@ namespace generator
 {
 namespace mwm_diff
 {
+enum Version : uint32_t
+{
+  // Format Version 0: bsdiff+gzip.
+  VERSION_V0 = 0,
+  // Format Version 1: bsdiff with separately deflated streams.
+  VERSION_V1 = 1,
+  // Format Version 2: sections of mwm are diffed separately.
+  VERSION_V2 = 2,
+  VERSION_LATEST = VERSION_V2,
+  // The released apps apply version 0 diffs only, so versions 1 and 2 are opt-in.
+  // Switch it when the apps which apply newer diffs are rolled out.
+  VERSION_DEFAULT = VERSION_V0
+};
+
 enum class DiffApplicationResult
 {
   Ok,
@@ -19,11 +34,11 @@ enum class DiffApplicationResult
 };
 
 // Makes a diff that, when applied to the mwm at |oldMwmPath|, will
-// result in the mwm at |newMwmPath|. The diff is stored at |diffPath|.
+// result in the mwm at |newMwmPath|. The diff is stored at |diffPath| in the format |version|.
 // It is assumed that the files at |oldMwmPath| and |newMwmPath| are valid mwms.
 // Returns true on success and false on failure.
 bool MakeDiff(std::string const & oldMwmPath, std::string const & newMwmPath,
-              std::string const & diffPath);
+              std::string const & diffPath, Version version = VERSION_DEFAULT);
 
 // Applies the diff at |diffPath| to the mwm at |oldMwmPath|. The resulting
 // mwm is stored at |newMwmPath|.
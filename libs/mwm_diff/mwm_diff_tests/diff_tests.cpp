@@ -5,12 +5,15 @@
 #include "platform/platform.hpp"
 
 #include "coding/file_writer.hpp"
+#include "coding/files_container.hpp"
 #include "coding/internal/file_data.hpp"
 
 #include "base/file_name_utils.hpp"
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 
+#include <cstdint>
+#include <random>
 #include <vector>
 
 namespace generator::diff_tests
@@ -40,6 +43,8 @@ UNIT_TEST(IncrementalUpdates_Smoke)
 
   base::Cancellable cancellable;
   TEST(MakeDiff(oldMwmPath, newMwmPath1, diffPath), ());
+  // Diffs are made in the format which the released apps can apply.
+  TEST_EQUAL(base::ReadFile(diffPath)[0], VERSION_V0, ());
   TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable), DiffApplicationResult::Ok,
              ());
 
@@ -88,4 +93,191 @@ UNIT_TEST(IncrementalUpdates_Smoke)
   TEST_EQUAL(ApplyDiff(oldMwmPath, newMwmPath2, diffPath, cancellable),
              DiffApplicationResult::Failed, ());
 }
+
+UNIT_TEST(IncrementalUpdates_Version1)
+{
+  base::ScopedLogAbortLevelChanger ignoreLogError(base::LogLevel::LCRITICAL);
+
+  string const oldPath = base::JoinPath(GetPlatform().WritableDir(), "version1-old.mwm");
+  string const newPath1 = base::JoinPath(GetPlatform().WritableDir(), "version1-new1.mwm");
+  string const newPath2 = base::JoinPath(GetPlatform().WritableDir(), "version1-new2.mwm");
+  string const diffPath = base::JoinPath(GetPlatform().WritableDir(), "version1.mwmdiff");
+
+  SCOPE_GUARD(cleanup, [&] {
+    FileWriter::DeleteFileX(oldPath);
+    FileWriter::DeleteFileX(newPath1);
+    FileWriter::DeleteFileX(newPath2);
+    FileWriter::DeleteFileX(diffPath);
+  });
+
+  // Random bytes are not compressible, so the streams of the patch are much larger than
+  // the buffers of their incremental inflating.
+  std::mt19937 rng(0);
+  vector<uint8_t> oldBytes(1000000);
+  for (auto & b : oldBytes)
+    b = static_cast<uint8_t>(rng());
+
+  auto newBytes = oldBytes;
+  for (size_t i = 0; i < newBytes.size(); i += 1000)
+    newBytes[i] ^= 1;
+  newBytes.erase(newBytes.begin() + 300000, newBytes.begin() + 400000);
+  for (size_t i = 0; i < 200000; ++i)
+    newBytes.push_back(static_cast<uint8_t>(rng()));
+
+  auto const write = [](string const & path, vector<uint8_t> const & bytes)
+  {
+    FileWriter writer(path);
+    writer.Write(bytes.data(), bytes.size());
+  };
+  write(oldPath, oldBytes);
+  write(newPath1, newBytes);
+
+  TEST(MakeDiff(oldPath, newPath1, diffPath, VERSION_V1), ());
+  auto diffContents = base::ReadFile(diffPath);
+  TEST_GREATER(diffContents.size(), 4, ());
+  TEST_EQUAL(diffContents[0], VERSION_V1, ());
+
+  base::Cancellable cancellable;
+  TEST_EQUAL(ApplyDiff(oldPath, newPath2, diffPath, cancellable), DiffApplicationResult::Ok, ());
+  TEST(base::IsEqualFiles(newPath1, newPath2), ());
+
+  cancellable.Cancel();
+  TEST_EQUAL(ApplyDiff(oldPath, newPath2, diffPath, cancellable), DiffApplicationResult::Cancelled, ());
+  cancellable.Reset();
+
+  // The diff doesn't match another old file.
+  TEST_EQUAL(ApplyDiff(newPath1, newPath2, diffPath, cancellable), DiffApplicationResult::Failed, ());
+
+  // Corrupt the deflated streams at the end of the diff.
+  for (size_t i = diffContents.size() / 2; i < diffContents.size(); i += 100)
+    diffContents[i] ^= 255;
+  write(diffPath, diffContents);
+  TEST_EQUAL(ApplyDiff(oldPath, newPath2, diffPath, cancellable), DiffApplicationResult::Failed, ());
+
+  // Truncate the diff.
+  diffContents.resize(diffContents.size() / 2);
+  write(diffPath, diffContents);
+  TEST_EQUAL(ApplyDiff(oldPath, newPath2, diffPath, cancellable), DiffApplicationResult::Failed, ());
+}
+
+UNIT_TEST(IncrementalUpdates_Sections)
+{
+  base::ScopedLogAbortLevelChanger ignoreLogError(base::LogLevel::LCRITICAL);
+
+  string const oldPath = base::JoinPath(GetPlatform().WritableDir(), "sections-old.mwm");
+  string const newPath1 = base::JoinPath(GetPlatform().WritableDir(), "sections-new1.mwm");
+  string const newPath2 = base::JoinPath(GetPlatform().WritableDir(), "sections-new2.mwm");
+  string const diffPath = base::JoinPath(GetPlatform().WritableDir(), "sections.mwmdiff");
+
+  SCOPE_GUARD(cleanup, [&] {
+    FileWriter::DeleteFileX(oldPath);
+    FileWriter::DeleteFileX(newPath1);
+    FileWriter::DeleteFileX(newPath2);
+    FileWriter::DeleteFileX(diffPath);
+  });
+
+  // Random bytes are not compressible, so the diff is small only if the unchanged
+  // section is copied from the old file.
+  std::mt19937 rng(0);
+  auto const makeBytes = [&rng](size_t size)
+  {
+    vector<uint8_t> bytes(size);
+    for (auto & b : bytes)
+      b = static_cast<uint8_t>(rng());
+    return bytes;
+  };
+
+  auto const changed = makeBytes(20000);
+  auto const unchanged = makeBytes(50000);
+  auto const removed = makeBytes(10000);
+  auto const added = makeBytes(100);
+
+  {
+    FilesContainerW cont(oldPath);
+    cont.Write(removed, "removed");
+    cont.Write(changed, "changed");
+    cont.Write(unchanged, "unchanged");
+    cont.Finish();
+  }
+
+  {
+    auto changedNew = changed;
+    for (size_t i = 1000; i < 1100; ++i)
+      changedNew[i] ^= 1;
+
+    // Sections are shifted in the new file.
+    FilesContainerW cont(newPath1);
+    cont.Write(added, "added");
+    cont.Write(unchanged, "unchanged");
+    cont.Write(changedNew, "changed");
+    cont.Finish();
+  }
+
+  base::Cancellable cancellable;
+  TEST(MakeDiff(oldPath, newPath1, diffPath, VERSION_V2), ());
+  TEST_EQUAL(ApplyDiff(oldPath, newPath2, diffPath, cancellable), DiffApplicationResult::Ok, ());
+  TEST(base::IsEqualFiles(newPath1, newPath2), ());
+
+  uint64_t diffSize = 0;
+  TEST(base::GetFileSize(diffPath, diffSize), ());
+  TEST_LESS(diffSize, 5000, ());
+
+  // The diff doesn't match another old file.
+  TEST_EQUAL(ApplyDiff(newPath1, newPath2, diffPath, cancellable), DiffApplicationResult::Failed, ());
+}
+
+UNIT_TEST(IncrementalUpdates_NotContainers)
+{
+  base::ScopedLogAbortLevelChanger ignoreLogError(base::LogLevel::LCRITICAL);
+
+  string const oldPath = base::JoinPath(GetPlatform().WritableDir(), "not-container-old.mwm");
+  string const newPath1 = base::JoinPath(GetPlatform().WritableDir(), "not-container-new1.mwm");
+  string const newPath2 = base::JoinPath(GetPlatform().WritableDir(), "not-container-new2.mwm");
+  string const diffPath = base::JoinPath(GetPlatform().WritableDir(), "not-container.mwmdiff");
+
+  SCOPE_GUARD(cleanup, [&] {
+    FileWriter::DeleteFileX(oldPath);
+    FileWriter::DeleteFileX(newPath1);
+    FileWriter::DeleteFileX(newPath2);
+    FileWriter::DeleteFileX(diffPath);
+  });
+
+  std::mt19937 rng(0);
+  vector<uint8_t> oldBytes(100000);
+  for (auto & b : oldBytes)
+    b = static_cast<uint8_t>(rng());
+  auto newBytes = oldBytes;
+  for (size_t i = 0; i < newBytes.size(); i += 500)
+    newBytes[i] ^= 1;
+
+  auto const write = [](string const & path, vector<uint8_t> const & bytes)
+  {
+    FileWriter writer(path);
+    writer.Write(bytes.data(), bytes.size());
+  };
+  write(oldPath, oldBytes);
+  write(newPath1, newBytes);
+
+  // Sections of random files can't be read, so the whole files are diffed in version 1 format.
+  TEST(MakeDiff(oldPath, newPath1, diffPath, VERSION_V2), ());
+  auto const diffContents = base::ReadFile(diffPath);
+  TEST_GREATER(diffContents.size(), 4, ());
+  TEST_EQUAL(diffContents[0], VERSION_V1, ());
+
+  base::Cancellable cancellable;
+  TEST_EQUAL(ApplyDiff(oldPath, newPath2, diffPath, cancellable), DiffApplicationResult::Ok, ());
+  TEST(base::IsEqualFiles(newPath1, newPath2), ());
+
+  // A files container with sections against a random file.
+  {
+    FilesContainerW cont(newPath1);
+    cont.Write(newBytes, "section");
+    cont.Finish();
+  }
+  // Version 2 falls back to a whole file version 1 diff.
+  TEST(MakeDiff(oldPath, newPath1, diffPath, VERSION_V2), ());
+  TEST_EQUAL(base::ReadFile(diffPath)[0], VERSION_V1, ());
+  TEST_EQUAL(ApplyDiff(oldPath, newPath2, diffPath, cancellable), DiffApplicationResult::Ok, ());
+  TEST(base::IsEqualFiles(newPath1, newPath2), ());
+}
 }  // namespace generator::diff_tests
@@ -1,18 +1,54 @@
 #include "mwm_diff/diff.hpp"
 
+#include "coding/internal/file_data.hpp"
+
 #include "base/cancellable.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
+
+#include "std/target_os.hpp"
 
 #include <iostream>
 #include <cstring>
 
+#ifndef OMIM_OS_WINDOWS
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+// Prints throughput of processing |size| bytes and peak resident memory of the process.
+void PrintStats(char const * action, uint64_t size, double seconds)
+{
+  double constexpr kMb = 1024.0 * 1024.0;
+  std::cout << action << " " << size / kMb << " MB in " << seconds << " s, "
+            << (seconds > 0.0 ? size / kMb / seconds : 0.0) << " MB/s";
+
+#ifndef OMIM_OS_WINDOWS
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef OMIM_OS_MAC
+  long const peakKb = usage.ru_maxrss / 1024;  // Bytes on macOS.
+#else
+  long const peakKb = usage.ru_maxrss;  // Kilobytes on Linux.
+#endif
+  std::cout << ", peak memory " << peakKb / 1024.0 << " MB";
+#endif
+
+  std::cout << std::endl;
+}
+}  // namespace
+
 int main(int argc, char ** argv)
 {
   auto const ShowUsage = [argv]()
   {
     std::cout <<
-        "Usage: " << argv[0] << " make|apply olderMWMPath newerMWMPath diffPath\n"
+        "Usage: " << argv[0] << " make|apply olderMWMPath newerMWMPath diffPath [diffVersion]\n"
         "make\n"
         "  Creates the diff between newer and older MWMs at `diffPath`\n"
+        "  in the format `diffVersion` (" << generator::mwm_diff::VERSION_DEFAULT << " by default, "
+        << generator::mwm_diff::VERSION_LATEST << " at most)\n"
         "apply\n"
         "  Applies the diff at `diffPath` to the mwm at `olderMWMPath` and stores result at `newerMWMPath`.\n"
         "WARNING: THERE IS NO MWM VALIDITY CHECK!\n";
@@ -27,17 +63,35 @@ int main(int argc, char ** argv)
   auto const IsEqualUsage = [argv](char const * s) { return 0 == std::strcmp(argv[1], s); };
   char const * olderMWMPath{argv[2]}, * newerMWMPath{argv[3]}, * diffPath{argv[4]};
 
+  base::Timer timer;
+  uint64_t size = 0;
   if (IsEqualUsage("make"))
   {
-    if (generator::mwm_diff::MakeDiff(olderMWMPath, newerMWMPath, diffPath))
+    uint32_t version = generator::mwm_diff::VERSION_DEFAULT;
+    if (argc > 5 && (!strings::to_uint(argv[5], version) || version > generator::mwm_diff::VERSION_LATEST))
+    {
+      ShowUsage();
+      return -1;
+    }
+
+    if (generator::mwm_diff::MakeDiff(olderMWMPath, newerMWMPath, diffPath,
+                                      static_cast<generator::mwm_diff::Version>(version)))
+    {
+      if (base::GetFileSize(newerMWMPath, size))
+        PrintStats("Made diff for", size, timer.ElapsedSeconds());
       return 0;
+    }
   }
   else if (IsEqualUsage("apply"))
   {
     base::Cancellable cancellable;
     auto const res = generator::mwm_diff::ApplyDiff(olderMWMPath, newerMWMPath, diffPath, cancellable);
     if (res == generator::mwm_diff::DiffApplicationResult::Ok)
+    {
+      if (base::GetFileSize(newerMWMPath, size))
+        PrintStats("Applied diff to", size, timer.ElapsedSeconds());
       return 0;
+    }
   }
   else
     ShowUsage();
@@ -10,6 +10,8 @@
 #include "base/logging.hpp"
 #include "base/macros.hpp"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace downloader
@@ -18,7 +20,40 @@ ChunksDownloadStrategy::ChunksDownloadStrategy(vector<string> const & urls)
 {
   // init servers list
   for (size_t i = 0; i < urls.size(); ++i)
-    m_servers.push_back(ServerT(urls[i], SERVER_READY));
+    m_servers.push_back(ServerT(urls[i]));
+}
+
+void ChunksDownloadStrategy::SetAutoChunkSize(bool autoChunkSize)
+{
+  m_autoChunkSize = autoChunkSize;
+  m_connectionsPerServer = autoChunkSize ? kAutoConnectionsPerServer : 1;
+}
+
+void ChunksDownloadStrategy::FitChunk(size_t index, ServerT const & server)
+{
+  if (server.m_bytesPerSecond <= 0)
+    return;
+
+  int64_t const size = std::clamp(static_cast<int64_t>(server.m_bytesPerSecond * kTargetChunkDuration.count()),
+                                  kMinAutoChunkSize, kMaxAutoChunkSize);
+  int64_t const pos = m_chunks[index].m_pos;
+
+  // The last AUX chunk stops merging.
+  while (m_chunks[index + 1].m_status == CHUNK_FREE && m_chunks[index + 2].m_pos - pos <= size)
+    m_chunks.erase(m_chunks.begin() + index + 1);
+
+  // The rest is left free, it's not split off if it's too small for a separate request.
+  if (m_chunks[index + 1].m_pos - pos >= size + kMinAutoChunkSize)
+    m_chunks.insert(m_chunks.begin() + index + 1, ChunkT(pos + size, CHUNK_FREE));
+}
+
+void ChunksDownloadStrategy::SetThroughputForTesting(string const & url, double bytesPerSecond)
+{
+  for (auto & server : m_servers)
+  {
+    if (server.m_url == url)
+      server.m_bytesPerSecond = bytesPerSecond;
+  }
 }
 
 pair<ChunksDownloadStrategy::ChunkT *, int>
@@ -40,6 +75,8 @@ ChunksDownloadStrategy::GetChunk(RangeT const & range)
 
 void ChunksDownloadStrategy::InitChunks(int64_t fileSize, int64_t chunkSize, ChunkStatusT status)
 {
+  SetAutoChunkSize(chunkSize == 0);
+
   if (chunkSize == 0)
   {
     int64_t constexpr kMb = 1024 * 1024;
@@ -115,6 +152,8 @@ int64_t ChunksDownloadStrategy::LoadOrInitChunks(string const & fName, int64_t f
 {
   ASSERT ( fileSize > 0, () );
 
+  SetAutoChunkSize(chunkSize == 0);
+
   if (Platform::IsFileExistsByFullPath(fName))
   {
     try
@@ -167,31 +206,46 @@ string ChunksDownloadStrategy::ChunkFinished(bool success, RangeT const & range)
 {
   pair<ChunkT *, int> res = GetChunk(range);
   string url;
+  if (!res.first)
+    return url;
+
   // find server which was downloading this chunk
-  if (res.first)
+  for (size_t s = 0; s < m_servers.size(); ++s)
   {
-    for (size_t s = 0; s < m_servers.size(); ++s)
+    auto & server = m_servers[s];
+    auto const it = find_if(server.m_chunks.begin(), server.m_chunks.end(),
+                            [&range](auto const & chunk) { return chunk.first == range.first; });
+    if (it == server.m_chunks.end())
+      continue;
+
+    url = server.m_url;
+    if (success)
     {
-      if (m_servers[s].m_chunkIndex == res.second)
+      LOG(LDEBUG, ("Completed chunk", res.second, "via", url));
+      res.first->m_status = CHUNK_COMPLETE;
+
+      double const seconds = chrono::duration<double>(Clock::now() - it->second).count();
+      if (seconds > 0)
       {
-        url = m_servers[s].m_url;
-        if (success)
-        {
-          LOG(LDEBUG, ("Completed chunk", m_servers[s].m_chunkIndex, "via", m_servers[s].m_url));
-          // mark server as free and chunk as ready
-          m_servers[s].m_chunkIndex = SERVER_READY;
-          res.first->m_status = CHUNK_COMPLETE;
-        }
-        else
-        {
-          LOG(LWARNING, ("Failed to dl chunk", m_servers[s].m_chunkIndex, "via", m_servers[s].m_url));
-          // remove failed server and mark chunk as free
-          m_servers.erase(m_servers.begin() + s);
-          res.first->m_status = CHUNK_FREE;
-        }
-        break;
+        double constexpr kAlpha = 0.3;
+        double const bytesPerSecond = (range.second - range.first + 1) / seconds;
+        server.m_bytesPerSecond = server.m_bytesPerSecond == 0
+                                      ? bytesPerSecond
+                                      : kAlpha * bytesPerSecond + (1 - kAlpha) * server.m_bytesPerSecond;
       }
     }
+    else
+    {
+      LOG(LWARNING, ("Failed to dl chunk", res.second, "via", url));
+      // mark server as failed and chunk as free
+      server.m_failed = true;
+      res.first->m_status = CHUNK_FREE;
+    }
+
+    server.m_chunks.erase(it);
+    if (server.m_failed && server.m_chunks.empty())
+      m_servers.erase(m_servers.begin() + s);
+    break;
   }
   return url;
 }
@@ -203,17 +257,17 @@ ChunksDownloadStrategy::NextChunk(string & outUrl, RangeT & range)
   if (m_servers.empty())
     return EDownloadFailed;
 
-  // Find first free server.
-  ServerT * server = 0;
-  for (size_t i = 0; i < m_servers.size(); ++i)
+  // Find the least loaded server which can take one more chunk.
+  ServerT * server = nullptr;
+  for (auto & s : m_servers)
   {
-    if (m_servers[i].m_chunkIndex == SERVER_READY)
+    if (!s.m_failed && s.m_chunks.size() < m_connectionsPerServer &&
+        (server == nullptr || s.m_chunks.size() < server->m_chunks.size()))
     {
-      server = &m_servers[i];
-      break;
+      server = &s;
     }
   }
-  if (server == 0)
+  if (server == nullptr)
     return ENoFreeServers;
 
   bool allChunksDownloaded = true;
@@ -224,14 +278,17 @@ ChunksDownloadStrategy::NextChunk(string & outUrl, RangeT & range)
     switch (m_chunks[i].m_status)
     {
     case CHUNK_FREE:
-      server->m_chunkIndex = static_cast<int>(i);
+      if (m_autoChunkSize)
+        FitChunk(i, *server);
+
       outUrl = server->m_url;
 
       range.first = m_chunks[i].m_pos;
       range.second = m_chunks[i+1].m_pos - 1;
 
       m_chunks[i].m_status = CHUNK_DOWNLOADING;
-      LOG(LDEBUG, ("Download chunk", server->m_chunkIndex, "via", outUrl));
+      server->m_chunks.emplace_back(range.first, Clock::now());
+      LOG(LDEBUG, ("Download chunk", i, "via", outUrl));
       return ENextChunk;
 
     case CHUNK_DOWNLOADING:
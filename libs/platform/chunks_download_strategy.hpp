@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <utility>
@@ -8,11 +10,20 @@
 namespace downloader
 {
 /// Single-threaded code
+/// With the auto chunk size every server gets several connections, and a free chunk is split
+/// or merged with the next free chunks when it's assigned to a server, so that it takes about
+/// kTargetChunkDuration at the throughput measured for the server.
 class ChunksDownloadStrategy
 {
 public:
   enum ChunkStatusT { CHUNK_FREE = 0, CHUNK_DOWNLOADING = 1, CHUNK_COMPLETE = 2, CHUNK_AUX = -1 };
 
+  /// Number of parallel range requests to one server with the auto chunk size.
+  static size_t constexpr kAutoConnectionsPerServer = 3;
+  static std::chrono::seconds constexpr kTargetChunkDuration{4};
+  static int64_t constexpr kMinAutoChunkSize = 256 * 1024;
+  static int64_t constexpr kMaxAutoChunkSize = 16 * 1024 * 1024;
+
 private:
 #pragma pack(push, 1)
   struct ChunkT
@@ -39,26 +50,39 @@ private:
 
   using RangeT = std::pair<int64_t, int64_t>;
 
-  static const int SERVER_READY = -1;
+  using Clock = std::chrono::steady_clock;
+
   struct ServerT
   {
     std::string m_url;
-    int m_chunkIndex;
-
-    ServerT(std::string const & url, int ind) : m_url(url), m_chunkIndex(ind) {}
+    /// Positions and start times of the chunks which are being downloaded from the server.
+    std::vector<std::pair<int64_t, Clock::time_point>> m_chunks;
+    /// Smoothed throughput of one connection, 0 if it's not measured yet.
+    double m_bytesPerSecond = 0;
+    /// Failed server doesn't get new chunks and is removed when its chunks are finished.
+    bool m_failed = false;
+
+    explicit ServerT(std::string const & url) : m_url(url) {}
   };
 
   std::vector<ChunkT> m_chunks;
 
   std::vector<ServerT> m_servers;
 
+  size_t m_connectionsPerServer = 1;
+  bool m_autoChunkSize = false;
+
   /// @return Chunk pointer and it's index for given file offsets range.
   std::pair<ChunkT *, int> GetChunk(RangeT const & range);
 
+  void SetAutoChunkSize(bool autoChunkSize);
+  /// Splits free chunk |index| or merges it with the next free chunks to suit |server|.
+  void FitChunk(size_t index, ServerT const & server);
+
 public:
   ChunksDownloadStrategy(std::vector<std::string> const & urls);
 
-  /// Init chunks vector for fileSize.
+  /// Init chunks vector for fileSize, 0 chunkSize for auto.
   void InitChunks(int64_t fileSize, int64_t chunkSize, ChunkStatusT status = CHUNK_FREE);
 
   /// Used in unit tests only!
@@ -75,6 +99,9 @@ public:
 
   size_t ActiveServersCount() const { return m_servers.size(); }
 
+  /// Used in unit tests only!
+  void SetThroughputForTesting(std::string const & url, double bytesPerSecond);
+
   enum ResultT
   {
     ENextChunk,
@@ -10,11 +10,14 @@
 
 #include "coding/internal/file_data.hpp"
 #include "coding/file_writer.hpp"
+#include "coding/sha1.hpp"
 
 #include "base/logging.hpp"
 #include "base/string_utils.hpp"
 
+#include <algorithm>
 #include <list>
+#include <map>
 #include <memory>
 
 #include "defines.hpp"
@@ -134,10 +137,21 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
   ThreadsContainerT m_threads;
 
   string m_filePath;
-  unique_ptr<FileWriter> m_writer;
+  // Chunks are written to their positions in the file which is reserved for the whole size.
+  unique_ptr<base::FileData> m_writer;
 
   bool m_doCleanProgressFiles;
 
+  // The file is hashed while downloading. Bytes which are written right after the hashed prefix
+  // are hashed at once, chunks which are written ahead of it are read back when the prefix
+  // reaches them. The calculator is reset when the hash can't be trusted, e.g. after a failed chunk.
+  unique_ptr<coding::SHA1::Calculator> m_sha1;
+  int64_t m_hashedBytes = 0;
+  // Begin -> end of merged ranges which are written ahead of the hashed prefix.
+  // The first range may be partially hashed already.
+  map<int64_t, int64_t> m_writtenAhead;
+  string m_sha1Base64;
+
   // Starts a thread per each free/available server.
   ChunksDownloadStrategy::ResultT StartThreads()
   {
@@ -187,8 +201,8 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
 
     try
     {
-      m_writer->Seek(offset);
-      m_writer->Write(buffer, size);
+      m_writer->WriteAt(offset, buffer, size);
+      UpdateHash(offset, buffer, size);
       return true;
     }
     catch (Writer::Exception const & e)
@@ -198,6 +212,120 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     }
   }
 
+  void UpdateHash(int64_t offset, void const * buffer, size_t size)
+  {
+    if (!m_sha1)
+      return;
+
+    if (offset < m_hashedBytes)
+    {
+      // Already hashed bytes are rewritten.
+      m_sha1.reset();
+      return;
+    }
+
+    int64_t const end = offset + static_cast<int64_t>(size);
+    if (offset == m_hashedBytes)
+    {
+      m_sha1->Update(buffer, size);
+      m_hashedBytes = end;
+      return;
+    }
+
+    // Bytes of a chunk come in order, so the range is usually merged with the previous one.
+    int64_t beg = offset;
+    int64_t last = end;
+    auto it = m_writtenAhead.upper_bound(beg);
+    if (it != m_writtenAhead.begin() && prev(it)->second >= beg)
+    {
+      --it;
+      beg = it->first;
+      last = max(last, it->second);
+      it = m_writtenAhead.erase(it);
+    }
+    while (it != m_writtenAhead.end() && it->first <= last)
+    {
+      last = max(last, it->second);
+      it = m_writtenAhead.erase(it);
+    }
+    m_writtenAhead.emplace(beg, last);
+  }
+
+  void DropWrittenAhead(int64_t beg, int64_t end)
+  {
+    auto it = m_writtenAhead.upper_bound(beg);
+    if (it != m_writtenAhead.begin())
+      --it;
+
+    while (it != m_writtenAhead.end() && it->first < end)
+    {
+      auto const [rangeBeg, rangeEnd] = *it;
+      if (rangeEnd <= beg)
+      {
+        ++it;
+        continue;
+      }
+
+      it = m_writtenAhead.erase(it);
+      if (rangeBeg < beg)
+        m_writtenAhead.emplace(rangeBeg, beg);
+      if (rangeEnd > end)
+        m_writtenAhead.emplace(end, rangeEnd);
+    }
+  }
+
+  // Hashes the ranges which are written ahead and adjoin the hashed prefix. It's called from
+  // OnFinish() on the GUI thread, so at most kMaxReadBackBytes are read per call and the rest
+  // is left for the next calls.
+  void HashWrittenAhead()
+  {
+    if (!m_sha1 || m_writtenAhead.empty() || m_writtenAhead.begin()->first > m_hashedBytes)
+      return;
+
+    try
+    {
+      m_writer->Flush();
+
+      base::FileData file(m_filePath + DOWNLOADING_FILE_EXTENSION, base::FileData::Op::READ);
+      size_t constexpr kBufferSize = 64 * 1024;
+      int64_t constexpr kMaxReadBackBytes = 4 * 1024 * 1024;
+      vector<char> buffer(kBufferSize);
+      int64_t readBytes = 0;
+      while (!m_writtenAhead.empty() && m_writtenAhead.begin()->first <= m_hashedBytes)
+      {
+        int64_t const end = m_writtenAhead.begin()->second;
+        while (m_hashedBytes < end)
+        {
+          if (readBytes == kMaxReadBackBytes)
+            return;
+
+          auto const toRead = static_cast<size_t>(
+              min({static_cast<int64_t>(kBufferSize), end - m_hashedBytes, kMaxReadBackBytes - readBytes}));
+          file.Read(m_hashedBytes, buffer.data(), toRead);
+          m_sha1->Update(buffer.data(), toRead);
+          m_hashedBytes += toRead;
+          readBytes += toRead;
+        }
+        m_writtenAhead.erase(m_writtenAhead.begin());
+      }
+    }
+    catch (RootException const & e)
+    {
+      LOG(LWARNING, ("Can't hash downloaded chunks of", m_filePath, e.Msg()));
+      m_sha1.reset();
+    }
+  }
+
+  // The hash is left empty if too many written ahead bytes are not hashed yet,
+  // then the client reads the whole file on its own thread.
+  void FinishHash()
+  {
+    HashWrittenAhead();
+    if (m_sha1 && m_hashedBytes == m_progress.m_bytesTotal)
+      m_sha1Base64 = coding::SHA1::ToBase64(m_sha1->GetHash());
+    m_sha1.reset();
+  }
+
   // Saves current chunks' statuses into a resume file.
   void SaveResumeChunks()
   {
@@ -231,6 +359,8 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     // report progress
     if (isChunkOk)
     {
+      HashWrittenAhead();
+
       m_progress.m_bytesDownloaded += (endRange - begRange) + 1;
       if (m_onProgress)
         m_onProgress(*this);
@@ -239,6 +369,12 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     {
       auto const message = non_http_error_code::DebugPrint(httpOrErrorCode);
       LOG(LWARNING, (m_filePath, "HttpRequest error:", message));
+
+      // Written bytes of the failed chunk are not reliable.
+      if (begRange < m_hashedBytes)
+        m_sha1.reset();
+      else
+        DropWrittenAhead(begRange, endRange + 1);
     }
 
     ChunksDownloadStrategy::ResultT const result = StartThreads();
@@ -258,7 +394,9 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
     if (m_status == DownloadStatus::Failed || m_status == DownloadStatus::FileNotFound)
       SaveResumeChunks();
 
-    // 2. Free file handle.
+    // 2. Finish the hash and free file handle.
+    if (m_status == DownloadStatus::Completed)
+      FinishHash();
     CloseWriter();
 
     // 3. Clean up resume file with chunks range on success
@@ -279,7 +417,8 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
   {
     try
     {
-      m_writer.reset();
+      if (m_writer)
+        m_writer->Flush();
     }
     catch (Writer::Exception const & e)
     {
@@ -287,6 +426,7 @@ class FileHttpRequest : public HttpRequest, public IHttpThreadCallback
 
       m_status = DownloadStatus::Failed;
     }
+    m_writer.reset();
   }
 
 public:
@@ -304,14 +444,14 @@ public:
                                                    fileSize, chunkSize);
     m_progress.m_bytesTotal = fileSize;
 
-    FileWriter::Op openMode = FileWriter::OP_WRITE_TRUNCATE;
+    auto openMode = base::FileData::Op::WRITE_TRUNCATE;
     if (m_progress.m_bytesDownloaded != 0)
     {
       // Check that resume information is correct with existing file.
       uint64_t size;
       if (base::GetFileSize(filePath + DOWNLOADING_FILE_EXTENSION, size) &&
               size <= static_cast<uint64_t>(fileSize))
-        openMode = FileWriter::OP_WRITE_EXISTING;
+        openMode = base::FileData::Op::WRITE_EXISTING;
       else
       {
         LOG(LWARNING, ("Incomplete file size is bigger than expected, re-downloading."));
@@ -320,10 +460,17 @@ public:
     }
 
     // Create file and reserve needed size.
-    unique_ptr<FileWriter> writer(new FileWriter(filePath + DOWNLOADING_FILE_EXTENSION, openMode));
+    auto writer = make_unique<base::FileData>(filePath + DOWNLOADING_FILE_EXTENSION, openMode);
+    writer->Truncate(static_cast<uint64_t>(fileSize));
 
     // Assign here, because previous functions can throw an exception.
     m_writer.swap(writer);
+
+    // Chunks of a resumed file were downloaded by another request, so its hash is calculated
+    // by the client after downloading.
+    if (openMode == base::FileData::Op::WRITE_TRUNCATE)
+      m_sha1 = make_unique<coding::SHA1::Calculator>();
+
     Platform::DisableBackupForFile(filePath + DOWNLOADING_FILE_EXTENSION);
     StartThreads();
   }
@@ -356,6 +503,11 @@ public:
   {
     return m_filePath;
   }
+
+  string const & GetSha1() const override
+  {
+    return m_sha1Base64;
+  }
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -371,6 +523,12 @@ HttpRequest::~HttpRequest()
 {
 }
 
+string const & HttpRequest::GetSha1() const
+{
+  static string const kEmpty;
+  return kEmpty;
+}
+
 HttpRequest * HttpRequest::Get(string const & url, Callback && onFinish, Callback && onProgress)
 {
   return new MemoryHttpRequest(url, std::move(onFinish), std::move(onProgress));
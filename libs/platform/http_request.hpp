@@ -41,6 +41,9 @@ public:
   Progress const & GetProgress() const { return m_progress; }
   /// Either file path (for chunks) or downloaded data
   virtual std::string const & GetData() const = 0;
+  /// Base64 SHA1 of the downloaded file which is calculated while downloading.
+  /// Empty if it's not available, e.g. when downloading was resumed.
+  virtual std::string const & GetSha1() const;
 
   /// Response saved to memory buffer and retrieved with Data()
   static HttpRequest * Get(std::string const & url,
@@ -54,6 +57,8 @@ public:
 
   /// Download file to filePath.
   /// Pulls chunks simultaneously from all available servers, 1 thread per server.
+  /// With the auto chunk size there are several threads per server and chunks are sized
+  /// by the measured throughput (@see ChunksDownloadStrategy).
   /// @param[in]  fileSize  Correct file size (needed for resuming and reserving).
   static HttpRequest * GetFile(std::vector<std::string> const & urls,
                                std::string const & filePath, int64_t fileSize,
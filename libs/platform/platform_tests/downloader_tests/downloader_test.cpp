@@ -7,13 +7,18 @@
 #include "coding/file_reader.hpp"
 #include "coding/file_writer.hpp"
 #include "coding/internal/file_data.hpp"
+#include "coding/sha1.hpp"
 
 #include "base/logging.hpp"
 #include "base/std_serialization.hpp"
+#include "base/string_utils.hpp"
+#include "base/timer.hpp"
 
 #include <QtCore/QCoreApplication>
 
+#include <algorithm>
 #include <functional>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -368,6 +373,85 @@ UNIT_TEST(ChunksDownloadStrategyDynamicChunks)
   TEST(r1 == R31 && r2 == R32, (r1, r2));
 }
 
+UNIT_TEST(ChunksDownloadStrategyConnectionsPerServer)
+{
+  vector<string> const servers = {"UrlOfServer1", "UrlOfServer2"};
+
+  typedef pair<int64_t, int64_t> RangeT;
+
+  // 10MB file - ten 1MB chunks, several connections per server with the auto chunk size.
+  ChunksDownloadStrategy strategy(servers);
+  strategy.InitChunks(10 * 1024 * 1024, 0);
+
+  size_t constexpr kConnections = ChunksDownloadStrategy::kAutoConnectionsPerServer;
+  map<string, vector<RangeT>> ranges;
+  for (size_t i = 0; i < servers.size() * kConnections; ++i)
+  {
+    string url;
+    RangeT r;
+    TEST_EQUAL(strategy.NextChunk(url, r), ChunksDownloadStrategy::ENextChunk, ());
+    ranges[url].push_back(r);
+  }
+  for (auto const & s : servers)
+    TEST_EQUAL(ranges[s].size(), kConnections, (s));
+
+  string sEmpty;
+  RangeT rEmpty;
+  TEST_EQUAL(strategy.NextChunk(sEmpty, rEmpty), ChunksDownloadStrategy::ENoFreeServers, ());
+
+  // The failed server doesn't get new chunks, the failed chunk goes to another server.
+  RangeT const failed = ranges[servers[0]][0];
+  strategy.ChunkFinished(false, failed);
+  TEST_EQUAL(strategy.NextChunk(sEmpty, rEmpty), ChunksDownloadStrategy::ENoFreeServers, ());
+
+  strategy.ChunkFinished(true, ranges[servers[1]][0]);
+  string url;
+  RangeT r;
+  TEST_EQUAL(strategy.NextChunk(url, r), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(url, servers[1], ());
+  TEST_EQUAL(r, failed, ());
+
+  // Chunks which were already started on the failed server are still accepted.
+  TEST_EQUAL(strategy.ChunkFinished(true, ranges[servers[0]][1]), servers[0], ());
+  TEST_EQUAL(strategy.ChunkFinished(true, ranges[servers[0]][2]), servers[0], ());
+  TEST_EQUAL(strategy.ActiveServersCount(), 1, ());
+}
+
+UNIT_TEST(ChunksDownloadStrategyAdaptiveChunks)
+{
+  vector<string> const servers = {"UrlOfServer1"};
+
+  typedef pair<int64_t, int64_t> RangeT;
+  int64_t constexpr kMb = 1024 * 1024;
+  auto const targetSeconds = ChunksDownloadStrategy::kTargetChunkDuration.count();
+
+  // 20MB file - twenty 1MB chunks.
+  ChunksDownloadStrategy strategy(servers);
+  strategy.InitChunks(20 * kMb, 0);
+
+  string url;
+  RangeT r;
+
+  // Free chunks are merged for a fast server.
+  strategy.SetThroughputForTesting(servers[0], kMb);
+  TEST_EQUAL(strategy.NextChunk(url, r), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(r, RangeT(0, targetSeconds * kMb - 1), ());
+
+  // And split for a slow one.
+  int64_t const pos = targetSeconds * kMb;
+  strategy.SetThroughputForTesting(servers[0], 100 * 1024);
+  TEST_EQUAL(strategy.NextChunk(url, r), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(r, RangeT(pos, pos + targetSeconds * 100 * 1024 - 1), ());
+
+  // The chunk size is limited, but a tail which is too small is not left.
+  strategy.SetThroughputForTesting(servers[0], 1000 * kMb);
+  TEST_EQUAL(strategy.NextChunk(url, r), ChunksDownloadStrategy::ENextChunk, ());
+  TEST_EQUAL(r.first, pos + targetSeconds * 100 * 1024, ());
+  TEST_EQUAL(r.second, 20 * kMb - 1, ());
+
+  TEST_EQUAL(strategy.NextChunk(url, r), ChunksDownloadStrategy::ENoFreeServers, ());
+}
+
 namespace
 {
 string ReadFileAsString(string const & file)
@@ -447,6 +531,7 @@ UNIT_TEST(DownloadChunks)
     observer.TestOk();
     TEST_EQUAL(request->GetData(), kFileName, ());
     TEST_EQUAL(ReadFileAsString(kFileName), "Test1", ());
+    TEST_EQUAL(request->GetSha1(), coding::SHA1::CalculateBase64(kFileName), ());
     FinishDownloadSuccess(kFileName);
   }
 
@@ -466,11 +551,12 @@ UNIT_TEST(DownloadChunks)
   urls = {kTestUrlBigFile, kTestUrlBigFile, kTestUrlBigFile};
   fileSize = kBigFileSize;
   {
-    // 3 threads - succeeded
-    [[maybe_unused]] unique_ptr<HttpRequest> const request {MakeRequest(2048)};
+    // 3 threads - succeeded, chunks which come out of order are hashed too
+    unique_ptr<HttpRequest> const request {MakeRequest(2048)};
     // wait until download is finished
     QCoreApplication::exec();
     observer.TestOk();
+    TEST_EQUAL(request->GetSha1(), coding::SHA1::CalculateBase64(kFileName), ());
     FinishDownloadSuccess(kFileName);
   }
 
@@ -499,6 +585,45 @@ UNIT_TEST(DownloadChunks)
   }
 }
 
+/*
+char constexpr kTestUrlBenchmarkFile[] = "http://localhost:34568/unit_tests/16mb.file";
+// Should match size defined in tools/python/test_server/server/ResponseProvider.py
+int64_t constexpr kBenchmarkFileSize = 16 * 1024 * 1024;
+
+// Compares a single connection with fixed chunks and the auto mode on the local test server.
+// It downloads 16MB twice, uncomment it to run manually.
+UNIT_TEST(DownloadChunksBenchmark)
+{
+  string const kFileName = "some_downloader_benchmark_file";
+  DeleteTempDownloadFiles();
+
+  string expected(kBenchmarkFileSize, 0);
+  for (int64_t i = 0; i < kBenchmarkFileSize; ++i)
+    expected[i] = static_cast<char>(i % 256);
+  auto const expectedSha1 = coding::SHA1::ToBase64(coding::SHA1::CalculateForString(expected));
+
+  for (int64_t const chunkSize : {int64_t{1024 * 1024}, int64_t{0}})
+  {
+    DownloadObserver observer;
+    base::Timer timer;
+    {
+      unique_ptr<HttpRequest> const request {HttpRequest::GetFile({kTestUrlBenchmarkFile}, kFileName,
+          kBenchmarkFileSize, bind(&DownloadObserver::OnDownloadFinish, &observer, _1),
+          bind(&DownloadObserver::OnDownloadProgress, &observer, _1), chunkSize)};
+      QCoreApplication::exec();
+      observer.TestOk();
+      TEST_EQUAL(request->GetSha1(), expectedSha1, ());
+    }
+
+    auto const seconds = timer.ElapsedSeconds();
+    LOG(LINFO, ("Chunk size", chunkSize == 0 ? "auto" : strings::to_string(chunkSize), "downloaded in", seconds,
+                "s,", kBenchmarkFileSize / 1024 / 1024 / std::max(seconds, 1e-3), "MB/s"));
+
+    TEST_EQUAL(coding::SHA1::CalculateBase64(kFileName), expectedSha1, ());
+    FinishDownloadSuccess(kFileName);
+  }
+}
+*/
 
 namespace
 {
@@ -595,6 +720,8 @@ UNIT_TEST(DownloadResumeChunks)
                                                          bind(&ResumeChecker::OnProgress, &checker, _1)));
     QCoreApplication::exec();
 
+    // The hash of a resumed file is not calculated while downloading.
+    TEST(request->GetSha1().empty(), ());
     FinishDownloadSuccess(FILENAME);
   }
 }
@@ -0,0 +1,169 @@
+#include "routing/cross_mwm_overlay.hpp"
+
+#include <utility>
+
+namespace routing
+{
+void CrossMwmOverlay::AddCell(CrossMwmOverlayCell && cell)
+{
+  CHECK_EQUAL(cell.m_weights.size(), cell.m_enters.size() * cell.m_exits.size(), ());
+  AddCellImpl(std::move(cell), {});
+}
+
+void CrossMwmOverlay::AddCellImpl(CrossMwmOverlayCell && cell, WeightsPosition const & weightsPos)
+{
+  auto const cellIdx = base::checked_cast<uint32_t>(m_cells.size());
+  for (auto const mwmId : cell.m_mwms)
+    CHECK(m_mwmToCell.emplace(mwmId, cellIdx).second, ("Mwm", mwmId, "is in several cells."));
+
+  for (uint32_t i = 0; i < cell.m_enters.size(); ++i)
+    m_enters.emplace(cell.m_enters[i], Position{cellIdx, i});
+  for (uint32_t i = 0; i < cell.m_exits.size(); ++i)
+    m_exits.emplace(cell.m_exits[i], Position{cellIdx, i});
+
+  m_cells.push_back(std::move(cell));
+  m_weightsPositions.push_back(weightsPos);
+}
+
+std::vector<CrossMwmOverlay::Weight> const & CrossMwmOverlay::GetWeights(uint32_t cellIdx) const
+{
+  ASSERT_LESS(cellIdx, m_cells.size(), ());
+  auto & cell = m_cells[cellIdx];
+  auto & weightsPos = m_weightsPositions[cellIdx];
+  if (weightsPos.m_size == 0)
+    return cell.m_weights;
+
+  CHECK(m_reader, ());
+  size_t const weightsCount = cell.m_enters.size() * cell.m_exits.size();
+  NonOwningReaderSource src(*m_reader, weightsPos.m_pos, weightsPos.m_pos + weightsPos.m_size);
+  cell.m_weights.reserve(weightsCount);
+  for (size_t i = 0; i < weightsCount; ++i)
+    cell.m_weights.push_back(ReadVarUint<Weight>(src));
+  CHECK_EQUAL(src.Size(), 0, ("Broken cross mwm overlay cell", cellIdx));
+
+  weightsPos = {};
+  return cell.m_weights;
+}
+
+std::optional<uint32_t> CrossMwmOverlay::GetCellIdx(NumMwmId mwmId) const
+{
+  auto const it = m_mwmToCell.find(mwmId);
+  if (it == m_mwmToCell.end())
+    return {};
+  return it->second;
+}
+
+std::optional<uint32_t> CrossMwmOverlay::GetEnterCellIdx(Segment const & segment) const
+{
+  auto const it = m_enters.find(segment);
+  if (it == m_enters.end())
+    return {};
+  return it->second.m_cellIdx;
+}
+
+std::optional<uint32_t> CrossMwmOverlay::GetExitCellIdx(Segment const & segment) const
+{
+  auto const it = m_exits.find(segment);
+  if (it == m_exits.end())
+    return {};
+  return it->second.m_cellIdx;
+}
+
+void CrossMwmOverlay::GetOutgoingEdgeList(Segment const & enter, EdgeListT & edges) const
+{
+  auto const it = m_enters.find(enter);
+  CHECK(it != m_enters.end(), (enter));
+
+  auto const & cell = m_cells[it->second.m_cellIdx];
+  auto const & weights = GetWeights(it->second.m_cellIdx);
+  size_t const row = it->second.m_idx * cell.m_exits.size();
+  for (size_t exitIdx = 0; exitIdx < cell.m_exits.size(); ++exitIdx)
+  {
+    auto const weight = weights[row + exitIdx];
+    if (weight != connector::kNoRouteStored)
+      edges.emplace_back(cell.m_exits[exitIdx], RouteWeight::FromCrossMwmWeight(weight));
+  }
+}
+
+void CrossMwmOverlay::GetIngoingEdgeList(Segment const & exit, EdgeListT & edges) const
+{
+  auto const it = m_exits.find(exit);
+  CHECK(it != m_exits.end(), (exit));
+
+  auto const & cell = m_cells[it->second.m_cellIdx];
+  auto const & weights = GetWeights(it->second.m_cellIdx);
+  for (size_t enterIdx = 0; enterIdx < cell.m_enters.size(); ++enterIdx)
+  {
+    auto const weight = weights[enterIdx * cell.m_exits.size() + it->second.m_idx];
+    if (weight != connector::kNoRouteStored)
+      edges.emplace_back(cell.m_enters[enterIdx], RouteWeight::FromCrossMwmWeight(weight));
+  }
+}
+
+// static
+void CrossMwmOverlaySerializer::Deserialize(CrossMwmOverlay & overlay, Reader const & reader,
+                                            NumMwmIds const & numMwmIds)
+{
+  NonOwningReaderSource src(reader);
+  auto const version = ReadPrimitiveFromSource<uint32_t>(src);
+  CHECK_LESS_OR_EQUAL(version, kVersion, ("Unknown cross mwm overlay version."));
+
+  auto const cellsCount = ReadPrimitiveFromSource<uint32_t>(src);
+  for (uint32_t cellIdx = 0; cellIdx < cellsCount; ++cellIdx)
+  {
+    CrossMwmOverlayCell cell;
+    bool isKnown = true;
+
+    auto const mwmsCount = ReadVarUint<uint32_t>(src);
+    cell.m_mwms.reserve(mwmsCount);
+    cell.m_mwmVersions.reserve(mwmsCount);
+    for (uint32_t i = 0; i < mwmsCount; ++i)
+    {
+      std::string name;
+      rw::Read(src, name);
+      platform::CountryFile const file(std::move(name));
+
+      if (numMwmIds.ContainsFile(file))
+      {
+        cell.m_mwms.push_back(numMwmIds.GetId(file));
+      }
+      else
+      {
+        isKnown = false;
+        cell.m_mwms.push_back(kFakeNumMwmId);
+      }
+      cell.m_mwmVersions.push_back(ReadVarUint<uint32_t>(src));
+    }
+
+    auto const readSegments = [&](std::vector<Segment> & segments)
+    {
+      auto const count = ReadVarUint<uint32_t>(src);
+      segments.reserve(count);
+      for (uint32_t i = 0; i < count; ++i)
+      {
+        auto const mwmIdx = ReadVarUint<uint32_t>(src);
+        CHECK_LESS(mwmIdx, cell.m_mwms.size(), ());
+        auto const featureId = ReadVarUint<uint32_t>(src);
+        auto const segmentIdx = ReadVarUint<uint32_t>(src);
+        bool const forward = ReadPrimitiveFromSource<uint8_t>(src) != 0;
+        segments.emplace_back(cell.m_mwms[mwmIdx], featureId, segmentIdx, forward);
+      }
+    };
+
+    readSegments(cell.m_enters);
+    readSegments(cell.m_exits);
+
+    CrossMwmOverlay::WeightsPosition weightsPos;
+    weightsPos.m_size = ReadVarUint<uint64_t>(src);
+    weightsPos.m_pos = src.Pos();
+    src.Skip(weightsPos.m_size);
+
+    if (isKnown)
+      overlay.AddCellImpl(std::move(cell), weightsPos);
+    else
+      LOG(LDEBUG, ("Skip cross mwm overlay cell", cellIdx, "with unknown mwms."));
+  }
+
+  overlay.m_reader = reader.CreateSubReader(0, reader.Size());
+}
+}  // namespace routing
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "routing/base/small_list.hpp"
+#include "routing/cross_mwm_connector.hpp"
+#include "routing/segment.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include "platform/country_file.hpp"
+
+#include "coding/read_write_utils.hpp"
+#include "coding/reader.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace routing
+{
+/// \brief Cell of the cross-mwm overlay. It is a group of mwms of the same country.
+/// Cell enters are the transitions which lead into the cell from the other countries and
+/// cell exits are the transitions which lead out of it.
+struct CrossMwmOverlayCell
+{
+  using Weight = connector::Weight;
+
+  std::vector<NumMwmId> m_mwms;
+  /// Versions (YYMMDD) of |m_mwms| the weights were calculated for.
+  std::vector<uint32_t> m_mwmVersions;
+
+  std::vector<Segment> m_enters;
+  std::vector<Segment> m_exits;
+  /// |m_enters| x |m_exits| matrix of the shortest cross-mwm weights inside the cell.
+  /// connector::kNoRouteStored if there is no route.
+  /// \note It's empty in a deserialized overlay, see CrossMwmOverlay::GetWeights().
+  std::vector<Weight> m_weights;
+};
+
+/// \brief The second level of the cross-mwm graph (CROSS_MWM_OVERLAY_FILE_TAG section of World.mwm).
+/// The first level is cross_mwm sections of the mwms with the enter -> exit weights of every mwm.
+/// The overlay keeps the same weights for the whole countries, so LeapsGraph may jump over
+/// a country without loading cross_mwm sections of its mwms.
+/// \note A deserialized overlay keeps only the cells' mwms and transitions in memory, the weights
+/// of a cell are read from the section when the cell is used for the first time. Not thread-safe.
+class CrossMwmOverlay
+{
+public:
+  using EdgeListT = SmallList<SegmentEdge>;
+  using Weight = CrossMwmOverlayCell::Weight;
+
+  void AddCell(CrossMwmOverlayCell && cell);
+
+  bool IsEmpty() const { return m_cells.empty(); }
+  size_t GetCellsCount() const { return m_cells.size(); }
+  CrossMwmOverlayCell const & GetCell(uint32_t cellIdx) const
+  {
+    ASSERT_LESS(cellIdx, m_cells.size(), ());
+    return m_cells[cellIdx];
+  }
+
+  /// \returns |m_weights| of the cell, reads them if they are not loaded yet.
+  std::vector<Weight> const & GetWeights(uint32_t cellIdx) const;
+
+  /// \returns index of the cell which contains |mwmId| if any.
+  std::optional<uint32_t> GetCellIdx(NumMwmId mwmId) const;
+  /// \returns index of the cell if |segment| is an enter to it.
+  std::optional<uint32_t> GetEnterCellIdx(Segment const & segment) const;
+  /// \returns index of the cell if |segment| is an exit from it.
+  std::optional<uint32_t> GetExitCellIdx(Segment const & segment) const;
+
+  /// \brief Fills |edges| with all exits of the cell reachable from |enter|.
+  void GetOutgoingEdgeList(Segment const & enter, EdgeListT & edges) const;
+  /// \brief Fills |edges| with all enters of the cell |exit| is reachable from.
+  void GetIngoingEdgeList(Segment const & exit, EdgeListT & edges) const;
+
+private:
+  friend class CrossMwmOverlaySerializer;
+
+  struct Position
+  {
+    uint32_t m_cellIdx = 0;
+    uint32_t m_idx = 0;
+  };
+
+  // Position of the cell weights in |m_reader|, |m_size| is 0 if the weights are loaded.
+  struct WeightsPosition
+  {
+    uint64_t m_pos = 0;
+    uint64_t m_size = 0;
+  };
+
+  void AddCellImpl(CrossMwmOverlayCell && cell, WeightsPosition const & weightsPos);
+
+  mutable std::vector<CrossMwmOverlayCell> m_cells;
+  mutable std::vector<WeightsPosition> m_weightsPositions;
+  std::unique_ptr<Reader> m_reader;
+
+  std::unordered_map<NumMwmId, uint32_t> m_mwmToCell;
+  std::unordered_map<Segment, Position> m_enters;
+  std::unordered_map<Segment, Position> m_exits;
+};
+
+class CrossMwmOverlaySerializer
+{
+public:
+  CrossMwmOverlaySerializer() = delete;
+
+  template <class Sink>
+  static void Serialize(CrossMwmOverlay const & overlay, Sink & sink, NumMwmIds const & numMwmIds);
+
+  /// \note Cells with mwms which are unknown to |numMwmIds| are skipped.
+  /// The weights are read from |reader| later, |overlay| keeps a copy of it.
+  static void Deserialize(CrossMwmOverlay & overlay, Reader const & reader, NumMwmIds const & numMwmIds);
+
+private:
+  static uint32_t constexpr kVersion = 0;
+};
+
+// static
+template <class Sink>
+void CrossMwmOverlaySerializer::Serialize(CrossMwmOverlay const & overlay, Sink & sink,
+                                          NumMwmIds const & numMwmIds)
+{
+  WriteToSink(sink, kVersion);
+  WriteToSink(sink, base::checked_cast<uint32_t>(overlay.GetCellsCount()));
+
+  std::vector<uint8_t> weightsBuffer;
+  for (uint32_t cellIdx = 0; cellIdx < overlay.GetCellsCount(); ++cellIdx)
+  {
+    auto const & cell = overlay.GetCell(cellIdx);
+    auto const & weights = overlay.GetWeights(cellIdx);
+    CHECK_EQUAL(cell.m_mwms.size(), cell.m_mwmVersions.size(), ());
+    CHECK_EQUAL(weights.size(), cell.m_enters.size() * cell.m_exits.size(), ());
+
+    std::unordered_map<NumMwmId, uint32_t> localIdx;
+    WriteVarUint(sink, base::checked_cast<uint32_t>(cell.m_mwms.size()));
+    for (size_t i = 0; i < cell.m_mwms.size(); ++i)
+    {
+      localIdx.emplace(cell.m_mwms[i], base::checked_cast<uint32_t>(i));
+      rw::Write(sink, numMwmIds.GetFile(cell.m_mwms[i]).GetName());
+      WriteVarUint(sink, cell.m_mwmVersions[i]);
+    }
+
+    auto const writeSegments = [&](std::vector<Segment> const & segments)
+    {
+      WriteVarUint(sink, base::checked_cast<uint32_t>(segments.size()));
+      for (auto const & s : segments)
+      {
+        auto const it = localIdx.find(s.GetMwmId());
+        CHECK(it != localIdx.end(), (s));
+        WriteVarUint(sink, it->second);
+        WriteVarUint(sink, s.GetFeatureId());
+        WriteVarUint(sink, s.GetSegmentIdx());
+        WriteToSink(sink, static_cast<uint8_t>(s.IsForward() ? 1 : 0));
+      }
+    };
+
+    writeSegments(cell.m_enters);
+    writeSegments(cell.m_exits);
+
+    // The weights are prefixed with their size to skip them while deserializing.
+    weightsBuffer.clear();
+    {
+      MemWriter<std::vector<uint8_t>> writer(weightsBuffer);
+      for (auto const w : weights)
+        WriteVarUint(writer, w);
+    }
+    WriteVarUint(sink, static_cast<uint64_t>(weightsBuffer.size()));
+    sink.Write(weightsBuffer.data(), weightsBuffer.size());
+  }
+}
+}  // namespace routing
@@ -4,17 +4,19 @@
 #include "routing_common/num_mwm_id.hpp"
 
 #include "indexer/data_source.hpp"
+#include "indexer/utils.hpp"
 
 #include "base/lru_cache.hpp"
 
 #include <map>
+#include <memory>
 #include <unordered_map>
 
 namespace routing
 {
 // Main purpose is to take and hold MwmHandle-s here (readers and caches).
 // Routing works in a separate threads and doesn't interfere within route calculation process.
-/// @note Should add additional thread's caches in case of concurrent routing process.
+/// @note Concurrent routing threads should use their own instances, see CreateForAnotherThread().
 class MwmDataSource
 {
   DataSource & m_dataSource;
@@ -48,6 +50,12 @@ public:
     : m_dataSource(dataSource), m_numMwmIDs(std::move(numMwmIDs))
   {}
 
+  /// \returns data source over the same DataSource with its own handles and caches.
+  std::unique_ptr<MwmDataSource> CreateForAnotherThread() const
+  {
+    return std::make_unique<MwmDataSource>(m_dataSource, m_numMwmIDs);
+  }
+
   void FreeHandles()
   {
     m_featureSources.Clear();
@@ -99,6 +107,8 @@ public:
     return m_dataSource.GetMwmIdByCountryFile(m_numMwmIDs->GetFile(numMwmId));
   }
 
+  MwmSet::MwmHandle GetWorldHandle() const { return indexer::FindWorld(m_dataSource); }
+
   template <class FnT> void ForEachStreet(FnT && fn, m2::RectD const & rect)
   {
     m_dataSource.ForEachInRect(fn, rect, scales::GetUpperScale());
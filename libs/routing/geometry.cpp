@@ -2,6 +2,7 @@
 
 #include "routing/city_roads.hpp"
 #include "routing/maxspeeds.hpp"
+#include "routing/routing_geometry_serialization.hpp"
 
 #include "indexer/altitude_loader.hpp"
 #include "indexer/feature.hpp"
@@ -70,17 +71,33 @@ namespace
 class GeometryLoaderImpl final : public GeometryLoader
 {
 public:
-  GeometryLoaderImpl(MwmSet::MwmHandle const & handle, VehicleModelPtrT const & vehicleModel, bool loadAltitudes)
+  GeometryLoaderImpl(MwmSet::MwmHandle const & handle, VehicleModelPtrT const & vehicleModel,
+                     VehicleType vehicleType, bool loadAltitudes)
     : m_vehicleModel(vehicleModel)
     , m_source(handle)
     , m_altitudeLoader(*handle.GetValue())
     , m_loadAltitudes(loadAltitudes)
   {
-    m_attrsGetter.Load(handle.GetValue()->m_cont);
+    auto const & cont = handle.GetValue()->m_cont;
+    m_attrsGetter.Load(cont);
+    m_routingGeometry = RoutingGeometryDeserializer::Load(cont, vehicleType, vehicleModel->GetHash());
   }
 
   void Load(uint32_t featureId, RoadGeometry & road) override
   {
+    // Roads from routing geometry section don't need FeatureType decoding. Features which
+    // are not in the section (not roads for the vehicle) and all the features if the section
+    // is built with another vehicle model are loaded in the usual way.
+    if (m_routingGeometry && m_routingGeometry->Get(featureId, m_roadAttrs, m_roadPoints))
+    {
+      geometry::Altitudes altitudes;
+      if (m_loadAltitudes)
+        altitudes = m_altitudeLoader.GetAltitudes(featureId, m_roadPoints.size());
+
+      road.Load(m_roadAttrs, m_roadPoints, altitudes.empty() ? nullptr : &altitudes);
+      return;
+    }
+
     auto feature = m_source.GetOriginalFeature(featureId);
     feature->ParseGeometry(FeatureType::BEST_GEOMETRY);
 
@@ -103,6 +120,10 @@ private:
   FeatureSource m_source;
   feature::AltitudeLoaderBase m_altitudeLoader;
   bool const m_loadAltitudes;
+
+  std::unique_ptr<RoutingGeometryDeserializer> m_routingGeometry;
+  RoadGeometryAttrs m_roadAttrs;
+  std::vector<m2::PointD> m_roadPoints;
 };
 
 class FileGeometryLoader final : public GeometryLoader
@@ -242,6 +263,46 @@ void RoadGeometry::Load(VehicleModelInterface const & vehicleModel, FeatureType
   }
 }
 
+void RoadGeometry::Load(RoadGeometryAttrs const & attrs, std::vector<m2::PointD> const & points,
+                        geometry::Altitudes const * altitudes)
+{
+  size_t const count = points.size();
+  CHECK_GREATER(count, 1, ());
+  CHECK(altitudes == nullptr || altitudes->size() == count, ());
+
+  m_forwardSpeed = attrs.m_forwardSpeed;
+  m_backwardSpeed = attrs.m_backwardSpeed;
+  m_highwayType = attrs.m_highwayType;
+  m_routingOptions = attrs.m_routingOptions;
+  m_valid = true;
+  m_isOneWay = attrs.m_isOneWay;
+  m_isPassThroughAllowed = attrs.m_isPassThroughAllowed;
+  m_inCity = attrs.m_inCity;
+
+  m_junctions.clear();
+  m_junctions.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    m_junctions.emplace_back(mercator::ToLatLon(points[i]),
+                             altitudes ? (*altitudes)[i] : geometry::kDefaultAltitudeMeters);
+  }
+
+  m_distances.assign(count - 1, -1);
+}
+
+RoadGeometryAttrs RoadGeometry::GetAttrs() const
+{
+  RoadGeometryAttrs attrs;
+  attrs.m_forwardSpeed = m_forwardSpeed;
+  attrs.m_backwardSpeed = m_backwardSpeed;
+  attrs.m_highwayType = m_highwayType;
+  attrs.m_routingOptions = m_routingOptions;
+  attrs.m_isOneWay = m_isOneWay;
+  attrs.m_isPassThroughAllowed = m_isPassThroughAllowed;
+  attrs.m_inCity = m_inCity;
+  return attrs;
+}
+
 double RoadGeometry::GetDistance(uint32_t idx) const
 {
   if (m_distances[idx] < 0)
@@ -296,11 +357,11 @@ SpeedInUnits GeometryLoader::GetSavedMaxspeed(uint32_t featureId, bool forward)
 // static
 unique_ptr<GeometryLoader> GeometryLoader::Create(MwmSet::MwmHandle const & handle,
                                                   VehicleModelPtrT const & vehicleModel,
-                                                  bool loadAltitudes)
+                                                  VehicleType vehicleType, bool loadAltitudes)
 {
   CHECK(handle.IsAlive(), ());
   CHECK(vehicleModel, ());
-  return make_unique<GeometryLoaderImpl>(handle, vehicleModel, loadAltitudes);
+  return make_unique<GeometryLoaderImpl>(handle, vehicleModel, vehicleType, loadAltitudes);
 }
 
 // static
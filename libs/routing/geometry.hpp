@@ -3,6 +3,7 @@
 #include "routing/latlon_with_altitude.hpp"
 #include "routing/road_point.hpp"
 #include "routing/routing_options.hpp"
+#include "routing/vehicle_mask.hpp"
 
 #include "routing_common/vehicle_model.hpp"
 
@@ -27,6 +28,7 @@ namespace routing
 size_t constexpr kRoadsCacheSize = 10000;
 
 class RoadAttrsGetter;
+struct RoadGeometryAttrs;
 
 class RoadGeometry final
 {
@@ -41,6 +43,14 @@ public:
   void Load(VehicleModelInterface const & vehicleModel, FeatureType & feature,
             geometry::Altitudes const * altitudes, RoadAttrsGetter & attrs);
 
+  /// Loads the road from ROUTING_GEOMETRY_FILE_TAG section data.
+  /// @param[in] altitudes May be nullptr.
+  void Load(RoadGeometryAttrs const & attrs, std::vector<m2::PointD> const & points,
+            geometry::Altitudes const * altitudes);
+
+  /// Used in generator to write ROUTING_GEOMETRY_FILE_TAG section.
+  RoadGeometryAttrs GetAttrs() const;
+
   SpeedKMpH const & GetSpeed(bool forward) const;
   std::optional<HighwayType> GetHighwayType() const { return m_highwayType; }
   bool IsOneWay() const { return m_isOneWay; }
@@ -111,9 +121,11 @@ public:
   using VehicleModelPtrT = std::shared_ptr<VehicleModelInterface>;
 
   /// @param[in] handle should be alive, its caller responsibility to check it.
+  /// @param[in] vehicleType is used to read roads from ROUTING_GEOMETRY_FILE_TAG section if it exists
+  /// and is built with |vehicleModel|, otherwise roads are loaded from features.
   static std::unique_ptr<GeometryLoader> Create(MwmSet::MwmHandle const & handle,
                                                 VehicleModelPtrT const & vehicleModel,
-                                                bool loadAltitudes);
+                                                VehicleType vehicleType, bool loadAltitudes);
 
   /// This is for stand-alone work.
   /// Use in generator_tool and unit tests.
@@ -33,6 +33,33 @@ bool IsBoarding(bool prevIsFerry, bool nextIsFerry)
   return !prevIsFerry && nextIsFerry;
 }
 
+// IndexGraphData ----------------------------------------------------------------------------------
+size_t IndexGraphData::GetMemorySize() const
+{
+  size_t size = m_jointIndex.GetNumPoints() * sizeof(RoadPoint) +
+                m_jointIndex.GetNumJoints() * sizeof(uint32_t);
+
+  // Hash map node, key and joint ids of the road.
+  size_t constexpr kRoadOverhead = 4 * sizeof(void *) + sizeof(uint32_t) + sizeof(RoadJointIds);
+  m_roadIndex.ForEachRoad([&size](uint32_t, RoadJointIds const & road)
+  {
+    size += kRoadOverhead;
+    road.ForEachJoint([&size](uint32_t, Joint::Id) { size += sizeof(Joint::Id); });
+  });
+
+  for (auto const * restrictions : {&m_restrictionsForward, &m_restrictionsBackward})
+  {
+    for (auto const & [_, sequences] : *restrictions)
+    {
+      for (auto const & sequence : sequences)
+        size += sequence.size() * sizeof(uint32_t);
+    }
+  }
+
+  return size + m_noUTurnRestrictions.size() * (sizeof(uint32_t) + sizeof(UTurnEnding));
+}
+
+// IndexGraph --------------------------------------------------------------------------------------
 IndexGraph::IndexGraph(shared_ptr<Geometry> geometry, shared_ptr<EdgeEstimator> estimator,
                        RoutingOptions routingOptions)
   : m_geometry(std::move(geometry)),
@@ -45,7 +72,7 @@ IndexGraph::IndexGraph(shared_ptr<Geometry> geometry, shared_ptr<EdgeEstimator>
 
 bool IndexGraph::IsJoint(RoadPoint const & roadPoint) const
 {
-  return m_roadIndex.GetJointId(roadPoint) != Joint::kInvalidId;
+  return m_data->m_roadIndex.GetJointId(roadPoint) != Joint::kInvalidId;
 }
 
 bool IndexGraph::IsJointOrEnd(Segment const & segment, bool fromStart) const
@@ -86,11 +113,11 @@ void IndexGraph::GetEdgeListImpl(astar::VertexData<Segment, RouteWeight> const &
   auto const & segment = vertexData.m_vertex;
 
   RoadPoint const roadPoint = segment.GetRoadPoint(isOutgoing);
-  Joint::Id const jointId = m_roadIndex.GetJointId(roadPoint);
+  Joint::Id const jointId = m_data->m_roadIndex.GetJointId(roadPoint);
 
   if (jointId != Joint::kInvalidId)
   {
-    m_jointIndex.ForEachPoint(jointId, [&](RoadPoint const & rp) {
+    m_data->m_jointIndex.ForEachPoint(jointId, [&](RoadPoint const & rp) {
       GetNeighboringEdges(vertexData, rp, isOutgoing, useRoutingOptions, edges, parents,
                           useAccessConditional);
     });
@@ -197,31 +224,33 @@ optional<JointEdge> IndexGraph::GetJointEdgeByLastPoint(Segment const & parent,
 
 void IndexGraph::Build(uint32_t numJoints)
 {
-  m_jointIndex.Build(m_roadIndex, numJoints);
+  auto & data = GetDataForUpdate();
+  data.m_jointIndex.Build(data.m_roadIndex, numJoints);
 }
 
 void IndexGraph::Import(vector<Joint> const & joints)
 {
-  m_roadIndex.Import(joints);
+  GetDataForUpdate().m_roadIndex.Import(joints);
   CHECK_LESS_OR_EQUAL(joints.size(), numeric_limits<uint32_t>::max(), ());
   Build(checked_cast<uint32_t>(joints.size()));
 }
 
 void IndexGraph::SetRestrictions(RestrictionVec && restrictions)
 {
-  m_restrictionsForward.clear();
-  m_restrictionsBackward.clear();
+  auto & data = GetDataForUpdate();
+  data.m_restrictionsForward.clear();
+  data.m_restrictionsBackward.clear();
 
   base::HighResTimer timer;
   for (auto const & restriction : restrictions)
   {
     ASSERT(!restriction.empty(), ());
 
-    auto & forward = m_restrictionsForward[restriction.back()];
+    auto & forward = data.m_restrictionsForward[restriction.back()];
     forward.emplace_back(restriction.begin(), prev(restriction.end()));
     reverse(forward.back().begin(), forward.back().end());
 
-    m_restrictionsBackward[restriction.front()].emplace_back(next(restriction.begin()), restriction.end());
+    data.m_restrictionsBackward[restriction.front()].emplace_back(next(restriction.begin()), restriction.end());
   }
 
   LOG(LDEBUG, ("Restrictions are loaded in:", timer.ElapsedMilliseconds(), "ms"));
@@ -229,15 +258,35 @@ void IndexGraph::SetRestrictions(RestrictionVec && restrictions)
 
 void IndexGraph::SetUTurnRestrictions(vector<RestrictionUTurn> && noUTurnRestrictions)
 {
+  auto & data = GetDataForUpdate();
   for (auto const & noUTurn : noUTurnRestrictions)
   {
     if (noUTurn.m_viaIsFirstPoint)
-      m_noUTurnRestrictions[noUTurn.m_featureId].m_atTheBegin = true;
+      data.m_noUTurnRestrictions[noUTurn.m_featureId].m_atTheBegin = true;
     else
-      m_noUTurnRestrictions[noUTurn.m_featureId].m_atTheEnd = true;
+      data.m_noUTurnRestrictions[noUTurn.m_featureId].m_atTheEnd = true;
   }
 }
 
+shared_ptr<IndexGraphData const> IndexGraph::ShareData()
+{
+  m_ownData.reset();
+  return m_data;
+}
+
+void IndexGraph::SetSharedData(shared_ptr<IndexGraphData const> data)
+{
+  CHECK(data, ());
+  m_ownData.reset();
+  m_data = std::move(data);
+}
+
+IndexGraphData & IndexGraph::GetDataForUpdate()
+{
+  CHECK(m_ownData, ("Shared index graph data can't be changed."));
+  return *m_ownData;
+}
+
 void IndexGraph::SetRoadAccess(RoadAccess && roadAccess)
 {
   m_roadAccess = std::move(roadAccess);
@@ -299,12 +348,12 @@ void IndexGraph::GetSegmentCandidateForJoint(Segment const & parent, bool isOutg
                                              SegmentListT & children) const
 {
   RoadPoint const roadPoint = parent.GetRoadPoint(isOutgoing);
-  Joint::Id const jointId = m_roadIndex.GetJointId(roadPoint);
+  Joint::Id const jointId = m_data->m_roadIndex.GetJointId(roadPoint);
 
   if (jointId == Joint::kInvalidId)
     return;
 
-  m_jointIndex.ForEachPoint(jointId, [&](RoadPoint const & rp) {
+  m_data->m_jointIndex.ForEachPoint(jointId, [&](RoadPoint const & rp) {
     GetSegmentCandidateForRoadPoint(rp, parent.GetMwmId(), isOutgoing, children);
   });
 }
@@ -533,11 +582,11 @@ bool IndexGraph::IsUTurnAndRestricted(Segment const & parent, Segment const & ch
   auto const & roadGeometry = GetRoadGeometry(featureId);
 
   RoadPoint const rp = parent.GetRoadPoint(isOutgoing);
-  if (m_roadIndex.GetJointId(rp) == Joint::kInvalidId && !roadGeometry.IsEndPointId(turnPoint))
+  if (m_data->m_roadIndex.GetJointId(rp) == Joint::kInvalidId && !roadGeometry.IsEndPointId(turnPoint))
     return true;
 
-  auto const it = m_noUTurnRestrictions.find(featureId);
-  if (it == m_noUTurnRestrictions.cend())
+  auto const it = m_data->m_noUTurnRestrictions.find(featureId);
+  if (it == m_data->m_noUTurnRestrictions.cend())
     return false;
 
   auto const & uTurn = it->second;
@@ -28,6 +28,37 @@ bool IsUTurn(Segment const & u, Segment const & v);
 
 enum class WorldGraphMode;
 
+/// \brief Road and joint indexes and restrictions of an mwm. They don't depend on the router
+/// settings and are not changed after loading, so graphs of several routers may share them.
+/// \note See IndexGraphDataCache.
+struct IndexGraphData
+{
+  using Restrictions = std::unordered_map<uint32_t, std::vector<std::vector<uint32_t>>>;
+
+  // u_turn can be in both sides of feature.
+  struct UTurnEnding
+  {
+    bool m_atTheBegin = false;
+    bool m_atTheEnd = false;
+  };
+
+  /// \returns approximate size of the loaded data in bytes.
+  size_t GetMemorySize() const;
+
+  RoadIndex m_roadIndex;
+  JointIndex m_jointIndex;
+
+  Restrictions m_restrictionsForward;
+  Restrictions m_restrictionsBackward;
+
+  // Stored featureId and it's UTurnEnding, which shows where is
+  // u_turn restriction is placed - at the beginning or at the ending of feature.
+  //
+  // If m_noUTurnRestrictions.count(featureId) == 0, that means, that there are no any
+  // no_u_turn restriction at the feature with id = featureId.
+  std::unordered_map<uint32_t, UTurnEnding> m_noUTurnRestrictions;
+};
+
 class IndexGraph final
 {
 public:
@@ -39,7 +70,7 @@ public:
   template <typename VertexType>
   using Parents = typename AStarGraph<VertexType, void, void>::Parents;
 
-  using Restrictions = std::unordered_map<uint32_t, std::vector<std::vector<uint32_t>>>;
+  using Restrictions = IndexGraphData::Restrictions;
 
   using SegmentEdgeListT = SmallList<SegmentEdge>;
   using JointEdgeListT = SmallList<JointEdge>;
@@ -70,10 +101,10 @@ public:
                                                    Segment const & firstChild, bool isOutgoing,
                                                    uint32_t lastPoint) const;
 
-  Joint::Id GetJointId(RoadPoint const & rp) const { return m_roadIndex.GetJointId(rp); }
+  Joint::Id GetJointId(RoadPoint const & rp) const { return m_data->m_roadIndex.GetJointId(rp); }
 
-  bool IsRoad(uint32_t featureId) const { return m_roadIndex.IsRoad(featureId); }
-  RoadJointIds const & GetRoad(uint32_t featureId) const { return m_roadIndex.GetRoad(featureId); }
+  bool IsRoad(uint32_t featureId) const { return m_data->m_roadIndex.IsRoad(featureId); }
+  RoadJointIds const & GetRoad(uint32_t featureId) const { return m_data->m_roadIndex.GetRoad(featureId); }
   RoadGeometry const & GetRoadGeometry(uint32_t featureId) const { return m_geometry->GetRoad(featureId); }
 
   Geometry & GetGeometry() const { return *m_geometry; }
@@ -83,9 +114,18 @@ public:
     return m_roadAccess.GetAccessWithoutConditional(segment.GetFeatureId()).first;
   }
 
-  uint32_t GetNumRoads() const { return m_roadIndex.GetSize(); }
-  uint32_t GetNumJoints() const { return m_jointIndex.GetNumJoints(); }
-  uint32_t GetNumPoints() const { return m_jointIndex.GetNumPoints(); }
+  uint32_t GetNumRoads() const { return m_data->m_roadIndex.GetSize(); }
+  uint32_t GetNumJoints() const { return m_data->m_jointIndex.GetNumJoints(); }
+  uint32_t GetNumPoints() const { return m_data->m_jointIndex.GetNumPoints(); }
+
+  /// \returns road and joint indexes and restrictions loaded by this graph to share them
+  /// with other graphs.
+  /// \note Shared data can't be changed, so Import(), Build(), SetRestrictions() and
+  /// SetUTurnRestrictions() are not allowed after the call.
+  std::shared_ptr<IndexGraphData const> ShareData();
+  /// \brief Replaces road and joint indexes and restrictions with |data| loaded by another graph.
+  /// \note The same as for ShareData(), the data can't be changed after the call.
+  void SetSharedData(std::shared_ptr<IndexGraphData const> data);
 
   void Build(uint32_t numJoints);
   void Import(std::vector<Joint> const & joints);
@@ -96,19 +136,19 @@ public:
 
   void PushFromSerializer(Joint::Id jointId, RoadPoint const & rp)
   {
-    m_roadIndex.PushFromSerializer(jointId, rp);
+    GetDataForUpdate().m_roadIndex.PushFromSerializer(jointId, rp);
   }
 
   template <typename F>
   void ForEachRoad(F && f) const
   {
-    m_roadIndex.ForEachRoad(std::forward<F>(f));
+    m_data->m_roadIndex.ForEachRoad(std::forward<F>(f));
   }
 
   template <typename F>
   void ForEachPoint(Joint::Id jointId, F && f) const
   {
-    m_jointIndex.ForEachPoint(jointId, std::forward<F>(f));
+    m_data->m_jointIndex.ForEachPoint(jointId, std::forward<F>(f));
   }
 
   bool IsJoint(RoadPoint const & roadPoint) const;
@@ -197,26 +237,13 @@ private:
   bool IsAccessNoForSure(AccessPositionType const & accessPositionType,
                          RouteWeight const & weight, bool useAccessConditional) const;
 
+  IndexGraphData & GetDataForUpdate();
+
   std::shared_ptr<Geometry> m_geometry;
   std::shared_ptr<EdgeEstimator> m_estimator;
-  RoadIndex m_roadIndex;
-  JointIndex m_jointIndex;
-
-  Restrictions m_restrictionsForward;
-  Restrictions m_restrictionsBackward;
-
-  // u_turn can be in both sides of feature.
-  struct UTurnEnding
-  {
-    bool m_atTheBegin = false;
-    bool m_atTheEnd = false;
-  };
-  // Stored featureId and it's UTurnEnding, which shows where is
-  // u_turn restriction is placed - at the beginning or at the ending of feature.
-  //
-  // If m_noUTurnRestrictions.count(featureId) == 0, that means, that there are no any
-  // no_u_turn restriction at the feature with id = featureId.
-  std::unordered_map<uint32_t, UTurnEnding> m_noUTurnRestrictions;
+  // The data which is loaded by this graph and is not shared yet, nullptr after sharing.
+  std::shared_ptr<IndexGraphData> m_ownData = std::make_shared<IndexGraphData>();
+  std::shared_ptr<IndexGraphData const> m_data = m_ownData;
 
   RoadAccess m_roadAccess;
   RoutingOptions m_avoidRoutingOptions;
@@ -246,7 +273,8 @@ bool IndexGraph::IsRestricted(ParentVertex const & parent,
   if (parentFeatureId == currentFeatureId)
     return false;
 
-  auto const & restrictions = isOutgoing ? m_restrictionsForward : m_restrictionsBackward;
+  auto const & restrictions =
+      isOutgoing ? m_data->m_restrictionsForward : m_data->m_restrictionsBackward;
   auto const it = restrictions.find(currentFeatureId);
   if (it == restrictions.cend())
     return false;
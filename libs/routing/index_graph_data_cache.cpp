@@ -0,0 +1,96 @@
+#include "routing/index_graph_data_cache.hpp"
+
+#include "base/assert.hpp"
+#include "base/logging.hpp"
+
+namespace routing
+{
+IndexGraphDataCache::Key::Key(MwmSet::MwmId const & mwmId, VehicleType vehicleType)
+  : Key(mwmId.GetInfo()->GetCountryName(), mwmId.GetInfo()->GetVersion(), vehicleType)
+{
+}
+
+IndexGraphDataCache::DataPtrT IndexGraphDataCache::Get(Key const & key)
+{
+  std::lock_guard guard(m_mutex);
+
+  auto const it = m_entries.find(key);
+  if (it == m_entries.end())
+    return {};
+
+  auto data = it->second.m_data.lock();
+  if (!data)
+  {
+    ASSERT(!it->second.m_isKept, ());
+    m_entries.erase(it);
+    return {};
+  }
+
+  Keep(key, it->second, data);
+  Shrink();
+  return data;
+}
+
+IndexGraphDataCache::DataPtrT IndexGraphDataCache::Put(Key const & key, DataPtrT const & data)
+{
+  CHECK(data, ());
+  std::lock_guard guard(m_mutex);
+
+  auto & entry = m_entries[key];
+  if (auto existing = entry.m_data.lock())
+  {
+    Keep(key, entry, existing);
+    Shrink();
+    return existing;
+  }
+
+  ASSERT(!entry.m_isKept, ());
+  entry.m_data = data;
+  entry.m_size = data->GetMemorySize();
+  Keep(key, entry, data);
+  Shrink();
+
+  LOG(LDEBUG, ("Index graph data of", key.m_countryName, "is shared, size:", entry.m_size,
+               "kept size:", m_keptSize));
+  return data;
+}
+
+size_t IndexGraphDataCache::GetMemorySize() const
+{
+  std::lock_guard guard(m_mutex);
+  return m_keptSize;
+}
+
+void IndexGraphDataCache::Keep(Key const & key, Entry & entry, DataPtrT const & data)
+{
+  if (entry.m_isKept)
+  {
+    m_lru.splice(m_lru.begin(), m_lru, entry.m_lruIt);
+    return;
+  }
+
+  m_lru.emplace_front(key, data);
+  entry.m_lruIt = m_lru.begin();
+  entry.m_isKept = true;
+  m_keptSize += entry.m_size;
+}
+
+void IndexGraphDataCache::Shrink()
+{
+  while (m_keptSize > m_memoryBudget && !m_lru.empty())
+  {
+    auto const & key = m_lru.back().first;
+    auto const it = m_entries.find(key);
+    CHECK(it != m_entries.end(), ());
+
+    it->second.m_isKept = false;
+    ASSERT_GREATER_OR_EQUAL(m_keptSize, it->second.m_size, ());
+    m_keptSize -= it->second.m_size;
+
+    // Graphs may still use the data, so the entry is erased only when the data is released.
+    if (it->second.m_data.expired() || m_lru.back().second.use_count() == 1)
+      m_entries.erase(it);
+    m_lru.pop_back();
+  }
+}
+}  // namespace routing
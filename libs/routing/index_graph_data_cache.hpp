@@ -0,0 +1,85 @@
+#pragma once
+
+#include "routing/index_graph.hpp"
+
+#include "routing_common/vehicle_model.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace routing
+{
+/// \brief Thread safe cache of IndexGraphData shared by graphs of several routers,
+/// so the same mwm is kept in memory once for all of them.
+/// The data is reference counted: it is alive while any graph uses it or while the cache keeps it.
+/// The cache keeps recently used data within |memoryBudget| bytes, the least recently used
+/// data is released first.
+class IndexGraphDataCache
+{
+public:
+  using DataPtrT = std::shared_ptr<IndexGraphData const>;
+
+  /// Mwms are identified by their files and not by MwmSet::MwmId, so routers
+  /// with different data sources share the data too.
+  struct Key
+  {
+    Key(MwmSet::MwmId const & mwmId, VehicleType vehicleType);
+    Key(std::string const & countryName, int64_t version, VehicleType vehicleType)
+      : m_countryName(countryName), m_version(version), m_vehicleType(vehicleType)
+    {
+    }
+
+    bool operator<(Key const & rhs) const
+    {
+      return std::tie(m_countryName, m_version, m_vehicleType) <
+             std::tie(rhs.m_countryName, rhs.m_version, rhs.m_vehicleType);
+    }
+
+    std::string m_countryName;
+    int64_t m_version = 0;
+    VehicleType m_vehicleType;
+  };
+
+  explicit IndexGraphDataCache(size_t memoryBudget) : m_memoryBudget(memoryBudget) {}
+
+  /// \returns data for |key| if it's used by any graph or kept by the cache and nullptr otherwise.
+  DataPtrT Get(Key const & key);
+
+  /// \brief Adds |data| loaded for |key|.
+  /// \returns the data which should be used for |key|. It's not |data| if another graph
+  /// has added the same data after the Get() call.
+  DataPtrT Put(Key const & key, DataPtrT const & data);
+
+  size_t GetMemorySize() const;
+
+private:
+  struct Entry
+  {
+    std::weak_ptr<IndexGraphData const> m_data;
+    size_t m_size = 0;
+    // Points to |m_lru| if the data is kept by the cache.
+    std::list<std::pair<Key, DataPtrT>>::iterator m_lruIt;
+    bool m_isKept = false;
+  };
+
+  void Keep(Key const & key, Entry & entry, DataPtrT const & data);
+  void Shrink();
+
+  size_t const m_memoryBudget;
+
+  mutable std::mutex m_mutex;
+  std::map<Key, Entry> m_entries;
+  // The most recently used data is at the front.
+  std::list<std::pair<Key, DataPtrT>> m_lru;
+  size_t m_keptSize = 0;
+};
+}  // namespace routing
@@ -1,6 +1,7 @@
 #include "routing/index_graph_loader.hpp"
 
 #include "routing/data_source.hpp"
+#include "routing/index_graph_data_cache.hpp"
 #include "routing/index_graph_serialization.hpp"
 #include "routing/restriction_loader.hpp"
 #include "routing/road_access.hpp"
@@ -30,12 +31,13 @@ public:
   IndexGraphLoaderImpl(VehicleType vehicleType, bool loadAltitudes,
                        shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
                        shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-                       RoutingOptions routingOptions = RoutingOptions())
+                       RoutingOptions routingOptions, shared_ptr<IndexGraphDataCache> dataCache)
     : m_vehicleType(vehicleType)
     , m_loadAltitudes(loadAltitudes)
     , m_dataSource(dataSource)
     , m_vehicleModelFactory(std::move(vehicleModelFactory))
     , m_estimator(std::move(estimator))
+    , m_dataCache(std::move(dataCache))
     , m_avoidRoutingOptions(routingOptions)
   {
     CHECK(m_vehicleModelFactory, ());
@@ -53,12 +55,15 @@ private:
   GeometryPtrT CreateGeometry(NumMwmId numMwmId);
   using GraphPtrT = unique_ptr<IndexGraph>;
   GraphPtrT CreateIndexGraph(NumMwmId numMwmId, GeometryPtrT & geometry);
+  void DeserializeSharedIndexGraph(MwmSet::MwmHandle const & handle, IndexGraph & graph);
 
   VehicleType m_vehicleType;
   bool m_loadAltitudes;
   MwmDataSource & m_dataSource;
   shared_ptr<VehicleModelFactoryInterface> m_vehicleModelFactory;
   shared_ptr<EdgeEstimator> m_estimator;
+  // May be nullptr, if graphs are not shared with other routers.
+  shared_ptr<IndexGraphDataCache> m_dataCache;
 
   struct GraphAttrs
   {
@@ -140,12 +145,16 @@ IndexGraphLoaderImpl::GraphPtrT IndexGraphLoaderImpl::CreateIndexGraph(NumMwmId
     if (!geometry)
     {
       auto vehicleModel = m_vehicleModelFactory->GetVehicleModelForCountry(value->GetCountryFileName());
-      geometry = make_shared<Geometry>(GeometryLoader::Create(handle, std::move(vehicleModel), m_loadAltitudes));
+      geometry = make_shared<Geometry>(
+          GeometryLoader::Create(handle, std::move(vehicleModel), m_vehicleType, m_loadAltitudes));
     }
 
     auto graph = make_unique<IndexGraph>(geometry, m_estimator, m_avoidRoutingOptions);
     graph->SetCurrentTimeGetter(m_currentTimeGetter);
-    DeserializeIndexGraph(*value, m_vehicleType, *graph);
+    if (m_dataCache)
+      DeserializeSharedIndexGraph(handle, *graph);
+    else
+      DeserializeIndexGraph(*value, m_vehicleType, *graph);
 
     LOG(LINFO, (ROUTING_FILE_TAG, "section for", value->GetCountryFileName(), "loaded in", timer.ElapsedSeconds(), "seconds"));
     return graph;
@@ -157,13 +166,38 @@ IndexGraphLoaderImpl::GraphPtrT IndexGraphLoaderImpl::CreateIndexGraph(NumMwmId
   }
 }
 
+void IndexGraphLoaderImpl::DeserializeSharedIndexGraph(MwmSet::MwmHandle const & handle,
+                                                       IndexGraph & graph)
+{
+  MwmValue const & value = *handle.GetValue();
+  IndexGraphDataCache::Key const key(handle.GetId(), m_vehicleType);
+
+  if (auto data = m_dataCache->Get(key))
+  {
+    graph.SetSharedData(std::move(data));
+
+    // Road access is not shared because it depends on the router's current time getter.
+    RoadAccess roadAccess;
+    if (ReadRoadAccessFromMwm(value, m_vehicleType, roadAccess))
+      graph.SetRoadAccess(std::move(roadAccess));
+    return;
+  }
+
+  DeserializeIndexGraph(value, m_vehicleType, graph);
+  auto const loadedData = graph.ShareData();
+  auto data = m_dataCache->Put(key, loadedData);
+  if (data != loadedData)
+    graph.SetSharedData(std::move(data));
+}
+
 IndexGraphLoaderImpl::GeometryPtrT IndexGraphLoaderImpl::CreateGeometry(NumMwmId numMwmId)
 {
   MwmSet::MwmHandle const & handle = m_dataSource.GetHandle(numMwmId);
   MwmValue const * value = handle.GetValue();
 
   auto vehicleModel = m_vehicleModelFactory->GetVehicleModelForCountry(value->GetCountryFileName());
-  return make_shared<Geometry>(GeometryLoader::Create(handle, std::move(vehicleModel), m_loadAltitudes));
+  return make_shared<Geometry>(
+      GeometryLoader::Create(handle, std::move(vehicleModel), m_vehicleType, m_loadAltitudes));
 }
 
 void IndexGraphLoaderImpl::Clear() { m_graphs.clear(); }
@@ -215,10 +249,11 @@ unique_ptr<IndexGraphLoader> IndexGraphLoader::Create(
     VehicleType vehicleType, bool loadAltitudes,
     shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
     shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-    RoutingOptions routingOptions)
+    RoutingOptions routingOptions, shared_ptr<IndexGraphDataCache> dataCache)
 {
   return make_unique<IndexGraphLoaderImpl>(vehicleType, loadAltitudes, vehicleModelFactory,
-                                           estimator, dataSource, routingOptions);
+                                           estimator, dataSource, routingOptions,
+                                           std::move(dataCache));
 }
 
 void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, IndexGraph & graph)
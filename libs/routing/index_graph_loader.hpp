@@ -16,6 +16,7 @@ class MwmValue;
 
 namespace routing
 {
+class IndexGraphDataCache;
 class MwmDataSource;
 
 class IndexGraphLoader
@@ -34,7 +35,8 @@ public:
       VehicleType vehicleType, bool loadAltitudes,
       std::shared_ptr<VehicleModelFactoryInterface> vehicleModelFactory,
       std::shared_ptr<EdgeEstimator> estimator, MwmDataSource & dataSource,
-      RoutingOptions routingOptions = RoutingOptions());
+      RoutingOptions routingOptions = RoutingOptions(),
+      std::shared_ptr<IndexGraphDataCache> dataCache = nullptr);
 };
 
 void DeserializeIndexGraph(MwmValue const & mwmValue, VehicleType vehicleType, IndexGraph & graph);
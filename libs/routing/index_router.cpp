@@ -5,6 +5,7 @@
 #include "routing/car_directions.hpp"
 #include "routing/fake_ending.hpp"
 #include "routing/index_graph.hpp"
+#include "routing/index_graph_data_cache.hpp"
 #include "routing/index_graph_loader.hpp"
 #include "routing/index_graph_starter.hpp"
 #include "routing/index_graph_starter_joints.hpp"
@@ -44,11 +45,15 @@
 #include "base/logging.hpp"
 #include "base/scope_guard.hpp"
 #include "base/stl_helpers.hpp"
+#include "base/thread_pool_computational.hpp"
+#include "base/timer.hpp"
 
 #include "defines.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
+#include <future>
 #include <iterator>
 #include <map>
 
@@ -369,6 +374,118 @@ RouterResultCode IndexRouter::CalculateRoute(Checkpoints const & checkpoints,
   }
 }
 
+RouterResultCode IndexRouter::CalculateRouteMatrix(vector<m2::PointD> const & origins,
+                                                   vector<m2::PointD> const & destinations,
+                                                   RouterDelegate const & delegate,
+                                                   size_t threadsCount, RouteMatrix & matrix)
+{
+  CHECK_NOT_EQUAL(m_vehicleType, VehicleType::Transit, ("Route matrix is not supported for transit."));
+  CHECK_GREATER(threadsCount, 0, ());
+
+  matrix = RouteMatrix(origins.size(), destinations.size());
+  if (origins.empty() || destinations.empty())
+    return RouterResultCode::NoError;
+
+  try
+  {
+    SCOPE_GUARD(featureRoadGraphClear, [this]
+    {
+      ClearState();
+    });
+
+    TrafficStash::Guard guard(m_trafficStash);
+
+    vector<FakeEnding> originEndings;
+    vector<FakeEnding> destinationEndings;
+    {
+      auto graph = MakeWorldGraph();
+      originEndings = MakeRouteMatrixEndings(origins, true /* isOutgoing */, *graph);
+      destinationEndings = MakeRouteMatrixEndings(destinations, false /* isOutgoing */, *graph);
+    }
+
+    if (delegate.IsCancelled())
+      return RouterResultCode::Cancelled;
+
+    // Index graphs are not thread safe, so every thread works with its own data source and graph.
+    threadsCount = min(threadsCount, origins.size());
+    vector<unique_ptr<MwmDataSource>> dataSources;
+    vector<unique_ptr<WorldGraph>> graphs;
+    for (size_t i = 0; i < threadsCount; ++i)
+    {
+      dataSources.push_back(m_dataSource.CreateForAnotherThread());
+      graphs.push_back(MakeWorldGraph(*dataSources.back()));
+      graphs.back()->SetMode(WorldGraphMode::NoLeaps);
+    }
+
+    base::ScopedTimerWithLog timer("Route matrix build");
+
+    atomic<size_t> nextOrigin = 0;
+    auto const calcRows = [&](WorldGraph & graph)
+    {
+      for (size_t i = nextOrigin++; i < origins.size(); i = nextOrigin++)
+      {
+        if (!CalcRouteMatrixRow(graph, originEndings[i], destinationEndings,
+                                delegate.GetCancellable(), i, matrix))
+        {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    bool isCancelled = false;
+    {
+      base::ComputationalThreadPool pool(threadsCount);
+      vector<future<bool>> results;
+      for (auto & graph : graphs)
+        results.push_back(pool.Submit(calcRows, ref(*graph)));
+
+      for (auto & result : results)
+        isCancelled = !result.get() || isCancelled;
+    }
+
+    if (isCancelled)
+      return RouterResultCode::Cancelled;
+
+    LOG(LINFO, ("Route matrix", origins.size(), "x", destinations.size(), "is built."));
+    return RouterResultCode::NoError;
+  }
+  catch (RootException const & e)
+  {
+    LOG(LERROR, ("Can't build route matrix", origins.size(), "x", destinations.size(), ":\n ",
+                 e.what()));
+    return RouterResultCode::InternalError;
+  }
+}
+
+vector<FakeEnding> IndexRouter::MakeRouteMatrixEndings(vector<m2::PointD> const & points,
+                                                       bool isOutgoing, WorldGraph & graph)
+{
+  vector<FakeEnding> endings(points.size());
+  PointsOnEdgesSnapping snapping(*this, graph);
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    auto const country = platform::CountryFile(m_countryFileFn(points[i]));
+    if (country.IsEmpty() || !m_dataSource.IsLoaded(country))
+    {
+      LOG(LWARNING, ("No loaded mwm for route matrix point", mercator::ToLatLon(points[i])));
+      continue;
+    }
+
+    vector<Segment> segments;
+    bool dummy = false;
+    if (!snapping.FindBestSegments(points[i], m2::PointD::Zero() /* direction */, isOutgoing,
+                                   segments, dummy))
+    {
+      LOG(LWARNING, ("Route matrix point", mercator::ToLatLon(points[i]), "is not snapped to roads."));
+      continue;
+    }
+
+    endings[i] = MakeFakeEnding(segments, points[i], graph);
+  }
+  return endings;
+}
+
 std::vector<Segment> IndexRouter::GetBestOutgoingSegments(m2::PointD const & checkpoint, WorldGraph & graph)
 {
   bool dummy = false;
@@ -815,6 +932,20 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
 
   {
     LeapsGraph leapsGraph(starter, MwmHierarchyHandler(m_numMwmIds, m_countryParentNameGetterFn));
+    if (auto const * overlay = GetCrossMwmOverlay())
+    {
+      // Overlay weights are valid for the same mwm versions only.
+      leapsGraph.SetOverlay(*overlay, [this](CrossMwmOverlayCell const & cell)
+      {
+        for (size_t i = 0; i < cell.m_mwms.size(); ++i)
+        {
+          auto const mwmId = m_dataSource.GetMwmId(cell.m_mwms[i]);
+          if (!mwmId.IsAlive() || mwmId.GetInfo()->m_version.GetVersion() != cell.m_mwmVersions[i])
+            return false;
+        }
+        return true;
+      });
+    }
 
     AStarSubProgress leapsProgress(mercator::ToLatLon(checkpoints.GetPoint(subrouteIdx)),
                                    mercator::ToLatLon(checkpoints.GetPoint(subrouteIdx + 1)),
@@ -940,6 +1071,12 @@ RouterResultCode IndexRouter::CalculateSubrouteLeapsOnlyMode(
       }
     }
 
+    // Candidates should consist of the cross-mwm leaps only for CalcMiddleCrossMwmWeight and ProcessLeapsJoints.
+    base::EraseIf(candidates, [&leapsGraph](RoutingResultT & c)
+    {
+      return !leapsGraph.UnpackOverlayJumps(c.m_path);
+    });
+
     LOG(LINFO, ("Filtered candidates count =", candidates.size()));
     candidateMidWeights.reserve(candidates.size());
     for (auto & c : candidates)
@@ -1107,7 +1244,41 @@ RouterResultCode IndexRouter::AdjustRoute(Checkpoints const & checkpoints,
   return RouterResultCode::NoError;
 }
 
-unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
+CrossMwmOverlay const * IndexRouter::GetCrossMwmOverlay()
+{
+  auto const handle = m_dataSource.GetWorldHandle();
+  if (!handle.IsAlive())
+    return nullptr;
+
+  // Reload when World appears after the first route or is updated.
+  if (!m_crossMwmOverlay || m_crossMwmOverlayWorldId != handle.GetId())
+  {
+    auto overlay = make_unique<CrossMwmOverlay>();
+    auto const & cont = handle.GetValue()->m_cont;
+    if (cont.IsExist(CROSS_MWM_OVERLAY_FILE_TAG))
+    {
+      try
+      {
+        auto const reader = cont.GetReader(CROSS_MWM_OVERLAY_FILE_TAG);
+        CrossMwmOverlaySerializer::Deserialize(*overlay, *reader.GetPtr(), *m_numMwmIds);
+        LOG(LINFO, ("Cross mwm overlay is loaded, cells count =", overlay->GetCellsCount()));
+      }
+      catch (Reader::Exception const & e)
+      {
+        // Keep the empty overlay for this World not to read the broken section on each route.
+        LOG(LERROR, ("Error while reading", CROSS_MWM_OVERLAY_FILE_TAG, "section:", e.Msg()));
+        overlay = make_unique<CrossMwmOverlay>();
+      }
+    }
+
+    m_crossMwmOverlay = std::move(overlay);
+    m_crossMwmOverlayWorldId = handle.GetId();
+  }
+
+  return m_crossMwmOverlay->IsEmpty() ? nullptr : m_crossMwmOverlay.get();
+}
+
+unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph(MwmDataSource & dataSource)
 {
   // Use saved routing options for all types (car, bicycle, pedestrian).
   RoutingOptions const routingOptions = RoutingOptions::LoadCarOptionsFromSettings();
@@ -1119,11 +1290,12 @@ unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
   auto crossMwmGraph = make_unique<CrossMwmGraph>(
       m_numMwmIds, m_numMwmTree,
       m_vehicleType == VehicleType::Transit ? VehicleType::Pedestrian : m_vehicleType,
-      m_countryRectFn, m_dataSource);
+      m_countryRectFn, dataSource);
 
   auto indexGraphLoader = IndexGraphLoader::Create(
       m_vehicleType == VehicleType::Transit ? VehicleType::Pedestrian : m_vehicleType,
-      m_loadAltitudes, m_vehicleModelFactory, m_estimator, m_dataSource, routingOptions);
+      m_loadAltitudes, m_vehicleModelFactory, m_estimator, dataSource, routingOptions,
+      m_indexGraphDataCache);
 
   if (m_vehicleType != VehicleType::Transit)
   {
@@ -1134,7 +1306,7 @@ unique_ptr<WorldGraph> IndexRouter::MakeWorldGraph()
     return graph;
   }
 
-  auto transitGraphLoader = TransitGraphLoader::Create(m_dataSource, m_estimator);
+  auto transitGraphLoader = TransitGraphLoader::Create(dataSource, m_estimator);
   return make_unique<TransitWorldGraph>(std::move(crossMwmGraph), std::move(indexGraphLoader),
                                         std::move(transitGraphLoader), m_estimator);
 }
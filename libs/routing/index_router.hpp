@@ -4,6 +4,7 @@
 #include "routing/base/astar_progress.hpp"
 #include "routing/base/routing_result.hpp"
 
+#include "routing/cross_mwm_overlay.hpp"
 #include "routing/data_source.hpp"
 #include "routing/directions_engine.hpp"
 #include "routing/edge_estimator.hpp"
@@ -11,6 +12,7 @@
 #include "routing/features_road_graph.hpp"
 #include "routing/guides_connections.hpp"
 #include "routing/nearest_edge_finder.hpp"
+#include "routing/route_matrix.hpp"
 #include "routing/regions_decl.hpp"
 #include "routing/router.hpp"
 #include "routing/routing_callbacks.hpp"
@@ -36,6 +38,7 @@ namespace traffic { class TrafficCache; }
 namespace routing
 {
 class IndexGraph;
+class IndexGraphDataCache;
 class IndexGraphStarter;
 
 class IndexRouter : public IRouter
@@ -82,6 +85,17 @@ public:
                                   m2::PointD const & startDirection, bool adjustToPrevRoute,
                                   RouterDelegate const & delegate, Route & route) override;
 
+  /// \brief Calculates |origins| x |destinations| table of route weights and ETAs without
+  /// building routes and turn instructions. Every point is snapped to the roads once, then
+  /// one-to-many sweeps from the origins run on |threadsCount| threads. Every thread has its own
+  /// world graph, so the loaded index and cross-mwm graphs are reused by all its sweeps.
+  /// \note Cells of the points which are not snapped and of unreachable destinations
+  /// are RouteMatrix::kNoRoute.
+  RouterResultCode CalculateRouteMatrix(std::vector<m2::PointD> const & origins,
+                                        std::vector<m2::PointD> const & destinations,
+                                        RouterDelegate const & delegate, size_t threadsCount,
+                                        RouteMatrix & matrix);
+
   bool FindClosestProjectionToRoad(m2::PointD const & point, m2::PointD const & direction,
                                    double radius, EdgeProj & proj) override;
 
@@ -89,6 +103,12 @@ public:
 
   VehicleType GetVehicleType() const { return m_vehicleType; }
 
+  /// \brief Shares loaded index graphs with other routers which use the same |cache|.
+  void SetIndexGraphDataCache(std::shared_ptr<IndexGraphDataCache> cache)
+  {
+    m_indexGraphDataCache = std::move(cache);
+  }
+
 private:
   RouterResultCode CalculateSubrouteJointsMode(IndexGraphStarter & starter,
                                                RouterDelegate const & delegate,
@@ -117,7 +137,15 @@ private:
                                m2::PointD const & startDirection,
                                RouterDelegate const & delegate, Route & route);
 
-  std::unique_ptr<WorldGraph> MakeWorldGraph();
+  std::unique_ptr<WorldGraph> MakeWorldGraph() { return MakeWorldGraph(m_dataSource); }
+  std::unique_ptr<WorldGraph> MakeWorldGraph(MwmDataSource & dataSource);
+
+  /// \brief Snaps |points| to the roads. Endings of not snapped points have no projections.
+  std::vector<FakeEnding> MakeRouteMatrixEndings(std::vector<m2::PointD> const & points,
+                                                 bool isOutgoing, WorldGraph & graph);
+
+  /// \returns nullptr if World.mwm has no CROSS_MWM_OVERLAY_FILE_TAG section.
+  CrossMwmOverlay const * GetCrossMwmOverlay();
 
   using EdgeProjectionT = IRoadGraph::EdgeProjectionT;
   class PointsOnEdgesSnapping
@@ -291,5 +319,12 @@ private:
   GuidesConnections m_guides;
 
   CountryParentNameGetterFn m_countryParentNameGetterFn;
+
+  // Loaded from World.mwm on the first LeapsOnly route when World is registered.
+  std::unique_ptr<CrossMwmOverlay> m_crossMwmOverlay;
+  MwmSet::MwmId m_crossMwmOverlayWorldId;
+
+  // Shared with other routers, may be nullptr.
+  std::shared_ptr<IndexGraphDataCache> m_indexGraphDataCache;
 };
 }  // namespace routing
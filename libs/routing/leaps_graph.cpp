@@ -4,8 +4,13 @@
 #include "routing/index_graph_starter.hpp"
 
 #include "base/assert.hpp"
+#include "base/logging.hpp"
 
+#include <functional>
+#include <queue>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 namespace routing
@@ -60,6 +65,16 @@ void LeapsGraph::GetEdgesList(Segment const & segment, bool isOutgoing, EdgeList
   if (!m_starter.IsRoutingOptionsGood(segment))
     return;
 
+  // Jump over the whole overlay cell without loading cross-mwm sections of its mwms.
+  if (m_overlay)
+  {
+    if (isOutgoing && IsOverlayCellUsable(m_overlay->GetEnterCellIdx(segment)))
+      return m_overlay->GetOutgoingEdgeList(segment, edges);
+
+    if (!isOutgoing && IsOverlayCellUsable(m_overlay->GetExitCellIdx(segment)))
+      return m_overlay->GetIngoingEdgeList(segment, edges);
+  }
+
   auto & crossMwmGraph = m_starter.GetGraph().GetCrossMwmGraph();
 
   if (crossMwmGraph.IsTransition(segment, isOutgoing))
@@ -143,4 +158,169 @@ RouteWeight LeapsGraph::CalcMiddleCrossMwmWeight(std::vector<Segment> const & pa
   return res;
 }
 
+void LeapsGraph::SetOverlay(CrossMwmOverlay const & overlay,
+                            std::function<bool(CrossMwmOverlayCell const &)> const & isCellUsable)
+{
+  m_overlay = &overlay;
+  m_usableOverlayCells.assign(overlay.GetCellsCount(), false);
+
+  std::set<uint32_t> endingCells;
+  auto const addEndingCells = [&](std::set<NumMwmId> const & mwms)
+  {
+    for (auto const mwmId : mwms)
+    {
+      if (auto const cellIdx = overlay.GetCellIdx(mwmId))
+        endingCells.insert(*cellIdx);
+    }
+  };
+  addEndingCells(m_starter.GetStartMwms());
+  addEndingCells(m_starter.GetFinishMwms());
+
+  for (uint32_t cellIdx = 0; cellIdx < overlay.GetCellsCount(); ++cellIdx)
+  {
+    if (endingCells.count(cellIdx) == 0)
+      m_usableOverlayCells[cellIdx] = isCellUsable(overlay.GetCell(cellIdx));
+  }
+}
+
+bool LeapsGraph::IsOverlayCellUsable(std::optional<uint32_t> const & cellIdx) const
+{
+  return cellIdx && m_usableOverlayCells[*cellIdx];
+}
+
+bool LeapsGraph::UnpackOverlayJumps(std::vector<Segment> & path)
+{
+  if (!m_overlay)
+    return true;
+
+  std::vector<Segment> unpacked;
+  unpacked.reserve(path.size());
+  for (size_t i = 0; i < path.size(); ++i)
+  {
+    // Edges from the enters of the usable cells are always the overlay jumps, see GetEdgesList().
+    if (i + 1 < path.size() && IsOverlayCellUsable(m_overlay->GetEnterCellIdx(path[i])))
+    {
+      if (!UnpackOverlayJump(path[i], path[i + 1], unpacked))
+        return false;
+      ++i;
+      continue;
+    }
+
+    unpacked.push_back(path[i]);
+  }
+
+  path = std::move(unpacked);
+  return true;
+}
+
+bool LeapsGraph::UnpackOverlayJump(Segment const & enter, Segment const & exit,
+                                   std::vector<Segment> & path)
+{
+  auto const cellIdx = m_overlay->GetEnterCellIdx(enter);
+  CHECK(cellIdx, (enter));
+  ASSERT_EQUAL(m_overlay->GetExitCellIdx(exit), cellIdx, (enter, exit));
+
+  auto const & cellMwms = m_overlay->GetCell(*cellIdx).m_mwms;
+  std::unordered_set<NumMwmId> const mwms(cellMwms.begin(), cellMwms.end());
+
+  auto & worldGraph = m_starter.GetGraph();
+  auto & crossMwmGraph = worldGraph.GetCrossMwmGraph();
+  auto const & exitPoint = m_starter.GetPoint(exit, true /* front */);
+
+  std::vector<Segment> twins;
+  auto const getEdges = [&](Segment const & vertex, EdgeListT & edges)
+  {
+    if (!crossMwmGraph.IsTransition(vertex, true /* isOutgoing */))
+    {
+      crossMwmGraph.GetOutgoingEdgeList(vertex, edges);
+      return;
+    }
+
+    twins.clear();
+    worldGraph.GetTwinsInner(vertex, true /* isOutgoing */, twins);
+    for (auto const & twin : twins)
+    {
+      if (mwms.count(twin.GetMwmId()) != 0)
+      {
+        edges.emplace_back(twin, m_hierarchyHandler.GetCrossBorderPenalty(vertex.GetMwmId(),
+                                                                           twin.GetMwmId()));
+      }
+    }
+  };
+
+  auto const heuristic = [&](Segment const & vertex)
+  {
+    return m_starter.HeuristicCostEstimate(vertex, exitPoint);
+  };
+
+  if (FindOverlayJumpPath(enter, exit, getEdges, heuristic, path))
+    return true;
+
+  LOG(LWARNING, ("Can't unpack cross mwm overlay jump", enter, "->", exit));
+  return false;
+}
+
+bool FindOverlayJumpPath(Segment const & enter, Segment const & exit,
+                         std::function<void(Segment const &, LeapsGraph::EdgeListT &)> const & getEdges,
+                         std::function<RouteWeight(Segment const &)> const & heuristic,
+                         std::vector<Segment> & path)
+{
+  // A* through the cell mwms' leaps. Overlay weights are computed with the same leaps, so the
+  // search is short and touches only the mwms along the jump.
+  struct State
+  {
+    bool operator>(State const & rhs) const { return m_estimate > rhs.m_estimate; }
+
+    RouteWeight m_estimate;
+    RouteWeight m_distance;
+    Segment m_vertex;
+  };
+
+  std::priority_queue<State, std::vector<State>, std::greater<State>> queue;
+  std::unordered_map<Segment, RouteWeight> distances;
+  std::unordered_map<Segment, Segment> parents;
+
+  distances.emplace(enter, RouteWeight(0.0));
+  queue.push({heuristic(enter), RouteWeight(0.0), enter});
+
+  LeapsGraph::EdgeListT edges;
+  while (!queue.empty())
+  {
+    State const state = queue.top();
+    queue.pop();
+
+    Segment const & vertex = state.m_vertex;
+    if (state.m_distance > distances[vertex])
+      continue;
+
+    if (vertex == exit)
+    {
+      std::vector<Segment> jump = {exit};
+      for (auto it = parents.find(exit); it != parents.end(); it = parents.find(it->second))
+        jump.push_back(it->second);
+
+      path.insert(path.end(), jump.rbegin(), jump.rend());
+      return true;
+    }
+
+    edges.clear();
+    getEdges(vertex, edges);
+
+    for (auto const & edge : edges)
+    {
+      Segment const & target = edge.GetTarget();
+      RouteWeight const distance = state.m_distance + edge.GetWeight();
+
+      auto const [it, inserted] = distances.emplace(target, distance);
+      if (!inserted && !(distance < it->second))
+        continue;
+
+      it->second = distance;
+      parents[target] = vertex;
+      queue.push({distance + heuristic(target), distance, target});
+    }
+  }
+
+  return false;
+}
 }  // namespace routing
@@ -2,12 +2,15 @@
 
 #include "routing/base/astar_graph.hpp"
 #include "routing/base/astar_vertex_data.hpp"
+#include "routing/cross_mwm_overlay.hpp"
 #include "routing/mwm_hierarchy_handler.hpp"
 #include "routing/route_weight.hpp"
 #include "routing/segment.hpp"
 
 #include "geometry/latlon.hpp"
 
+#include <functional>
+#include <optional>
 #include <vector>
 
 namespace routing
@@ -35,12 +38,24 @@ public:
 
   RouteWeight CalcMiddleCrossMwmWeight(std::vector<Segment> const & path);
 
+  /// \brief Makes the graph jump over the |overlay| cells which contain neither start nor finish
+  /// and satisfy |isCellUsable|. Cross-mwm sections of such cells' mwms are not loaded.
+  void SetOverlay(CrossMwmOverlay const & overlay,
+                  std::function<bool(CrossMwmOverlayCell const &)> const & isCellUsable);
+
+  /// \brief Replaces overlay cell enter -> exit jumps in |path| with the leaps through the cell mwms.
+  /// \return false if some jump can't be unpacked.
+  bool UnpackOverlayJumps(std::vector<Segment> & path);
+
 private:
   void GetEdgesList(Segment const & segment, bool isOutgoing, EdgeListT & edges);
 
   void GetEdgesListFromStart(EdgeListT & edges) const;
   void GetEdgesListToFinish(EdgeListT & edges) const;
 
+  bool IsOverlayCellUsable(std::optional<uint32_t> const & cellIdx) const;
+  bool UnpackOverlayJump(Segment const & enter, Segment const & exit, std::vector<Segment> & path);
+
 private:
   ms::LatLon m_startPoint;
   ms::LatLon m_finishPoint;
@@ -51,5 +66,17 @@ private:
   IndexGraphStarter & m_starter;
 
   MwmHierarchyHandler m_hierarchyHandler;
+
+  CrossMwmOverlay const * m_overlay = nullptr;
+  std::vector<bool> m_usableOverlayCells;
 };
+
+/// \brief A* from |enter| to |exit| which unpacks a cross mwm overlay jump.
+/// |getEdges| fills outgoing edges of a vertex, |heuristic| estimates the weight to |exit|.
+/// Appends the path from |enter| to |exit| inclusive to |path|.
+/// \return false if |exit| is not reachable.
+bool FindOverlayJumpPath(Segment const & enter, Segment const & exit,
+                         std::function<void(Segment const &, LeapsGraph::EdgeListT &)> const & getEdges,
+                         std::function<RouteWeight(Segment const &)> const & heuristic,
+                         std::vector<Segment> & path);
 }  // namespace routing
@@ -0,0 +1,275 @@
+#include "routing/route_matrix.hpp"
+
+#include "routing/base/astar_weight.hpp"
+#include "routing/base/astar_vertex_data.hpp"
+#include "routing/route_weight.hpp"
+
+#include "geometry/distance_on_sphere.hpp"
+#include "geometry/latlon.hpp"
+
+#include "base/scope_guard.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <sstream>
+
+#include "3party/skarupke/bytell_hash_map.hpp"
+
+namespace routing
+{
+namespace
+{
+uint32_t constexpr kCancelCheckPeriod = 100;
+
+// Real segment with a fake ending projected to it.
+struct EndingPart
+{
+  Segment m_segment;
+  // Part of |m_segment| from its back point to the projection.
+  double m_beforePart = 0.0;
+  // Offroad part from the ending point to the projection.
+  RouteWeight m_offroadWeight;
+  double m_offroadEta = 0.0;
+};
+
+// The same parts of real segments as IndexGraphStarter adds for non strict forward endings.
+std::vector<EndingPart> GetEndingParts(WorldGraph & graph, FakeEnding const & ending)
+{
+  std::vector<EndingPart> parts;
+  for (auto const & projection : ending.m_projections)
+  {
+    auto const & junction = projection.m_junction.GetLatLon();
+    auto const & back = projection.m_segmentBack.GetLatLon();
+    auto const & front = projection.m_segmentFront.GetLatLon();
+
+    double const fullLen = ms::DistanceOnEarth(back, front);
+    double const beforePart =
+        fullLen == 0.0 ? 0.0 : std::min(1.0, ms::DistanceOnEarth(back, junction) / fullLen);
+
+    EndingPart part;
+    part.m_segment = projection.m_segment;
+    part.m_beforePart = beforePart;
+    part.m_offroadWeight = graph.CalcOffroadWeight(ending.m_originJunction.GetLatLon(), junction,
+                                                   EdgeEstimator::Purpose::Weight);
+    part.m_offroadEta = graph.CalcOffroadWeight(ending.m_originJunction.GetLatLon(), junction,
+                                                EdgeEstimator::Purpose::ETA).GetWeight();
+    parts.push_back(part);
+
+    if (!projection.m_isOneWay)
+    {
+      part.m_segment = projection.m_segment.GetReversed();
+      part.m_beforePart = 1.0 - beforePart;
+      parts.push_back(part);
+    }
+  }
+  return parts;
+}
+
+struct State
+{
+  State(Segment const & segment, RouteWeight const & distance)
+    : m_segment(segment), m_distance(distance)
+  {
+  }
+
+  bool operator>(State const & rhs) const { return m_distance > rhs.m_distance; }
+
+  Segment m_segment;
+  RouteWeight m_distance;
+};
+
+struct Candidate
+{
+  Candidate(size_t destinationIdx, RouteWeight const & distance)
+    : m_destinationIdx(destinationIdx), m_distance(distance)
+  {
+  }
+
+  bool operator>(Candidate const & rhs) const { return m_distance > rhs.m_distance; }
+
+  size_t m_destinationIdx;
+  RouteWeight m_distance;
+};
+
+struct Label
+{
+  RouteWeight m_distance;
+  double m_eta = 0.0;
+};
+}  // namespace
+
+// RouteMatrix -------------------------------------------------------------------------------------
+RouteMatrix::RouteMatrix(size_t originsCount, size_t destinationsCount)
+  : m_originsCount(originsCount)
+  , m_destinationsCount(destinationsCount)
+  , m_weights(originsCount * destinationsCount, kNoRoute)
+  , m_etas(originsCount * destinationsCount, kNoRoute)
+{
+}
+
+bool CalcRouteMatrixRow(WorldGraph & graph, FakeEnding const & origin,
+                        std::vector<FakeEnding> const & destinations,
+                        base::Cancellable const & cancellable, size_t originIdx,
+                        RouteMatrix & matrix)
+{
+  using Weight = RouteWeight;
+
+  // Destination parts by segments. Destination is settled when the popped distance is not less
+  // than its best candidate.
+  ska::bytell_hash_map<Segment, std::vector<std::pair<size_t, EndingPart>>> destinationParts;
+  std::vector<Label> best(destinations.size(), {GetAStarWeightMax<Weight>(), 0.0});
+  std::vector<bool> settled(destinations.size(), false);
+  size_t unsettledCount = 0;
+  for (size_t i = 0; i < destinations.size(); ++i)
+  {
+    if (destinations[i].m_projections.empty())
+    {
+      settled[i] = true;
+      continue;
+    }
+
+    ++unsettledCount;
+    for (auto const & part : GetEndingParts(graph, destinations[i]))
+      destinationParts[part.m_segment].emplace_back(i, part);
+  }
+
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+  auto const addCandidate = [&](size_t destinationIdx, Weight const & distance, double eta)
+  {
+    auto & label = best[destinationIdx];
+    if (settled[destinationIdx] || distance >= label.m_distance)
+      return;
+
+    label = {distance, eta};
+    candidates.emplace(destinationIdx, distance);
+  };
+
+  auto const settleCandidates = [&](Weight const & upTo)
+  {
+    while (!candidates.empty() && candidates.top().m_distance <= upTo)
+    {
+      auto const idx = candidates.top().m_destinationIdx;
+      candidates.pop();
+      if (!settled[idx])
+      {
+        settled[idx] = true;
+        --unsettledCount;
+      }
+    }
+  };
+
+  // |labels| keep the distance to the front point of the segment.
+  ska::bytell_hash_map<Segment, Label> labels;
+  WorldGraph::Parents<Segment> parents;
+  graph.SetAStarParents(true /* forward */, parents);
+  SCOPE_GUARD(dropParents, [&graph]() { graph.DropAStarParents(); });
+
+  std::priority_queue<State, std::vector<State>, std::greater<State>> queue;
+
+  if (!origin.m_projections.empty())
+  {
+    for (auto const & part : GetEndingParts(graph, origin))
+    {
+      double const afterPart = 1.0 - part.m_beforePart;
+      Weight const distance = part.m_offroadWeight +
+                              afterPart * graph.CalcSegmentWeight(part.m_segment, EdgeEstimator::Purpose::Weight);
+      double const eta = part.m_offroadEta +
+          afterPart * graph.CalcSegmentWeight(part.m_segment, EdgeEstimator::Purpose::ETA).GetWeight();
+
+      auto const it = labels.find(part.m_segment);
+      if (it == labels.end() || distance < it->second.m_distance)
+      {
+        labels[part.m_segment] = {distance, eta};
+        queue.emplace(part.m_segment, distance);
+      }
+
+      // Destinations on the same segment ahead of the origin.
+      auto const destIt = destinationParts.find(part.m_segment);
+      if (destIt == destinationParts.end())
+        continue;
+
+      for (auto const & [destinationIdx, destinationPart] : destIt->second)
+      {
+        double const between = destinationPart.m_beforePart - part.m_beforePart;
+        if (between < 0.0)
+          continue;
+
+        addCandidate(destinationIdx,
+                     part.m_offroadWeight + destinationPart.m_offroadWeight +
+                         between * graph.CalcSegmentWeight(part.m_segment, EdgeEstimator::Purpose::Weight),
+                     part.m_offroadEta + destinationPart.m_offroadEta +
+                         between * graph.CalcSegmentWeight(part.m_segment, EdgeEstimator::Purpose::ETA).GetWeight());
+      }
+    }
+  }
+
+  WorldGraph::SegmentEdgeListT edges;
+  uint32_t steps = 0;
+  while (!queue.empty() && unsettledCount != 0)
+  {
+    if (++steps % kCancelCheckPeriod == 0 && cancellable.IsCancelled())
+      return false;
+
+    State const state = queue.top();
+    queue.pop();
+
+    settleCandidates(state.m_distance);
+    if (unsettledCount == 0)
+      break;
+
+    Label const label = labels[state.m_segment];
+    if (state.m_distance > label.m_distance)
+      continue;
+
+    edges.clear();
+    graph.GetEdgeList({state.m_segment, state.m_distance}, true /* isOutgoing */,
+                      true /* useRoutingOptions */, true /* useAccessConditional */, edges);
+
+    for (auto const & edge : edges)
+    {
+      Segment const & target = edge.GetTarget();
+      Weight const distance = state.m_distance + edge.GetWeight();
+
+      auto const destIt = destinationParts.find(target);
+      if (destIt != destinationParts.end())
+      {
+        // Fake parts of real segments have no turn penalties, see IndexGraphStarter::CalcSegmentWeight().
+        Weight const targetWeight = graph.CalcSegmentWeight(target, EdgeEstimator::Purpose::Weight);
+        double const targetEta = graph.CalcSegmentWeight(target, EdgeEstimator::Purpose::ETA).GetWeight();
+        for (auto const & [destinationIdx, destinationPart] : destIt->second)
+        {
+          addCandidate(destinationIdx,
+                       state.m_distance + destinationPart.m_beforePart * targetWeight +
+                           destinationPart.m_offroadWeight,
+                       label.m_eta + destinationPart.m_beforePart * targetEta +
+                           destinationPart.m_offroadEta);
+        }
+      }
+
+      auto const it = labels.find(target);
+      if (it != labels.end() && it->second.m_distance <= distance)
+        continue;
+
+      labels[target] = {distance, label.m_eta + graph.CalculateETA(state.m_segment, target)};
+      parents[target] = state.m_segment;
+      queue.emplace(target, distance);
+    }
+  }
+
+  for (size_t i = 0; i < destinations.size(); ++i)
+  {
+    if (best[i].m_distance != GetAStarWeightMax<Weight>())
+      matrix.Set(originIdx, i, best[i].m_distance.GetWeight(), best[i].m_eta);
+  }
+  return true;
+}
+
+std::string DebugPrint(RouteMatrix const & matrix)
+{
+  std::ostringstream oss;
+  oss << "RouteMatrix [ origins: " << matrix.GetOriginsCount()
+      << ", destinations: " << matrix.GetDestinationsCount() << " ]";
+  return oss.str();
+}
+}  // namespace routing
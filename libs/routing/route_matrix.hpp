@@ -0,0 +1,80 @@
+#pragma once
+
+#include "routing/fake_ending.hpp"
+#include "routing/world_graph.hpp"
+
+#include "base/assert.hpp"
+#include "base/cancellable.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace routing
+{
+/// \brief Origins x destinations table of route weights and ETAs. It's a result of
+/// IndexRouter::CalculateRouteMatrix(), which doesn't build Route-s and turn instructions.
+class RouteMatrix
+{
+public:
+  /// Weight and ETA of the cells without a route.
+  static double constexpr kNoRoute = -1.0;
+
+  RouteMatrix() = default;
+  RouteMatrix(size_t originsCount, size_t destinationsCount);
+
+  size_t GetOriginsCount() const { return m_originsCount; }
+  size_t GetDestinationsCount() const { return m_destinationsCount; }
+
+  bool IsRouteFound(size_t originIdx, size_t destinationIdx) const
+  {
+    return GetWeight(originIdx, destinationIdx) != kNoRoute;
+  }
+
+  /// \returns route weight (with penalties) or kNoRoute.
+  double GetWeight(size_t originIdx, size_t destinationIdx) const
+  {
+    return m_weights[GetIdx(originIdx, destinationIdx)];
+  }
+
+  /// \returns estimated time of arrival in seconds or kNoRoute.
+  double GetETA(size_t originIdx, size_t destinationIdx) const
+  {
+    return m_etas[GetIdx(originIdx, destinationIdx)];
+  }
+
+  void Set(size_t originIdx, size_t destinationIdx, double weight, double eta)
+  {
+    auto const idx = GetIdx(originIdx, destinationIdx);
+    m_weights[idx] = weight;
+    m_etas[idx] = eta;
+  }
+
+private:
+  size_t GetIdx(size_t originIdx, size_t destinationIdx) const
+  {
+    ASSERT_LESS(originIdx, m_originsCount, ());
+    ASSERT_LESS(destinationIdx, m_destinationsCount, ());
+    return originIdx * m_destinationsCount + destinationIdx;
+  }
+
+  size_t m_originsCount = 0;
+  size_t m_destinationsCount = 0;
+  std::vector<double> m_weights;
+  std::vector<double> m_etas;
+};
+
+/// \brief One-to-many Dijkstra sweep over real segments of |graph| from |origin| to all
+/// |destinations|. Parts of the segments the endings are projected to are weighted
+/// the same way as IndexGraphStarter weights its fake segments.
+/// \param destinations Endings with empty projections are unreachable.
+/// \note The sweep stops as soon as all destinations are settled, so it's cheap for
+/// close destinations. |graph| should be in WorldGraphMode::NoLeaps or WorldGraphMode::SingleMwm.
+/// \returns false if |cancellable| was cancelled.
+bool CalcRouteMatrixRow(WorldGraph & graph, FakeEnding const & origin,
+                        std::vector<FakeEnding> const & destinations,
+                        base::Cancellable const & cancellable, size_t originIdx,
+                        RouteMatrix & matrix);
+
+std::string DebugPrint(RouteMatrix const & matrix);
+}  // namespace routing
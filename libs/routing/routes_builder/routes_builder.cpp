@@ -21,6 +21,9 @@
 
 namespace
 {
+// Memory which is kept for index graphs of mwms no router uses at the moment.
+size_t constexpr kIndexGraphDataCacheSize = 2048 * 1024 * 1024ULL;
+
 void DumpPointDVector(std::vector<m2::PointD> const & points, FileWriter & writer)
 {
   WriteToSink(writer, points.size());
@@ -91,7 +94,9 @@ RoutesBuilder & RoutesBuilder::GetSimpleRoutesBuilder()
   static RoutesBuilder routesBuilder(1 /* threadsNumber */);
   return routesBuilder;
 }
-RoutesBuilder::RoutesBuilder(size_t threadsNumber) : m_threadPool(threadsNumber)
+RoutesBuilder::RoutesBuilder(size_t threadsNumber)
+  : m_threadPool(threadsNumber)
+  , m_indexGraphDataCache(std::make_shared<IndexGraphDataCache>(kIndexGraphDataCacheSize))
 {
   CHECK_GREATER(threadsNumber, 0, ());
   LOG(LINFO, ("Threads number:", threadsNumber));
@@ -132,14 +137,15 @@ RoutesBuilder::RoutesBuilder(size_t threadsNumber) : m_threadPool(threadsNumber)
 
 RoutesBuilder::Result RoutesBuilder::ProcessTask(Params const & params)
 {
-  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig);
+  Processor processor(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig, m_indexGraphDataCache);
   return processor(params);
 }
 
 std::future<RoutesBuilder::Result> RoutesBuilder::ProcessTaskAsync(Params const & params)
 {
   // Should be copyable to workaround MSVC bug (https://developercommunity.visualstudio.com/t/108672)
-  auto task = [processor = std::make_shared<Processor>(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig)](Params const & params) -> Result
+  auto task = [processor = std::make_shared<Processor>(m_numMwmIds, m_dataSourcesStorage, m_cpg, m_cig,
+                                                           m_indexGraphDataCache)](Params const & params) -> Result
   {
       return (*processor)(params);
   };
@@ -232,11 +238,13 @@ std::vector<ms::LatLon> RoutesBuilder::Route::GetWaypoints() const
 RoutesBuilder::Processor::Processor(std::shared_ptr<NumMwmIds> numMwmIds,
                                     DataSourceStorage & dataSourceStorage,
                                     std::weak_ptr<storage::CountryParentGetter> cpg,
-                                    std::weak_ptr<storage::CountryInfoGetter> cig)
+                                    std::weak_ptr<storage::CountryInfoGetter> cig,
+                                    std::shared_ptr<IndexGraphDataCache> indexGraphDataCache)
     : m_numMwmIds(std::move(numMwmIds))
     , m_dataSourceStorage(dataSourceStorage)
     , m_cpg(std::move(cpg))
     , m_cig(std::move(cig))
+    , m_indexGraphDataCache(std::move(indexGraphDataCache))
 {
 }
 
@@ -252,6 +260,7 @@ RoutesBuilder::Processor::Processor(Processor && rhs) noexcept
   m_trafficCache = std::move(rhs.m_trafficCache);
   m_cpg = std::move(rhs.m_cpg);
   m_cig = std::move(rhs.m_cig);
+  m_indexGraphDataCache = std::move(rhs.m_indexGraphDataCache);
   m_dataSource = std::move(rhs.m_dataSource);
 }
 
@@ -284,6 +293,7 @@ void RoutesBuilder::Processor::InitRouter(VehicleType type)
                                            MakeNumMwmTree(*m_numMwmIds, *m_cig.lock()),
                                            *m_trafficCache,
                                            *m_dataSource);
+  m_router->SetIndexGraphDataCache(m_indexGraphDataCache);
 }
 
 RoutesBuilder::Result
@@ -3,6 +3,7 @@
 #include "routing/routes_builder/data_source_storage.hpp"
 
 #include "routing/checkpoints.hpp"
+#include "routing/index_graph_data_cache.hpp"
 #include "routing/index_router.hpp"
 #include "routing/router_delegate.hpp"
 #include "routing/routing_callbacks.hpp"
@@ -106,7 +107,8 @@ private:
     Processor(std::shared_ptr<NumMwmIds> numMwmIds,
               DataSourceStorage & dataSourceStorage,
               std::weak_ptr<storage::CountryParentGetter> cpg,
-              std::weak_ptr<storage::CountryInfoGetter> cig);
+              std::weak_ptr<storage::CountryInfoGetter> cig,
+              std::shared_ptr<IndexGraphDataCache> indexGraphDataCache);
 
     Processor(Processor && rhs) noexcept;
 
@@ -126,6 +128,7 @@ private:
     DataSourceStorage & m_dataSourceStorage;
     std::weak_ptr<storage::CountryParentGetter> m_cpg;
     std::weak_ptr<storage::CountryInfoGetter> m_cig;
+    std::shared_ptr<IndexGraphDataCache> m_indexGraphDataCache;
     std::unique_ptr<FrozenDataSource> m_dataSource;
   };
 
@@ -140,6 +143,9 @@ private:
   std::shared_ptr<NumMwmIds> m_numMwmIds = std::make_shared<NumMwmIds>();
 
   DataSourceStorage m_dataSourcesStorage;
+
+  // Routers of all threads load every mwm once.
+  std::shared_ptr<IndexGraphDataCache> m_indexGraphDataCache;
 };
 }  // namespace routes_builder
 }  // namespace routing
@@ -0,0 +1,353 @@
+#include "routing/routing_geometry_serialization.hpp"
+
+#include "coding/geometry_coding.hpp"
+#include "coding/succinct_mapper.hpp"
+#include "coding/varint.hpp"
+#include "coding/write_to_sink.hpp"
+
+#include "base/assert.hpp"
+#include "base/checked_cast.hpp"
+#include "base/logging.hpp"
+#include "base/stl_helpers.hpp"
+
+#include "defines.hpp"
+
+#include <bit>
+#include <tuple>
+
+namespace routing
+{
+using namespace std;
+
+namespace
+{
+uint8_t constexpr kOneWayBit = 1 << 0;
+uint8_t constexpr kPassThroughAllowedBit = 1 << 1;
+uint8_t constexpr kInCityBit = 1 << 2;
+uint8_t constexpr kHighwayTypeBit = 1 << 3;
+
+// Speeds are stored as is, they are calculated with floating point factors.
+template <typename Sink>
+void SerializeSpeed(Sink & sink, SpeedKMpH const & speed)
+{
+  WriteToSink(sink, bit_cast<uint64_t>(speed.m_weight));
+  WriteToSink(sink, bit_cast<uint64_t>(speed.m_eta));
+}
+
+template <typename Source>
+SpeedKMpH DeserializeSpeed(Source & src)
+{
+  SpeedKMpH speed;
+  speed.m_weight = bit_cast<double>(ReadPrimitiveFromSource<uint64_t>(src));
+  speed.m_eta = bit_cast<double>(ReadPrimitiveFromSource<uint64_t>(src));
+  return speed;
+}
+
+template <typename Sink>
+void SerializeAttrs(Sink & sink, RoadGeometryAttrs const & attrs)
+{
+  uint8_t flags = 0;
+  if (attrs.m_isOneWay)
+    flags |= kOneWayBit;
+  if (attrs.m_isPassThroughAllowed)
+    flags |= kPassThroughAllowedBit;
+  if (attrs.m_inCity)
+    flags |= kInCityBit;
+  if (attrs.m_highwayType)
+    flags |= kHighwayTypeBit;
+
+  WriteToSink(sink, flags);
+  if (attrs.m_highwayType)
+    WriteVarUint(sink, static_cast<uint32_t>(base::Underlying(*attrs.m_highwayType)));
+  WriteToSink(sink, attrs.m_routingOptions.GetOptions());
+  SerializeSpeed(sink, attrs.m_forwardSpeed);
+  SerializeSpeed(sink, attrs.m_backwardSpeed);
+}
+
+template <typename Source>
+RoadGeometryAttrs DeserializeAttrs(Source & src)
+{
+  RoadGeometryAttrs attrs;
+  auto const flags = ReadPrimitiveFromSource<uint8_t>(src);
+  attrs.m_isOneWay = (flags & kOneWayBit) != 0;
+  attrs.m_isPassThroughAllowed = (flags & kPassThroughAllowedBit) != 0;
+  attrs.m_inCity = (flags & kInCityBit) != 0;
+  if (flags & kHighwayTypeBit)
+    attrs.m_highwayType = static_cast<HighwayType>(ReadVarUint<uint32_t>(src));
+  attrs.m_routingOptions = RoutingOptions(ReadPrimitiveFromSource<RoutingOptions::RoadType>(src));
+  attrs.m_forwardSpeed = DeserializeSpeed(src);
+  attrs.m_backwardSpeed = DeserializeSpeed(src);
+  return attrs;
+}
+
+auto AttrsTie(RoadGeometryAttrs const & a)
+{
+  return tie(a.m_forwardSpeed.m_weight, a.m_forwardSpeed.m_eta, a.m_backwardSpeed.m_weight,
+             a.m_backwardSpeed.m_eta, a.m_highwayType, a.m_isOneWay, a.m_isPassThroughAllowed, a.m_inCity);
+}
+
+template <typename Writer>
+void Align8(Writer & writer, uint64_t startOffset)
+{
+  uint64_t bytesWritten = writer.Pos() - startOffset;
+  coding::WritePadding(writer, bytesWritten);
+}
+}  // namespace
+
+// RoadGeometryAttrs -------------------------------------------------------------------------------
+bool RoadGeometryAttrs::operator==(RoadGeometryAttrs const & rhs) const
+{
+  return AttrsTie(*this) == AttrsTie(rhs) &&
+         m_routingOptions.GetOptions() == rhs.m_routingOptions.GetOptions();
+}
+
+bool RoadGeometryAttrs::operator<(RoadGeometryAttrs const & rhs) const
+{
+  if (AttrsTie(*this) != AttrsTie(rhs))
+    return AttrsTie(*this) < AttrsTie(rhs);
+  return m_routingOptions.GetOptions() < rhs.m_routingOptions.GetOptions();
+}
+
+// RoutingGeometryDeserializer ---------------------------------------------------------------------
+void RoutingGeometryDeserializer::Header::Read(Reader & reader)
+{
+  NonOwningReaderSource src(reader);
+  m_version = static_cast<Version>(ReadPrimitiveFromSource<uint16_t>(src));
+  m_coordBits = ReadPrimitiveFromSource<uint8_t>(src);
+  m_vehicleMask = ReadPrimitiveFromSource<uint8_t>(src);
+  m_pointsMapOffset = ReadPrimitiveFromSource<uint32_t>(src);
+  m_pointsMapSize = ReadPrimitiveFromSource<uint32_t>(src);
+  for (auto & table : m_tables)
+  {
+    table.m_attrsOffset = ReadPrimitiveFromSource<uint32_t>(src);
+    table.m_mapOffset = ReadPrimitiveFromSource<uint32_t>(src);
+    table.m_mapSize = ReadPrimitiveFromSource<uint32_t>(src);
+    table.m_modelHash = ReadPrimitiveFromSource<uint64_t>(src);
+  }
+}
+
+// static
+unique_ptr<RoutingGeometryDeserializer> RoutingGeometryDeserializer::Load(FilesContainerR const & cont,
+                                                                          VehicleType vehicleType,
+                                                                          uint64_t modelHash)
+{
+  if (!cont.IsExist(ROUTING_GEOMETRY_FILE_TAG))
+    return {};
+
+  try
+  {
+    auto reader = cont.GetReader(ROUTING_GEOMETRY_FILE_TAG);
+    return Load(*reader.GetPtr(), vehicleType, modelHash);
+  }
+  catch (Reader::Exception const & e)
+  {
+    LOG(LERROR, ("Error while reading", ROUTING_GEOMETRY_FILE_TAG, "section.", e.Msg()));
+    return {};
+  }
+}
+
+// static
+unique_ptr<RoutingGeometryDeserializer> RoutingGeometryDeserializer::Load(Reader & reader,
+                                                                          VehicleType vehicleType,
+                                                                          uint64_t modelHash)
+{
+  Header header;
+  header.Read(reader);
+  if (header.m_version > Version::Latest)
+  {
+    LOG(LWARNING, ("Unsupported", ROUTING_GEOMETRY_FILE_TAG, "version", base::Underlying(header.m_version)));
+    return {};
+  }
+
+  auto const vehicleIdx = static_cast<size_t>(vehicleType);
+  if (vehicleIdx >= kVehicleTypesCount || (header.m_vehicleMask & GetVehicleMask(vehicleType)) == 0)
+    return {};
+
+  auto const & table = header.m_tables[vehicleIdx];
+  if (table.m_modelHash != modelHash)
+  {
+    LOG(LINFO, (ROUTING_GEOMETRY_FILE_TAG, "section is built with another", vehicleType,
+                "model, roads are loaded from features."));
+    return {};
+  }
+
+  auto deserializer = make_unique<RoutingGeometryDeserializer>();
+  deserializer->m_coordBits = header.m_coordBits;
+
+  deserializer->m_pointsSubreader = reader.CreateSubReader(header.m_pointsMapOffset, header.m_pointsMapSize);
+  if (!deserializer->m_pointsSubreader)
+    return {};
+
+  // Decodes block encoded by writeBlockCallback from RoutingGeometryBuilder::Freeze.
+  auto const readPointsBlock = [](NonOwningReaderSource & src, uint32_t blockSize,
+                                  vector<vector<m2::PointU>> & values)
+  {
+    values.resize(blockSize);
+    m2::PointU first(0, 0);
+    for (size_t i = 0; i < blockSize && src.Size() > 0; ++i)
+    {
+      auto & points = values[i];
+      points.resize(ReadVarUint<uint32_t>(src));
+      CHECK(!points.empty(), ());
+
+      m2::PointU prev = first;
+      for (auto & point : points)
+      {
+        point = coding::DecodePointDeltaFromUint(ReadVarUint<uint64_t>(src), prev);
+        prev = point;
+      }
+      first = points.front();
+    }
+  };
+
+  deserializer->m_points = PointsMap::Load(*deserializer->m_pointsSubreader, readPointsBlock);
+  if (!deserializer->m_points)
+    return {};
+
+  {
+    NonOwningReaderSource src(reader, table.m_attrsOffset, table.m_mapOffset);
+    deserializer->m_attrs.resize(ReadVarUint<uint32_t>(src));
+    for (auto & attrs : deserializer->m_attrs)
+      attrs = DeserializeAttrs(src);
+  }
+
+  deserializer->m_attrsSubreader = reader.CreateSubReader(table.m_mapOffset, table.m_mapSize);
+  if (!deserializer->m_attrsSubreader)
+    return {};
+
+  auto const readAttrsBlock = [](NonOwningReaderSource & src, uint32_t blockSize, vector<uint32_t> & values)
+  {
+    values.reserve(blockSize);
+    while (values.size() < blockSize && src.Size() > 0)
+      values.push_back(ReadVarUint<uint32_t>(src));
+  };
+
+  deserializer->m_attrsIds = AttrsMap::Load(*deserializer->m_attrsSubreader, readAttrsBlock);
+  if (!deserializer->m_attrsIds)
+    return {};
+
+  return deserializer;
+}
+
+bool RoutingGeometryDeserializer::Get(uint32_t featureId, RoadGeometryAttrs & attrs,
+                                      vector<m2::PointD> & points) const
+{
+  uint32_t attrsId = 0;
+  if (!m_attrsIds->GetThreadsafe(featureId, attrsId))
+    return false;
+  CHECK_LESS(attrsId, m_attrs.size(), (featureId));
+
+  vector<m2::PointU> pointsU;
+  CHECK(m_points->GetThreadsafe(featureId, pointsU), (featureId));
+
+  attrs = m_attrs[attrsId];
+  points.clear();
+  points.reserve(pointsU.size());
+  for (auto const & point : pointsU)
+    points.push_back(PointUToPointD(point, m_coordBits));
+  return true;
+}
+
+// RoutingGeometryBuilder --------------------------------------------------------------------------
+void RoutingGeometryBuilder::PutPoints(uint32_t featureId, vector<m2::PointD> const & points)
+{
+  CHECK(!points.empty(), (featureId));
+
+  vector<m2::PointU> pointsU;
+  pointsU.reserve(points.size());
+  for (auto const & point : points)
+    pointsU.push_back(PointDToPointU(point, m_coordBits));
+  m_points.Put(featureId, std::move(pointsU));
+}
+
+void RoutingGeometryBuilder::PutAttrs(VehicleType vehicleType, uint32_t featureId,
+                                      RoadGeometryAttrs const & attrs)
+{
+  auto const vehicleIdx = static_cast<size_t>(vehicleType);
+  CHECK_LESS(vehicleIdx, m_vehicleAttrs.size(), ());
+
+  auto & vehicleAttrs = m_vehicleAttrs[vehicleIdx];
+  auto const id = static_cast<uint32_t>(vehicleAttrs.m_attrsToId.size());
+  auto const it = vehicleAttrs.m_attrsToId.emplace(attrs, id).first;
+  vehicleAttrs.m_ids.Put(featureId, it->second);
+  m_vehicleMask |= GetVehicleMask(vehicleType);
+}
+
+void RoutingGeometryBuilder::SetModelHash(VehicleType vehicleType, uint64_t modelHash)
+{
+  auto const vehicleIdx = static_cast<size_t>(vehicleType);
+  CHECK_LESS(vehicleIdx, m_vehicleAttrs.size(), ());
+  m_vehicleAttrs[vehicleIdx].m_modelHash = modelHash;
+}
+
+void RoutingGeometryBuilder::Freeze(Writer & writer) const
+{
+  uint64_t const startOffset = writer.Pos();
+
+  RoutingGeometryDeserializer::Header header;
+  header.m_coordBits = m_coordBits;
+  header.m_vehicleMask = m_vehicleMask;
+  header.Serialize(writer);
+  Align8(writer, startOffset);
+
+  header.m_pointsMapOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
+  auto const writePointsBlock = [](auto & w, auto begin, auto end)
+  {
+    m2::PointU first(0, 0);
+    for (auto it = begin; it != end; ++it)
+    {
+      vector<m2::PointU> const & points = *it;
+      WriteVarUint(w, base::asserted_cast<uint32_t>(points.size()));
+
+      m2::PointU prev = first;
+      for (auto const & point : points)
+      {
+        WriteVarUint(w, coding::EncodePointDeltaAsUint(point, prev));
+        prev = point;
+      }
+      first = points.front();
+    }
+  };
+  // Points of a road are decoded up to the road in a block, so blocks are kept small.
+  m_points.Freeze(writer, writePointsBlock, 16 /* blockSize */);
+  header.m_pointsMapSize = base::asserted_cast<uint32_t>(writer.Pos() - startOffset - header.m_pointsMapOffset);
+
+  auto const writeAttrsBlock = [](auto & w, auto begin, auto end)
+  {
+    for (auto it = begin; it != end; ++it)
+      WriteVarUint(w, *it);
+  };
+
+  for (size_t i = 0; i < m_vehicleAttrs.size(); ++i)
+  {
+    if ((m_vehicleMask & GetVehicleMask(static_cast<VehicleType>(i))) == 0)
+      continue;
+
+    auto const & vehicleAttrs = m_vehicleAttrs[i];
+    auto & table = header.m_tables[i];
+    table.m_modelHash = vehicleAttrs.m_modelHash;
+
+    vector<RoadGeometryAttrs const *> attrs(vehicleAttrs.m_attrsToId.size());
+    for (auto const & [value, id] : vehicleAttrs.m_attrsToId)
+      attrs[id] = &value;
+
+    table.m_attrsOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
+    WriteVarUint(writer, base::asserted_cast<uint32_t>(attrs.size()));
+    for (auto const * value : attrs)
+      SerializeAttrs(writer, *value);
+    Align8(writer, startOffset);
+
+    table.m_mapOffset = base::asserted_cast<uint32_t>(writer.Pos() - startOffset);
+    vehicleAttrs.m_ids.Freeze(writer, writeAttrsBlock);
+    table.m_mapSize = base::asserted_cast<uint32_t>(writer.Pos() - startOffset - table.m_mapOffset);
+
+    LOG(LINFO, (ROUTING_GEOMETRY_FILE_TAG, "section has", attrs.size(), "distinct road attributes for",
+                static_cast<VehicleType>(i)));
+  }
+
+  auto const endOffset = writer.Pos();
+  writer.Seek(startOffset);
+  header.Serialize(writer);
+  writer.Seek(endOffset);
+}
+}  // namespace routing
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "routing/routing_options.hpp"
+#include "routing/vehicle_mask.hpp"
+
+#include "routing_common/vehicle_model.hpp"
+
+#include "coding/files_container.hpp"
+#include "coding/map_uint32_to_val.hpp"
+#include "coding/point_coding.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace routing
+{
+/// Vehicle dependent attributes of a road which RoadGeometry::Load calculates
+/// by a feature, a vehicle model and city_roads/maxspeeds sections.
+struct RoadGeometryAttrs
+{
+  bool operator==(RoadGeometryAttrs const & rhs) const;
+  bool operator<(RoadGeometryAttrs const & rhs) const;
+
+  SpeedKMpH m_forwardSpeed;
+  SpeedKMpH m_backwardSpeed;
+  std::optional<HighwayType> m_highwayType;
+  RoutingOptions m_routingOptions;
+  bool m_isOneWay = false;
+  bool m_isPassThroughAllowed = false;
+  bool m_inCity = false;
+};
+
+/// \brief ROUTING_GEOMETRY_FILE_TAG section keeps routing geometry of road features, so
+/// RoadGeometry may be loaded without FeatureType decoding and vehicle model classification.
+///
+/// Format:
+/// Header, all offsets are relative to the start of the section.
+/// Points map: MapUint32ToValue from feature id to the road points. Points are quantized with
+///   |m_coordBits| and delta-coded, the first point of a road relative to the first point of
+///   the previous road in the block.
+/// For each vehicle type of |m_vehicleMask|:
+///   Hash of the vehicle model the attributes are calculated with (in the header).
+///   Attributes table: VarUint count and distinct RoadGeometryAttrs.
+///   Attributes map: MapUint32ToValue from feature id to the index in the attributes table.
+///
+/// Features which aren't roads for a vehicle have no attributes for it. Attributes of a vehicle
+/// are not used if the runtime vehicle model differs from the one the section was built with.
+class RoutingGeometryDeserializer
+{
+public:
+  enum class Version : uint16_t
+  {
+    V0 = 0,
+    Latest = V0
+  };
+
+  static size_t constexpr kVehicleTypesCount = static_cast<size_t>(VehicleType::Transit);
+
+  struct VehicleTable
+  {
+    uint32_t m_attrsOffset = 0;
+    uint32_t m_mapOffset = 0;
+    uint32_t m_mapSize = 0;
+    uint64_t m_modelHash = 0;
+  };
+
+  struct Header
+  {
+    template <typename Sink>
+    void Serialize(Sink & sink) const
+    {
+      WriteToSink(sink, static_cast<uint16_t>(m_version));
+      WriteToSink(sink, m_coordBits);
+      WriteToSink(sink, m_vehicleMask);
+      WriteToSink(sink, m_pointsMapOffset);
+      WriteToSink(sink, m_pointsMapSize);
+      for (auto const & table : m_tables)
+      {
+        WriteToSink(sink, table.m_attrsOffset);
+        WriteToSink(sink, table.m_mapOffset);
+        WriteToSink(sink, table.m_mapSize);
+        WriteToSink(sink, table.m_modelHash);
+      }
+    }
+
+    void Read(Reader & reader);
+
+    Version m_version = Version::Latest;
+    uint8_t m_coordBits = kPointCoordBits;
+    uint8_t m_vehicleMask = 0;
+    uint32_t m_pointsMapOffset = 0;
+    uint32_t m_pointsMapSize = 0;
+    std::array<VehicleTable, kVehicleTypesCount> m_tables;
+  };
+
+  /// \returns nullptr if |cont| has no ROUTING_GEOMETRY_FILE_TAG section, the section has
+  /// an unknown version, it has no attributes for |vehicleType| or they are calculated with
+  /// a vehicle model which hash is not |modelHash|.
+  static std::unique_ptr<RoutingGeometryDeserializer> Load(FilesContainerR const & cont,
+                                                           VehicleType vehicleType, uint64_t modelHash);
+  static std::unique_ptr<RoutingGeometryDeserializer> Load(Reader & reader, VehicleType vehicleType,
+                                                           uint64_t modelHash);
+
+  /// \returns false if there is no road with |featureId| for the vehicle type.
+  /// This method is threadsafe.
+  [[nodiscard]] bool Get(uint32_t featureId, RoadGeometryAttrs & attrs,
+                         std::vector<m2::PointD> & points) const;
+
+private:
+  using PointsMap = MapUint32ToValue<std::vector<m2::PointU>>;
+  using AttrsMap = MapUint32ToValue<uint32_t>;
+
+  std::unique_ptr<Reader> m_pointsSubreader;
+  std::unique_ptr<Reader> m_attrsSubreader;
+  std::unique_ptr<PointsMap> m_points;
+  std::unique_ptr<AttrsMap> m_attrsIds;
+  std::vector<RoadGeometryAttrs> m_attrs;
+  uint8_t m_coordBits = kPointCoordBits;
+};
+
+class RoutingGeometryBuilder
+{
+public:
+  explicit RoutingGeometryBuilder(uint8_t coordBits) : m_coordBits(coordBits) {}
+
+  /// Features should be put in the increasing order of ids.
+  void PutPoints(uint32_t featureId, std::vector<m2::PointD> const & points);
+  void PutAttrs(VehicleType vehicleType, uint32_t featureId, RoadGeometryAttrs const & attrs);
+  /// Sets VehicleModelInterface::GetHash() of the model attributes of |vehicleType| are calculated with.
+  void SetModelHash(VehicleType vehicleType, uint64_t modelHash);
+
+  void Freeze(Writer & writer) const;
+
+private:
+  struct VehicleAttrs
+  {
+    std::map<RoadGeometryAttrs, uint32_t> m_attrsToId;
+    MapUint32ToValueBuilder<uint32_t> m_ids;
+    uint64_t m_modelHash = 0;
+  };
+
+  uint8_t m_coordBits;
+  MapUint32ToValueBuilder<std::vector<m2::PointU>> m_points;
+  std::array<VehicleAttrs, RoutingGeometryDeserializer::kVehicleTypesCount> m_vehicleAttrs;
+  uint8_t m_vehicleMask = 0;
+};
+}  // namespace routing
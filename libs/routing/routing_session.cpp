@@ -851,13 +851,7 @@ void RoutingSession::OnTrafficInfoClear()
 
 void RoutingSession::OnTrafficInfoAdded(TrafficInfo && info)
 {
-  TrafficInfo::Coloring const & fullColoring = info.GetColoring();
-  auto coloring = std::make_shared<TrafficInfo::Coloring>();
-  for (auto const & kv : fullColoring)
-  {
-    ASSERT_NOT_EQUAL(kv.second, SpeedGroup::Unknown, ());
-    coloring->insert(kv);
-  }
+  auto coloring = std::make_shared<TrafficInfo::PackedColoring const>(info.GetColoring());
 
   // Note. |coloring| should not be used after this call on gui thread.
   auto const mwmId = info.GetMwmId();
@@ -107,7 +107,7 @@ public:
 
   void SetTrafficColoring(shared_ptr<TrafficInfo::Coloring const> coloring)
   {
-    m_trafficStash->SetColoring(kTestNumMwmId, coloring);
+    m_trafficStash->SetColoring(kTestNumMwmId, make_shared<TrafficInfo::PackedColoring const>(*coloring));
   }
 
   shared_ptr<EdgeEstimator> GetEstimator() const { return m_estimator; }
@@ -0,0 +1,170 @@
+#include "testing/testing.hpp"
+
+#include "routing/cross_mwm_overlay.hpp"
+#include "routing/leaps_graph.hpp"
+#include "routing/route_weight.hpp"
+#include "routing/segment.hpp"
+
+#include "routing_common/num_mwm_id.hpp"
+
+#include "platform/country_file.hpp"
+
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace cross_mwm_overlay_tests
+{
+using namespace routing;
+using namespace std;
+
+NumMwmIds MakeNumMwmIds(vector<string> const & names)
+{
+  NumMwmIds numMwmIds;
+  for (auto const & name : names)
+    numMwmIds.RegisterFile(platform::CountryFile(name));
+  return numMwmIds;
+}
+
+NumMwmId GetId(NumMwmIds const & numMwmIds, string const & name)
+{
+  return numMwmIds.GetId(platform::CountryFile(name));
+}
+
+// Cell of 2 mwms with 2 enters and 3 exits.
+CrossMwmOverlayCell MakeCell(NumMwmIds const & numMwmIds, string const & mwm1, string const & mwm2)
+{
+  NumMwmId const id1 = GetId(numMwmIds, mwm1);
+  NumMwmId const id2 = GetId(numMwmIds, mwm2);
+
+  CrossMwmOverlayCell cell;
+  cell.m_mwms = {id1, id2};
+  cell.m_mwmVersions = {210101, 210102};
+  cell.m_enters = {Segment(id1, 10, 1, true), Segment(id2, 20, 0, false)};
+  cell.m_exits = {Segment(id1, 11, 2, false), Segment(id2, 21, 3, true), Segment(id2, 22, 0, true)};
+  cell.m_weights = {100, connector::kNoRouteStored, 300,
+                    400, 500, 600};
+  return cell;
+}
+
+CrossMwmOverlay::EdgeListT GetOutgoing(CrossMwmOverlay const & overlay, Segment const & s)
+{
+  CrossMwmOverlay::EdgeListT edges;
+  overlay.GetOutgoingEdgeList(s, edges);
+  return edges;
+}
+
+CrossMwmOverlay::EdgeListT GetIngoing(CrossMwmOverlay const & overlay, Segment const & s)
+{
+  CrossMwmOverlay::EdgeListT edges;
+  overlay.GetIngoingEdgeList(s, edges);
+  return edges;
+}
+
+void TestEdges(CrossMwmOverlay::EdgeListT const & edges, vector<SegmentEdge> const & expected)
+{
+  TEST_EQUAL(edges.size(), expected.size(), ());
+  for (size_t i = 0; i < edges.size(); ++i)
+    TEST_EQUAL(edges[i], expected[i], ());
+}
+
+UNIT_TEST(CrossMwmOverlay_Edges)
+{
+  auto const numMwmIds = MakeNumMwmIds({"A_1", "A_2"});
+  CrossMwmOverlay overlay;
+  overlay.AddCell(MakeCell(numMwmIds, "A_1", "A_2"));
+
+  auto const & cell = overlay.GetCell(0);
+  TEST_EQUAL(overlay.GetCellIdx(GetId(numMwmIds, "A_2")), 0, ());
+  TEST_EQUAL(overlay.GetEnterCellIdx(cell.m_enters[1]), 0, ());
+  TEST(!overlay.GetEnterCellIdx(cell.m_exits[0]), ());
+  TEST_EQUAL(overlay.GetExitCellIdx(cell.m_exits[2]), 0, ());
+  TEST(!overlay.GetExitCellIdx(cell.m_enters[0]), ());
+
+  TestEdges(GetOutgoing(overlay, cell.m_enters[0]),
+            {{cell.m_exits[0], RouteWeight::FromCrossMwmWeight(100)},
+             {cell.m_exits[2], RouteWeight::FromCrossMwmWeight(300)}});
+  TestEdges(GetIngoing(overlay, cell.m_exits[1]),
+            {{cell.m_enters[1], RouteWeight::FromCrossMwmWeight(500)}});
+}
+
+UNIT_TEST(CrossMwmOverlay_SerDes)
+{
+  auto const numMwmIds1 = MakeNumMwmIds({"A_1", "A_2", "B_1", "B_2"});
+  CrossMwmOverlay overlay1;
+  overlay1.AddCell(MakeCell(numMwmIds1, "A_1", "A_2"));
+  overlay1.AddCell(MakeCell(numMwmIds1, "B_2", "B_1"));
+
+  vector<uint8_t> buffer;
+  {
+    MemWriter<vector<uint8_t>> writer(buffer);
+    CrossMwmOverlaySerializer::Serialize(overlay1, writer, numMwmIds1);
+  }
+
+  // Router may have another mwms numeration and doesn't know about some mwms.
+  auto const numMwmIds2 = MakeNumMwmIds({"B_2", "C", "B_1"});
+  CrossMwmOverlay overlay2;
+  {
+    MemReader reader(buffer.data(), buffer.size());
+    CrossMwmOverlaySerializer::Deserialize(overlay2, reader, numMwmIds2);
+  }
+
+  TEST_EQUAL(overlay2.GetCellsCount(), 1, ());
+  TEST(!overlay2.GetCellIdx(GetId(numMwmIds2, "C")), ());
+
+  auto const expected = MakeCell(numMwmIds2, "B_2", "B_1");
+  auto const & cell = overlay2.GetCell(0);
+  TEST_EQUAL(cell.m_mwms, expected.m_mwms, ());
+  TEST_EQUAL(cell.m_mwmVersions, expected.m_mwmVersions, ());
+  TEST_EQUAL(cell.m_enters, expected.m_enters, ());
+  TEST_EQUAL(cell.m_exits, expected.m_exits, ());
+
+  // Weights are read on the first use of the cell.
+  TEST(cell.m_weights.empty(), ());
+  TestEdges(GetOutgoing(overlay2, cell.m_enters[0]),
+            {{cell.m_exits[0], RouteWeight::FromCrossMwmWeight(100)},
+             {cell.m_exits[2], RouteWeight::FromCrossMwmWeight(300)}});
+  TEST_EQUAL(cell.m_weights, expected.m_weights, ());
+  TEST_EQUAL(overlay2.GetWeights(0), expected.m_weights, ());
+}
+
+UNIT_TEST(CrossMwmOverlay_UnpackJump)
+{
+  // Leaps and twins of a cell: 0 -> 1 -> 3 is shorter than 0 -> 2 -> 3, 4 can't be reached.
+  Segment const enter(1, 0, 0, true);
+  Segment const s1(1, 1, 0, true);
+  Segment const s2(2, 2, 0, true);
+  Segment const exit(2, 3, 0, true);
+  Segment const unreachable(2, 4, 0, true);
+
+  map<Segment, vector<SegmentEdge>> const graph = {
+      {enter, {{s1, RouteWeight(10.0)}, {s2, RouteWeight(4.0)}}},
+      {s1, {{exit, RouteWeight(0.0)}}},
+      {s2, {{exit, RouteWeight(7.0)}}},
+      {exit, {{s1, RouteWeight(1.0)}}}};
+
+  auto const getEdges = [&graph](Segment const & vertex, LeapsGraph::EdgeListT & edges)
+  {
+    auto const it = graph.find(vertex);
+    if (it == graph.end())
+      return;
+    for (auto const & edge : it->second)
+      edges.emplace_back(edge);
+  };
+  auto const heuristic = [](Segment const &) { return RouteWeight(0.0); };
+
+  // The jump is appended to the path before the cell.
+  Segment const before(3, 5, 0, true);
+  vector<Segment> path = {before};
+  TEST(FindOverlayJumpPath(enter, exit, getEdges, heuristic, path), ());
+  TEST_EQUAL(path, vector<Segment>({before, enter, s1, exit}), ());
+
+  path = {before};
+  TEST(!FindOverlayJumpPath(enter, unreachable, getEdges, heuristic, path), ());
+  TEST_EQUAL(path, vector<Segment>({before}), ());
+}
+}  // namespace cross_mwm_overlay_tests
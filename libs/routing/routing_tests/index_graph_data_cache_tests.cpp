@@ -0,0 +1,90 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/index_graph_tools.hpp"
+
+#include "routing/index_graph.hpp"
+#include "routing/index_graph_data_cache.hpp"
+
+#include "routing_common/vehicle_model.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace index_graph_data_cache_tests
+{
+using namespace routing;
+using namespace std;
+
+// Road 0 and road 1 with joints at their ends.
+shared_ptr<IndexGraphData const> MakeData()
+{
+  IndexGraph graph;
+  graph.Import({MakeJoint({{0, 0}}), MakeJoint({{0, 1}, {1, 0}}), MakeJoint({{1, 1}})});
+  return graph.ShareData();
+}
+
+IndexGraphDataCache::Key MakeKey(VehicleType vehicleType) { return {"Country", 1 /* version */, vehicleType}; }
+
+UNIT_TEST(IndexGraphDataCache_Share)
+{
+  IndexGraphDataCache cache(1000000 /* memoryBudget */);
+  auto const key = MakeKey(VehicleType::Car);
+  TEST(!cache.Get(key), ());
+
+  auto const data1 = MakeData();
+  TEST_EQUAL(cache.Put(key, data1), data1, ());
+  TEST_EQUAL(cache.Get(key), data1, ());
+  TEST_EQUAL(cache.GetMemorySize(), data1->GetMemorySize(), ());
+
+  // Another graph has loaded the same mwm simultaneously.
+  auto const data2 = MakeData();
+  TEST_EQUAL(cache.Put(key, data2), data1, ());
+
+  TEST(!cache.Get(MakeKey(VehicleType::Pedestrian)), ());
+  TEST(!cache.Get({"Country", 2 /* version */, VehicleType::Car}), ());
+  TEST(!cache.Get({"AnotherCountry", 1 /* version */, VehicleType::Car}), ());
+}
+
+UNIT_TEST(IndexGraphDataCache_Budget)
+{
+  auto const dataSize = MakeData()->GetMemorySize();
+  TEST_GREATER(dataSize, 0, ());
+
+  IndexGraphDataCache cache(2 * dataSize /* memoryBudget */);
+  auto const carKey = MakeKey(VehicleType::Car);
+  auto const bicycleKey = MakeKey(VehicleType::Bicycle);
+  auto const pedestrianKey = MakeKey(VehicleType::Pedestrian);
+  auto const transitKey = MakeKey(VehicleType::Transit);
+
+  cache.Put(carKey, MakeData());
+  cache.Put(bicycleKey, MakeData());
+  auto const carData = cache.Get(carKey);
+  TEST(carData, ());
+
+  // Bicycle data is the least recently used one and no graph uses it.
+  cache.Put(pedestrianKey, MakeData());
+  TEST_EQUAL(cache.GetMemorySize(), 2 * dataSize, ());
+  TEST(!cache.Get(bicycleKey), ());
+
+  // Car data is not kept by the cache, but it's still used by a graph.
+  cache.Put(transitKey, MakeData());
+  TEST_EQUAL(cache.GetMemorySize(), 2 * dataSize, ());
+  TEST_EQUAL(cache.Get(carKey), carData, ());
+  TEST(cache.Get(transitKey), ());
+  TEST(!cache.Get(pedestrianKey), ());
+}
+
+UNIT_TEST(IndexGraph_SharedData)
+{
+  IndexGraph graph1;
+  graph1.Import({MakeJoint({{0, 0}}), MakeJoint({{0, 1}, {1, 0}})});
+
+  IndexGraph graph2;
+  graph2.SetSharedData(graph1.ShareData());
+  TEST_EQUAL(graph2.GetNumRoads(), 2, ());
+  TEST_EQUAL(graph2.GetNumJoints(), 2, ());
+  TEST_EQUAL(graph2.GetJointId({1, 0}), graph1.GetJointId({0, 1}), ());
+}
+}  // namespace index_graph_data_cache_tests
@@ -0,0 +1,127 @@
+#include "testing/testing.hpp"
+
+#include "routing/routing_tests/index_graph_tools.hpp"
+
+#include "routing/base/astar_algorithm.hpp"
+
+#include "routing/edge_estimator.hpp"
+#include "routing/fake_ending.hpp"
+#include "routing/index_graph_starter.hpp"
+#include "routing/route_matrix.hpp"
+
+#include "traffic/traffic_cache.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/cancellable.hpp"
+#include "base/math.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace route_matrix_tests
+{
+using namespace routing;
+using namespace routing_test;
+using namespace std;
+
+using Algorithm = AStarAlgorithm<Segment, SegmentEdge, RouteWeight>;
+
+// Roads   R3  R4  R5
+//
+//    R0   * - * - *
+//         |   |   |
+//    R1   * - * - *
+//         |   |   |
+//    R2   * > * > *    (one way)
+//
+unique_ptr<WorldGraph> BuildGrid(shared_ptr<EdgeEstimator> const & estimator)
+{
+  uint32_t constexpr kSize = 3;
+  auto loader = make_unique<TestGeometryLoader>();
+  for (uint32_t i = 0; i < kSize; ++i)
+  {
+    RoadGeometry::Points street;
+    RoadGeometry::Points avenue;
+    for (uint32_t j = 0; j < kSize; ++j)
+    {
+      street.emplace_back(static_cast<double>(j), static_cast<double>(i));
+      avenue.emplace_back(static_cast<double>(i), static_cast<double>(j));
+    }
+    loader->AddRoad(i, i == kSize - 1 /* oneWay */, 1.0 /* speed */, street);
+    loader->AddRoad(i + kSize, false /* oneWay */, 1.0 /* speed */, avenue);
+  }
+
+  vector<Joint> joints;
+  for (uint32_t i = 0; i < kSize; ++i)
+  {
+    for (uint32_t j = 0; j < kSize; ++j)
+      joints.emplace_back(MakeJoint({{i, j}, {j + kSize, i}}));
+  }
+
+  return BuildWorldGraph(std::move(loader), estimator, joints);
+}
+
+vector<FakeEnding> MakeEndings(WorldGraph & graph)
+{
+  return {MakeFakeEnding(0 /* featureId */, 0 /* segmentIdx */, m2::PointD(0.3, 0.0), graph),
+          MakeFakeEnding(0, 0, m2::PointD(0.7, 0.0), graph),
+          MakeFakeEnding(2, 1, m2::PointD(1.5, 2.0), graph),
+          MakeFakeEnding(4, 0, m2::PointD(1.0, 0.5), graph),
+          MakeFakeEnding(5, 1, m2::PointD(2.1, 1.5), graph)};
+}
+
+UNIT_TEST(RouteMatrix_SameAsAStar)
+{
+  traffic::TrafficCache const trafficCache;
+  auto const estimator = CreateEstimatorForCar(trafficCache);
+  auto graph = BuildGrid(estimator);
+  auto const endings = MakeEndings(*graph);
+
+  RouteMatrix matrix(endings.size(), endings.size());
+  base::Cancellable const cancellable;
+  for (size_t i = 0; i < endings.size(); ++i)
+    TEST(CalcRouteMatrixRow(*graph, endings[i], endings, cancellable, i, matrix), ());
+
+  for (size_t i = 0; i < endings.size(); ++i)
+  {
+    for (size_t j = 0; j < endings.size(); ++j)
+    {
+      auto starter = MakeStarter(endings[i], endings[j], *graph);
+      vector<Segment> route;
+      double timeSec = 0.0;
+      TEST_EQUAL(CalculateRoute(*starter, route, timeSec), Algorithm::Result::OK, (i, j));
+
+      TEST(matrix.IsRouteFound(i, j), (i, j));
+      TEST(AlmostEqualAbs(matrix.GetWeight(i, j), timeSec, 1e-6),
+           (i, j, matrix.GetWeight(i, j), timeSec));
+      TEST_GREATER_OR_EQUAL(matrix.GetETA(i, j), 0.0, (i, j));
+    }
+  }
+
+  // The one way road R2 is longer backward.
+  TEST_LESS(matrix.GetWeight(2, 4), matrix.GetWeight(4, 2), ());
+}
+
+UNIT_TEST(RouteMatrix_NotSnapped)
+{
+  traffic::TrafficCache const trafficCache;
+  auto const estimator = CreateEstimatorForCar(trafficCache);
+  auto graph = BuildGrid(estimator);
+
+  auto destinations = MakeEndings(*graph);
+  destinations.emplace_back();
+
+  RouteMatrix matrix(2 /* originsCount */, destinations.size());
+  base::Cancellable const cancellable;
+  TEST(CalcRouteMatrixRow(*graph, destinations[0], destinations, cancellable, 0, matrix), ());
+  TEST(CalcRouteMatrixRow(*graph, FakeEnding(), destinations, cancellable, 1, matrix), ());
+
+  TEST(matrix.IsRouteFound(0, 0), ());
+  TEST(AlmostEqualAbs(matrix.GetWeight(0, 0), 0.0, 1e-9), ());
+  TEST(!matrix.IsRouteFound(0, destinations.size() - 1), ());
+  for (size_t j = 0; j < destinations.size(); ++j)
+    TEST(!matrix.IsRouteFound(1, j), (j));
+}
+}  // namespace route_matrix_tests
@@ -0,0 +1,307 @@
+#include "testing/testing.hpp"
+
+#include "generator/altitude_generator.hpp"
+#include "generator/feature_builder.hpp"
+#include "generator/generator_tests_support/test_mwm_builder.hpp"
+#include "generator/routing_geometry_generator.hpp"
+
+#include "routing/geometry.hpp"
+#include "routing/routing_geometry_serialization.hpp"
+
+#include "routing_common/bicycle_model.hpp"
+#include "routing_common/car_model.hpp"
+#include "routing_common/pedestrian_model.hpp"
+
+#include "indexer/classificator.hpp"
+#include "indexer/classificator_loader.hpp"
+#include "indexer/data_source.hpp"
+#include "indexer/feature_data.hpp"
+
+#include "platform/country_file.hpp"
+#include "platform/local_country_file.hpp"
+#include "platform/platform.hpp"
+#include "platform/platform_tests_support/scoped_dir.hpp"
+#include "platform/platform_tests_support/scoped_file.hpp"
+
+#include "coding/point_coding.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "geometry/point2d.hpp"
+
+#include "base/file_name_utils.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "defines.hpp"
+
+namespace routing_geometry_serialization_tests
+{
+using namespace platform;
+using namespace platform::tests_support;
+using namespace routing;
+using namespace std;
+
+// Directory name for creating test mwm and temporary files.
+string const kTestDir = "routing_geometry_generation_test";
+// Temporary mwm name for testing.
+string const kTestMwm = "test";
+
+class TestAltitudeGetter : public AltitudeGetter
+{
+public:
+  // AltitudeGetter overrides:
+  geometry::Altitude GetAltitude(m2::PointD const & p) override
+  {
+    return static_cast<geometry::Altitude>(round(p.x * 10.0 + p.y));
+  }
+};
+
+struct RoadFeature
+{
+  vector<m2::PointD> m_points;
+  vector<vector<string>> m_types;
+};
+
+void BuildMwm(vector<RoadFeature> const & roads, LocalCountryFile & country)
+{
+  generator::tests_support::TestMwmBuilder builder(country, feature::DataHeader::MapType::Country);
+  for (auto const & road : roads)
+  {
+    feature::FeatureBuilder fb;
+    fb.AssignPoints(road.m_points);
+    fb.SetLinear();
+    for (auto const & type : road.m_types)
+      fb.AddType(classif().GetTypeByPath(type));
+    TEST(builder.Add(fb), (road.m_types));
+  }
+}
+
+void TestRoadsEqual(RoadGeometry const & expected, RoadGeometry const & road, uint32_t featureId)
+{
+  TEST_EQUAL(road.IsValid(), expected.IsValid(), (featureId));
+  if (!expected.IsValid())
+    return;
+
+  TEST(road.GetAttrs() == expected.GetAttrs(), (featureId));
+  TEST_EQUAL(road.IsOneWay(), expected.IsOneWay(), (featureId));
+  TEST_EQUAL(road.IsPassThroughAllowed(), expected.IsPassThroughAllowed(), (featureId));
+  TEST_EQUAL(road.IsInCity(), expected.IsInCity(), (featureId));
+  TEST_EQUAL(road.GetSpeed(true /* forward */), expected.GetSpeed(true /* forward */), (featureId));
+  TEST_EQUAL(road.GetSpeed(false /* forward */), expected.GetSpeed(false /* forward */), (featureId));
+  TEST(road.GetHighwayType() == expected.GetHighwayType(), (featureId));
+  TEST_EQUAL(road.GetRoutingOptions().GetOptions(), expected.GetRoutingOptions().GetOptions(), (featureId));
+
+  TEST_EQUAL(road.GetPointsCount(), expected.GetPointsCount(), (featureId));
+  for (uint32_t i = 0; i < expected.GetPointsCount(); ++i)
+  {
+    TEST_EQUAL(road.GetJunction(i), expected.GetJunction(i), (featureId, i));
+    TEST_EQUAL(road.GetJunction(i).GetAltitude(), expected.GetJunction(i).GetAltitude(), (featureId, i));
+  }
+}
+
+vector<m2::PointD> MakePoints(vector<m2::PointU> const & points)
+{
+  // Points on the coding grid are restored exactly.
+  vector<m2::PointD> result;
+  for (auto const & p : points)
+    result.push_back(PointUToPointD(p, kPointCoordBits));
+  return result;
+}
+
+RoadGeometryAttrs MakeAttrs(double speed, bool oneWay, optional<HighwayType> highwayType)
+{
+  RoadGeometryAttrs attrs;
+  attrs.m_forwardSpeed = SpeedKMpH(speed, speed * 0.9);
+  attrs.m_backwardSpeed = SpeedKMpH(speed / 3.0);
+  attrs.m_highwayType = highwayType;
+  attrs.m_isOneWay = oneWay;
+  attrs.m_isPassThroughAllowed = !oneWay;
+  attrs.m_inCity = oneWay;
+  if (oneWay)
+    attrs.m_routingOptions.Add(RoutingOptions::Road::Toll);
+  return attrs;
+}
+
+void TestRoad(RoutingGeometryDeserializer const & deserializer, uint32_t featureId,
+              RoadGeometryAttrs const & expectedAttrs, vector<m2::PointD> const & expectedPoints)
+{
+  RoadGeometryAttrs attrs;
+  vector<m2::PointD> points;
+  TEST(deserializer.Get(featureId, attrs, points), (featureId));
+  TEST(attrs == expectedAttrs, (featureId));
+  TEST_EQUAL(points, expectedPoints, (featureId));
+}
+
+UNIT_TEST(RoutingGeometrySerialization_Smoke)
+{
+  auto const road0 = MakePoints({{1000, 1000}, {1100, 900}, {1200, 1300}});
+  auto const road5 = MakePoints({{5, 5}, {1 << 29, 1 << 29}});
+  auto const road7 = MakePoints({{(1 << 30) - 1, 0}, {0, (1 << 30) - 1}, {7, 7}, {8, 8}});
+
+  auto const primary = MakeAttrs(90.0, true /* oneWay */, HighwayType::HighwayPrimary);
+  auto const footway = MakeAttrs(5.0, false /* oneWay */, HighwayType::HighwayFootway);
+  auto const noType = MakeAttrs(20.0, false /* oneWay */, {} /* highwayType */);
+
+  vector<uint8_t> buffer;
+  {
+    RoutingGeometryBuilder builder(kPointCoordBits);
+    builder.PutPoints(0, road0);
+    builder.PutAttrs(VehicleType::Car, 0, primary);
+    builder.PutPoints(5, road5);
+    builder.PutAttrs(VehicleType::Pedestrian, 5, footway);
+    builder.PutAttrs(VehicleType::Car, 5, noType);
+    builder.PutPoints(7, road7);
+    builder.PutAttrs(VehicleType::Car, 7, primary);
+    builder.SetModelHash(VehicleType::Car, 1 /* modelHash */);
+    builder.SetModelHash(VehicleType::Pedestrian, 2 /* modelHash */);
+
+    MemWriter<vector<uint8_t>> writer(buffer);
+    builder.Freeze(writer);
+  }
+
+  MemReader reader(buffer.data(), buffer.size());
+
+  auto const car = RoutingGeometryDeserializer::Load(reader, VehicleType::Car, 1 /* modelHash */);
+  TEST(car, ());
+  TestRoad(*car, 0, primary, road0);
+  TestRoad(*car, 5, noType, road5);
+  TestRoad(*car, 7, primary, road7);
+
+  RoadGeometryAttrs attrs;
+  vector<m2::PointD> points;
+  TEST(!car->Get(1, attrs, points), ());
+  TEST(!car->Get(100, attrs, points), ());
+
+  auto const pedestrian = RoutingGeometryDeserializer::Load(reader, VehicleType::Pedestrian, 2 /* modelHash */);
+  TEST(pedestrian, ());
+  TestRoad(*pedestrian, 5, footway, road5);
+  TEST(!pedestrian->Get(0, attrs, points), ());
+  TEST(!pedestrian->Get(7, attrs, points), ());
+
+  TEST(!RoutingGeometryDeserializer::Load(reader, VehicleType::Bicycle, 0 /* modelHash */), ());
+
+  // Attributes calculated with another vehicle model are not used.
+  TEST(!RoutingGeometryDeserializer::Load(reader, VehicleType::Car, 2 /* modelHash */), ());
+}
+
+// Roads loaded from the routing geometry section should be the same as roads loaded from
+// features of the mwm the section is built for.
+UNIT_TEST(RoutingGeometrySerialization_SectionEqualsFeatures)
+{
+  classificator::Load();
+
+  vector<RoadFeature> const roads = {
+      {{{0.0, 0.0}, {1.0, 0.0}, {2.0, 1.0}}, {{"highway", "primary"}, {"hwtag", "oneway"}, {"hwtag", "toll"}}},
+      {{{2.0, 1.0}, {3.0, 2.0}, {2.0, 3.0}, {1.0, 2.0}},
+       {{"highway", "residential"}, {"junction", "roundabout"}, {"hwtag", "oneway"}}},
+      {{{0.0, 0.0}, {0.0, -1.0}, {-1.0, -2.0}}, {{"highway", "footway"}}},
+      {{{2.0, 1.0}, {4.0, 1.0}}, {{"highway", "residential"}}},
+  };
+
+  string const writableDir = GetPlatform().WritableDir();
+  LocalCountryFile country(base::JoinPath(writableDir, kTestDir), CountryFile(kTestMwm), 1 /* version */);
+  ScopedDir const scopedDir(kTestDir);
+  ScopedFile const scopedMwm(base::JoinPath(kTestDir, kTestMwm + DATA_FILE_EXTENSION), ScopedFile::Mode::Create);
+  BuildMwm(roads, country);
+
+  string const mwmPath = scopedMwm.GetFullPath();
+  TestAltitudeGetter altitudeGetter;
+  BuildRoadAltitudes(mwmPath, altitudeGetter);
+
+  vector<pair<VehicleType, GeometryLoader::VehicleModelPtrT>> const models = {
+      {VehicleType::Pedestrian, PedestrianModelFactory().GetVehicleModelForCountry(kTestMwm)},
+      {VehicleType::Bicycle, BicycleModelFactory().GetVehicleModelForCountry(kTestMwm)},
+      {VehicleType::Car, CarModelFactory({} /* countryParentNameGetterFn */).GetVehicleModelForCountry(kTestMwm)},
+  };
+
+  // Roads of each vehicle type loaded from features, before the section is built. Routing loads
+  // roads of its vehicle only, other features are left invalid.
+  vector<vector<RoadGeometry>> expectedRoads(models.size());
+  {
+    FrozenDataSource dataSource;
+    auto const regResult = dataSource.RegisterMap(country);
+    TEST_EQUAL(regResult.second, MwmSet::RegResult::Success, ());
+    auto const handle = dataSource.GetMwmHandleById(regResult.first);
+    TEST(handle.IsAlive(), ());
+    TEST(!handle.GetValue()->m_cont.IsExist(ROUTING_GEOMETRY_FILE_TAG), ());
+
+    FeaturesLoaderGuard guard(dataSource, regResult.first);
+    uint32_t const featuresCount = guard.GetNumFeatures();
+    TEST_EQUAL(featuresCount, roads.size(), ());
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+      auto loader = GeometryLoader::Create(handle, models[i].second, models[i].first, true /* loadAltitudes */);
+      expectedRoads[i].resize(featuresCount);
+      for (uint32_t featureId = 0; featureId < featuresCount; ++featureId)
+      {
+        auto ft = guard.GetFeatureByIndex(featureId);
+        TEST(ft, (featureId));
+        if (models[i].second->IsRoad(feature::TypesHolder(*ft)))
+          loader->Load(featureId, expectedRoads[i][featureId]);
+      }
+    }
+  }
+
+  TEST(routing_builder::BuildRoutingGeometry(mwmPath, kTestMwm, {} /* countryParentNameGetterFn */), ());
+
+  FrozenDataSource dataSource;
+  auto const regResult = dataSource.RegisterMap(country);
+  TEST_EQUAL(regResult.second, MwmSet::RegResult::Success, ());
+  auto const handle = dataSource.GetMwmHandleById(regResult.first);
+  TEST(handle.IsAlive(), ());
+
+  size_t oneWayCount = 0;
+  for (size_t i = 0; i < models.size(); ++i)
+  {
+    auto const vehicleType = models[i].first;
+    auto const deserializer =
+        RoutingGeometryDeserializer::Load(handle.GetValue()->m_cont, vehicleType, models[i].second->GetHash());
+    TEST(deserializer, (vehicleType));
+
+    auto loader = GeometryLoader::Create(handle, models[i].second, vehicleType, true /* loadAltitudes */);
+    for (uint32_t featureId = 0; featureId < expectedRoads[i].size(); ++featureId)
+    {
+      auto const & expected = expectedRoads[i][featureId];
+
+      // Valid roads should be read from the section, not from the feature.
+      RoadGeometryAttrs attrs;
+      vector<m2::PointD> points;
+      TEST_EQUAL(deserializer->Get(featureId, attrs, points), expected.IsValid(), (vehicleType, featureId));
+      if (!expected.IsValid())
+        continue;
+
+      RoadGeometry road;
+      loader->Load(featureId, road);
+      TestRoadsEqual(expected, road, featureId);
+
+      if (vehicleType == VehicleType::Car && road.IsOneWay())
+        ++oneWayCount;
+      TEST_EQUAL(road.GetJunction(1).GetAltitude(), altitudeGetter.GetAltitude(points[1]), (vehicleType, featureId));
+    }
+  }
+
+  // The primary road and the roundabout.
+  TEST_EQUAL(oneWayCount, 2, ());
+
+  // Car roads of the section are not used with another vehicle model.
+  auto const & pedestrianModel = models[0].second;
+  TEST_NOT_EQUAL(pedestrianModel->GetHash(), models[2].second->GetHash(), ());
+  TEST(!RoutingGeometryDeserializer::Load(handle.GetValue()->m_cont, VehicleType::Car, pedestrianModel->GetHash()),
+       ());
+  auto loader = GeometryLoader::Create(handle, pedestrianModel, VehicleType::Car, true /* loadAltitudes */);
+  for (uint32_t featureId = 0; featureId < expectedRoads[0].size(); ++featureId)
+  {
+    if (!expectedRoads[0][featureId].IsValid())
+      continue;
+
+    RoadGeometry road;
+    loader->Load(featureId, road);
+    TestRoadsEqual(expectedRoads[0][featureId], road, featureId);
+  }
+}
+}  // namespace routing_geometry_serialization_tests
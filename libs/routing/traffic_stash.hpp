@@ -42,7 +42,7 @@ public:
   TrafficStash(traffic::TrafficCache const & source, std::shared_ptr<NumMwmIds> numMwmIds);
 
   traffic::SpeedGroup GetSpeedGroup(Segment const & segment) const;
-  void SetColoring(NumMwmId numMwmId, std::shared_ptr<const traffic::TrafficInfo::Coloring> coloring);
+  void SetColoring(NumMwmId numMwmId, std::shared_ptr<const traffic::TrafficInfo::PackedColoring> coloring);
   bool Has(NumMwmId numMwmId) const;
 
 private:
@@ -52,6 +52,6 @@ private:
 
   traffic::TrafficCache const & m_source;
   std::shared_ptr<NumMwmIds> m_numMwmIds;
-  std::unordered_map<NumMwmId, std::shared_ptr<const traffic::TrafficInfo::Coloring>> m_mwmToTraffic;
+  std::unordered_map<NumMwmId, std::shared_ptr<const traffic::TrafficInfo::PackedColoring>> m_mwmToTraffic;
 };
 }  // namespace routing
@@ -4,8 +4,10 @@
 #include "indexer/ftypes_matcher.hpp"
 
 #include "base/assert.hpp"
+#include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <sstream>
 
 namespace routing
@@ -24,6 +26,38 @@ SpeedKMpH Max(SpeedKMpH const & lhs, InOutCitySpeedKMpH const & rhs)
 {
   return Pick<max>(lhs, Pick<max>(rhs.m_inCity, rhs.m_outCity));
 }
+
+// Increase it when the way models calculate speeds or flags changes, so the hashes of
+// the models change even if their tables stay the same.
+uint64_t constexpr kModelCodeVersion = 0;
+
+// FNV-1a hash of 64-bit values which doesn't depend on the platform.
+class ModelHasher
+{
+public:
+  void Add(uint64_t value)
+  {
+    for (size_t i = 0; i < sizeof(value); ++i)
+    {
+      m_hash ^= (value >> (8 * i)) & 0xFF;
+      m_hash *= 1099511628211ULL;
+    }
+  }
+
+  void Add(double value) { Add(bit_cast<uint64_t>(value)); }
+
+  template <typename WeightAndETA>
+  void Add(WeightAndETA const & value)
+  {
+    Add(value.m_weight);
+    Add(value.m_eta);
+  }
+
+  uint64_t Get() const { return m_hash; }
+
+private:
+  uint64_t m_hash = 14695981039346656037ULL;
+};
 }  // namespace
 
 VehicleModel::VehicleModel(Classificator const & classif, LimitsInitList const & featureTypeLimits,
@@ -228,6 +262,47 @@ bool VehicleModel::IsPassThroughAllowed(FeatureTypes const & types) const
   return false;
 }
 
+uint64_t VehicleModel::GetHash() const
+{
+  ModelHasher hasher;
+  hasher.Add(kModelCodeVersion);
+  hasher.Add(uint64_t{m_yesType});
+  hasher.Add(uint64_t{m_noType});
+  hasher.Add(uint64_t{m_onewayType});
+  hasher.Add(m_maxModelSpeed);
+  hasher.Add(m_minSurfaceFactorForMaxspeed);
+
+  for (auto const & [type, speed] : m_highwayBasedInfo.m_speeds)
+  {
+    hasher.Add(uint64_t{base::Underlying(type)});
+    hasher.Add(speed.m_inCity);
+    hasher.Add(speed.m_outCity);
+  }
+  for (auto const & [type, factor] : m_highwayBasedInfo.m_factors)
+  {
+    hasher.Add(uint64_t{base::Underlying(type)});
+    hasher.Add(factor.m_inCity);
+    hasher.Add(factor.m_outCity);
+  }
+  for (auto const & [type, isPassThroughAllowed] : m_roadTypes)
+  {
+    hasher.Add(uint64_t{type});
+    hasher.Add(uint64_t{isPassThroughAllowed});
+  }
+  for (auto const & [type, factor] : m_surfaceFactors)
+  {
+    hasher.Add(uint64_t{type});
+    hasher.Add(factor);
+  }
+  for (auto const & [type, speed] : m_addRoadTypes)
+  {
+    hasher.Add(uint64_t{type});
+    hasher.Add(speed.m_inCity);
+    hasher.Add(speed.m_outCity);
+  }
+  return hasher.Get();
+}
+
 bool VehicleModel::IsRoadType(uint32_t type) const
 {
   ftype::TruncValue(type, 2);
@@ -6,6 +6,7 @@
 
 #include "base/small_map.hpp"
 
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <limits>
@@ -242,6 +243,11 @@ public:
   /// Roads with additional types e.g. "path = ferry", "vehicle_type = yes" considered as allowed
   /// to pass through.
   virtual bool IsPassThroughAllowed(FeatureTypes const & types) const = 0;
+
+  /// @returns hash of the parameters which the model calculates road speeds and flags with.
+  /// Road attributes calculated with one model may be used instead of another model's ones
+  /// only if the hashes of the models are equal.
+  virtual uint64_t GetHash() const = 0;
 };
 
 class VehicleModelFactoryInterface
@@ -298,6 +304,7 @@ public:
   bool IsOneWay(FeatureTypes const & types) const override;
   bool IsRoad(FeatureTypes const & types) const override;
   bool IsPassThroughAllowed(FeatureTypes const & types) const override;
+  uint64_t GetHash() const override;
   /// @}
 
   // Made public to have simple access from unit tests.
@@ -120,4 +120,13 @@ uint64_t CBV::Hash() const
     return kModulo;
   return coding::CompressedBitVectorHasher::Hash(*m_p) % kModulo;
 }
+
+void CBV::Serialize(Writer & writer) const
+{
+  CHECK(!IsFull(), ());
+  if (m_p)
+    m_p->SerializeWithStrategy(writer);
+  else
+    coding::SparseCBV().Serialize(writer);
+}
 }  // namespace search
@@ -53,6 +53,16 @@ public:
 
   uint64_t Hash() const;
 
+  // Writes non-full bit vector in CompressedBitVector format keeping its storage strategy.
+  // It's for in-process caches only, see CompressedBitVector::SerializeWithStrategy().
+  void Serialize(Writer & writer) const;
+
+  template <typename Source>
+  static CBV Deserialize(Source & src)
+  {
+    return CBV(coding::CompressedBitVectorBuilder::DeserializeFromSource(src));
+  }
+
 private:
   explicit CBV(bool full);
 
@@ -88,11 +88,20 @@ Engine::Engine(DataSource & dataSource, CategoriesHolder const & categories,
   categories.ForEachName(doInit);
   doInit.GetSuggests(m_suggests);
 
+  if (params.m_retrievalCacheSize != 0)
+  {
+    m_retrievalCache = make_shared<RetrievalCache>(
+        params.m_retrievalCacheSize, params.m_retrievalCacheSpillFile, params.m_retrievalCacheSpillSize);
+  }
+
   m_contexts.resize(params.m_numThreads);
   for (size_t i = 0; i < params.m_numThreads; ++i)
   {
     auto processor = make_unique<Processor>(dataSource, categories, m_suggests, infoGetter);
     processor->SetPreferredLocale(params.m_locale);
+    processor->SetRetrievalThreadsCount(params.m_numRetrievalThreads);
+    processor->SetAddressThreadsCount(params.m_numAddressThreads);
+    processor->SetRetrievalCache(m_retrievalCache);
     m_contexts[i].m_processor = std::move(processor);
   }
 
@@ -137,9 +146,16 @@ size_t Engine::GetNumThreads() const { return m_threads.size(); }
 
 void Engine::ClearCaches()
 {
+  if (m_retrievalCache)
+    m_retrievalCache->Clear();
   PostMessage(Message::TYPE_BROADCAST, [](Processor & processor) { processor.ClearCaches(); });
 }
 
+RetrievalCache::Stats Engine::GetRetrievalCacheStats() const
+{
+  return m_retrievalCache ? m_retrievalCache->GetStats() : RetrievalCache::Stats();
+}
+
 void Engine::CacheWorldLocalities()
 {
   PostMessage(Message::TYPE_BROADCAST,
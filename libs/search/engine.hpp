@@ -1,5 +1,6 @@
 #pragma once
 
+#include "search/retrieval_cache.hpp"
 #include "search/search_params.hpp"
 #include "search/suggest.hpp"
 
@@ -80,6 +81,22 @@ public:
     // to process queries. Use this field wisely as large values may
     // negatively affect performance due to false sharing.
     size_t m_numThreads;
+
+    // Number of threads each of query processing threads uses to retrieve
+    // features from several mwms in parallel. Zero means no extra threads.
+    size_t m_numRetrievalThreads = 0;
+
+    // Number of threads each of query processing threads uses to look up
+    // addresses of the emitted results in parallel. Zero means no extra threads.
+    size_t m_numAddressThreads = 0;
+
+    // Memory budget in bytes of the features cache shared by all query
+    // processing threads. Zero means that the cache is disabled.
+    size_t m_retrievalCacheSize = 0;
+    // Optional file for cached features which don't fit into the memory budget
+    // and its maximum size in bytes.
+    std::string m_retrievalCacheSpillFile;
+    uint64_t m_retrievalCacheSpillSize = 0;
   };
 
   // Doesn't take ownership of dataSource and categories.
@@ -99,6 +116,9 @@ public:
   // Posts request to clear caches to the queue.
   void ClearCaches();
 
+  // Returns statistics of the features cache, see Params::m_retrievalCacheSize.
+  RetrievalCache::Stats GetRetrievalCacheStats() const;
+
   // Posts requests to load and cache localities from World.mwm.
   void CacheWorldLocalities();
 
@@ -170,6 +190,9 @@ private:
 
   std::vector<Suggest> m_suggests;
 
+  // May be nullptr.
+  std::shared_ptr<RetrievalCache> m_retrievalCache;
+
   bool m_shutdown;
   std::mutex m_mu;
   std::condition_variable m_cv;
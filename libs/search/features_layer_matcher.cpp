@@ -65,13 +65,10 @@ std::vector<uint32_t> const & FeaturesLayerMatcher::GetPlaceAddrFeatures(
   auto const res = m_place2address.Get(placeId);
   if (res.second)
   {
-    auto & value = m_context->m_value;
-    if (!value.m_house2place)
-      value.m_house2place = LoadHouseToPlaceTable(value);
-
+    auto const & house2place = GetHouseToPlaceTable(m_context->m_value);
     fn().ForEach([&](uint32_t fid)
     {
-      auto const r = value.m_house2place->Get(fid);
+      auto const r = house2place.Get(fid);
       if (r && r->m_streetId == placeId)
         res.first.push_back(fid);
     });
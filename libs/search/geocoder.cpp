@@ -38,6 +38,9 @@
 #include "base/stl_helpers.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <future>
 
 #include "defines.hpp"
 
@@ -72,6 +75,28 @@ size_t constexpr kPostcodesRectsCacheSize = 10;
 size_t constexpr kSuburbsRectsCacheSize = 10;
 size_t constexpr kLocalityRectsCacheSize = 10;
 
+// Makes a key which identifies the search trie request for the |i|-th token
+// for all mwms. Request depends on the token and its synonyms, matched
+// categories and langs, see Geocoder::SetParams().
+string MakeRetrievalCacheKey(QueryParams const & params, size_t i)
+{
+  // Separators can't appear in tokens.
+  char constexpr kSep = '\0';
+
+  string key(1, params.IsPrefixToken(i) ? 'p' : 'f');
+  params.GetToken(i).ForOriginalAndSynonyms([&key](UniString const & s)
+  {
+    key += ToUtf8(s);
+    key += kSep;
+  });
+  key += kSep;
+  for (auto const index : params.GetTypeIndices(i))
+    key += std::to_string(index) + ',';
+  key += kSep;
+  for (auto const lang : params.GetLangs())
+    key += std::to_string(lang) + ',';
+  return key;
+}
 
 struct ScopedMarkTokens
 {
@@ -365,8 +390,11 @@ void Geocoder::SetParams(Params const & params)
 
   m_tokenRequests.clear();
   m_prefixTokenRequest.Clear();
+  m_retrievalCacheKeys.clear();
   for (size_t i = 0; i < m_params.GetNumTokens(); ++i)
   {
+    m_retrievalCacheKeys.push_back(MakeRetrievalCacheKey(m_params, i));
+
     if (!m_params.IsPrefixToken(i))
     {
       m_tokenRequests.emplace_back();
@@ -441,12 +469,24 @@ void Geocoder::ClearCaches()
   m_postcodes.Clear();
 }
 
+void Geocoder::SetRetrievalThreadsCount(size_t threadsCount)
+{
+  if (threadsCount == m_retrievalThreadsCount)
+    return;
+
+  m_retrievalPool.reset();
+  m_retrievalThreadsCount = threadsCount;
+  if (threadsCount != 0)
+    m_retrievalPool = make_unique<base::ComputationalThreadPool>(threadsCount);
+}
+
 void Geocoder::SetParamsForCategorialSearch(Params const & params)
 {
   m_params = params;
 
   m_tokenRequests.clear();
   m_prefixTokenRequest.Clear();
+  m_retrievalCacheKeys.clear();
 
   LOG(LDEBUG, (static_cast<QueryParams const &>(m_params)));
 }
@@ -581,9 +621,9 @@ void Geocoder::GoImpl(vector<MwmInfoPtr> const & infos, bool inViewport)
 
   // MatchAroundPivot() should always be matched in mwms
   // intersecting with position and viewport.
-  auto processCountry = [&](unique_ptr<MwmContext> context, bool updatePreranker) {
-    ASSERT(context, ());
-    m_context = std::move(context);
+  auto processCountry = [&](RetrievedMwm && mwm, bool updatePreranker) {
+    ASSERT(mwm.m_context, ());
+    m_context = std::move(mwm.m_context);
 
     SCOPE_GUARD(cleanup, [&]() {
       LOG(LDEBUG, (m_context->GetName(), "geocoding complete."));
@@ -604,7 +644,10 @@ void Geocoder::GoImpl(vector<MwmInfoPtr> const & infos, bool inViewport)
     m_matcher->SetContext(m_context.get());
 
     BaseContext ctx;
-    InitBaseContext(ctx);
+    if (mwm.m_features.empty())
+      InitBaseContext(ctx);
+    else
+      InitBaseContext(ctx, std::move(mwm.m_features));
 
     if (inViewport)
     {
@@ -650,11 +693,24 @@ void Geocoder::GoImpl(vector<MwmInfoPtr> const & infos, bool inViewport)
 
 void Geocoder::InitBaseContext(BaseContext & ctx)
 {
-  Retrieval retrieval(*m_context, m_cancellable);
+  InitBaseContext(ctx, RetrieveTokensFeatures(*m_context));
+}
+
+void Geocoder::InitBaseContext(BaseContext & ctx, vector<Retrieval::ExtendedFeatures> && features)
+{
+  ASSERT_EQUAL(features.size(), m_params.GetNumTokens(), ());
+
+  ctx.m_tokens.assign(features.size(), BaseContext::TOKEN_TYPE_COUNT);
+  ctx.m_features = std::move(features);
+  ctx.m_cuisineFilter = m_cuisineFilter.MakeScopedFilter(*m_context, m_params.m_cuisineTypes);
+}
+
+vector<Retrieval::ExtendedFeatures> Geocoder::RetrieveTokensFeatures(MwmContext const & context) const
+{
+  Retrieval retrieval(context, m_cancellable, m_retrievalCache.get());
 
   size_t const numTokens = m_params.GetNumTokens();
-  ctx.m_tokens.assign(numTokens, BaseContext::TOKEN_TYPE_COUNT);
-  ctx.m_features.resize(numTokens);
+  vector<Retrieval::ExtendedFeatures> features(numTokens);
   for (size_t i = 0; i < numTokens; ++i)
   {
     if (m_params.IsCategorialRequest())
@@ -662,19 +718,18 @@ void Geocoder::InitBaseContext(BaseContext & ctx)
       // Implementation-wise, the simplest way to match a feature by
       // its category bypassing the matching by name is by using a CategoriesCache.
       CategoriesCache cache(m_params.m_preferredTypes, m_cancellable);
-      ctx.m_features[i] = Retrieval::ExtendedFeatures(cache.Get(*m_context));
+      features[i] = Retrieval::ExtendedFeatures(cache.Get(context));
     }
     else if (m_params.IsPrefixToken(i))
     {
-      ctx.m_features[i] = retrieval.RetrieveAddressFeatures(m_prefixTokenRequest);
+      features[i] = retrieval.RetrieveAddressFeatures(m_prefixTokenRequest, m_retrievalCacheKeys[i]);
     }
     else
     {
-      ctx.m_features[i] = retrieval.RetrieveAddressFeatures(m_tokenRequests[i]);
+      features[i] = retrieval.RetrieveAddressFeatures(m_tokenRequests[i], m_retrievalCacheKeys[i]);
     }
   }
-
-  ctx.m_cuisineFilter = m_cuisineFilter.MakeScopedFilter(*m_context, m_params.m_cuisineTypes);
+  return features;
 }
 
 void Geocoder::InitLayer(Model::Type type, TokenRange const & tokenRange, FeaturesLayer & layer)
@@ -889,30 +944,86 @@ bool Geocoder::CityHasPostcode(BaseContext const & ctx) const
   return m_postcodes.Has(ctx.m_city->GetFeatureIndex(), ctx.m_city->m_featureId.IsWorld());
 }
 
+unique_ptr<MwmContext> Geocoder::MakeCountryContext(ExtendedMwmInfos::ExtendedMwmInfo const & info) const
+{
+  auto const type = info.m_info->GetType();
+  if (type != MwmInfo::COUNTRY && type != MwmInfo::WORLD)
+    return {};
+  if (type == MwmInfo::COUNTRY && m_params.m_mode == Mode::Downloader)
+    return {};
+
+  auto handle = m_dataSource.GetMwmHandleById(MwmSet::MwmId(info.m_info));
+  if (!handle.IsAlive())
+    return {};
+  auto & value = *handle.GetValue();
+  if (!value.HasSearchIndex() || !value.HasGeometryIndex())
+    return {};
+  return make_unique<MwmContext>(std::move(handle), info.m_type);
+}
+
 template <typename Fn>
 void Geocoder::ForEachCountry(ExtendedMwmInfos const & extendedInfos, Fn && fn)
 {
-  for (size_t i = 0; i < extendedInfos.m_infos.size(); ++i)
+  auto const & infos = extendedInfos.m_infos;
+  auto const isUpdatePreranker = [&extendedInfos](size_t i)
   {
-    auto const & info = extendedInfos.m_infos[i].m_info;
-    if (info->GetType() != MwmInfo::COUNTRY && info->GetType() != MwmInfo::WORLD)
-      continue;
-    if (info->GetType() == MwmInfo::COUNTRY && m_params.m_mode == Mode::Downloader)
-      continue;
+    return i + 1 >= extendedInfos.m_firstBatchSize;
+  };
 
-    auto handle = m_dataSource.GetMwmHandleById(MwmSet::MwmId(info));
-    if (!handle.IsAlive())
-      continue;
-    auto & value = *handle.GetValue();
-    if (!value.HasSearchIndex() || !value.HasGeometryIndex())
-      continue;
-    bool const updatePreranker = i + 1 >= extendedInfos.m_firstBatchSize;
-    auto const & mwmType = extendedInfos.m_infos[i].m_type;
-    if (fn(make_unique<MwmContext>(std::move(handle), mwmType), updatePreranker) ==
-        base::ControlFlow::Break)
+  if (!m_retrievalPool)
+  {
+    for (size_t i = 0; i < infos.size(); ++i)
     {
-      break;
+      RetrievedMwm mwm;
+      mwm.m_context = MakeCountryContext(infos[i]);
+      if (mwm.m_context && fn(std::move(mwm), isUpdatePreranker(i)) == base::ControlFlow::Break)
+        break;
     }
+    return;
+  }
+
+  // Retrieval for the next mwms is started in advance, but mwms are passed to |fn| strictly
+  // in the |infos| order, so the results are the same as for the single threaded search.
+  // Every mwm handle is used by one thread at a time. Each retrieval thread has its own
+  // Retrieval and all the caches are used on the caller's thread only.
+  atomic<bool> stopped = false;
+  deque<future<RetrievedMwm>> retrieved;
+  size_t nextIdx = 0;
+  auto const retrieveNext = [&]()
+  {
+    auto const & info = infos[nextIdx++];
+    retrieved.push_back(m_retrievalPool->Submit([this, &info, &stopped]()
+    {
+      RetrievedMwm mwm;
+      if (stopped)
+        return mwm;
+
+      mwm.m_context = MakeCountryContext(info);
+      if (mwm.m_context)
+        mwm.m_features = RetrieveTokensFeatures(*mwm.m_context);
+      return mwm;
+    }));
+  };
+
+  // Pending tasks refer to |this| and |infos|, so they must be finished on break or exception.
+  SCOPE_GUARD(waitRetrieval, [&]()
+  {
+    stopped = true;
+    for (auto & result : retrieved)
+      result.wait();
+  });
+
+  for (size_t i = 0; i < infos.size(); ++i)
+  {
+    while (nextIdx < infos.size() && retrieved.size() < m_retrievalThreadsCount + 1)
+      retrieveNext();
+
+    // Rethrows CancelException from the retrieval thread.
+    auto mwm = retrieved.front().get();
+    retrieved.pop_front();
+
+    if (mwm.m_context && fn(std::move(mwm), isUpdatePreranker(i)) == base::ControlFlow::Break)
+      break;
   }
 }
 
@@ -17,6 +17,7 @@
 #include "search/mwm_context.hpp"
 #include "search/postcode_points.hpp"
 #include "search/query_params.hpp"
+#include "search/retrieval_cache.hpp"
 #include "search/streets_matcher.hpp"
 #include "search/token_range.hpp"
 #include "search/tracer.hpp"
@@ -29,10 +30,12 @@
 #include "base/cancellable.hpp"
 #include "base/dfa_helpers.hpp"
 #include "base/levenshtein_dfa.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include <map>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 class CategoriesHolder;
@@ -127,6 +130,14 @@ public:
   void CacheWorldLocalities();
   void ClearCaches();
 
+  // Sets the number of worker threads which retrieve features from the next mwms while
+  // the current one is matched. Zero means that everything is done on the caller's thread.
+  void SetRetrievalThreadsCount(size_t threadsCount);
+
+  // Sets the cache of features retrieved from search indices which is kept between
+  // queries and may be shared with other geocoders. |cache| may be nullptr.
+  void SetRetrievalCache(std::shared_ptr<RetrievalCache> cache) { m_retrievalCache = std::move(cache); }
+
 private:
   enum class RectId
   {
@@ -156,6 +167,13 @@ private:
     size_t m_firstBatchSize = 0;
   };
 
+  // Mwm context with features retrieved for each query token.
+  struct RetrievedMwm
+  {
+    std::unique_ptr<MwmContext> m_context;
+    std::vector<Retrieval::ExtendedFeatures> m_features;
+  };
+
   struct Postcodes
   {
     void Clear()
@@ -192,6 +210,11 @@ private:
   // Creates a cache of posting lists corresponding to features in m_context
   // for each token and saves it to m_addressFeatures.
   void InitBaseContext(BaseContext & ctx);
+  void InitBaseContext(BaseContext & ctx, std::vector<Retrieval::ExtendedFeatures> && features);
+
+  // Retrieves features from |context| for each query token.
+  // Uses only query params and may be called from retrieval threads.
+  std::vector<Retrieval::ExtendedFeatures> RetrieveTokensFeatures(MwmContext const & context) const;
 
   void InitLayer(Model::Type type, TokenRange const & tokenRange, FeaturesLayer & layer);
 
@@ -204,6 +227,11 @@ private:
 
   bool CityHasPostcode(BaseContext const & ctx) const;
 
+  // Returns nullptr if the mwm is not alive or can't be searched.
+  std::unique_ptr<MwmContext> MakeCountryContext(ExtendedMwmInfos::ExtendedMwmInfo const & info) const;
+
+  // Calls |fn| for searchable mwms in the |infos| order. When retrieval threads are set, features
+  // for the next mwms are retrieved in parallel with |fn| calls.
   template <typename Fn>
   void ForEachCountry(ExtendedMwmInfos const & infos, Fn && fn);
 
@@ -371,9 +399,16 @@ private:
   // Search query params prepared for retrieval.
   std::vector<SearchTrieRequest<strings::LevenshteinDFA>> m_tokenRequests;
   SearchTrieRequest<strings::PrefixDFAModifier<strings::LevenshteinDFA>> m_prefixTokenRequest;
+  // Keys of token requests in |m_retrievalCache|.
+  std::vector<std::string> m_retrievalCacheKeys;
+  std::shared_ptr<RetrievalCache> m_retrievalCache;
 
   ResultTracer m_resultTracer;
 
   PreRanker & m_preRanker;
+
+  // Pool for features retrieval from the next mwms, may be nullptr.
+  std::unique_ptr<base::ComputationalThreadPool> m_retrievalPool;
+  size_t m_retrievalThreadsCount = 0;
 };
 }  // namespace search
@@ -16,6 +16,7 @@
 
 #include "defines.hpp"
 
+#include <mutex>
 #include <vector>
 
 namespace search
@@ -24,6 +25,9 @@ using namespace std;
 
 namespace
 {
+// Guards the tables which are lazily loaded into MwmValue.
+mutex g_houseTablesMutex;
+
 class EliasFanoMap : public HouseToStreetTable
 {
 public:
@@ -52,6 +56,8 @@ public:
   // HouseToStreetTable overrides:
   std::optional<Result> Get(uint32_t houseId) const override
   {
+    // The map caches decoded blocks and the table may be used by several address lookup threads.
+    lock_guard lock(m_mutex);
     uint32_t fID;
     if (!m_map->Get(houseId, fID))
       return {};
@@ -61,6 +67,7 @@ public:
 private:
   unique_ptr<Reader> m_reader;
   unique_ptr<Map> m_map;
+  mutable mutex m_mutex;
 };
 
 class DummyTable : public HouseToStreetTable
@@ -111,6 +118,22 @@ std::unique_ptr<HouseToStreetTable> LoadHouseToPlaceTable(MwmValue const & value
   return LoadHouseTableImpl(value, FEATURE2PLACE_FILE_TAG);
 }
 
+HouseToStreetTable const & GetHouseToStreetTable(MwmValue & value)
+{
+  lock_guard lock(g_houseTablesMutex);
+  if (!value.m_house2street)
+    value.m_house2street = LoadHouseToStreetTable(value);
+  return *value.m_house2street;
+}
+
+HouseToStreetTable const & GetHouseToPlaceTable(MwmValue & value)
+{
+  lock_guard lock(g_houseTablesMutex);
+  if (!value.m_house2place)
+    value.m_house2place = LoadHouseToPlaceTable(value);
+  return *value.m_house2place;
+}
+
 // HouseToStreetTableBuilder -----------------------------------------------------------------------
 void HouseToStreetTableBuilder::Put(uint32_t houseId, uint32_t streetId)
 {
@@ -13,6 +13,11 @@ namespace search
 std::unique_ptr<HouseToStreetTable> LoadHouseToStreetTable(MwmValue const & value);
 std::unique_ptr<HouseToStreetTable> LoadHouseToPlaceTable(MwmValue const & value);
 
+// Return the tables cached in |value|, loading them on the first call.
+// The tables may be requested for the same mwm from several threads.
+HouseToStreetTable const & GetHouseToStreetTable(MwmValue & value);
+HouseToStreetTable const & GetHouseToPlaceTable(MwmValue & value);
+
 class HouseToStreetTableBuilder
 {
 public:
@@ -18,7 +18,8 @@ void CoverRect(m2::RectD const & rect, int scale, covering::Intervals & result)
 MwmContext::MwmContext(MwmSet::MwmHandle handle)
   : m_handle(std::move(handle))
   , m_value(*m_handle.GetValue())
-  , m_vector(m_value.m_cont, m_value.GetHeader(), m_value.m_table.get(), m_value.m_metaDeserializer.get())
+  , m_vector(m_value.m_cont, m_value.GetHeader(), m_value.m_table.get(), m_value.m_metaDeserializer.get(),
+             m_value.m_mappedFeatures.get())
   , m_index(m_value.m_cont.GetReader(INDEX_FILE_TAG), m_value.m_factory)
   , m_centers(m_value)
   , m_editableSource(m_handle)
@@ -59,10 +60,7 @@ std::optional<uint32_t> MwmContext::GetStreet(uint32_t index) const
   if (feature::FakeFeatureIds::IsEditorCreatedFeature(index))
     return {};
 
-  if (!m_value.m_house2street)
-    m_value.m_house2street = LoadHouseToStreetTable(m_value);
-
-  auto const res = m_value.m_house2street->Get(index);
+  auto const res = GetHouseToStreetTable(m_value).Get(index);
   if (res)
   {
     ASSERT(res->m_type == HouseToStreetTable::StreetIdType::FeatureId, ());
@@ -63,6 +63,9 @@ public:
   void SetPreferredLocale(std::string const & locale);
   void SetInputLocale(std::string const & locale);
   void SetQuery(std::string const & query, bool categorialRequest = false);
+  void SetRetrievalThreadsCount(size_t threadsCount) { m_geocoder.SetRetrievalThreadsCount(threadsCount); }
+  void SetRetrievalCache(std::shared_ptr<RetrievalCache> cache) { m_geocoder.SetRetrievalCache(std::move(cache)); }
+  void SetAddressThreadsCount(size_t threadsCount) { m_ranker.SetAddressThreadsCount(threadsCount); }
 
   inline bool IsEmptyQuery() const { return m_query.IsEmpty(); }
 
@@ -21,6 +21,7 @@
 
 #include "coding/string_utf8_multilang.hpp"
 
+#include "base/exception.hpp"
 #include "base/logging.hpp"
 #include "base/string_utils.hpp"
 
@@ -308,6 +309,14 @@ string FormatStreetAndHouse(ReverseGeocoder::Address const & addr)
   return addr.GetStreetName() + ", " + feature::GetReadableAddress(addr.GetHouseNumber());
 }
 
+ReverseGeocoder::Address LookupAddress(ReverseGeocoder const & coder, RankerResult const & result)
+{
+  ReverseGeocoder::Address addr;
+  if (!(result.GetID().IsValid() && coder.GetExactAddress(result.GetID(), addr)))
+    coder.GetNearbyAddress(result.GetCenter(), addr);
+  return addr;
+}
+
 // TODO: Share common formatting code for search results and place page.
 string FormatFullAddress(ReverseGeocoder::Address const & addr, string const & region)
 {
@@ -712,7 +721,7 @@ Ranker::Ranker(DataSource const & dataSource, CitiesBoundariesTable const & boun
                Emitter & emitter, CategoriesHolder const & categories,
                vector<Suggest> const & suggests, VillagesCache & villagesCache,
                base::Cancellable const & cancellable)
-  : m_reverseGeocoder(dataSource)
+  : m_reverseGeocoder(dataSource, &m_streetsCache)
   , m_cancellable(cancellable)
   , m_keywordsScorer(keywordsScorer)
   , m_localities(dataSource, boundariesTable, villagesCache)
@@ -730,6 +739,8 @@ void Ranker::Init(Params const & params, Geocoder::Params const & geocoderParams
   m_geocoderParams = geocoderParams;
   m_preRankerResults.clear();
   m_tentativeResults.clear();
+  m_prefetchedAddresses.clear();
+  m_streetsCache.Clear();
 }
 
 void Ranker::Finish(bool cancelled)
@@ -748,13 +759,7 @@ Result Ranker::MakeResult(RankerResult const & rankerResult, bool needAddress, b
 
     // Format full address only for suitable results.
     if (ftypes::IsAddressObjectChecker::Instance()(rankerResult.GetTypes()))
-    {
-      ReverseGeocoder::Address addr;
-      if (!(rankerResult.GetID().IsValid() && m_reverseGeocoder.GetExactAddress(rankerResult.GetID(), addr)))
-        m_reverseGeocoder.GetNearbyAddress(rankerResult.GetCenter(), addr);
-
-      address = FormatFullAddress(addr, address);
-    }
+      address = FormatFullAddress(GetAddress(rankerResult), address);
 
     res.SetAddress(std::move(address));
   }
@@ -852,6 +857,7 @@ void Ranker::UpdateResults(bool lastUpdate)
   // Emit feature results.
   size_t count = m_emitter.GetResults().GetCount();
   size_t i = 0;
+  size_t prefetchedEnd = 0;
   for (; i < m_tentativeResults.size(); ++i)
   {
     if (!lastUpdate && count >= m_params.m_batchSize && !m_params.m_viewportSearch &&
@@ -874,6 +880,20 @@ void Ranker::UpdateResults(bool lastUpdate)
     if (count >= m_params.m_limit)
       break;
 
+    if (m_params.m_needAddress && i == prefetchedEnd)
+    {
+      // Addresses are looked up in batches, only for the results which are going to be
+      // emitted before the next Emit(). Results rejected as duplicates shift the batch.
+      size_t toEmit = m_params.m_limit - count;
+      if (m_params.m_batchSize != 0)
+        toEmit = min(toEmit, m_params.m_batchSize - count % m_params.m_batchSize);
+      prefetchedEnd = min(m_tentativeResults.size(), i + toEmit);
+      PrefetchAddresses(i, prefetchedEnd);
+
+      if (!lastUpdate)
+        BailIfCancelled();
+    }
+
     auto const & rankerResult = m_tentativeResults[i];
 
     /// @DebugNote
@@ -907,7 +927,22 @@ void Ranker::UpdateResults(bool lastUpdate)
   }
 }
 
-void Ranker::ClearCaches() { m_localities.ClearCache(); }
+void Ranker::ClearCaches()
+{
+  m_localities.ClearCache();
+  m_streetsCache.Clear();
+}
+
+void Ranker::SetAddressThreadsCount(size_t threadsCount)
+{
+  if (threadsCount == m_addressThreadsCount)
+    return;
+
+  m_addressPool.reset();
+  m_addressThreadsCount = threadsCount;
+  if (threadsCount != 0)
+    m_addressPool = make_unique<base::ComputationalThreadPool>(threadsCount);
+}
 
 void Ranker::SetLocale(string const & locale)
 {
@@ -1034,6 +1069,64 @@ void Ranker::ProcessSuggestions(vector<RankerResult> const & vec) const
   }
 }
 
+void Ranker::PrefetchAddresses(size_t begin, size_t end)
+{
+  vector<RankerResult const *> results;
+  for (size_t i = begin; i < end; ++i)
+  {
+    auto const & r = m_tentativeResults[i];
+    if (r.GetID().IsValid() && ftypes::IsAddressObjectChecker::Instance()(r.GetTypes()) &&
+        m_prefetchedAddresses.count(r.GetID()) == 0)
+    {
+      results.push_back(&r);
+    }
+  }
+
+  vector<ReverseGeocoder::Address> addresses(results.size());
+  auto const lookup = [&](size_t i)
+  {
+    if (m_cancellable.IsCancelled())
+      return;
+
+    try
+    {
+      addresses[i] = LookupAddress(m_reverseGeocoder, *results[i]);
+    }
+    catch (RootException const & e)
+    {
+      LOG(LWARNING, ("Can't get address of", results[i]->GetID(), e.Msg()));
+    }
+  };
+
+  // Features may be read from several threads only with the concurrent backend,
+  // see FeatureSource::IsThreadSafe().
+  if (m_addressPool && results.size() > 1 &&
+      m_dataSource.GetFeaturesBackend() == feature::FeaturesBackend::Concurrent)
+  {
+    base::ParallelFor(m_addressPool->GetPool(), 0, results.size(), lookup);
+  }
+  else
+  {
+    for (size_t i = 0; i < results.size(); ++i)
+      lookup(i);
+  }
+
+  // Addresses of the cancelled lookups are not valid.
+  if (m_cancellable.IsCancelled())
+    return;
+
+  for (size_t i = 0; i < results.size(); ++i)
+    m_prefetchedAddresses.emplace(results[i]->GetID(), std::move(addresses[i]));
+}
+
+ReverseGeocoder::Address Ranker::GetAddress(RankerResult const & result) const
+{
+  auto const it = m_prefetchedAddresses.find(result.GetID());
+  if (it != m_prefetchedAddresses.end())
+    return it->second;
+  return LookupAddress(m_reverseGeocoder, result);
+}
+
 string Ranker::GetLocalizedRegionInfoForResult(RankerResult const & result) const
 {
   auto const type = result.GetBestType(&m_params.m_preferredTypes);
@@ -15,8 +15,11 @@
 #include "geometry/rect2d.hpp"
 
 #include "base/string_utils.hpp"
+#include "base/thread_pool_computational.hpp"
 
 #include <algorithm>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -90,6 +93,10 @@ public:
 
   void ClearCaches();
 
+  // Sets the number of threads which look up addresses of the results of one batch in parallel.
+  // Zero means that addresses are looked up on the caller's thread.
+  void SetAddressThreadsCount(size_t threadsCount);
+
   void BailIfCancelled() { ::search::BailIfCancelled(m_cancellable); }
 
   void SetLocale(std::string const & locale);
@@ -108,8 +115,15 @@ private:
 
   std::string GetLocalizedRegionInfoForResult(RankerResult const & result) const;
 
+  // Looks up addresses of the address objects among m_tentativeResults[begin, end).
+  // Lookups run on the address threads when the features may be read concurrently.
+  void PrefetchAddresses(size_t begin, size_t end);
+  ReverseGeocoder::Address GetAddress(RankerResult const & result) const;
+
   Params m_params;
   Geocoder::Params m_geocoderParams;
+  // Streets of buildings are valid within a query, the cache is cleared in Init().
+  ReverseGeocoder::StreetsCache m_streetsCache;
   ReverseGeocoder const m_reverseGeocoder;
   base::Cancellable const & m_cancellable;
   KeywordLangMatcher & m_keywordsScorer;
@@ -125,5 +139,12 @@ private:
 
   std::vector<PreRankerResult> m_preRankerResults;
   std::vector<RankerResult> m_tentativeResults;
+
+  // Addresses of the results which are going to be emitted, cleared in Init().
+  std::map<FeatureID, ReverseGeocoder::Address> m_prefetchedAddresses;
+
+  // Pool for address lookups, may be nullptr.
+  std::unique_ptr<base::ComputationalThreadPool> m_addressPool;
+  size_t m_addressThreadsCount = 0;
 };
 }  // namespace search
@@ -3,6 +3,7 @@
 #include "search/cancel_exception.hpp"
 #include "search/feature_offset_match.hpp"
 #include "search/mwm_context.hpp"
+#include "search/retrieval_cache.hpp"
 #include "search/search_index_header.hpp"
 #include "search/search_index_values.hpp"
 #include "search/token_slice.hpp"
@@ -96,6 +97,8 @@ public:
     m_created = editor.GetFeaturesByStatus(id, FeatureStatus::Created);
   }
 
+  bool IsEmpty() const { return m_deleted.empty() && m_modified.empty() && m_created.empty(); }
+
   bool ModifiedOrDeleted(uint32_t featureIndex) const
   {
     return binary_search(m_deleted.begin(), m_deleted.end(), featureIndex) ||
@@ -242,19 +245,53 @@ template <typename Value, typename DFA>
 Retrieval::ExtendedFeatures RetrieveAddressFeaturesImpl(Retrieval::TrieRoot<Value> const & root,
                                                         MwmContext const & context,
                                                         base::Cancellable const & cancellable,
-                                                        SearchTrieRequest<DFA> const & request)
+                                                        SearchTrieRequest<DFA> const & request,
+                                                        RetrievalCache * cache,
+                                                        string const & cacheKey)
 {
   EditedFeaturesHolder holder(context.GetId());
   vector<uint64_t> features;
   vector<uint64_t> exactlyMatchedFeatures;
-  FeaturesCollector collector(cancellable, features, exactlyMatchedFeatures);
 
-  MatchFeaturesInTrie(
-      request, root,
-      [&holder](Value const & value) {
-        return !holder.ModifiedOrDeleted(base::asserted_cast<uint32_t>(value.m_featureId));
-      } /* filter */,
-      collector);
+  if (cache && !cacheKey.empty())
+  {
+    // Edits may change between queries, so features from the search index
+    // are cached as is and edited features are filtered after that.
+    RetrievalCache::Key const key(context.GetId(), cacheKey);
+    Retrieval::ExtendedFeatures indexFeatures;
+    if (!cache->Get(key, indexFeatures))
+    {
+      FeaturesCollector collector(cancellable, features, exactlyMatchedFeatures);
+      MatchFeaturesInTrie(
+          request, root, [](Value const & /* value */) { return true; } /* filter */, collector);
+      indexFeatures =
+          SortFeaturesAndBuildResult(std::move(features), std::move(exactlyMatchedFeatures));
+      cache->Put(key, indexFeatures);
+    }
+
+    if (holder.IsEmpty())
+      return indexFeatures;
+
+    features.clear();
+    exactlyMatchedFeatures.clear();
+    indexFeatures.ForEach([&](uint32_t index, bool exactMatch) {
+      if (holder.ModifiedOrDeleted(index))
+        return;
+      features.emplace_back(index);
+      if (exactMatch)
+        exactlyMatchedFeatures.emplace_back(index);
+    });
+  }
+  else
+  {
+    FeaturesCollector collector(cancellable, features, exactlyMatchedFeatures);
+    MatchFeaturesInTrie(
+        request, root,
+        [&holder](Value const & value) {
+          return !holder.ModifiedOrDeleted(base::asserted_cast<uint32_t>(value.m_featureId));
+        } /* filter */,
+        collector);
+  }
 
   holder.ForEachModifiedOrCreated([&](EditableMapObject const & emo, uint64_t index) {
     auto const matched = MatchFeatureByNameAndType(emo, request);
@@ -347,8 +384,12 @@ unique_ptr<Retrieval::TrieRoot<Value>> ReadTrie(ModelReaderPtr & reader)
 }
 }  // namespace
 
-Retrieval::Retrieval(MwmContext const & context, base::Cancellable const & cancellable)
-  : m_context(context), m_cancellable(cancellable), m_reader(unique_ptr<ModelReader>())
+Retrieval::Retrieval(MwmContext const & context, base::Cancellable const & cancellable,
+                     RetrievalCache * cache)
+  : m_context(context)
+  , m_cancellable(cancellable)
+  , m_cache(cache)
+  , m_reader(unique_ptr<ModelReader>())
 {
   auto const & value = context.m_value;
 
@@ -376,27 +417,27 @@ Retrieval::Retrieval(MwmContext const & context, base::Cancellable const & cance
 }
 
 Retrieval::ExtendedFeatures Retrieval::RetrieveAddressFeatures(
-    SearchTrieRequest<UniStringDFA> const & request) const
+    SearchTrieRequest<UniStringDFA> const & request, string const & cacheKey) const
 {
-  return Retrieve<RetrieveAddressFeaturesAdaptor>(request);
+  return Retrieve<RetrieveAddressFeaturesAdaptor>(request, m_cache, cacheKey);
 }
 
 Retrieval::ExtendedFeatures Retrieval::RetrieveAddressFeatures(
-    SearchTrieRequest<PrefixDFAModifier<UniStringDFA>> const & request) const
+    SearchTrieRequest<PrefixDFAModifier<UniStringDFA>> const & request, string const & cacheKey) const
 {
-  return Retrieve<RetrieveAddressFeaturesAdaptor>(request);
+  return Retrieve<RetrieveAddressFeaturesAdaptor>(request, m_cache, cacheKey);
 }
 
 Retrieval::ExtendedFeatures Retrieval::RetrieveAddressFeatures(
-    SearchTrieRequest<LevenshteinDFA> const & request) const
+    SearchTrieRequest<LevenshteinDFA> const & request, string const & cacheKey) const
 {
-  return Retrieve<RetrieveAddressFeaturesAdaptor>(request);
+  return Retrieve<RetrieveAddressFeaturesAdaptor>(request, m_cache, cacheKey);
 }
 
 Retrieval::ExtendedFeatures Retrieval::RetrieveAddressFeatures(
-    SearchTrieRequest<PrefixDFAModifier<LevenshteinDFA>> const & request) const
+    SearchTrieRequest<PrefixDFAModifier<LevenshteinDFA>> const & request, string const & cacheKey) const
 {
-  return Retrieve<RetrieveAddressFeaturesAdaptor>(request);
+  return Retrieve<RetrieveAddressFeaturesAdaptor>(request, m_cache, cacheKey);
 }
 
 Retrieval::Features Retrieval::RetrievePostcodeFeatures(TokenSlice const & slice) const
@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 
 class MwmValue;
@@ -25,6 +26,7 @@ class MwmValue;
 namespace search
 {
 class MwmContext;
+class RetrievalCache;
 class TokenSlice;
 
 class Retrieval
@@ -86,20 +88,28 @@ public:
     Features m_exactMatchingFeatures;
   };
 
-  Retrieval(MwmContext const & context, base::Cancellable const & cancellable);
+  // |cache| may be nullptr.
+  Retrieval(MwmContext const & context, base::Cancellable const & cancellable,
+            RetrievalCache * cache = nullptr);
 
   // Following functions retrieve all features matching to |request| from the search index.
+  // When |cacheKey| is not empty, features from the search index are cached by it, so
+  // the same key must always be used for the same request.
   ExtendedFeatures RetrieveAddressFeatures(
-      SearchTrieRequest<strings::UniStringDFA> const & request) const;
+      SearchTrieRequest<strings::UniStringDFA> const & request,
+      std::string const & cacheKey = {}) const;
 
   ExtendedFeatures RetrieveAddressFeatures(
-      SearchTrieRequest<strings::PrefixDFAModifier<strings::UniStringDFA>> const & request) const;
+      SearchTrieRequest<strings::PrefixDFAModifier<strings::UniStringDFA>> const & request,
+      std::string const & cacheKey = {}) const;
 
   ExtendedFeatures RetrieveAddressFeatures(
-      SearchTrieRequest<strings::LevenshteinDFA> const & request) const;
+      SearchTrieRequest<strings::LevenshteinDFA> const & request,
+      std::string const & cacheKey = {}) const;
 
   ExtendedFeatures RetrieveAddressFeatures(
-      SearchTrieRequest<strings::PrefixDFAModifier<strings::LevenshteinDFA>> const & request) const;
+      SearchTrieRequest<strings::PrefixDFAModifier<strings::LevenshteinDFA>> const & request,
+      std::string const & cacheKey = {}) const;
 
   // Retrieves all postcodes matching to |slice| from the search index.
   Features RetrievePostcodeFeatures(TokenSlice const & slice) const;
@@ -113,6 +123,7 @@ private:
 
   MwmContext const & m_context;
   base::Cancellable const & m_cancellable;
+  RetrievalCache * m_cache;
   ModelReaderPtr m_reader;
 
   std::unique_ptr<TrieRoot<Uint64IndexValue>> m_root;
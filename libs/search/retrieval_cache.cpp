@@ -0,0 +1,247 @@
+#include "search/retrieval_cache.hpp"
+
+#include "search/cbv.hpp"
+
+#include "coding/file_writer.hpp"
+#include "coding/internal/file_data.hpp"
+#include "coding/mmap_reader.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/assert.hpp"
+#include "base/exception.hpp"
+#include "base/logging.hpp"
+
+#include <sstream>
+
+namespace search
+{
+using namespace std;
+
+namespace
+{
+void Serialize(Retrieval::ExtendedFeatures const & features, vector<uint8_t> & data)
+{
+  MemWriter<vector<uint8_t>> writer(data);
+  features.m_features.Serialize(writer);
+  features.m_exactMatchingFeatures.Serialize(writer);
+}
+
+Retrieval::ExtendedFeatures Deserialize(vector<uint8_t> const & data)
+{
+  MemReader reader(data.data(), data.size());
+  ReaderSource<MemReader> src(reader);
+  auto features = CBV::Deserialize(src);
+  auto exactMatchingFeatures = CBV::Deserialize(src);
+  return Retrieval::ExtendedFeatures(std::move(features), std::move(exactMatchingFeatures));
+}
+}  // namespace
+
+// RetrievalCache::Stats ---------------------------------------------------------------------------
+double RetrievalCache::Stats::GetHitRate() const
+{
+  auto const hits = m_memoryHits + m_spillHits;
+  auto const total = hits + m_misses;
+  return total == 0 ? 0.0 : static_cast<double>(hits) / total;
+}
+
+// RetrievalCache ----------------------------------------------------------------------------------
+RetrievalCache::RetrievalCache(size_t memoryBudget, string const & spillFileName,
+                               uint64_t spillBudget)
+  : m_memoryBudget(memoryBudget), m_spillFileName(spillFileName), m_spillBudget(spillBudget)
+{
+}
+
+RetrievalCache::~RetrievalCache()
+{
+  lock_guard<mutex> lock(m_mutex);
+  ResetSpill();
+}
+
+bool RetrievalCache::Get(Key const & key, Retrieval::ExtendedFeatures & features)
+{
+  Data data;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    auto const it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+      ++m_stats.m_misses;
+      return false;
+    }
+
+    auto & entry = it->second;
+    if (entry.m_inMemory)
+    {
+      m_lru.splice(m_lru.begin(), m_lru, entry.m_lruIt);
+      data = entry.m_data;
+      ++m_stats.m_memoryHits;
+    }
+    else
+    {
+      if (!ReadSpilled(entry, data))
+      {
+        m_entries.erase(it);
+        ++m_stats.m_misses;
+        return false;
+      }
+
+      AddToMemory(key, entry, Data(data));
+      ++m_stats.m_spillHits;
+      Shrink();
+    }
+  }
+
+  features = Deserialize(data);
+  return true;
+}
+
+void RetrievalCache::Put(Key const & key, Retrieval::ExtendedFeatures const & features)
+{
+  Data data;
+  Serialize(features, data);
+
+  lock_guard<mutex> lock(m_mutex);
+  auto & entry = m_entries[key];
+  if (entry.m_inMemory && !entry.m_data.empty())
+  {
+    // The same features were put by another thread.
+    m_lru.splice(m_lru.begin(), m_lru, entry.m_lruIt);
+    return;
+  }
+
+  AddToMemory(key, entry, std::move(data));
+  Shrink();
+}
+
+void RetrievalCache::Clear()
+{
+  lock_guard<mutex> lock(m_mutex);
+  m_entries.clear();
+  m_lru.clear();
+  m_memorySize = 0;
+  ResetSpill();
+}
+
+RetrievalCache::Stats RetrievalCache::GetStats() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_stats;
+}
+
+size_t RetrievalCache::GetMemorySize() const
+{
+  lock_guard<mutex> lock(m_mutex);
+  return m_memorySize;
+}
+
+void RetrievalCache::AddToMemory(Key const & key, Entry & entry, Data && data)
+{
+  ASSERT(!data.empty(), ());
+  if (!entry.m_inMemory || entry.m_data.empty())
+  {
+    m_lru.push_front(key);
+    entry.m_lruIt = m_lru.begin();
+  }
+
+  entry.m_data = std::move(data);
+  entry.m_inMemory = true;
+  m_memorySize += entry.m_data.size();
+}
+
+bool RetrievalCache::ReadSpilled(Entry const & entry, Data & data)
+{
+  ASSERT(!entry.m_inMemory, ());
+  try
+  {
+    if (!m_spillReader || m_spillReader->Size() < entry.m_spillOffset + entry.m_spillSize)
+    {
+      CHECK(m_spillWriter, ());
+      m_spillWriter->Flush();
+      m_spillReader = make_unique<MmapReader>(m_spillFileName, MmapReader::Advice::Random);
+    }
+
+    data.resize(static_cast<size_t>(entry.m_spillSize));
+    m_spillReader->Read(entry.m_spillOffset, data.data(), data.size());
+    return true;
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Can't read retrieval cache spill file", m_spillFileName, e.Msg()));
+    return false;
+  }
+}
+
+bool RetrievalCache::Spill(Entry & entry)
+{
+  if (m_spillFileName.empty() || entry.m_data.size() > m_spillBudget)
+    return false;
+
+  try
+  {
+    if (m_spillWriter && m_spillWriter->Size() + entry.m_data.size() > m_spillBudget)
+      ResetSpill();
+
+    if (!m_spillWriter)
+      m_spillWriter = make_unique<FileWriter>(m_spillFileName);
+
+    entry.m_spillOffset = m_spillWriter->Size();
+    entry.m_spillSize = entry.m_data.size();
+    m_spillWriter->Write(entry.m_data.data(), entry.m_data.size());
+  }
+  catch (RootException const & e)
+  {
+    LOG(LWARNING, ("Can't write retrieval cache spill file", m_spillFileName, e.Msg()));
+    return false;
+  }
+
+  entry.m_inMemory = false;
+  entry.m_data = {};
+  return true;
+}
+
+void RetrievalCache::Shrink()
+{
+  while (m_memorySize > m_memoryBudget && !m_lru.empty())
+  {
+    auto const it = m_entries.find(m_lru.back());
+    CHECK(it != m_entries.end(), ());
+    m_lru.pop_back();
+
+    auto & entry = it->second;
+    ASSERT(entry.m_inMemory, ());
+    ASSERT_GREATER_OR_EQUAL(m_memorySize, entry.m_data.size(), ());
+    m_memorySize -= entry.m_data.size();
+
+    if (!Spill(entry))
+      m_entries.erase(it);
+  }
+}
+
+void RetrievalCache::ResetSpill()
+{
+  for (auto it = m_entries.begin(); it != m_entries.end();)
+  {
+    if (it->second.m_inMemory)
+      ++it;
+    else
+      it = m_entries.erase(it);
+  }
+
+  m_spillReader.reset();
+  if (!m_spillWriter)
+    return;
+
+  m_spillWriter.reset();
+  base::DeleteFileX(m_spillFileName);
+}
+
+string DebugPrint(RetrievalCache::Stats const & stats)
+{
+  ostringstream os;
+  os << "RetrievalCache::Stats [ memoryHits: " << stats.m_memoryHits
+     << ", spillHits: " << stats.m_spillHits << ", misses: " << stats.m_misses
+     << ", hitRate: " << stats.GetHitRate() << " ]";
+  return os.str();
+}
+}  // namespace search
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "search/retrieval.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class FileWriter;
+class MmapReader;
+
+namespace search
+{
+// This class represents a cross-query cache of features retrieved from
+// search indices. Entries are keyed by mwm and by a string which
+// identifies a search trie request for all mwms (see Geocoder for
+// details). Features are kept serialized, so every Get() returns its
+// own copy of bit vectors and the cache may be shared by several
+// query processing threads.
+//
+// Least recently used entries which don't fit into |memoryBudget| are
+// moved to the spill file, if it's set, and are read back via mmap.
+// The spill file is truncated when it exceeds |spillBudget| and it's
+// removed on destruction.
+//
+// *NOTE* This class is thread-safe.
+class RetrievalCache
+{
+public:
+  using Key = std::pair<MwmSet::MwmId, std::string>;
+
+  struct Stats
+  {
+    double GetHitRate() const;
+
+    uint64_t m_memoryHits = 0;
+    uint64_t m_spillHits = 0;
+    uint64_t m_misses = 0;
+  };
+
+  RetrievalCache(size_t memoryBudget, std::string const & spillFileName = {},
+                 uint64_t spillBudget = 0);
+  ~RetrievalCache();
+
+  // Returns true and fills |features| if there is an entry for |key|.
+  bool Get(Key const & key, Retrieval::ExtendedFeatures & features);
+
+  void Put(Key const & key, Retrieval::ExtendedFeatures const & features);
+
+  void Clear();
+
+  Stats GetStats() const;
+  size_t GetMemorySize() const;
+
+private:
+  using Data = std::vector<uint8_t>;
+
+  struct Entry
+  {
+    // Serialized features when the entry is in memory.
+    Data m_data;
+    bool m_inMemory = true;
+    std::list<Key>::iterator m_lruIt;
+
+    // Position in the spill file when the entry is spilled.
+    uint64_t m_spillOffset = 0;
+    uint64_t m_spillSize = 0;
+  };
+
+  void AddToMemory(Key const & key, Entry & entry, Data && data);
+  bool ReadSpilled(Entry const & entry, Data & data);
+  bool Spill(Entry & entry);
+  void Shrink();
+  void ResetSpill();
+
+  size_t const m_memoryBudget;
+  std::string const m_spillFileName;
+  uint64_t const m_spillBudget;
+
+  mutable std::mutex m_mutex;
+  std::map<Key, Entry> m_entries;
+  // The most recently used in-memory entries are at the front.
+  std::list<Key> m_lru;
+  size_t m_memorySize = 0;
+
+  std::unique_ptr<FileWriter> m_spillWriter;
+  std::unique_ptr<MmapReader> m_spillReader;
+
+  Stats m_stats;
+};
+
+std::string DebugPrint(RetrievalCache::Stats const & stats);
+}  // namespace search
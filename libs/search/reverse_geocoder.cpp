@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <mutex>
 
 
 namespace search
@@ -75,7 +76,10 @@ std::string const & GetHouseNumber(FeatureType & ft)
 
 }  // namespace
 
-ReverseGeocoder::ReverseGeocoder(DataSource const & dataSource) : m_dataSource(dataSource) {}
+ReverseGeocoder::ReverseGeocoder(DataSource const & dataSource, StreetsCache * streetsCache)
+  : m_dataSource(dataSource), m_streetsCache(streetsCache)
+{
+}
 
 template <class ObjT, class FilterT>
 vector<ObjT> GetNearbyObjects(search::MwmContext & context, m2::PointD const & center,
@@ -217,17 +221,55 @@ bool ReverseGeocoder::GetExactAddress(FeatureID const & fid, Address & addr) con
 bool ReverseGeocoder::GetNearbyAddress(HouseTable & table, Building const & bld, bool ignoreEdits,
                                        Address & addr) const
 {
-  string street;
-  if (!ignoreEdits && osm::Editor::Instance().GetEditedFeatureStreet(bld.m_id, street))
+  string editedStreet;
+  if (!ignoreEdits && osm::Editor::Instance().GetEditedFeatureStreet(bld.m_id, editedStreet))
   {
     addr.m_building = bld;
-    addr.m_street.m_name = street;
+    addr.m_street.m_name = editedStreet;
     return true;
   }
 
+  optional<Street> street;
+  if (m_streetsCache)
+  {
+    auto const key = make_pair(bld.m_id, table.IsPlaceAsStreet());
+    bool cached = false;
+    {
+      lock_guard lock(m_streetsCache->m_mutex);
+      auto const it = m_streetsCache->m_streets.find(key);
+      if (it != m_streetsCache->m_streets.end())
+      {
+        street = it->second;
+        cached = true;
+      }
+    }
+
+    // Two threads may look up the same building at once, it's cheaper than locking the lookup.
+    if (!cached)
+    {
+      street = GetBuildingStreet(table, bld);
+      lock_guard lock(m_streetsCache->m_mutex);
+      m_streetsCache->m_streets.emplace(key, street);
+    }
+  }
+  else
+  {
+    street = GetBuildingStreet(table, bld);
+  }
+
+  if (!street)
+    return false;
+
+  addr.m_building = bld;
+  addr.m_street = std::move(*street);
+  return true;
+}
+
+optional<ReverseGeocoder::Street> ReverseGeocoder::GetBuildingStreet(HouseTable & table, Building const & bld) const
+{
   auto const res = table.Get(bld.m_id);
   if (!res)
-    return false;
+    return {};
 
   switch (res->m_type)
   {
@@ -238,27 +280,23 @@ bool ReverseGeocoder::GetNearbyAddress(HouseTable & table, Building const & bld,
 //    // Get streets without squares and suburbs for backward compatibility with data.
 //    GetNearbyStreetsWaysOnly(bld.m_id.m_mwmId, bld.m_center, streets);
 //    if (res->m_streetId < streets.size())
-//    {
-//      addr.m_building = bld;
-//      addr.m_street = streets[res->m_streetId];
-//      return true;
-//    }
+//      return streets[res->m_streetId];
 //    LOG(LWARNING, ("Out of bound street index", res->m_streetId, "for", bld.m_id));
-//    return false;
+//    return {};
 //  }
   case HouseToStreetTable::StreetIdType::FeatureId:
   {
     FeatureID streetFeature(bld.m_id.m_mwmId, res->m_streetId);
     CHECK(bld.m_id.m_mwmId.IsAlive(), (bld.m_id.m_mwmId));
-    m_dataSource.ReadFeature([&bld, &addr](FeatureType & ft)
+    Street street;
+    m_dataSource.ReadFeature([&bld, &street](FeatureType & ft)
     {
       double distance = feature::GetMinDistanceMeters(ft, bld.m_center);
-      addr.m_street = Street(ft.GetID(), distance, ft.GetReadableName(), ft.GetNames());
+      street = Street(ft.GetID(), distance, ft.GetReadableName(), ft.GetNames());
     }, streetFeature);
 
-    CHECK(!addr.m_street.m_multilangName.IsEmpty(), (bld.m_id.m_mwmId, res->m_streetId));
-    addr.m_building = bld;
-    return true;
+    CHECK(!street.m_multilangName.IsEmpty(), (bld.m_id.m_mwmId, res->m_streetId));
+    return street;
   }
   default:
   {
@@ -355,20 +393,19 @@ std::optional<HouseToStreetTable::Result> ReverseGeocoder::HouseTable::Get(Featu
     m_handle = std::move(handle);
   }
 
-  auto value = m_handle.GetValue();
-  if (!value->m_house2street)
-    value->m_house2street = LoadHouseToStreetTable(*value);
-
-  auto res = value->m_house2street->Get(fid.m_index);
+  auto & value = *m_handle.GetValue();
+  auto res = GetHouseToStreetTable(value).Get(fid.m_index);
   if (!res && m_placeAsStreet)
-  {
-    if (!value->m_house2place)
-      value->m_house2place = LoadHouseToPlaceTable(*value);
-    res = value->m_house2place->Get(fid.m_index);
-  }
+    res = GetHouseToPlaceTable(value).Get(fid.m_index);
   return res;
 }
 
+void ReverseGeocoder::StreetsCache::Clear()
+{
+  lock_guard lock(m_mutex);
+  m_streets.clear();
+}
+
 string ReverseGeocoder::Address::FormatAddress() const
 {
   // Check whether we can format address according to the query type
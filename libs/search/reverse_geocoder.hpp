@@ -7,7 +7,9 @@
 
 #include "coding/string_utf8_multilang.hpp"
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -28,7 +30,12 @@ class RegionInfoGetter;
 
 class ReverseGeocoder
 {
+public:
+  class StreetsCache;
+
+private:
   DataSource const & m_dataSource;
+  StreetsCache * m_streetsCache;
 
   struct Object
   {
@@ -51,7 +58,8 @@ public:
   /// All "Nearby" functions work in this lookup radius.
   static int constexpr kLookupRadiusM = 500;
 
-  explicit ReverseGeocoder(DataSource const & dataSource);
+  /// |streetsCache| is optional and is not owned by ReverseGeocoder.
+  explicit ReverseGeocoder(DataSource const & dataSource, StreetsCache * streetsCache = nullptr);
 
   struct Street : public Object
   {
@@ -95,6 +103,23 @@ public:
     std::string FormatAddress() const;
   };
 
+  /// Memoizes streets of buildings, so the addresses of several objects in the same building
+  /// don't read the house-to-street table and the street feature again.
+  /// Streets from the editor are not cached. It's safe to use the cache from several threads.
+  class StreetsCache
+  {
+  public:
+    /// Should be called when mwms or edits may have changed, e.g. before a new search query.
+    void Clear();
+
+  private:
+    friend class ReverseGeocoder;
+
+    std::mutex m_mutex;
+    // Key is a building and whether places are used as streets, nullopt means no street.
+    std::map<std::pair<FeatureID, bool>, std::optional<Street>> m_streets;
+  };
+
   struct RegionAddress
   {
     // CountryId is set in case when FeatureID is not found or belongs to World.wmw
@@ -171,6 +196,8 @@ private:
     }
     std::optional<HouseToStreetTable::Result> Get(FeatureID const & fid);
 
+    bool IsPlaceAsStreet() const { return m_placeAsStreet; }
+
   private:
     DataSource const & m_dataSource;
     MwmSet::MwmHandle m_handle;
@@ -180,6 +207,7 @@ private:
   /// Ignores changes from editor if |ignoreEdits| is true.
   bool GetNearbyAddress(HouseTable & table, Building const & bld, bool ignoreEdits,
                         Address & addr) const;
+  std::optional<Street> GetBuildingStreet(HouseTable & table, Building const & bld) const;
 
   /// @return Sorted by distance houses vector with valid house number.
   void GetNearbyBuildings(m2::PointD const & center, double maxDistanceM,
@@ -3709,4 +3709,142 @@ UNIT_CLASS_TEST(ProcessorTest, Numeric_POI_Name)
   }
 }
 
+UNIT_CLASS_TEST(ProcessorTest, ParallelRetrieval)
+{
+  TestCafe cafe1({0.0, 0.1}, "Sherlock", "en");
+  TestCafe cafe2({5.0, 5.0}, "Sherlock", "en");
+  TestCafe cafe3({10.0, 10.0}, "Sherlock", "en");
+
+  auto const wonderlandId = BuildCountry("Wonderland", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(cafe1);
+  });
+  auto const neverlandId = BuildCountry("Neverland", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(cafe2);
+  });
+  auto const ozId = BuildCountry("Oz", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(cafe3);
+  });
+
+  Engine::Params params;
+  params.m_numRetrievalThreads = 2;
+  TestSearchEngine parallelEngine(m_dataSource, params, true /* mockCountryInfo */);
+  auto & infoGetter = dynamic_cast<storage::CountryInfoGetterForTesting &>(parallelEngine.GetCountryInfoGetter());
+  for (auto const & id : {wonderlandId, neverlandId, ozId})
+    infoGetter.AddCountry(storage::CountryDef(id.GetInfo()->GetCountryName(), id.GetInfo()->m_bordersRect));
+
+  SetViewport(m2::RectD(-1.0, -1.0, 1.0, 1.0));
+
+  TestSearchRequest serial(m_engine, "Sherlock", "en", Mode::Everywhere, m_viewport);
+  serial.Run();
+  TestSearchRequest parallel(parallelEngine, "Sherlock", "en", Mode::Everywhere, m_viewport);
+  parallel.Run();
+
+  Rules const rules = {ExactMatch(wonderlandId, cafe1), ExactMatch(neverlandId, cafe2), ExactMatch(ozId, cafe3)};
+  TEST(ResultsMatch(parallel.Results(), rules), ());
+
+  // Mwms are matched in the same order, so results are the same as for the single threaded search.
+  TEST_EQUAL(serial.Results().size(), parallel.Results().size(), ());
+  for (size_t i = 0; i < serial.Results().size(); ++i)
+    TEST_EQUAL(serial.Results()[i].GetFeatureID(), parallel.Results()[i].GetFeatureID(), (i));
+}
+
+UNIT_CLASS_TEST(ProcessorTest, RetrievalCache)
+{
+  TestCafe cafe({0.0, 0.1}, "Sherlock", "en");
+
+  auto const wonderlandId = BuildCountry("Wonderland", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(cafe);
+  });
+
+  Engine::Params params;
+  params.m_retrievalCacheSize = 1024 * 1024;
+  TestSearchEngine engine(m_dataSource, params, true /* mockCountryInfo */);
+  auto & infoGetter = dynamic_cast<storage::CountryInfoGetterForTesting &>(engine.GetCountryInfoGetter());
+  infoGetter.AddCountry(storage::CountryDef(wonderlandId.GetInfo()->GetCountryName(),
+                                            wonderlandId.GetInfo()->m_bordersRect));
+
+  SetViewport(m2::RectD(-1.0, -1.0, 1.0, 1.0));
+
+  auto const search = [&](string const & query)
+  {
+    TestSearchRequest request(engine, query, "en", Mode::Everywhere, m_viewport);
+    request.Run();
+    return request.Results();
+  };
+
+  Rules const rules = {ExactMatch(wonderlandId, cafe)};
+  TEST(ResultsMatch(search("Sherlock "), rules), ());
+  TEST_EQUAL(engine.GetRetrievalCacheStats().m_memoryHits, 0, ());
+
+  // The same token is retrieved from the cache.
+  TEST(ResultsMatch(search("Sherlock "), rules), ());
+  TEST_GREATER(engine.GetRetrievalCacheStats().m_memoryHits, 0, ());
+
+  // Prefix and full tokens are different requests.
+  auto const hits = engine.GetRetrievalCacheStats().m_memoryHits;
+  TEST(ResultsMatch(search("Sherlock"), rules), ());
+  TEST_EQUAL(engine.GetRetrievalCacheStats().m_memoryHits, hits, ());
+}
+
+UNIT_CLASS_TEST(ProcessorTest, ParallelAddresses)
+{
+  // Features are read from several threads only with the concurrent backend.
+  m_dataSource.SetFeaturesBackend(feature::FeaturesBackend::Concurrent);
+
+  string const lang = "default";
+  string const streetName = "Baker street";
+  double constexpr coord = 0.01;
+
+  TestStreet street({{-coord, -coord}, {coord, coord}}, streetName, lang);
+
+  vector<TestPOI> cafes;
+  for (int i = 0; i < 5; ++i)
+  {
+    double const d = -coord / 2 + i * coord / 5;
+    cafes.emplace_back(m2::PointD(d, d), "Sherlock", "en");
+    cafes.back().SetTypes({{"amenity", "cafe"}});
+    cafes.back().SetHouseNumber(strings::to_string(221 + i));
+    cafes.back().SetStreetName(streetName);
+  }
+
+  auto const wonderlandId = BuildCountry("Wonderland", [&](TestMwmBuilder & builder)
+  {
+    builder.Add(street);
+    for (auto const & cafe : cafes)
+      builder.Add(cafe);
+  });
+
+  Engine::Params params;
+  params.m_numAddressThreads = 2;
+  TestSearchEngine parallelEngine(m_dataSource, params, true /* mockCountryInfo */);
+  auto & infoGetter = dynamic_cast<storage::CountryInfoGetterForTesting &>(parallelEngine.GetCountryInfoGetter());
+  infoGetter.AddCountry(storage::CountryDef(wonderlandId.GetInfo()->GetCountryName(),
+                                            wonderlandId.GetInfo()->m_bordersRect));
+
+  SetViewport(m2::RectD(-coord, -coord, coord, coord));
+
+  TestSearchRequest serial(m_engine, "Sherlock", "en", Mode::Everywhere, m_viewport);
+  serial.Run();
+  TestSearchRequest parallel(parallelEngine, "Sherlock", "en", Mode::Everywhere, m_viewport);
+  parallel.Run();
+
+  Rules rules;
+  for (auto const & cafe : cafes)
+    rules.push_back(ExactMatch(wonderlandId, cafe));
+  TEST(ResultsMatch(parallel.Results(), rules), ());
+
+  TEST_EQUAL(serial.Results().size(), parallel.Results().size(), ());
+  for (size_t i = 0; i < serial.Results().size(); ++i)
+  {
+    auto const & address = parallel.Results()[i].GetAddress();
+    TEST_EQUAL(serial.Results()[i].GetFeatureID(), parallel.Results()[i].GetFeatureID(), (i));
+    TEST_EQUAL(serial.Results()[i].GetAddress(), address, (i));
+    TEST(address.find(streetName) != string::npos, (address));
+  }
+}
+
 } // namespace processor_test
@@ -0,0 +1,110 @@
+#include "testing/testing.hpp"
+
+#include "search/cbv.hpp"
+#include "search/retrieval.hpp"
+#include "search/retrieval_cache.hpp"
+
+#include "indexer/mwm_set.hpp"
+
+#include "platform/platform.hpp"
+
+#include "coding/compressed_bit_vector.hpp"
+
+#include "base/math.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace retrieval_cache_tests
+{
+using namespace search;
+using namespace std;
+
+Retrieval::ExtendedFeatures MakeFeatures(vector<uint64_t> const & features,
+                                         vector<uint64_t> const & exactlyMatchedFeatures)
+{
+  using Builder = coding::CompressedBitVectorBuilder;
+  return Retrieval::ExtendedFeatures(CBV(Builder::FromBitPositions(features)),
+                                     CBV(Builder::FromBitPositions(exactlyMatchedFeatures)));
+}
+
+vector<uint64_t> ToVector(CBV const & cbv)
+{
+  vector<uint64_t> result;
+  cbv.ForEach([&result](uint64_t id) { result.push_back(id); });
+  return result;
+}
+
+void TestFeatures(RetrievalCache & cache, RetrievalCache::Key const & key,
+                  vector<uint64_t> const & features, vector<uint64_t> const & exactlyMatchedFeatures)
+{
+  Retrieval::ExtendedFeatures cached;
+  TEST(cache.Get(key, cached), (key.second));
+  TEST_EQUAL(ToVector(cached.m_features), features, (key.second));
+  TEST_EQUAL(ToVector(cached.m_exactMatchingFeatures), exactlyMatchedFeatures, (key.second));
+}
+
+UNIT_TEST(RetrievalCache_Smoke)
+{
+  RetrievalCache cache(1000000 /* memoryBudget */);
+  RetrievalCache::Key const london(MwmSet::MwmId(), "london");
+  RetrievalCache::Key const paris(MwmSet::MwmId(), "paris");
+
+  Retrieval::ExtendedFeatures features;
+  TEST(!cache.Get(london, features), ());
+
+  cache.Put(london, MakeFeatures({1, 5, 7}, {5}));
+  cache.Put(paris, MakeFeatures({}, {}));
+  TestFeatures(cache, london, {1, 5, 7}, {5});
+  TestFeatures(cache, paris, {}, {});
+
+  auto const stats = cache.GetStats();
+  TEST_EQUAL(stats.m_memoryHits, 2, ());
+  TEST_EQUAL(stats.m_spillHits, 0, ());
+  TEST_EQUAL(stats.m_misses, 1, ());
+  TEST(AlmostEqualAbs(stats.GetHitRate(), 2.0 / 3.0, 1e-9), ());
+
+  cache.Clear();
+  TEST(!cache.Get(london, features), ());
+  TEST_EQUAL(cache.GetMemorySize(), 0, ());
+}
+
+UNIT_TEST(RetrievalCache_Spill)
+{
+  vector<RetrievalCache::Key> keys;
+  for (size_t i = 0; i < 10; ++i)
+    keys.emplace_back(MwmSet::MwmId(), "token" + to_string(i));
+
+  auto const makeFeatures = [](size_t i) { return MakeFeatures({i, 100 + i, 1000 + i}, {i}); };
+
+  // The memory budget is enough for one entry only.
+  auto const spillFile = GetPlatform().TmpPathForFile("retrieval_cache_spill");
+  RetrievalCache cache(60 /* memoryBudget */, spillFile, 1000000 /* spillBudget */);
+  for (size_t i = 0; i < keys.size(); ++i)
+    cache.Put(keys[i], makeFeatures(i));
+  TEST_LESS_OR_EQUAL(cache.GetMemorySize(), 60, ());
+
+  for (size_t i = 0; i < keys.size(); ++i)
+    TestFeatures(cache, keys[i], {i, 100 + i, 1000 + i}, {i});
+
+  auto const stats = cache.GetStats();
+  TEST_GREATER(stats.m_spillHits, 0, ());
+  TEST_EQUAL(stats.m_memoryHits + stats.m_spillHits, keys.size(), ());
+  TEST_EQUAL(stats.m_misses, 0, ());
+}
+
+UNIT_TEST(RetrievalCache_NoSpill)
+{
+  RetrievalCache cache(60 /* memoryBudget */);
+  RetrievalCache::Key const first(MwmSet::MwmId(), "first");
+  RetrievalCache::Key const second(MwmSet::MwmId(), "second");
+
+  cache.Put(first, MakeFeatures({1, 1000, 100000}, {1}));
+  cache.Put(second, MakeFeatures({4, 1000, 100000}, {}));
+
+  Retrieval::ExtendedFeatures features;
+  TEST(!cache.Get(first, features), ());
+  TestFeatures(cache, second, {4, 1000, 100000}, {});
+}
+}  // namespace retrieval_cache_tests
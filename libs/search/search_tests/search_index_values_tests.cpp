@@ -0,0 +1,120 @@
+#include "testing/testing.hpp"
+
+#include "search/search_index_values.hpp"
+
+#include "indexer/trie.hpp"
+#include "indexer/trie_builder.hpp"
+#include "indexer/trie_reader.hpp"
+
+#include "coding/byte_stream.hpp"
+#include "coding/compressed_bit_vector.hpp"
+#include "coding/reader.hpp"
+#include "coding/writer.hpp"
+
+#include "base/string_utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace search_index_values_tests
+{
+using namespace std;
+
+using Value = Uint64IndexValue;
+using Key = strings::UniString;
+
+// Clustered feature ids which span a large range, ChunkedCBV is chosen for them in memory.
+vector<uint64_t> MakeClusteredIds()
+{
+  vector<uint64_t> ids;
+  for (uint64_t i = 0; i < 5000; ++i)
+    ids.push_back(i);
+  for (uint64_t i = 0; i < 30000; ++i)
+    ids.push_back(1000 * coding::ChunkedCBV::kChunkSize + i * 2);
+  return ids;
+}
+
+vector<uint64_t> ToIds(ValueList<Value> const & values)
+{
+  vector<uint64_t> ids;
+  values.ForEach([&ids](Value const & v) { ids.push_back(v.m_featureId); });
+  return ids;
+}
+
+UNIT_TEST(ValueList_SerializesDenseOrSparse)
+{
+  auto const ids = MakeClusteredIds();
+  vector<Value> values;
+  for (auto const id : ids)
+    values.emplace_back(id);
+
+  ValueList<Value> list;
+  list.Init(values);
+
+  SingleValueSerializer<Value> serializer;
+  vector<uint8_t> buf;
+  {
+    PushBackByteSink<vector<uint8_t>> sink(buf);
+    list.Serialize(sink, serializer);
+  }
+
+  // The search index keeps the format which is known to all app versions:
+  // the bytes are the same as the sparse bit vector gives for these ids.
+  vector<uint8_t> expected;
+  {
+    MemWriter<vector<uint8_t>> writer(expected);
+    coding::SparseCBV(ids).Serialize(writer);
+  }
+  TEST_EQUAL(buf, expected, ());
+
+  MemReader reader(buf.data(), buf.size());
+  ReaderSource<MemReader> src(reader);
+  ValueList<Value> read;
+  read.Deserialize(src, serializer);
+  TEST_EQUAL(ToIds(read), ids, ());
+}
+
+UNIT_TEST(ValueList_TrieRoundTrip)
+{
+  auto const clustered = MakeClusteredIds();
+  vector<uint64_t> dense;
+  for (uint64_t i = 0; i < 2000; ++i)
+    dense.push_back(i * 2);
+
+  Key const keyA(1, 'a');
+  Key const keyB(1, 'b');
+
+  // Pairs are added in the sorted order as the search index builder does.
+  vector<pair<Key, Value>> data;
+  for (auto const id : clustered)
+    data.emplace_back(keyA, Value(id));
+  for (auto const id : dense)
+    data.emplace_back(keyB, Value(id));
+
+  SingleValueSerializer<Value> serializer;
+  vector<uint8_t> buf;
+  {
+    PushBackByteSink<vector<uint8_t>> sink(buf);
+    trie::Build<PushBackByteSink<vector<uint8_t>>, Key, ValueList<Value>, SingleValueSerializer<Value>>(
+        sink, serializer, data);
+  }
+  // Trie nodes are written from the leaves, the reader expects them from the root.
+  reverse(buf.begin(), buf.end());
+
+  MemReader reader(buf.data(), buf.size());
+  auto const root = trie::ReadTrie<MemReader, ValueList<Value>>(reader, serializer);
+  TEST(root, ());
+  TEST(root->m_values.IsEmpty(), ());
+  TEST_EQUAL(root->m_edges.size(), 2, ());
+
+  for (size_t i = 0; i < root->m_edges.size(); ++i)
+  {
+    auto const & label = root->m_edges[i].m_label;
+    TEST_EQUAL(label.size(), 1, ());
+    auto const child = root->GoToEdge(i);
+    TEST_EQUAL(ToIds(child->m_values), label[0] == 'a' ? clustered : dense, (i));
+  }
+}
+}  // namespace search_index_values_tests
@@ -29,6 +29,8 @@ public:
 
   std::weak_ptr<ProcessorHandle> Search(SearchParams const & params);
 
+  RetrievalCache::Stats GetRetrievalCacheStats() const { return m_engine.GetRetrievalCacheStats(); }
+
   storage::CountryInfoGetter & GetCountryInfoGetter() { return *m_infoGetter; }
 
 private:
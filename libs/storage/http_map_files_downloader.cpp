@@ -44,37 +44,46 @@ void HttpMapFilesDownloader::Download(QueuedCountry && queuedCountry)
 
   m_queue.Append(std::move(queuedCountry));
 
-  if (m_queue.Count() == 1)
-    Download();
+  Download();
 }
 
 void HttpMapFilesDownloader::Download()
 {
   CHECK_THREAD_CHECKER(m_checker, ());
 
-  auto const & queuedCountry = m_queue.GetFirstCountry();
-
-  auto const urls = MakeUrlList(queuedCountry.GetRelativeUrl());
-  auto const path = queuedCountry.GetFileDownloadPath();
-  auto const size = queuedCountry.GetDownloadSize();
-
-  m_request.reset();
-
-  if (IsDownloadingAllowed())
+  while (m_requests.size() < GetMaxConcurrentDownloads())
   {
+    QueuedCountry const * next = nullptr;
+    m_queue.ForEachCountry([this, &next](QueuedCountry const & country)
+    {
+      if (next == nullptr && m_requests.count(country.GetCountryId()) == 0)
+        next = &country;
+    });
+
+    if (next == nullptr)
+      return;
+
+    auto const & queuedCountry = *next;
+    auto const urls = MakeUrlList(queuedCountry.GetRelativeUrl());
+    auto const path = queuedCountry.GetFileDownloadPath();
+    auto const size = queuedCountry.GetDownloadSize();
+
+    if (!IsDownloadingAllowed())
+    {
+      ErrorHttpRequest error(path);
+      auto const copy = queuedCountry;
+      // Downloading of the rest of the queue is started from there.
+      OnMapFileDownloaded(copy, error);
+      return;
+    }
+
     queuedCountry.OnStartDownloading();
 
-    m_request.reset(downloader::HttpRequest::GetFile(
+    m_requests[queuedCountry.GetCountryId()].reset(downloader::HttpRequest::GetFile(
         urls, path, size,
         std::bind(&HttpMapFilesDownloader::OnMapFileDownloaded, this, queuedCountry, _1),
         std::bind(&HttpMapFilesDownloader::OnMapFileDownloadingProgress, this, queuedCountry, _1)));
   }
-  else
-  {
-    ErrorHttpRequest error(path);
-    auto const copy = queuedCountry;
-    OnMapFileDownloaded(copy, error);
-  }
 }
 
 void HttpMapFilesDownloader::Remove(CountryId const & id)
@@ -86,13 +95,10 @@ void HttpMapFilesDownloader::Remove(CountryId const & id)
   if (!m_queue.Contains(id))
     return;
 
-  if (m_request && m_queue.GetFirstId() == id)
-    m_request.reset();
-
+  m_requests.erase(id);
   m_queue.Remove(id);
 
-  if (!m_queue.IsEmpty() && !m_request)
-    Download();
+  Download();
 }
 
 void HttpMapFilesDownloader::Clear()
@@ -101,7 +107,7 @@ void HttpMapFilesDownloader::Clear()
 
   MapFilesDownloader::Clear();
 
-  m_request.reset();
+  m_requests.clear();
   m_queue.Clear();
 }
 
@@ -121,17 +127,24 @@ void HttpMapFilesDownloader::OnMapFileDownloaded(QueuedCountry const & queuedCou
   CHECK_THREAD_CHECKER(m_checker, ());
   // Because this method is called deferred on original thread,
   // it is possible the country is already removed from queue.
-  if (m_queue.IsEmpty() || m_queue.GetFirstId() != queuedCountry.GetCountryId())
+  auto const id = queuedCountry.GetCountryId();
+  if (!m_queue.Contains(id))
     return;
 
-  m_queue.PopFront();
+  m_queue.Remove(id);
 
-  queuedCountry.OnDownloadFinished(request.GetStatus());
+  // |request| owns |queuedCountry| and calls this method, so it's destroyed at the very end.
+  // The country may be queued and started again from OnDownloadFinished.
+  std::unique_ptr<downloader::HttpRequest> finished;
+  if (auto const it = m_requests.find(id); it != m_requests.end())
+  {
+    finished = std::move(it->second);
+    m_requests.erase(it);
+  }
 
-  m_request.reset();
+  queuedCountry.OnDownloadFinished(request.GetStatus(), request.GetSha1());
 
-  if (!m_queue.IsEmpty())
-    Download();
+  Download();
 }
 
 void HttpMapFilesDownloader::OnMapFileDownloadingProgress(QueuedCountry const & queuedCountry,
@@ -140,7 +153,7 @@ void HttpMapFilesDownloader::OnMapFileDownloadingProgress(QueuedCountry const &
   CHECK_THREAD_CHECKER(m_checker, ());
   // Because of this method calls deferred on original thread,
   // it is possible the country is already removed from queue.
-  if (m_queue.IsEmpty() || m_queue.GetFirstId() != queuedCountry.GetCountryId())
+  if (!m_queue.Contains(queuedCountry.GetCountryId()))
     return;
 
   queuedCountry.OnDownloadProgress(request.GetProgress());
@@ -8,6 +8,7 @@
 #include "base/thread_checker.hpp"
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -16,6 +17,8 @@ namespace storage
 {
 /// This class encapsulates HTTP requests for receiving server lists
 /// and file downloading.
+/// Up to GetMaxConcurrentDownloads() countries from the head of the queue are downloaded
+/// at the same time.
 //
 // *NOTE*, this class is not thread-safe.
 class HttpMapFilesDownloader : public MapFilesDownloader
@@ -32,13 +35,14 @@ private:
   // MapFilesDownloader overrides:
   void Download(QueuedCountry && queuedCountry) override;
 
+  // Starts downloading of the queued countries while there are free slots.
   void Download();
 
   void OnMapFileDownloaded(QueuedCountry const & queuedCountry, downloader::HttpRequest & request);
   void OnMapFileDownloadingProgress(QueuedCountry const & queuedCountry,
                                     downloader::HttpRequest & request);
 
-  std::unique_ptr<downloader::HttpRequest> m_request;
+  std::map<CountryId, std::unique_ptr<downloader::HttpRequest>> m_requests;
   Queue m_queue;
 
   DECLARE_THREAD_CHECKER(m_checker);
@@ -136,6 +136,12 @@ void MapFilesDownloader::SetDownloadingPolicy(DownloadingPolicy * policy)
   m_downloadingPolicy = policy;
 }
 
+void MapFilesDownloader::SetMaxConcurrentDownloads(size_t count)
+{
+  CHECK_GREATER(count, 0, ());
+  m_maxConcurrentDownloads = count;
+}
+
 bool MapFilesDownloader::IsDownloadingAllowed() const
 {
   return m_downloadingPolicy == nullptr || m_downloadingPolicy->IsDownloadingAllowed();
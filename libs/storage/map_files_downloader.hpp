@@ -66,6 +66,10 @@ public:
   void SetDownloadingPolicy(DownloadingPolicy * policy);
   void SetDataVersion(int64_t version) { m_dataVersion = version; }
 
+  // Number of files which are downloaded at the same time, 1 by default.
+  void SetMaxConcurrentDownloads(size_t count);
+  size_t GetMaxConcurrentDownloads() const { return m_maxConcurrentDownloads; }
+
   /// @name Legacy functions for Android resources downloading routine (initial World download).
   /// @{
   void EnsureMetaConfigReady(std::function<void ()> && callback);
@@ -100,6 +104,7 @@ private:
 
   ServersList m_serversList;
   int64_t m_dataVersion = 0;
+  size_t m_maxConcurrentDownloads = 1;
 
   /// Used as guard for m_serversList assign.
   std::atomic_bool m_isMetaConfigRequested = false;
@@ -95,10 +95,10 @@ void QueuedCountry::OnDownloadProgress(downloader::Progress const & progress) co
     m_subscriber->OnDownloadProgress(*this, progress);
 }
 
-void QueuedCountry::OnDownloadFinished(downloader::DownloadStatus status) const
+void QueuedCountry::OnDownloadFinished(downloader::DownloadStatus status, std::string const & sha1) const
 {
   if (m_subscriber != nullptr)
-    m_subscriber->OnDownloadFinished(*this, status);
+    m_subscriber->OnDownloadFinished(*this, status, sha1);
 }
 
 bool QueuedCountry::operator==(CountryId const & countryId) const
@@ -21,7 +21,9 @@ public:
     virtual void OnCountryInQueue(QueuedCountry const & queuedCountry) = 0;
     virtual void OnStartDownloading(QueuedCountry const & queuedCountry) = 0;
     virtual void OnDownloadProgress(QueuedCountry const & queuedCountry, downloader::Progress const & progress) = 0;
-    virtual void OnDownloadFinished(QueuedCountry const & queuedCountry, downloader::DownloadStatus status) = 0;
+    // |sha1| is a base64 hash of the downloaded file if the downloader calculated it.
+    virtual void OnDownloadFinished(QueuedCountry const & queuedCountry, downloader::DownloadStatus status,
+                                    std::string const & sha1) = 0;
   protected:
     virtual ~Subscriber() = default;
   };
@@ -45,7 +47,7 @@ public:
   void OnCountryInQueue() const;
   void OnStartDownloading() const;
   void OnDownloadProgress(downloader::Progress const & progress) const;
-  void OnDownloadFinished(downloader::DownloadStatus status) const;
+  void OnDownloadFinished(downloader::DownloadStatus status, std::string const & sha1 = {}) const;
 
   bool operator==(CountryId const & countryId) const;
 
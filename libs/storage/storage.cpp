@@ -92,6 +92,19 @@ bool IsFileDownloaded(string const fileDownloadPath, MapFileType type)
   // switch to next file.
   return isDownloadedDiff || GetPlatform().IsFileExistsByFullPath(readyFilePath);
 }
+
+DownloadStatus CheckSha1(string const & path, string const & sha1, string const & expectedSha1)
+{
+  if (sha1 != expectedSha1)
+  {
+    LOG(LERROR, ("SHA check error for", path));
+    base::DeleteFileX(path);
+    return DownloadStatus::FailedSHA;
+  }
+
+  LOG(LDEBUG, ("Successful SHA check"));
+  return DownloadStatus::Completed;
+}
 }  // namespace
 
 CountriesSet GetQueuedCountries(QueueInterface const & queue)
@@ -172,6 +185,14 @@ void Storage::SetDownloadingPolicy(DownloadingPolicy * policy)
   m_downloader->SetDownloadingPolicy(policy);
 }
 
+void Storage::SetMaxConcurrentDownloads(size_t count)
+{
+  CHECK_THREAD_CHECKER(m_threadChecker, ());
+
+  m_maxConcurrentDownloads = count;
+  m_downloader->SetMaxConcurrentDownloads(count);
+}
+
 void Storage::DeleteAllLocalMaps(CountriesVec * existedCountries /* = nullptr */)
 {
   CHECK_THREAD_CHECKER(m_threadChecker, ());
@@ -713,7 +734,8 @@ void Storage::OnDownloadProgress(QueuedCountry const & queuedCountry, Progress c
   ReportProgressForHierarchy(queuedCountry.GetCountryId(), progress);
 }
 
-void Storage::OnDownloadFinished(QueuedCountry const & queuedCountry, DownloadStatus status)
+void Storage::OnDownloadFinished(QueuedCountry const & queuedCountry, DownloadStatus status,
+                                 string const & sha1)
 {
   CHECK_THREAD_CHECKER(m_threadChecker, ());
 
@@ -734,24 +756,25 @@ void Storage::OnDownloadFinished(QueuedCountry const & queuedCountry, DownloadSt
     /// should make this kind of checks (taking expecting SHA as input). But now it's
     /// not so simple as it may seem ..
 
-    GetPlatform().RunTask(Platform::Thread::File, [path = GetFileDownloadPath(countryId, fileType),
-                                                   sha1 = GetCountryFile(countryId).GetSha1(),
-                                                   fn = std::move(finishFn)]()
+    auto path = GetFileDownloadPath(countryId, fileType);
+    auto expectedSha1 = GetCountryFile(countryId).GetSha1();
+
+    // The hash is calculated by the downloader while the file is downloading,
+    // the file is read again only if it's not available (e.g. downloading was resumed).
+    if (!sha1.empty())
     {
-      DownloadStatus status = DownloadStatus::Completed;
+      finishFn(CheckSha1(path, sha1, expectedSha1));
+      return;
+    }
 
-      if (coding::SHA1::CalculateBase64(path) != sha1)
-      {
-        LOG(LERROR, ("SHA check error for", path));
-        base::DeleteFileX(path);
-        status = DownloadStatus::FailedSHA;
-      }
+    GetPlatform().RunTask(Platform::Thread::File, [path = std::move(path),
+                                                   expectedSha1 = std::move(expectedSha1),
+                                                   fn = std::move(finishFn)]()
+    {
+      DownloadStatus const status = CheckSha1(path, coding::SHA1::CalculateBase64(path), expectedSha1);
 
       GetPlatform().RunTask(Platform::Thread::Gui, [fn = std::move(fn), status]()
       {
-        if (status == DownloadStatus::Completed)
-          LOG(LDEBUG, ("Successful SHA check"));
-
         fn(status);
       });
     });
@@ -885,6 +908,7 @@ void Storage::SetDownloaderForTesting(unique_ptr<MapFilesDownloader> downloader)
 
   m_downloader = std::move(downloader);
   m_downloader->SetDownloadingPolicy(m_downloadingPolicy);
+  m_downloader->SetMaxConcurrentDownloads(m_maxConcurrentDownloads);
 }
 
 void Storage::SetEnabledIntegrityValidationForTesting(bool enabled)
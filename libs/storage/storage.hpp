@@ -158,8 +158,8 @@ public:
   using DownloadingCountries = std::unordered_map<CountryId, downloader::Progress>;
 
 private:
-  /// We support only one simultaneous request at the moment
   std::unique_ptr<MapFilesDownloader> m_downloader;
+  size_t m_maxConcurrentDownloads = 1;
 
   /// Stores timestamp for update checks
   int64_t m_currentVersion = 0;
@@ -268,7 +268,7 @@ private:
   /// Called on the main thread by MapFilesDownloader when
   /// downloading of a map file succeeds/fails.
   void OnDownloadFinished(QueuedCountry const & queuedCountry,
-                          downloader::DownloadStatus status) override;
+                          downloader::DownloadStatus status, std::string const & sha1) override;
 
   /// Periodically called on the main thread by MapFilesDownloader
   /// during the downloading process.
@@ -306,6 +306,8 @@ public:
   void Init(UpdateCallback didDownload, DeleteCallback willDelete);
 
   void SetDownloadingPolicy(DownloadingPolicy * policy);
+  /// Sets the number of countries which are downloaded at the same time.
+  void SetMaxConcurrentDownloads(size_t count);
 
   bool CheckFailedCountries(CountriesVec const & countries) const;
 
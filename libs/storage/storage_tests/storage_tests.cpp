@@ -675,6 +675,57 @@ UNIT_TEST(StorageTest_FailedDownloading)
   TEST(Platform::IsFileExistsByFullPath(downloadPath + RESUME_FILE_EXTENSION), ());
 }
 
+UNIT_TEST(StorageTest_ConcurrentDownloading)
+{
+  Platform::ThreadRunner m_runner;
+  Storage storage;
+  storage.Init(&OnCountryDownloaded, [](CountryId const &, LocalFilePtr const) { return false; });
+  storage.SetDownloaderForTesting(make_unique<TestMapFilesDownloader>());
+  storage.SetCurrentDataVersionForTesting(1234);
+  storage.SetMaxConcurrentDownloads(2);
+
+  CountriesVec const countries = {storage.FindCountryIdByFile("Uruguay"),
+                                  storage.FindCountryIdByFile("Paraguay"),
+                                  storage.FindCountryIdByFile("Chile_North")};
+
+  auto const deleteFiles = [&]()
+  {
+    for (auto const & countryId : countries)
+      DeleteDownloaderFilesForCountry(storage.GetCurrentDataVersion(), storage.GetCountryFile(countryId));
+  };
+  deleteFiles();
+  SCOPE_GUARD(cleanup, [&]() {
+    deleteFiles();
+    storage.Clear();
+  });
+
+  // Files don't exist on the test server, so all the downloads fail in any order.
+  CountriesSet failed;
+  int const slot = storage.Subscribe([&](CountryId const & countryId)
+  {
+    if (find(countries.begin(), countries.end(), countryId) == countries.end() ||
+        storage.CountryStatusEx(countryId) != Status::DownloadFailed)
+    {
+      return;
+    }
+
+    failed.insert(countryId);
+    if (failed.size() == countries.size())
+      testing::StopEventLoop();
+  }, [](CountryId const &, downloader::Progress const &) {});
+
+  for (auto const & countryId : countries)
+    storage.DownloadCountry(countryId, MapFileType::Map);
+
+  // The first two countries are downloaded at the same time, the third one waits for a free slot.
+  TEST_EQUAL(storage.CountryStatusEx(countries[0]), Status::Downloading, ());
+  TEST_EQUAL(storage.CountryStatusEx(countries[1]), Status::Downloading, ());
+  TEST_EQUAL(storage.CountryStatusEx(countries[2]), Status::InQueue, ());
+
+  testing::RunEventLoop();
+  storage.Unsubscribe(slot);
+}
+
 UNIT_TEST(StorageTest_ObsoleteMapsRemoval)
 {
   Platform::ThreadRunner m_runner;
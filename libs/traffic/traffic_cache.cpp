@@ -3,7 +3,7 @@
 namespace traffic
 {
 
-void TrafficCache::Set(MwmSet::MwmId const & mwmId, std::shared_ptr<TrafficInfo::Coloring const> coloring)
+void TrafficCache::Set(MwmSet::MwmId const & mwmId, std::shared_ptr<TrafficInfo::PackedColoring const> coloring)
 {
   auto guard = std::lock_guard(m_mutex);
   m_trafficColoring[mwmId] = std::move(coloring);
@@ -10,7 +10,7 @@
 
 namespace traffic
 {
-using AllMwmTrafficInfo = std::map<MwmSet::MwmId, std::shared_ptr<const traffic::TrafficInfo::Coloring>>;
+using AllMwmTrafficInfo = std::map<MwmSet::MwmId, std::shared_ptr<const traffic::TrafficInfo::PackedColoring>>;
 
 class TrafficCache
 {
@@ -21,7 +21,7 @@ public:
   virtual void CopyTraffic(AllMwmTrafficInfo & trafficColoring) const;
 
 protected:
-  void Set(MwmSet::MwmId const & mwmId, std::shared_ptr<TrafficInfo::Coloring const> coloring);
+  void Set(MwmSet::MwmId const & mwmId, std::shared_ptr<TrafficInfo::PackedColoring const> coloring);
   void Remove(MwmSet::MwmId const & mwmId);
   void Clear();
 
@@ -85,6 +85,86 @@ TrafficInfo::RoadSegmentId::RoadSegmentId(uint32_t fid, uint16_t idx, uint8_t di
 {
 }
 
+// TrafficInfo::PackedColoring ----------------------------------------------------------------
+TrafficInfo::PackedColoring::PackedColoring(vector<RoadSegmentId> const & keys,
+                                            vector<SpeedGroup> const & values)
+{
+  Build(keys, values);
+}
+
+TrafficInfo::PackedColoring::PackedColoring(Coloring const & coloring)
+{
+  vector<RoadSegmentId> keys;
+  vector<SpeedGroup> values;
+  keys.reserve(coloring.size());
+  values.reserve(coloring.size());
+  for (auto const & [key, value] : coloring)
+  {
+    keys.push_back(key);
+    values.push_back(value);
+  }
+  Build(keys, values);
+}
+
+SpeedGroup TrafficInfo::PackedColoring::Get(uint32_t fid, uint16_t idx, uint8_t dir) const
+{
+  if (static_cast<size_t>(fid) + 1 >= m_offsets.size())
+    return SpeedGroup::Unknown;
+
+  uint32_t const entry = m_offsets[fid] + 2 * static_cast<uint32_t>(idx) + dir;
+  if (entry >= m_offsets[fid + 1])
+    return SpeedGroup::Unknown;
+
+  uint8_t const byte = m_entries[entry / 2];
+  return static_cast<SpeedGroup>(entry % 2 == 0 ? byte & 0xF : byte >> 4);
+}
+
+size_t TrafficInfo::PackedColoring::GetMemorySize() const
+{
+  return m_offsets.size() * sizeof(uint32_t) + m_entries.size();
+}
+
+void TrafficInfo::PackedColoring::Build(vector<RoadSegmentId> const & keys,
+                                        vector<SpeedGroup> const & values)
+{
+  CHECK_EQUAL(keys.size(), values.size(), ());
+  ASSERT(is_sorted(keys.begin(), keys.end()), ());
+
+  m_offsets.clear();
+  m_entries.clear();
+  m_knownCount = 0;
+  if (keys.empty())
+    return;
+
+  // Entries count of each feature is stored at its next feature position first
+  // and then the counts are turned into offsets.
+  m_offsets.assign(static_cast<size_t>(keys.back().m_fid) + 2, 0);
+  for (auto const & key : keys)
+  {
+    auto & count = m_offsets[key.m_fid + 1];
+    count = max(count, 2 * (static_cast<uint32_t>(key.m_idx) + 1));
+  }
+  for (size_t i = 1; i < m_offsets.size(); ++i)
+    m_offsets[i] += m_offsets[i - 1];
+
+  auto const unknown = static_cast<uint8_t>(SpeedGroup::Unknown);
+  static_assert(static_cast<uint8_t>(SpeedGroup::Count) <= 16, "A speed group should fit into 4 bits");
+  m_entries.assign((m_offsets.back() + 1) / 2, static_cast<uint8_t>(unknown | (unknown << 4)));
+
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    if (values[i] == SpeedGroup::Unknown)
+      continue;
+
+    auto const & key = keys[i];
+    uint32_t const entry = m_offsets[key.m_fid] + 2 * static_cast<uint32_t>(key.m_idx) + key.m_dir;
+    auto const value = static_cast<uint8_t>(values[i]);
+    auto & byte = m_entries[entry / 2];
+    byte = entry % 2 == 0 ? (byte & 0xF0) | value : (byte & 0x0F) | (value << 4);
+    ++m_knownCount;
+  }
+}
+
 // TrafficInfo --------------------------------------------------------------------------------
 
 // static
@@ -137,7 +217,7 @@ TrafficInfo::TrafficInfo(MwmSet::MwmId const & mwmId, int64_t currentDataVersion
 TrafficInfo TrafficInfo::BuildForTesting(Coloring && coloring)
 {
   TrafficInfo info;
-  info.m_coloring = std::move(coloring);
+  info.m_coloring = PackedColoring(coloring);
   return info;
 }
 
@@ -165,10 +245,7 @@ bool TrafficInfo::ReceiveTrafficData(string & etag)
 
 SpeedGroup TrafficInfo::GetSpeedGroup(RoadSegmentId const & id) const
 {
-  auto const it = m_coloring.find(id);
-  if (it == m_coloring.cend())
-    return SpeedGroup::Unknown;
-  return it->second;
+  return m_coloring.Get(id);
 }
 
 // static
@@ -477,23 +554,17 @@ TrafficInfo::ServerDataStatus TrafficInfo::ReceiveTrafficValues(string & etag, v
 
 bool TrafficInfo::UpdateTrafficData(vector<SpeedGroup> const & values)
 {
-  m_coloring.clear();
-
   if (m_keys.size() != values.size())
   {
     LOG(LWARNING,
         ("The number of received traffic values does not correspond to the number of keys:",
          m_keys.size(), "keys", values.size(), "values."));
+    m_coloring = {};
     m_availability = Availability::NoData;
     return false;
   }
 
-  for (size_t i = 0; i < m_keys.size(); ++i)
-  {
-    if (values[i] != SpeedGroup::Unknown)
-      m_coloring.emplace(m_keys[i], values[i]);
-  }
-
+  m_coloring = PackedColoring(m_keys, values);
   return true;
 }
 
@@ -71,9 +71,42 @@ public:
     uint8_t m_dir : 1;
   };
 
-  // todo(@m) unordered_map?
+  // Sparse coloring. It is used to build and combine colorings, see PackedColoring
+  // for the coloring which is kept for an mwm.
   using Coloring = std::map<RoadSegmentId, SpeedGroup>;
 
+  // Speed groups of all the segments of an mwm in a flat array of 4 bit entries indexed by
+  // feature id. Segments of a feature go in the order of traffic keys, both directions of a segment
+  // have entries, so a speed group is found without any search. It takes half a byte
+  // per segment direction and 4 bytes per feature instead of a std::map node per segment.
+  class PackedColoring
+  {
+  public:
+    PackedColoring() = default;
+    // |keys| should be sorted and |values| should be in the order of |keys|.
+    PackedColoring(std::vector<RoadSegmentId> const & keys, std::vector<SpeedGroup> const & values);
+    explicit PackedColoring(Coloring const & coloring);
+
+    // Returns SpeedGroup::Unknown if there is no information about the segment.
+    SpeedGroup Get(RoadSegmentId const & id) const { return Get(id.m_fid, id.m_idx, id.m_dir); }
+    SpeedGroup Get(uint32_t fid, uint16_t idx, uint8_t dir) const;
+
+    // Returns true if no segment has a known speed group.
+    bool IsEmpty() const { return m_knownCount == 0; }
+    size_t GetKnownCount() const { return m_knownCount; }
+    size_t GetMemorySize() const;
+
+  private:
+    void Build(std::vector<RoadSegmentId> const & keys, std::vector<SpeedGroup> const & values);
+
+    // Entries of feature |fid| are [m_offsets[fid], m_offsets[fid + 1]), the entry of
+    // a segment is m_offsets[fid] + 2 * idx + dir.
+    std::vector<uint32_t> m_offsets;
+    // Two entries per byte, an even entry in the low half.
+    std::vector<uint8_t> m_entries;
+    size_t m_knownCount = 0;
+  };
+
   TrafficInfo() = default;
 
   TrafficInfo(MwmSet::MwmId const & mwmId, int64_t currentDataVersion);
@@ -94,7 +127,7 @@ public:
   SpeedGroup GetSpeedGroup(RoadSegmentId const & id) const;
 
   MwmSet::MwmId const & GetMwmId() const { return m_mwmId; }
-  Coloring const & GetColoring() const { return m_coloring; }
+  PackedColoring const & GetColoring() const { return m_coloring; }
   Availability GetAvailability() const { return m_availability; }
 
   // Extracts RoadSegmentIds from mwm and stores them in a sorted order.
@@ -144,7 +177,7 @@ private:
   ServerDataStatus ProcessFailure(platform::HttpClient const & request, int64_t const mwmVersion);
 
   // The mapping from feature segments to speed groups (see speed_groups.hpp).
-  Coloring m_coloring;
+  PackedColoring m_coloring;
 
   // The keys of the coloring map. The values are downloaded periodically
   // and combined with the keys to form m_coloring.
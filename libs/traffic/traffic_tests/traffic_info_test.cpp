@@ -145,4 +145,38 @@ UNIT_TEST(TrafficInfo_UpdateTrafficData)
   for (size_t i = 0; i < keys.size(); ++i)
     TEST_EQUAL(info.GetSpeedGroup(keys[i]), values2[i], ());
 }
+
+UNIT_TEST(TrafficInfo_PackedColoring)
+{
+  TrafficInfo::Coloring const coloring = {
+      {TrafficInfo::RoadSegmentId(0, 0, 0), SpeedGroup::G0},
+
+      {TrafficInfo::RoadSegmentId(1, 0, 0), SpeedGroup::G1},
+      {TrafficInfo::RoadSegmentId(1, 0, 1), SpeedGroup::Unknown},
+      {TrafficInfo::RoadSegmentId(1, 2, 1), SpeedGroup::G3},
+
+      {TrafficInfo::RoadSegmentId(5, 0, 1), SpeedGroup::TempBlock},
+      {TrafficInfo::RoadSegmentId(5, 1, 0), SpeedGroup::G5},
+  };
+
+  TrafficInfo::PackedColoring const packed(coloring);
+  TEST(!packed.IsEmpty(), ());
+  TEST_EQUAL(packed.GetKnownCount(), 5, ());
+
+  for (auto const & [key, value] : coloring)
+    TEST_EQUAL(packed.Get(key), value, (key));
+
+  // Segments which are not in the coloring.
+  TEST_EQUAL(packed.Get(TrafficInfo::RoadSegmentId(0, 0, 1)), SpeedGroup::Unknown, ());
+  TEST_EQUAL(packed.Get(TrafficInfo::RoadSegmentId(0, 1, 0)), SpeedGroup::Unknown, ());
+  TEST_EQUAL(packed.Get(TrafficInfo::RoadSegmentId(1, 1, 0)), SpeedGroup::Unknown, ());
+  TEST_EQUAL(packed.Get(TrafficInfo::RoadSegmentId(3, 0, 0)), SpeedGroup::Unknown, ());
+  TEST_EQUAL(packed.Get(TrafficInfo::RoadSegmentId(5, 0, 0)), SpeedGroup::Unknown, ());
+  TEST_EQUAL(packed.Get(TrafficInfo::RoadSegmentId(5, 1, 1)), SpeedGroup::Unknown, ());
+  TEST_EQUAL(packed.Get(TrafficInfo::RoadSegmentId(6, 0, 0)), SpeedGroup::Unknown, ());
+
+  TrafficInfo::PackedColoring const empty;
+  TEST(empty.IsEmpty(), ());
+  TEST_EQUAL(empty.Get(TrafficInfo::RoadSegmentId(0, 0, 0)), SpeedGroup::Unknown, ());
+}
 }  // namespace traffic
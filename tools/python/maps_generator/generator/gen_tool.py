@@ -37,6 +37,7 @@ class GenTool:
         "make_city_roads": bool,
         "make_coasts": bool,
         "make_cross_mwm": bool,
+        "make_routing_geometry": bool,
         "make_routing_index": bool,
         "make_transit_cross_mwm": bool,
         "make_transit_cross_mwm_experimental": bool,
@@ -51,6 +52,7 @@ class GenTool:
         "brands_translations_data": str,
         "cache_path": str,
         "cities_boundaries_data": str,
+        "cross_mwm_overlay_path": str,
         "data_path": str,
         "dump_wikipedia_urls": str,
         "geo_objects_features": str,
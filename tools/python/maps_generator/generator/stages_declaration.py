@@ -346,6 +346,14 @@ class StageMwmStatistics(Stage):
         steps.step_statistics(env, country, **kwargs)
 
 
+@outer_stage
+class StageCrossMwmOverlay(Stage):
+    def apply(self, env: Env):
+        # Should be run after all the countries' cross mwm sections are built.
+        if WORLD_NAME in env.countries:
+            steps.step_cross_mwm_overlay(env, threads_count=settings.THREADS_COUNT)
+
+
 @outer_stage
 @depends_from_internal(
     D(
@@ -283,6 +283,20 @@ def step_routing_world(env: Env, country: AnyStr, **kwargs):
     )
 
 
+def step_cross_mwm_overlay(env: Env, **kwargs):
+    run_gen_tool_with_recovery_country(
+        env,
+        env.gen_tool,
+        out=env.get_subprocess_out(),
+        err=env.get_subprocess_out(),
+        data_path=env.paths.mwm_path,
+        user_resource_path=env.paths.user_resource_path,
+        output=WORLD_NAME,
+        cross_mwm_overlay_path=env.paths.mwm_path,
+        **kwargs,
+    )
+
+
 def step_index(env: Env, country: AnyStr, **kwargs):
     _generate_common_index(env, country, generate_search_index=True, **kwargs)
 
@@ -34,6 +34,7 @@ def generate_maps(env: Env, from_stage: Optional[AnyStr] = None):
         sd.StageFeatures(),
         sd.StageDownloadDescriptions(),
         sd.StageMwm(),
+        sd.StageCrossMwmOverlay(),
         sd.StageCountriesTxt(),
         sd.StageLocalAds(),
         sd.StageStatistics(),
@@ -6,6 +6,8 @@ import os
 
 # Should match size defined in platform/platform_tests/downloader_tests/downloader_test.cpp
 BIG_FILE_SIZE = 47684
+# Should match size defined in platform/platform_tests/downloader_tests/downloader_test.cpp
+BENCHMARK_FILE_SIZE = 16 * 1024 * 1024
 
 
 class Payload:
@@ -133,6 +135,7 @@ class ResponseProvider:
                 "/unit_tests/notexisting_unittest": self.test_404,
                 "/unit_tests/permanent": self.test_301,
                 "/unit_tests/47kb.file": self.test_47_kb,
+                "/unit_tests/16mb.file": self.test_16_mb,
                 # Following two URIs are used to test downloading failures on different platforms.
                 "/unit_tests/mac/1234/Uruguay.mwm": self.test_404,
                 "/unit_tests/linux/1234/Uruguay.mwm": self.test_404,
@@ -222,6 +225,22 @@ class ResponseProvider:
         return bytes(message)
 
 
+    def test_16_mb(self):
+        self.check_byterange(BENCHMARK_FILE_SIZE)
+        headers = self.chunked_response_header(BENCHMARK_FILE_SIZE)
+        first, last = self.byterange if self.is_chunked else (0, BENCHMARK_FILE_SIZE - 1)
+
+        return Payload(self.message_for_16mb_file(first, last), self.response_code, headers)
+
+
+    def message_for_16mb_file(self, first, last):
+        # Byte i of the file is i % 256, only the requested range is built.
+        pattern = bytes(range(256))
+        size = last - first + 1
+        message = pattern[first % 256:] + pattern * (size // 256 + 1)
+        return message[:size]
+
+
     # Partners_api_tests
     def partners_time(self):
         return Payload(jsons.PARTNERS_TIME)
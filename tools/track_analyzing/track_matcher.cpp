@@ -68,7 +68,8 @@ TrackMatcher::TrackMatcher(storage::Storage const & storage, NumMwmId mwmId,
   MwmSet::MwmHandle handle = m_dataSource.GetMwmHandleByCountryFile(countryFile);
 
   m_graph = make_unique<IndexGraph>(
-      make_shared<Geometry>(GeometryLoader::Create(handle, m_vehicleModel, false /* loadAltitudes */)),
+      make_shared<Geometry>(
+          GeometryLoader::Create(handle, m_vehicleModel, VehicleType::Car, false /* loadAltitudes */)),
       EdgeEstimator::Create(VehicleType::Car, *m_vehicleModel, nullptr /* trafficStash */,
         nullptr /* dataSource */, nullptr /* numMvmIds */));
 